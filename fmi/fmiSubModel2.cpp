@@ -1050,7 +1050,7 @@ void fmiSubModel2::loadFMU()
 		return;
 	}
 	auto modelName = fmi2_import_get_model_name(fmu);
-	description = std::string(modelName);
+	setDescription(std::string(modelName));
 
 
 	m_stateSize = static_cast<count_t>(fmi2_import_get_number_of_continuous_states(fmu));
@@ -172,6 +172,38 @@ void scheduler::setTime (double time)
   prevTime = time;
 }
 
+void scheduler::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridSubModel::getDiscreteState (dstate);
+  dstate.push_back (prevTime);
+  dstate.push_back (PCurr);
+  dstate.push_back (output);
+  dstate.push_back (static_cast<double> (pTarget.size ()));
+  for (auto &pt : pTarget)
+    {
+      dstate.push_back (pt.time);
+      dstate.push_back (pt.target);
+    }
+}
+
+count_t scheduler::setDiscreteState (const double dstate[])
+{
+  count_t used = gridSubModel::setDiscreteState (dstate);
+  prevTime = dstate[used];
+  PCurr = dstate[used + 1];
+  output = dstate[used + 2];
+  auto targetCount = static_cast<count_t> (dstate[used + 3]);
+  used += 4;
+  pTarget.resize (targetCount);
+  for (auto &pt : pTarget)
+    {
+      pt.time = dstate[used];
+      pt.target = dstate[used + 1];
+      used += 2;
+    }
+  return used;
+}
+
 void scheduler::updateA (double time)
 {
   double dt = (time - prevTime);
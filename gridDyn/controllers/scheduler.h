@@ -70,6 +70,8 @@ public:
 
   virtual double get (const std::string &param, gridUnits::units_t unitType = gridUnits::defUnit) const override;
   virtual void setTime (double time) override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
   /** tie the scheduler to a dispatcher */
   virtual void dispatcherLink ();
   /** get the maximum available power withing a specified time window
@@ -136,6 +138,8 @@ public:
 
   virtual void updateA (double time) override;
   virtual double predict (double time) override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   virtual void objectInitializeA (double time, unsigned long flags) override;
   virtual void objectInitializeB (const IOdata &args, const IOdata &outputSet, IOdata &inputSet) override;
@@ -77,6 +77,25 @@ void schedulerRamp::setTarget (double time, double target)
 
 
 
+void schedulerRamp::getDiscreteState (std::vector<double> &dstate) const
+{
+  scheduler::getDiscreteState (dstate);
+  dstate.push_back (dPdt);
+  dstate.push_back (PRampCurr);
+  dstate.push_back (lastTargetTime);
+  dstate.push_back (reserveUse);
+}
+
+count_t schedulerRamp::setDiscreteState (const double dstate[])
+{
+  count_t used = scheduler::setDiscreteState (dstate);
+  dPdt = dstate[used];
+  PRampCurr = dstate[used + 1];
+  lastTargetTime = dstate[used + 2];
+  reserveUse = dstate[used + 3];
+  return used + 4;
+}
+
 void schedulerRamp::updateA (double time)
 {
   double dt = (time - prevTime);
@@ -27,6 +27,7 @@
 #include "variableGenerator.h"
 #include "arrayDataSparse.h"
 
+#include <algorithm>
 //#include <set>
 /*
 For the dynamics states order matters for entries used across
@@ -118,6 +119,7 @@ gridCoreObject *gridDynGenerator::clone (gridCoreObject *obj) const
   gen->m_Rs = m_Rs;
   gen->m_Xs = m_Xs;
   gen->vRegFraction = vRegFraction;
+  gen->deferredModels = deferredModels;
   return gen;
 }
 
@@ -354,6 +356,7 @@ void gridDynGenerator::dynObjectInitializeA (double time0, unsigned long flags)
     {
       machineBasePower = systemBasePower;
     }
+  constructDeferredModels ();
   //automatically define a trivial generator model if none has been specified
   if (!genModel)
     {
@@ -591,6 +594,20 @@ void gridDynGenerator::guess (double ttime, double state[], double dstate_dt[],
 }
 
 
+void gridDynGenerator::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridSecondary::getDiscreteState (dstate);
+  dstate.push_back (Pset);
+}
+
+count_t gridDynGenerator::setDiscreteState (const double dstate[])
+{
+  count_t used = gridSecondary::setDiscreteState (dstate);
+  Pset = dstate[used];
+  return used + 1;
+}
+
+
 int gridDynGenerator::add (gridCoreObject *obj)
 {
   if (dynamic_cast<gridSubModel *> (obj))
@@ -608,16 +625,26 @@ int gridDynGenerator::add (gridCoreObject *obj)
     }
 }
 
+//remove any deferred records of a component so the most recent definition is the one used
+static void dropDeferredModels (std::vector<gridDynGenerator::deferredSubModel> &models, const std::string &component)
+{
+  models.erase (std::remove_if (models.begin (), models.end (), [&component](const gridDynGenerator::deferredSubModel &dm) {
+    return (dm.component == component);
+  }), models.end ());
+}
+
 int gridDynGenerator::add (gridSubModel *obj)
 {
 
   if (dynamic_cast<gridDynExciter *> (obj))
     {
       ext = static_cast<gridDynExciter *> (replaceSubObject (obj, ext, exciter_loc));
+      dropDeferredModels (deferredModels, "exciter");
     }
   else if (dynamic_cast<gridDynGenModel *> (obj))
     {
       genModel = static_cast<gridDynGenModel *> (replaceSubObject (obj, genModel, genmodel_loc));
+      dropDeferredModels (deferredModels, "genmodel");
       if (m_Rs != 0.0)
         {
           obj->set ("rs", m_Rs);
@@ -630,6 +657,7 @@ int gridDynGenerator::add (gridSubModel *obj)
   else if (dynamic_cast<gridDynGovernor *> (obj))
     {
       gov = static_cast<gridDynGovernor *> (replaceSubObject (obj, gov, governor_loc));
+      dropDeferredModels (deferredModels, "governor");
       //mesh up the Pmax and Pmin giving priority to the new gov
       double govpmax = gov->get ("pmax");
       double govpmin = gov->get ("pmin");
@@ -648,6 +676,7 @@ int gridDynGenerator::add (gridSubModel *obj)
   else if (dynamic_cast<gridDynPSS *> (obj))
     {
       pss = static_cast<gridDynPSS *> (replaceSubObject (obj, pss, pss_loc));
+      dropDeferredModels (deferredModels, "pss");
     }
 
   else
@@ -662,6 +691,57 @@ int gridDynGenerator::add (gridSubModel *obj)
 
 }
 
+void gridDynGenerator::addDeferredModel (deferredSubModel model)
+{
+  if (model.component == "governor")
+    {
+      //the governor limits are used in the power flow so they are applied now as add would
+      for (auto &pp : model.params)
+        {
+          if ((pp.first == "pmax") && (pp.second < kHalfBigNum))
+            {
+              Pmax = pp.second * machineBasePower / systemBasePower;
+            }
+          else if ((pp.first == "pmin") && (pp.second > -kHalfBigNum))
+            {
+              Pmin = pp.second * machineBasePower / systemBasePower;
+            }
+        }
+    }
+  dropDeferredModels (deferredModels, model.component);
+  deferredModels.push_back (std::move (model));
+}
+
+void gridDynGenerator::constructDeferredModels ()
+{
+  if (deferredModels.empty ())
+    {
+      return;
+    }
+  //add removes records from deferredModels so work from a local copy
+  std::vector<deferredSubModel> models;
+  models.swap (deferredModels);
+  auto cof = coreObjectFactory::instance ();
+  for (auto &dm : models)
+    {
+      auto sm = dynamic_cast<gridSubModel *> (cof->createObject (dm.component, dm.type));
+      if (!sm)
+        {
+          LOG_WARNING ("unable to construct deferred " + dm.component + " of type " + dm.type);
+          continue;
+        }
+      for (auto &pp : dm.params)
+        {
+          sm->set (pp.first, pp.second);
+        }
+      if (add (sm) != OBJECT_ADD_SUCCESS)
+        {
+          LOG_WARNING ("unable to add deferred " + dm.component + " of type " + dm.type);
+          delete sm;
+        }
+    }
+}
+
 gridSubModel *gridDynGenerator::replaceSubObject (gridSubModel *newObject, gridSubModel *oldObject, index_t newIndex)
 {
   if (oldObject)
@@ -854,6 +934,22 @@ double gridDynGenerator::get (const std::string &param, units_t unitType) const
     {
       ret = unitConversion (getPset (), puMW, unitType, systemBasePower);
     }
+  else if ((param == "rating") || (param == "base") || (param == "mbase"))
+    {
+      ret = unitConversion (machineBasePower, MVAR, unitType, systemBasePower, baseVoltage);
+    }
+  else if (param == "xs")
+    {
+      ret = m_Xs;
+    }
+  else if (param == "rs")
+    {
+      ret = m_Rs;
+    }
+  else if (param == "deferredmodels")
+    {
+      ret = static_cast<double> (deferredModels.size ());
+    }
   else
     {
       ret = gridSecondary::get (param, unitType);
@@ -16,6 +16,8 @@
 
 #include "gridObjects.h"
 
+#include <utility>
+
 class gridDynExciter;
 class gridDynGovernor;
 class gridDynGenModel;
@@ -64,6 +66,17 @@ public:
   {
     genmodel_loc = 1, exciter_loc = 2, governor_loc = 3,pss_loc = 4
   };
+  /** @brief a compact description of a dynamic submodel whose construction is deferred
+   readers of dynamic data can record the models instead of building them so runs which only use the power flow never
+  construct the objects,  the models are built when the dynamic initialization starts
+  */
+  class deferredSubModel
+  {
+public:
+    std::string component;  //!< the factory component name,  genmodel, exciter, governor, or pss
+    std::string type;  //!< the factory type name
+    std::vector<std::pair<std::string, double> > params;  //!< the parameters to set in order
+  };
   static count_t genCount;                                      //!< generator cound
   double baseVoltage = 120;             //!< [V] base voltage
 protected:
@@ -99,6 +112,7 @@ protected:
   std::vector<double> PC;                       //!< power control point for the capability curve
   std::vector<double> minQPC;           //!< min reactive power corresponding to the PC point
   std::vector<double> maxQPC;           //!< max reactive power corresponding to the PC points
+  std::vector<deferredSubModel> deferredModels;  //!< submodels described but not yet constructed
 
 public:
   static dynModel_t dynModelFromString (const std::string &dynModelType);
@@ -117,6 +131,8 @@ public:
   virtual void dynObjectInitializeB (const IOdata &args, const IOdata &outputSet) override;
   virtual void setState (double ttime, const double state[], const double dstate_dt[], const solverMode &sMode) override;       //for saving the state
   virtual void guess (double ttime, double state[],double dstate_dt[], const solverMode &sMode) override;               //for initial setting of the state
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   virtual int set (const std::string &param,  const std::string &val) override;
   virtual int set (const std::string &param, double val, gridUnits::units_t unitType = gridUnits::defUnit) override;
@@ -128,6 +144,19 @@ public:
   @param[in] a submodel to add
   @return OBJECT_ADD_SUCCESS if successful OBJECT_ADD_FAILURE if not*/
   virtual int add (gridSubModel *obj);
+  /** @brief record a submodel to be constructed at the start of the dynamic initialization
+   any earlier record of the same component is discarded, and a record is discarded if a submodel of the same
+  component is added before the models are constructed,  so the latest definition of each component is the one used
+  @param[in] model the description of the submodel
+  */
+  void addDeferredModel (deferredSubModel model);
+  /** @brief get the number of submodels waiting to be constructed*/
+  count_t deferredModelCount () const
+  {
+    return static_cast<count_t> (deferredModels.size ());
+  }
+  /** @brief construct any deferred submodels and add them to the generator*/
+  void constructDeferredModels ();
 
   void loadSizes (const solverMode &sMode, bool dynOnly) override;
 
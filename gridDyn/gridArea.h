@@ -18,6 +18,8 @@
 #include "gridObjects.h"
 #include "primary/listMaintainer.h"
 
+#include <utility>
+
 // forward classes
 class gridDynSimulation;
 class gridRelay;
@@ -39,6 +41,8 @@ public:
   {
     reverse_converge = object_flag1,           //!< flag indicating that the area should do a convergence/algebraic loop in reverse
     direction_oscillate = object_flag2,           //!< flag indicating that the direction of iteration for convergence functions should flip every time the function is called
+    parallel_initialization = object_flag3,           //!< flag indicating that buses with a local initialization are initialized concurrently
+    deferring_alerts = object_flag4,           //!< flag indicating the alerts from the buses are held until a concurrent initialization completes
   };
   static count_t areaCount;  //!< basic counter for the areas to compute an id
 
@@ -60,6 +64,7 @@ protected:
   int masterBus = -1;                   //!< the master bus for frequency calculations purposes
   int zone = 1;                                 //!< the zone of the area
   double fTarget=1.0;                 //!<[puHz] a target frequency
+  std::vector<std::pair<gridCoreObject *, int> > deferredAlerts;  //!< alerts held during a concurrent initialization
 public:
   /** @brief the default constructor*/
   gridArea (const std::string &objName = "area_$");
@@ -138,6 +143,17 @@ protected:
   //initializeB dynamics
   virtual void dynObjectInitializeA (double time0, unsigned long flags) override;
   virtual void dynObjectInitializeB (IOdata &outputSet) override;
+  /** @brief run the part 2 dynamic initialization of a set of buses with local initializations
+   the buses are initialized concurrently when OpenMP is available,  the alerts they raise are held and forwarded after
+  all the buses complete in the order of the buses so the result matches a sequential initialization
+  @param[in] batch the buses to initialize
+  @param[in] outputSet the desired outputs passed to each bus
+  */
+  void initializeBusBatch (std::vector<gridBus *> &batch, IOdata &outputSet);
+  /** @brief hold an alert if the area is running a concurrent initialization
+  @return true if the alert was held
+  */
+  bool deferAlert (gridCoreObject *obj, int code);
 
 public:
   virtual void setTime (double time) override;
@@ -193,6 +209,22 @@ public:
   virtual void getTols (double tols[], const solverMode &sMode) override;
   // dynamic simulation
   virtual void guess (double ttime, double state[], double dstate_dt[], const solverMode &sMode) override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
+  /** @brief get the discrete state and the number of values contributed by each block
+  @details the first block is the area itself followed by one block per primary object
+  @param[out] dstate the vector to append the discrete state to
+  @param[out] blockSizes the number of values appended by each block
+  */
+  void getDiscreteStateBlocks (std::vector<double> &dstate, std::vector<count_t> &blockSizes) const;
+  /** @brief load a discrete state captured by getDiscreteStateBlocks
+  @details each block is loaded from its own recorded offset so a change in the length of one object's
+  discrete state does not shift the values of the objects that follow it
+  @param[in] dstate the discrete state values
+  @param[in] blockSizes the number of values in each block
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the blocks do not match the area
+  */
+  int setDiscreteStateBlocks (const double dstate[], const std::vector<count_t> &blockSizes);
 
   /** @brief try to do a local converge on the solution
    to be replaced by the algebraic update function soon
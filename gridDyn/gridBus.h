@@ -23,6 +23,7 @@
 class gridLink;
 class gridLoad;
 class gridDynGenerator;
+class networkAdmittance;
 
 #define GOOD_SOLUTION (0)
 #define QLIMIT_VIOLATION (1)
@@ -101,6 +102,8 @@ protected:
   gridDyn_time lowVtime = -kBigNum;	//!< the last time a low voltage alert was triggered
   IOdata outputs;   //!< the current output values
   IOlocs outLocs;   //!< the current output locations
+  networkAdmittance *admittanceModel = nullptr;  //!< the assembled admittance model of the passive links if it is used
+  index_t admittanceIndex = kNullLocation;  //!< the index of the bus in the assembled network
 public:
   /** @brief default constructor*/
   gridBus (const std::string &objName = "bus_$");
@@ -153,6 +156,10 @@ protected:
   virtual void dynObjectInitializeA (double time0, unsigned long flags) override;
   virtual void dynObjectInitializeB (IOdata &outputSet) override;
 public:
+  /** @brief check if the dynamic initialization of the bus only changes the bus and its attached objects
+   buses with a local initialization can be initialized concurrently by the area
+  */
+  virtual bool hasLocalInitialization () const;
   virtual void disable () override;
   /** @brief  disconnect the bus*/
   virtual void disconnect () override;
@@ -177,6 +184,8 @@ public:
   virtual void algebraicUpdate (const stateData *sD, double update[], const solverMode &sMode, double alpha) override;
   virtual void voltageUpdate (const stateData *sD, double update[], const solverMode &sMode, double alpha);
   virtual void guess (double ttime, double state[], double dstate_dt[], const solverMode &sMode) override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   virtual void converge (double ttime, double state[], double dstate_dt[], const solverMode &sMode, converge_mode = converge_mode::high_error_only, double tol = 0.01) override;
 
@@ -185,6 +194,16 @@ public:
 
   virtual void updateLocalCache () override;
   virtual void updateLocalCache (const stateData *sD, const solverMode &sMode) override;
+  /** @brief attach the bus to an assembled network admittance model
+   the flows of links flagged as network_assembled come from the network model when it has been evaluated for the state
+  @param[in] net the network model or nullptr to compute all the link flows from the links
+  @param[in] index the index of the bus in the network model
+  */
+  void setNetworkModel (networkAdmittance *net, index_t index);
+
+protected:
+  /** @brief check if the passive link flows come from the network model for a given state*/
+  bool useNetworkModel (const stateData *sD, const solverMode &sMode) const;
 
 public:
   void setTime (double time) override;
@@ -13,29 +13,60 @@
 
 #include "gridCore.h"
 
+#include <mutex>
+#include <unordered_map>
+
 
 //set up the global object count
 
 //start at 100 since there are some objects that use low numbers as a check for interface number and the id as secondary
-count_t gridCoreObject::s_obcnt = 100;
+std::atomic<count_t> gridCoreObject::s_obcnt (100);
 
 gridCoreObject::gridCoreObject (const std::string &objName) : name (objName)
 {
 
-  s_obcnt++;
-  m_oid = s_obcnt;
+  m_oid = ++s_obcnt;
   //not using updateName since in many cases the id has not been set yet
-  if (name.back () == '#')
+  if ((!name.empty ()) && (name.back () == '#'))
     {
-      name.pop_back ();
-      name += std::to_string (m_oid);
+      name = name.substr (0, name.size () - 1) + std::to_string (m_oid);
     }
   id = m_oid;
 
 }
 
+/** the side tables for the rarely used object data keyed by the object address*/
+namespace
+{
+class objectSideData
+{
+public:
+  std::string description;
+  std::shared_ptr<gridPositionInfo> pos;
+};
+
+class sideTable
+{
+public:
+  std::unordered_map<const gridCoreObject *, objectSideData> entries;
+  std::mutex lock;
+};
+
+sideTable &sideData ()
+{
+  static sideTable table;
+  return table;
+}
+}
+
 gridCoreObject::~gridCoreObject ()
 {
+  if (hasSideData)
+    {
+      auto &tab = sideData ();
+      std::lock_guard<std::mutex> guard (tab.lock);
+      tab.entries.erase (this);
+    }
 }
 
 //inherited copy construction method
@@ -50,21 +81,27 @@ gridCoreObject *gridCoreObject::clone (gridCoreObject *obj) const
   obj->nextUpdateTime = nextUpdateTime;
   obj->m_lastUpdateTime = m_lastUpdateTime;
   obj->prevTime = prevTime;
-  obj->description = description;
+  if (hasSideData)
+    {
+      obj->setDescription (getDescription ());
+      obj->loadPosition (getPosition ());
+    }
   return obj;
 }
 
 void gridCoreObject::updateName ()
 {
+  if (name.empty ())
+    {
+      return;
+    }
   if (name.back () == '$')
     {
-      name.pop_back ();
-      name += std::to_string (id);
+      name = name.substr (0, name.size () - 1) + std::to_string (id);
     }
   else if (name.back () == '#')
     {
-      name.pop_back ();
-      name += std::to_string (m_oid);
+      name = name.substr (0, name.size () - 1) + std::to_string (m_oid);
     }
 }
 
@@ -157,7 +194,7 @@ int gridCoreObject::set (const std::string &param,  const std::string &val)
     }
   else if (param == "description")
     {
-      description = val;
+      setDescription (val);
     }
   else if (param[0] == '#')
     {
@@ -348,7 +385,7 @@ std::string gridCoreObject::getString (const std::string &param) const
     }
   else if (param == "description")
     {
-      out = description;
+      out = getDescription ();
     }
   else if (param == "parent")
     {
@@ -413,11 +450,16 @@ void gridCoreObject::log (gridCoreObject *object, int level, const std::string &
     }
 }
 
+int gridCoreObject::logLevelLimit () const
+{
+  //messages from objects without a parent are dropped by log so nothing should be built for them
+  return (parent) ? parent->logLevelLimit () : GD_NO_PRINT;
+}
+
 
 void gridCoreObject::makeNewOID ()
 {
-  s_obcnt++;
-  m_oid = s_obcnt;
+  m_oid = ++s_obcnt;
 }
 //NOTE: there is some potential for recursion here if the parent object searches in lower objects
 //But in some cases you search up, and others you want to search down so we will rely on intelligence on the part of the implementer
@@ -442,7 +484,50 @@ int gridCoreObject::getInt (const std::string &param) const
 
 void gridCoreObject::loadPosition (std::shared_ptr<gridPositionInfo> npos)
 {
-  pos = npos;
+  if ((!npos) && (!hasSideData))
+    {
+      return;
+    }
+  auto &tab = sideData ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  tab.entries[this].pos = npos;
+  hasSideData = true;
+}
+
+std::shared_ptr<gridPositionInfo> gridCoreObject::getPosition () const
+{
+  if (!hasSideData)
+    {
+      return nullptr;
+    }
+  auto &tab = sideData ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  auto fnd = tab.entries.find (this);
+  return (fnd != tab.entries.end ()) ? fnd->second.pos : nullptr;
+}
+
+void gridCoreObject::setDescription (const std::string &desc)
+{
+  if ((desc.empty ()) && (!hasSideData))
+    {
+      return;
+    }
+  auto &tab = sideData ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  tab.entries[this].description = desc;
+  hasSideData = true;
+}
+
+std::string gridCoreObject::getDescription () const
+{
+  if (!hasSideData)
+    {
+      return std::string ();
+    }
+  auto &tab = sideData ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  auto fnd = tab.entries.find (this);
+  return (fnd != tab.entries.end ()) ? fnd->second.description : std::string ();
 }
 
 
@@ -19,10 +19,12 @@
 #include "basicDefs.h"
 #include "gridDynTypes.h"
 #include "units.h"
+#include "internedString.h"
 
 //common libraries in all code
 //library for printf debug statements
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -51,7 +53,6 @@ alert and logging functions
 class gridCoreObject
 {
 public:
-  std::string description;             //!< storage for a description of the object meant for user, no operational impact
   index_t locIndex = kNullLocation;           //!< a lookup index for the object to reference parent location in storage arrays for use by containing objects no operational dependencies
   index_t locIndex2 = kNullLocation;           //!< a second lookup index for the object to reference parent location in storage arrays for use by containing objects no operational dependencies
   //this is used much more frequently than any other so it gets its own bool for ease of use
@@ -59,11 +60,12 @@ public:
   bool enabled = true;           //!< enabled indicator TODO: PT move to a protected instead of public
 
 private:
-  static count_t s_obcnt;       //!< the global object counter
+  bool hasSideData = false;       //!< the object has an entry in the description or position side tables
+  static std::atomic<count_t> s_obcnt;       //!< the global object counter,  atomic since separate simulations may create objects concurrently
   count_t m_oid;       //!< a unique index for the object
   gridCoreObject *owner = nullptr;      //!<a pointer to the owner object
 protected:
-  std::string name;       //!< the text name of the object
+  internedString name;       //!< the text name of the object stored in the shared string table
   index_t id;              //!< a user defined id for the object
   gridCoreObject *parent = nullptr;      //!< a pointer to the parent object
   double prevTime = -kBigNum;       //!<[s]the last state time of the object
@@ -73,8 +75,6 @@ protected:
   double m_bDelay  = -1.0;         //!<[s]the requested delay between updateA and updateB--requested is key here not guaranteed
   double systemBasePower = 100.0;        //!<[MW] the base power of the object
 
-
-  std::shared_ptr<gridPositionInfo> pos;  //!< pointer to as of yet undefined position infomation stucture.
 public:
   /** @brief default constructor*/
   gridCoreObject (const std::string &name = "object_#");
@@ -111,6 +111,19 @@ public:
   */
   virtual void log (gridCoreObject *object, int level, const std::string &message);
   /**
+  * @brief get the highest log level that will be processed by the object that ultimately handles log messages
+  * @return the maximum print level, messages with a level above this are discarded
+  */
+  virtual int logLevelLimit () const;
+  /**
+  * @brief check if a message at a given level would be processed so the message only gets built if it is needed
+  * @param[in] level the level of the log message
+  */
+  bool checkLogLevel (int level) const
+  {
+    return (level <= logLevelLimit ());
+  }
+  /**
   * @brief sets the object time used primarily for shifting the clock to a different basis
   * @param[in] time the time to set the object clock to.
   */
@@ -256,6 +269,14 @@ public:
   @param[in] a gridPositionObject
   */
   void loadPosition (std::shared_ptr<gridPositionInfo> npos);
+  /** @brief get the position object if one was loaded*/
+  std::shared_ptr<gridPositionInfo> getPosition () const;
+  /** @brief set the description
+   the descriptions and positions are rarely used so they are kept in tables outside the objects
+  */
+  void setDescription (const std::string &desc);
+  /** @brief get the description of the object*/
+  std::string getDescription () const;
 
   /** @brief set the name*/
   virtual void setName (std::string name);
@@ -330,21 +351,24 @@ std::string fullObjectName (gridCoreObject *obj);
 
 //logging Macros
 
-#define LOG_ERROR(message) log (this,GD_ERROR_PRINT,message);
-#define LOG_WARNING(message) log (this,GD_WARNING_PRINT,message);
+//the level is checked before the message argument is evaluated so filtered messages are never constructed
+#define LOG_LEVEL_MESSAGE(level,message) do { if (checkLogLevel (level)) { log (this,level,message); } } while (false);
+
+#define LOG_ERROR(message) LOG_LEVEL_MESSAGE (GD_ERROR_PRINT,message)
+#define LOG_WARNING(message) LOG_LEVEL_MESSAGE (GD_WARNING_PRINT,message)
 
 #ifdef LOG_ENABLE
-#define LOG_SUMMARY(message) log (this,GD_SUMMARY_PRINT,message);
-#define LOG_NORMAL(message) log (this,GD_NORMAL_PRINT,message);
+#define LOG_SUMMARY(message) LOG_LEVEL_MESSAGE (GD_SUMMARY_PRINT,message)
+#define LOG_NORMAL(message) LOG_LEVEL_MESSAGE (GD_NORMAL_PRINT,message)
 
 #ifdef DEBUG_LOG_ENABLE
-#define LOG_DEBUG(message) log (this,GD_DEBUG_PRINT,message);
+#define LOG_DEBUG(message) LOG_LEVEL_MESSAGE (GD_DEBUG_PRINT,message)
 #else
 #define LOG_DEBUG(message)
 #endif
 
 #ifdef TRACE_LOG_ENABLE
-#define LOG_TRACE(message) log (this,GD_TRACE_PRINT,message);
+#define LOG_TRACE(message) LOG_LEVEL_MESSAGE (GD_TRACE_PRINT,message)
 #else
 #define LOG_TRACE(message)
 #endif
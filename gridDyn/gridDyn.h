@@ -40,6 +40,17 @@ const std::string griddyn_version_string = "GridDyn version " + griddyn_version
 class contingency;
 class continuationSequence;
 class solverInterface;
+class residualDeltaEvaluator;
+class realTimePacer;
+class powerFlowCache;
+class trajectorySensitivity;
+class networkAdmittance;
+class rollbackBuffer;
+class partitionedCoupling;
+class objectRegistry;
+class jacobianPatternCache;
+class sparsePattern;
+class residualValidator;
 
 //!<additional flags for the controlFlags bitset
 enum gd_flags
@@ -65,6 +76,9 @@ enum gd_flags
   save_power_flow_data = 49,
   no_powerflow_error_recovery = 50,
   dae_initialization_for_partitioned = 51,
+  delta_residual_evaluation = 52,
+  powerflow_cache_enabled = 53,
+  assembled_network = 54,
 };
 
 //for the status flags bitset
@@ -112,6 +126,15 @@ public:
   friend class powerFlowErrorRecovery;
   friend class dynamicInitialConditionRecovery;
   friend class faultResetRecovery;
+  friend class residualDeltaEvaluator;
+  friend class branchOutageScreening;
+  friend class voltageStabilityScreening;
+  friend class trajectorySensitivity;
+  friend class stateEstimator;
+  friend class rollbackBuffer;
+  friend class partitionedCoupling;
+  friend class jacobianPatternCache;
+  friend class residualValidator;
   //!< define various contingency modes  [probably will be changed in the near future]
   enum class contingency_mode_t
   {
@@ -169,10 +192,23 @@ protected:
   std::vector<gridBus *> slkBusses;                             //!< vector of slk buses to aid in powerflow adjust
   std::queue<gridDynAction> actionQueue;                //!< queue for actions for Griddyn to execute
   std::vector < std::shared_ptr < continuationSequence >> continList;  //!< set of continuation seqeunces to run
+  std::unique_ptr<residualDeltaEvaluator> deltaEval;  //!< change driven residual evaluation if enabled
+  double deltaResidualTolerance = 0.0;  //!< the change tolerance for the delta residual evaluation 0 for exact
+  realTimePacer *pacer = nullptr;  //!< frame timing for real time execution, not owned by the simulation
+  std::unique_ptr<powerFlowCache> pfCache;  //!< cache of power flow solutions for warm starts if enabled
+  std::unique_ptr<trajectorySensitivity> sensitivity;  //!< forward sensitivities of the dynamic trajectory if parameters are set
+  std::unique_ptr<networkAdmittance> network;  //!< assembled admittance model of the passive links if enabled
+  std::unique_ptr<rollbackBuffer> rollback;  //!< in memory snapshots for the checkpoint and rollback actions if used
+  std::unique_ptr<partitionedCoupling> coupling;  //!< error controlled coupling for the partitioned dynamic solution if used
+  std::unique_ptr<objectRegistry> registry;  //!< flat lists of the simulation objects by type
+  std::unique_ptr<jacobianPatternCache> jacPatterns;  //!< Jacobian patterns and orderings shared by the solver interfaces
+  count_t jacobianChanges = 0;  //!< the number of alerts which changed the states or Jacobian entries of an object
+  std::unique_ptr<residualValidator> validator;  //!< checks of the solver callback data for non-finite values
 public:
   /** @ constructor to set the name
   @param[in] objName the name of the simulation*/
   gridDynSimulation (const std::string &objName = "gridDynSim_#");
+  ~gridDynSimulation ();
 
   virtual gridCoreObject * clone (gridCoreObject *obj = nullptr) const override;
 
@@ -294,6 +330,29 @@ public:
   virtual double get (const std::string &param, gridUnits::units_t unitType = gridUnits::defUnit) const override;
   virtual std::string getString (const std::string &param) const override;
   virtual int setFlag (const std::string &flag, bool val = true) override;
+  /** @brief set a parameter on all the objects of a type in the simulation
+   the bus,  link,  and relay types cover the objects of all the areas in the simulation*/
+  virtual void setAll (const std::string &type, std::string param, double val, gridUnits::units_t unitType = gridUnits::defUnit) override;
+  /** @brief get the flat lists of the simulation objects by type and class*/
+  objectRegistry *getObjectRegistry () const
+  {
+    return registry.get ();
+  }
+  /** @brief get the Jacobian sparsity pattern and fill reducing ordering of a solver mode
+  @return the pattern or nullptr if it cannot be determined
+  */
+  std::shared_ptr<const sparsePattern> getJacobianPattern (const solverMode &sMode);
+  /** @brief use the Jacobian patterns and orderings of another simulation with the same structure
+   the sparse solvers of this simulation then share the symbolic analysis of the source and only compute their own numeric factors
+  */
+  void shareJacobianPatterns (const gridDynSimulation *source);
+  /** @brief get a counter which changes whenever the Jacobian structure of the simulation may have changed
+   it counts the objects added or removed and the alerts changing the states or Jacobian entries of an object
+  */
+  count_t patternVersion () const
+  {
+    return structureVersion () + jacobianChanges;
+  }
 
   /** @brief get a vector of the states
   @param[in]  sMode the solverMode to get the states for
@@ -495,7 +554,23 @@ public:
   @param[in] sMode the solverMode of the state Data object
   */
   void fillExtraStateData (stateData *sD, const solverMode &sMode) const;
+  /** @brief attach a pacer to account for the solver, event, and recorder time within each step
+  @param[in] rtp the pacer to use or nullptr to turn off the accounting,  the pacer must outlive the simulation or be removed
+  */
+  void setRealTimePacer (realTimePacer *rtp)
+  {
+    pacer = rtp;
+  }
+  /** @brief get the trajectory sensitivity engine
+  @return a pointer to the engine or nullptr if no sensitivity parameters have been set
+  */
+  trajectorySensitivity *getSensitivity () const
+  {
+    return sensitivity.get ();
+  }
 protected:
+  /** @brief compute the flows of the assembled network for a state if the assembled_network flag is set*/
+  void networkEvaluation (const stateData *sD, const solverMode &sMode);
   /** @brief makes sure the the specified mode has the correct offsets
   @param[in] sMode the solverMode of the offsets to check
   */
@@ -601,6 +676,9 @@ protected:
   */
   void handleEarlySolverReturn (int retval, double timeReturn, std::shared_ptr<solverInterface> &dynData);
 
+  /** @brief execute the events at the given time with the event and recorder time accounted to the pacer*/
+  change_code executeTimedEvents (double time);
+
   /** @brief reset the dynamic simulation
    function checks for various conditions that cause specific things in the solver or simulation to be reset
   the nature of the reset can be driven by the reset_code given as an argument or internal flags from alerts or other mechanisms
@@ -621,6 +699,11 @@ protected:
   */
   bool checkEventsForDynamicReset (double cTime, const solverMode &sMode);
 
+  /** @brief take any due rollback capture and get the next time the dynamic solution must stop
+  @return the earlier of the next event time and the next rollback capture time
+  */
+  double checkRollbackCapture ();
+
 
 private:
   void setupDynamicDAE ();
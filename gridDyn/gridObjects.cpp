@@ -833,6 +833,28 @@ void gridObject::guess(double ttime, double state[], double dstate_dt[], const s
 	}
 }
 
+void gridObject::getDiscreteState (std::vector<double> &dstate) const
+{
+  dstate.push_back (nextUpdateTime);
+  dstate.push_back (m_lastUpdateTime);
+  for (auto &sub : subObjectList)
+    {
+      sub->getDiscreteState (dstate);
+    }
+}
+
+count_t gridObject::setDiscreteState (const double dstate[])
+{
+  nextUpdateTime = dstate[0];
+  m_lastUpdateTime = dstate[1];
+  count_t used = 2;
+  for (auto &sub : subObjectList)
+    {
+      used += sub->setDiscreteState (dstate + used);
+    }
+  return used;
+}
+
 void gridObject::setupPFlowFlags ()
 {
 
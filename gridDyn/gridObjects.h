@@ -16,6 +16,7 @@
 #include "gridCore.h"
 #include "gridObjectsHelperClasses.h"
 
+#include <atomic>
 #include <bitset>
 
 class gridBus;
@@ -29,23 +30,10 @@ class arrayData;
 
 typedef std::vector<std::string> stringVec;
 
-#include "boost/version.hpp"
-#if BOOST_VERSION / 100 % 1000 >= 58
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wshadow"
-    #include "boost/container/small_vector.hpp"
-#pragma GCC diagnostic pop
-#else
-#include "boost/container/small_vector.hpp"
-#endif
+#include "ioVector.h"
 
-typedef boost::container::small_vector<double, 4> IOdata;
-typedef boost::container::small_vector<index_t, 4> IOlocs;
-#else
-typedef std::vector<double> IOdata;
-typedef std::vector<index_t> IOlocs;
-#endif
+typedef ioVector<double, 4> IOdata;
+typedef ioVector<index_t, 4> IOlocs;
 
 class violation;
 
@@ -90,6 +78,11 @@ public:
   {
     return (opFlags.to_ullong () & flagMask);
   }
+  /** @brief get the list of sub objects*/
+  const std::vector<gridObject *> &getSubObjects () const
+  {
+    return subObjectList;
+  }
 
   /** @brief set the offsets of an object for a particular optimization mode using a single offset.
   \param[in] offset the offset index all variables are sequential.
@@ -269,6 +262,17 @@ public:
   \param sMode  -- the solverMode corresponding to the computed state.
   */
   virtual void guess (double ttime, double state[], double dstate_dt[], const solverMode &sMode);
+  /** @brief get the discrete state of the object and its subObjects
+   the discrete state is the information outside the solver states which changes as a simulation runs such as switch
+  positions,  relay conditions,  tap positions,  and scheduled targets
+  \param[out] dstate the vector to append the values to
+  */
+  virtual void getDiscreteState (std::vector<double> &dstate) const;
+  /** @brief restore the discrete state of the object and its subObjects
+  \param[in] dstate the values written by getDiscreteState
+  \return the number of values used
+  */
+  virtual count_t setDiscreteState (const double dstate[]);
   /** @brief load tolerance information from the objects
   \param[out] tols -- a double array with the state tolerance information
   \param[in] sMode  -- the solverMode corresponding to the computed state.
@@ -361,7 +365,16 @@ public:
   */
   void dynInitializeB (IOdata &outputSet);
 
+  /** @brief record that objects were added to or removed from the object
+   the change is counted on the root of the tree so separate simulations do not invalidate each other
+  */
+  void structureChanged ();
+  /** @brief get the count of structure changes in the tree containing the object,  used to detect stale object indices*/
+  count_t structureVersion () const;
+
 protected:
+  std::atomic<count_t> structureChanges;  //!< counter of the objects added to or removed from the tree,  only the root counter is used
+
   /** @brief initialize local object for power flow part A
  see pFlowInitializeA for more details
 @param[in] time0 the time0 at which the power flow will take place
@@ -18,10 +18,37 @@
 #include <map>
 #include <algorithm>
 
-gridPrimary::gridPrimary (const std::string &objName) : gridObject (objName)
+gridPrimary::gridPrimary (const std::string &objName) : gridObject (objName), structureChanges (0)
 {
 }
 
+/** find the top primary object containing obj*/
+static const gridPrimary *structureRoot (const gridPrimary *obj)
+{
+  const gridPrimary *root = obj;
+  auto par = obj->getParent ();
+  while (par != nullptr)
+    {
+      auto pp = dynamic_cast<const gridPrimary *> (par);
+      if (pp != nullptr)
+        {
+          root = pp;
+        }
+      par = par->getParent ();
+    }
+  return root;
+}
+
+void gridPrimary::structureChanged ()
+{
+  ++const_cast<gridPrimary *> (structureRoot (this))->structureChanges;
+}
+
+count_t gridPrimary::structureVersion () const
+{
+  return structureRoot (this)->structureChanges.load ();
+}
+
 
 void gridPrimary::pFlowInitializeA (double time0, unsigned long flags)
 {
@@ -881,6 +881,27 @@ void acLine::disable()
 
 }
 
+void acLine::getDiscreteState(std::vector<double> &dstate) const
+{
+	gridLink::getDiscreteState(dstate);
+	dstate.push_back(fault);
+	dstate.push_back(tap);
+	dstate.push_back(tapAngle);
+}
+
+count_t acLine::setDiscreteState(const double dstate[])
+{
+	count_t used = gridLink::setDiscreteState(dstate);
+	if (dstate[used] != fault)
+	{
+		//go through set so the fault change is announced
+		set("fault", dstate[used]);
+	}
+	tap = dstate[used + 1];
+	tapAngle = dstate[used + 2];
+	return used + 3;
+}
+
 double acLine::getMaxTransfer() const
 {
 	if (!isConnected())
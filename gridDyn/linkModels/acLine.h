@@ -59,6 +59,7 @@ Each link has a disconnect switch at the from bus and the to bus
 */
 class acLine : public gridLink
 {
+  friend class networkAdmittance;
 public:
 protected:
   double minAngle = -kPI / 2.0;                     //!<the minimum angle of the link can handle
@@ -117,6 +118,8 @@ public:
   }
 
   void disable () override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
   /** @brief allow the real power flow to be fixed by adjusting the properties of one bus or another
    performs the calculations necessary to get the power at the mterminal to be a certain value
   @param[in] power  the desired real power flow as measured by mterminal
@@ -185,6 +185,11 @@ int adjustableTransformer::set (const std::string &param, double val, units_t un
       tap = val;
       tap0 = val;
     }
+  else if (param == "currenttap")
+    {
+      //change the operating tap without changing the tap restored on reset
+      tap = val;
+    }
   else if (param == "tapangle")
     {
       tapAngle = unitConversion (val,unitType,rad);
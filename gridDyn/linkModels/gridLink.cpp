@@ -323,6 +323,22 @@ void gridLink::switchMode (index_t num, bool mode)
 
 }
 
+void gridLink::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridPrimary::getDiscreteState (dstate);
+  dstate.push_back ((opFlags[switch1_open_flag]) ? 1.0 : 0.0);
+  dstate.push_back ((opFlags[switch2_open_flag]) ? 1.0 : 0.0);
+}
+
+count_t gridLink::setDiscreteState (const double dstate[])
+{
+  count_t used = gridPrimary::setDiscreteState (dstate);
+  //switchMode does nothing if the switch is already in the requested position
+  switchMode (1, (dstate[used] > 0.5));
+  switchMode (2, (dstate[used + 1] > 0.5));
+  return used + 2;
+}
+
 
 void gridLink::switchChange (int /*switchNum*/)
 {
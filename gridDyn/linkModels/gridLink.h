@@ -62,6 +62,7 @@ public:
     switch2_open_flag = object_flag2, //!< switch for the to bus
     fixed_target_power = object_flag3,  //!< flag indicating if the power flow was fixed
 	network_connected=object_flag4, //!< indicates if a link ties the buses together in connected network
+    network_assembled = object_flag10,  //!< the flows of the link are computed by an assembled network admittance model
   };
   int zone = 1;  //!< publicly accessible loss zone indicator not used internally
 protected:
@@ -115,6 +116,8 @@ public:
   * @return true if there is a connection between the to and from bus
   */
   virtual bool isConnected () const override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   virtual void updateLocalCache () override;
   virtual void updateLocalCache (const stateData *sD, const solverMode &sMode) override;
@@ -158,6 +158,29 @@ void gridLoad::setState (double ttime, const double /*state*/[], const double /*
     }
 }
 
+void gridLoad::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridSecondary::getDiscreteState (dstate);
+  dstate.push_back (P);
+  dstate.push_back (Q);
+  dstate.push_back (Ip);
+  dstate.push_back (Iq);
+  dstate.push_back (Yp);
+  dstate.push_back (Yq);
+}
+
+count_t gridLoad::setDiscreteState (const double dstate[])
+{
+  count_t used = gridSecondary::setDiscreteState (dstate);
+  P = dstate[used];
+  Q = dstate[used + 1];
+  Ip = dstate[used + 2];
+  Iq = dstate[used + 3];
+  Yp = dstate[used + 4];
+  Yq = dstate[used + 5];
+  return used + 6;
+}
+
 double gridLoad::timestep (double ttime, const IOdata &args, const solverMode &)
 {
   if (!enabled)
@@ -109,6 +109,8 @@ public:
   virtual double getReactivePower () const override;
 
   virtual void setState (double ttime, const double state[], const double dstate_dt[], const solverMode &sMode) override;                                                                                                                                //for saving the state
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   double getdPdf ()
   {
@@ -0,0 +1,834 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "loadModels/motorBankLoad.h"
+#include "gridBus.h"
+#include "objectFactoryTemplates.h"
+#include "gridCoreTemplates.h"
+#include "arrayData.h"
+#include "stringOps.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace gridUnits;
+
+static typeFactory<motorBankLoad> mbf ("load", stringVec { "motorbank", "motorgroup" });
+
+motorBankLoad::motorBankLoad (const std::string &objName) : gridLoad (objName)
+{
+  opFlags.set (no_pqvoltage_limit);
+  opFlags.set (has_dyn_states);
+}
+
+gridCoreObject *motorBankLoad::clone (gridCoreObject *obj) const
+{
+  motorBankLoad *ld = cloneBase<motorBankLoad, gridLoad> (this, obj);
+  if (!(ld))
+    {
+      return obj;
+    }
+  ld->motorCount = motorCount;
+  ld->r1 = r1;
+  ld->xs = xs;
+  ld->xm = xm;
+  ld->Hm = Hm;
+  ld->alpha = alpha;
+  ld->beta = beta;
+  ld->gamma = gamma;
+  ld->mscale = mscale;
+  ld->Vcontrol = Vcontrol;
+  ld->connected = connected;
+  ld->running = running;
+  ld->Vtrip = Vtrip;
+  ld->Vreconnect = Vreconnect;
+  ld->tripFraction = tripFraction;
+  ld->init_slip = init_slip;
+  return ld;
+}
+
+int motorBankLoad::setMotorCount (count_t count)
+{
+  if (opFlags[pFlow_initialized])
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  bool empty = (motorCount == 0);
+  auto fill = [empty,count](std::vector<double> &vec, double def) {
+      vec.resize (count, (empty) ? def : vec[0]);
+    };
+  fill (r1, 0.05);
+  fill (xs, 0.3);
+  fill (xm, 5.0);
+  fill (Hm, 3.0);
+  fill (alpha, 1.0);
+  fill (beta, 0.0);
+  fill (gamma, 0.0);
+  fill (mscale, 0.0);
+  fill (Vcontrol, 1.0);
+  connected.resize (count, 1.0);
+  running.resize (count, 1.0);
+  motorCount = count;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void motorBankLoad::pFlowObjectInitializeA (double time0, unsigned long flags)
+{
+  m_state.assign (motorCount, init_slip);
+  //these parameters need to be ignored for the time being
+  Vpqmin = -1.0;
+  Vpqmax = kBigNum;
+  return gridLoad::pFlowObjectInitializeA (time0, flags);
+}
+
+void motorBankLoad::dynObjectInitializeA (double time0, unsigned long flags)
+{
+  if (motorCount > 0)
+    {
+      opFlags.set (has_roots);
+    }
+  return gridLoad::dynObjectInitializeA (time0, flags);
+}
+
+void motorBankLoad::dynObjectInitializeB (const IOdata & /*args*/, const IOdata & /*outputSet*/)
+{
+  for (auto &ds : m_dstate_dt)
+    {
+      ds = 0.0;
+    }
+}
+
+void motorBankLoad::loadSizes (const solverMode &sMode, bool dynOnly)
+{
+  auto so = offsets.getOffsets (sMode);
+  //the status masks never change the sizes,  every motor keeps its state,  roots and Jacobian entries
+  count_t roots = (Vtrip > 0.0) ? motorCount + 1 : motorCount;
+  if (dynOnly)
+    {
+      so->total.jacSize = 2 * motorCount;
+      so->total.diffRoots = roots;
+      so->rjLoaded = true;
+    }
+  else
+    {
+      so->reset ();
+      if (isDynamic (sMode))
+        {
+          so->total.diffRoots = roots;
+          if (!isAlgebraicOnly (sMode))
+            {
+              so->total.diffSize = motorCount;
+              so->total.jacSize = 2 * motorCount;
+            }
+        }
+      else
+        {
+          so->total.algSize = motorCount;
+          so->total.jacSize = 2 * motorCount;
+        }
+      so->rjLoaded = true;
+      so->stateLoaded = true;
+    }
+}
+
+int motorBankLoad::set (const std::string &param,  const std::string &val)
+{
+  return gridLoad::set (param, val);
+}
+
+int motorBankLoad::set (const std::string &param, double val, gridUnits::units_t unitType)
+{
+  int out = PARAMETER_FOUND;
+  if ((param == "motors") || (param == "motorcount") || (param == "count"))
+    {
+      if ((val < 0) || (setMotorCount (static_cast<count_t> (val)) != FUNCTION_EXECUTION_SUCCESS))
+        {
+          out = INVALID_PARAMETER_VALUE;
+        }
+    }
+  else if ((param == "vtrip") || (param == "vreconnect"))
+    {
+      double Vnew = unitConversion (val, unitType, puV, systemBasePower, baseVoltage);
+      if (param == "vreconnect")
+        {
+          Vreconnect = Vnew;
+        }
+      else
+        {
+          bool change = ((Vtrip > 0.0) != (Vnew > 0.0));
+          Vtrip = Vnew;
+          if ((change) && (opFlags[dyn_initialized]))
+            {
+              offsets.rjUnload (true);
+              alert (this, ROOT_COUNT_CHANGE);
+            }
+        }
+    }
+  else if (param == "tripfraction")
+    {
+      if ((val < 0.0) || (val > 1.0))
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      tripFraction = val;
+    }
+  else if (param == "trip")
+    {
+      trip ((val > 0.0) ? val : tripFraction);
+    }
+  else if (param == "reconnect")
+    {
+      if (val > 0.0)
+        {
+          reconnect ();
+        }
+    }
+  else if (param == "initslip")
+    {
+      init_slip = val;
+    }
+  else
+    {
+      std::string iparam = param;
+      int num = -1;
+      if (param.find ('#') != std::string::npos)
+        {
+          num = trailingStringInt (param, iparam, -1);
+        }
+      out = setMotorParameter (iparam, num, val, unitType);
+      if (out == PARAMETER_NOT_FOUND)
+        {
+          out = gridLoad::set (param, val, unitType);
+        }
+    }
+  return out;
+}
+
+int motorBankLoad::setMotorParameter (const std::string &param, int index, double val, gridUnits::units_t unitType)
+{
+  index_t start = 0;
+  index_t stop = motorCount;
+  if (index >= 0)
+    {
+      if ((index == 0) || (index > static_cast<int> (motorCount)))
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      start = static_cast<index_t> (index - 1);
+      stop = start + 1;
+    }
+  std::vector<double> *target = nullptr;
+  if (param == "r1")
+    {
+      target = &r1;
+    }
+  else if ((param == "x1") || (param == "xs"))
+    {
+      target = &xs;
+    }
+  else if (param == "xm")
+    {
+      target = &xm;
+    }
+  else if ((param == "h") || (param == "inertia"))
+    {
+      target = &Hm;
+    }
+  else if (param == "alpha")
+    {
+      target = &alpha;
+    }
+  else if (param == "beta")
+    {
+      target = &beta;
+    }
+  else if (param == "gamma")
+    {
+      target = &gamma;
+    }
+  else if (param == "vcontrol")
+    {
+      val = unitConversion (val, unitType, puV, systemBasePower, baseVoltage);
+      target = &Vcontrol;
+    }
+  else if (param == "online")
+    {
+      if ((val < 0.0) || (val > 1.0))
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      target = &connected;
+    }
+  else if ((param == "mbase") || (param == "rating"))
+    {
+      val = unitConversion (val, unitType, MW, systemBasePower, baseVoltage) / systemBasePower;
+      target = &mscale;
+    }
+  else if (param == "motorp")
+    {
+      //the mechanical load in system pu sets the rating of motors without one and the loading on the rating
+      double Pm = unitConversion (val, unitType, puMW, systemBasePower, baseVoltage);
+      for (index_t kk = start; kk < stop; ++kk)
+        {
+          if (mscale[kk] <= 0.0)
+            {
+              mscale[kk] = Pm;
+            }
+          alpha[kk] = (mscale[kk] > 0.0) ? Pm / mscale[kk] : 0.0;
+        }
+      return PARAMETER_FOUND;
+    }
+  else
+    {
+      return PARAMETER_NOT_FOUND;
+    }
+  for (index_t kk = start; kk < stop; ++kk)
+    {
+      (*target)[kk] = val;
+    }
+  return PARAMETER_FOUND;
+}
+
+double motorBankLoad::get (const std::string &param, gridUnits::units_t unitType) const
+{
+  if ((param == "motors") || (param == "motorcount") || (param == "count"))
+    {
+      return static_cast<double> (motorCount);
+    }
+  if (param == "online")
+    {
+      double conn = 0.0;
+      for (auto &cn : connected)
+        {
+          conn += cn;
+        }
+      return (motorCount > 0) ? conn / static_cast<double> (motorCount) : 0.0;
+    }
+  if (param == "stalled")
+    {
+      double stalled = 0.0;
+      for (auto &rn : running)
+        {
+          stalled += 1.0 - rn;
+        }
+      return stalled;
+    }
+  if (param == "stalls")
+    {
+      return static_cast<double> (stalls);
+    }
+  if (param == "trips")
+    {
+      return static_cast<double> (trips);
+    }
+  if (param == "motorpower")
+    {
+      double V = (bus) ? bus->getVoltage () : 1.0;
+      double Pm = (m_state.size () >= motorCount) ? motorRealPower (m_state.data (), V) : 0.0;
+      return unitConversion (Pm, puMW, unitType, systemBasePower);
+    }
+  if (param.compare (0, 5, "slip#") == 0)
+    {
+      int num = trailingStringInt (param, -1);
+      if ((num > 0) && (num <= static_cast<int> (m_state.size ())))
+        {
+          return m_state[num - 1];
+        }
+      return kNullVal;
+    }
+  return gridLoad::get (param, unitType);
+}
+
+void motorBankLoad::trip (double fraction)
+{
+  if ((fraction <= 0.0) || (motorCount == 0))
+    {
+      return;
+    }
+  double keep = 1.0 - std::min (fraction, 1.0);
+  for (auto &cn : connected)
+    {
+      cn *= keep;
+    }
+  ++trips;
+}
+
+void motorBankLoad::reconnect ()
+{
+  for (auto &cn : connected)
+    {
+      cn = 1.0;
+    }
+  opFlags.reset (uv_tripped);
+}
+
+void motorBankLoad::evaluateTerms (const double slip[], double V)
+{
+  if (terms.rp.size () != motorCount)
+    {
+      for (auto vec : { &terms.rp, &terms.qp, &terms.mech, &terms.drpds, &terms.dqpds, &terms.dmechds, &terms.drpdv, &terms.dqpdv })
+        {
+          vec->resize (motorCount);
+        }
+    }
+  const double *pr1 = r1.data ();
+  const double *pxs = xs.data ();
+  const double *pxm = xm.data ();
+  const double *pal = alpha.data ();
+  const double *pbe = beta.data ();
+  const double *pga = gamma.data ();
+  const double *pvc = Vcontrol.data ();
+  double *rp = terms.rp.data ();
+  double *qp = terms.qp.data ();
+  double *mech = terms.mech.data ();
+  double *drpds = terms.drpds.data ();
+  double *dqpds = terms.dqpds.data ();
+  double *dmechds = terms.dmechds.data ();
+  double *drpdv = terms.drpdv.data ();
+  double *dqpdv = terms.dqpdv.data ();
+  //a single pass over the bank with no branches so the compiler can vectorize it
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double s = slip[kk];
+      double Vm = V * pvc[kk];
+      double Vm2 = Vm * Vm;
+      double xs2 = pxs[kk] * pxs[kk];
+      double r2 = pr1[kk] * pr1[kk];
+      double den = r2 + s * s * xs2;
+      double iden = 1.0 / den;
+      double iden2 = iden * iden;
+      double qfac = 1.0 / pxm[kk] + pxs[kk] * s * s * iden;
+      rp[kk] = pr1[kk] * Vm2 * s * iden;
+      qp[kk] = Vm2 * qfac;
+      mech[kk] = pal[kk] + pbe[kk] * s + pga[kk] * s * s;
+      drpds[kk] = pr1[kk] * Vm2 * (r2 - s * s * xs2) * iden2;
+      dqpds[kk] = 2.0 * Vm2 * pxs[kk] * s * r2 * iden2;
+      dmechds[kk] = pbe[kk] + 2.0 * pga[kk] * s;
+      drpdv[kk] = 2.0 * pr1[kk] * Vm * s * iden * pvc[kk];
+      dqpdv[kk] = 2.0 * Vm * qfac * pvc[kk];
+    }
+}
+
+double motorBankLoad::motorRealPower (const double slip[], double V) const
+{
+  double Pm = 0.0;
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double s = slip[kk];
+      double Vm = V * Vcontrol[kk];
+      Pm += mscale[kk] * connected[kk] * r1[kk] * Vm * Vm * s / (r1[kk] * r1[kk] + s * s * xs[kk] * xs[kk]);
+    }
+  return Pm;
+}
+
+double motorBankLoad::motorReactivePower (const double slip[], double V) const
+{
+  double Qm = 0.0;
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double s = slip[kk];
+      double Vm = V * Vcontrol[kk];
+      Qm += mscale[kk] * connected[kk] * Vm * Vm * (1.0 / xm[kk] + xs[kk] * s * s / (r1[kk] * r1[kk] + s * s * xs[kk] * xs[kk]));
+    }
+  return Qm;
+}
+
+const double *motorBankLoad::getSlips (const stateData *sD, const solverMode &sMode) const
+{
+  if ((!sD) || (sMode.local))
+    {
+      return m_state.data ();
+    }
+  if (isDynamic (sMode))
+    {
+      Lp Loc = offsets.getLocations (sD, sMode, this);
+      return Loc.diffStateLoc;
+    }
+  return sD->state + offsets.getAlgOffset (sMode);
+}
+
+void motorBankLoad::setState (double ttime, const double state[], const double dstate_dt[], const solverMode &sMode)
+{
+  if (isDynamic (sMode))
+    {
+      if (hasDifferential (sMode))
+        {
+          auto offset = offsets.getDiffOffset (sMode);
+          std::copy (state + offset, state + offset + motorCount, m_state.begin ());
+          std::copy (dstate_dt + offset, dstate_dt + offset + motorCount, m_dstate_dt.begin ());
+        }
+    }
+  else
+    {
+      auto offset = offsets.getAlgOffset (sMode);
+      std::copy (state + offset, state + offset + motorCount, m_state.begin ());
+    }
+  gridLoad::setState (ttime, state, dstate_dt, sMode);
+  prevTime = ttime;
+}
+
+void motorBankLoad::guess (double /*ttime*/, double state[], double dstate_dt[], const solverMode &sMode)
+{
+  if (isDynamic (sMode))
+    {
+      if (hasDifferential (sMode))
+        {
+          auto offset = offsets.getDiffOffset (sMode);
+          std::copy (m_state.begin (), m_state.begin () + motorCount, state + offset);
+          std::copy (m_dstate_dt.begin (), m_dstate_dt.begin () + motorCount, dstate_dt + offset);
+        }
+    }
+  else
+    {
+      auto offset = offsets.getAlgOffset (sMode);
+      std::copy (m_state.begin (), m_state.begin () + motorCount, state + offset);
+    }
+}
+
+void motorBankLoad::residual (const IOdata &args, const stateData *sD, double resid[], const solverMode &sMode)
+{
+  if (motorCount == 0)
+    {
+      return;
+    }
+  if (isDynamic (sMode))
+    {
+      if (hasDifferential (sMode))
+        {
+          derivative (args, sD, resid, sMode);
+          auto offset = offsets.getDiffOffset (sMode);
+          const double *dst = sD->dstate_dt + offset;
+          for (index_t kk = 0; kk < motorCount; ++kk)
+            {
+              resid[offset + kk] -= dst[kk];
+            }
+        }
+    }
+  else
+    {
+      auto offset = offsets.getAlgOffset (sMode);
+      evaluateTerms (sD->state + offset, args[voltageInLocation]);
+      for (index_t kk = 0; kk < motorCount; ++kk)
+        {
+          resid[offset + kk] = terms.mech[kk] - terms.rp[kk];
+        }
+    }
+}
+
+void motorBankLoad::derivative (const IOdata &args, const stateData *sD, double deriv[], const solverMode &sMode)
+{
+  auto offset = offsets.getDiffOffset (sMode);
+  const double *slip = (sD) ? sD->state + offset : m_state.data ();
+  evaluateTerms (slip, args[voltageInLocation]);
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      deriv[offset + kk] = running[kk] * 0.5 / Hm[kk] * (terms.mech[kk] - terms.rp[kk]);
+    }
+}
+
+void motorBankLoad::jacobianElements (const IOdata &args, const stateData *sD, arrayData<double> *ad, const IOlocs &argLocs, const solverMode &sMode)
+{
+  if (motorCount == 0)
+    {
+      return;
+    }
+  double V = args[voltageInLocation];
+  auto vLoc = argLocs[voltageInLocation];
+  if (isDynamic (sMode))
+    {
+      if (hasDifferential (sMode))
+        {
+          auto offset = offsets.getDiffOffset (sMode);
+          evaluateTerms (sD->state + offset, V);
+          //stalled motors keep their entries with the running mask zeroing the values
+          for (index_t kk = 0; kk < motorCount; ++kk)
+            {
+              double gain = running[kk] * 0.5 / Hm[kk];
+              ad->assign (offset + kk, offset + kk, gain * (terms.dmechds[kk] - terms.drpds[kk]) - sD->cj);
+              ad->assignCheckCol (offset + kk, vLoc, -gain * terms.drpdv[kk]);
+            }
+        }
+    }
+  else
+    {
+      auto offset = offsets.getAlgOffset (sMode);
+      evaluateTerms (sD->state + offset, V);
+      for (index_t kk = 0; kk < motorCount; ++kk)
+        {
+          ad->assign (offset + kk, offset + kk, terms.dmechds[kk] - terms.drpds[kk]);
+          ad->assignCheckCol (offset + kk, vLoc, -terms.drpdv[kk]);
+        }
+    }
+}
+
+void motorBankLoad::outputPartialDerivatives (const IOdata &args, const stateData *sD, arrayData<double> *ad, const solverMode &sMode)
+{
+  gridLoad::outputPartialDerivatives (args, sD, ad, sMode);
+  if (motorCount == 0)
+    {
+      return;
+    }
+  index_t offset;
+  if (!isDynamic (sMode))
+    {
+      //the slips are algebraic states in the power flow
+      offset = offsets.getAlgOffset (sMode);
+    }
+  else if (isAlgebraicOnly (sMode))
+    {
+      return;
+    }
+  else
+    {
+      offset = offsets.getDiffOffset (sMode);
+    }
+  double V = (args.empty ()) ? bus->getVoltage (sD->state, sMode) : args[voltageInLocation];
+  evaluateTerms (sD->state + offset, V);
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double sc = mscale[kk] * connected[kk];
+      ad->assign (PoutLocation, offset + kk, sc * terms.drpds[kk]);
+      ad->assign (QoutLocation, offset + kk, sc * terms.dqpds[kk]);
+    }
+}
+
+void motorBankLoad::ioPartialDerivatives (const IOdata &args, const stateData *sD, arrayData<double> *ad, const IOlocs &argLocs, const solverMode &sMode)
+{
+  gridLoad::ioPartialDerivatives (args, sD, ad, argLocs, sMode);
+  if ((motorCount == 0) || (argLocs[voltageInLocation] == kNullLocation))
+    {
+      return;
+    }
+  const double *slip = getSlips (sD, sMode);
+  evaluateTerms (slip, args[voltageInLocation]);
+  double dPdV = 0.0;
+  double dQdV = 0.0;
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double sc = mscale[kk] * connected[kk];
+      dPdV += sc * terms.drpdv[kk];
+      dQdV += sc * terms.dqpdv[kk];
+    }
+  ad->assign (PoutLocation, argLocs[voltageInLocation], dPdV);
+  ad->assign (QoutLocation, argLocs[voltageInLocation], dQdV);
+}
+
+void motorBankLoad::getStateName (stringVec &stNames, const solverMode &sMode, const std::string &prefix) const
+{
+  index_t offset;
+  if (isDynamic (sMode))
+    {
+      if (isAlgebraicOnly (sMode))
+        {
+          return;
+        }
+      offset = offsets.getDiffOffset (sMode);
+    }
+  else
+    {
+      offset = offsets.getAlgOffset (sMode);
+    }
+  if (stNames.size () < offset + motorCount)
+    {
+      stNames.resize (offset + motorCount);
+    }
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      stNames[offset + kk] = prefix + name + ":slip#" + std::to_string (kk + 1);
+    }
+}
+
+index_t motorBankLoad::findIndex (const std::string &field, const solverMode &sMode) const
+{
+  index_t ret = kInvalidLocation;
+  if (field.compare (0, 5, "slip#") == 0)
+    {
+      int num = trailingStringInt (field, -1);
+      if ((num > 0) && (num <= static_cast<int> (motorCount)))
+        {
+          auto offset = offsets.getDiffOffset (sMode);
+          if (offset != kNullLocation)
+            {
+              ret = offset + static_cast<index_t> (num - 1);
+            }
+        }
+    }
+  return ret;
+}
+
+double motorBankLoad::timestep (double ttime, const IOdata &args, const solverMode &)
+{
+  double dt = ttime - prevTime;
+  if (motorCount > 0)
+    {
+      motorBankLoad::derivative (args, nullptr, m_dstate_dt.data (), cLocalSolverMode);
+      for (index_t kk = 0; kk < motorCount; ++kk)
+        {
+          m_state[kk] += dt * m_dstate_dt[kk];
+        }
+    }
+  prevTime = ttime;
+  return getRealPower (args[voltageInLocation]);
+}
+
+void motorBankLoad::rootTest (const IOdata &args, const stateData *sD, double roots[], const solverMode &sMode)
+{
+  auto ro = offsets.getRootOffset (sMode);
+  const double *slip = getSlips (sD, sMode);
+  double V = args[voltageInLocation];
+  //a running motor stalls at a slip of 1,  a stalled motor restarts when the electrical torque at standstill exceeds the load
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      double Vm = V * Vcontrol[kk];
+      double standstill = r1[kk] * Vm * Vm / (r1[kk] * r1[kk] + xs[kk] * xs[kk]) - (alpha[kk] + beta[kk] + gamma[kk]);
+      roots[ro + kk] = running[kk] * (1.0 - slip[kk]) + (1.0 - running[kk]) * standstill;
+    }
+  if (Vtrip > 0.0)
+    {
+      if (opFlags[uv_tripped])
+        {
+          roots[ro + motorCount] = (Vreconnect > 0.0) ? V - Vreconnect : 1.0;
+        }
+      else
+        {
+          roots[ro + motorCount] = V - Vtrip;
+        }
+    }
+}
+
+void motorBankLoad::rootTrigger (double /*ttime*/, const IOdata &args, const std::vector<int> &rootMask, const solverMode &sMode)
+{
+  auto ro = offsets.getRootOffset (sMode);
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      if (!rootMask[ro + kk])
+        {
+          continue;
+        }
+      if (running[kk] > 0.5)
+        {
+          running[kk] = 0.0;
+          m_state[kk] = 1.0;
+          ++stalls;
+        }
+      else if (args[voltageInLocation] > 0.5)
+        {
+          running[kk] = 1.0;
+          m_state[kk] = 1.0 - 1e-7;
+        }
+    }
+  if ((Vtrip > 0.0) && (rootMask[ro + motorCount]))
+    {
+      if (opFlags[uv_tripped])
+        {
+          reconnect ();
+        }
+      else
+        {
+          trip (tripFraction);
+          opFlags.set (uv_tripped);
+        }
+    }
+}
+
+change_code motorBankLoad::rootCheck (const IOdata &args, const stateData *, const solverMode &, check_level_t /*level*/)
+{
+  change_code ret = change_code::no_change;
+  double V = args[voltageInLocation];
+  for (index_t kk = 0; kk < motorCount; ++kk)
+    {
+      if (running[kk] > 0.5)
+        {
+          continue;
+        }
+      double Vm = V * Vcontrol[kk];
+      if (r1[kk] * Vm * Vm / (r1[kk] * r1[kk] + xs[kk] * xs[kk]) - (alpha[kk] + beta[kk] + gamma[kk]) > 0)
+        {
+          running[kk] = 1.0;
+          //the restart only changes values, the Jacobian structure is unchanged
+          ret = change_code::parameter_change;
+        }
+    }
+  return ret;
+}
+
+double motorBankLoad::getRealPower (const IOdata &args, const stateData *sD, const solverMode &sMode)
+{
+  double val = gridLoad::getRealPower (args, sD, sMode);
+  if ((motorCount == 0) || (!isConnected ()) || (m_state.size () < motorCount))
+    {
+      return val;
+    }
+  double V = (args.empty ()) ? (bus->getVoltage ((sD) ? (sD->state) : nullptr, sMode)) : args[voltageInLocation];
+  return val + motorRealPower (getSlips (sD, sMode), V);
+}
+
+double motorBankLoad::getReactivePower (const IOdata &args, const stateData *sD, const solverMode &sMode)
+{
+  double val = gridLoad::getReactivePower (args, sD, sMode);
+  if ((motorCount == 0) || (!isConnected ()) || (m_state.size () < motorCount))
+    {
+      return val;
+    }
+  double V = (args.empty ()) ? (bus->getVoltage ((sD) ? (sD->state) : nullptr, sMode)) : args[voltageInLocation];
+  return val + motorReactivePower (getSlips (sD, sMode), V);
+}
+
+double motorBankLoad::getRealPower (double V) const
+{
+  double val = gridLoad::getRealPower (V);
+  if ((motorCount == 0) || (!isConnected ()) || (m_state.size () < motorCount))
+    {
+      return val;
+    }
+  return val + motorRealPower (m_state.data (), V);
+}
+
+double motorBankLoad::getReactivePower (double V) const
+{
+  double val = gridLoad::getReactivePower (V);
+  if ((motorCount == 0) || (!isConnected ()) || (m_state.size () < motorCount))
+    {
+      return val;
+    }
+  return val + motorReactivePower (m_state.data (), V);
+}
+
+double motorBankLoad::getRealPower () const
+{
+  return getRealPower (bus->getVoltage ());
+}
+
+double motorBankLoad::getReactivePower () const
+{
+  return getReactivePower (bus->getVoltage ());
+}
+
+void motorBankLoad::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridLoad::getDiscreteState (dstate);
+  dstate.insert (dstate.end (), connected.begin (), connected.end ());
+  dstate.insert (dstate.end (), running.begin (), running.end ());
+  dstate.push_back ((opFlags[uv_tripped]) ? 1.0 : 0.0);
+}
+
+count_t motorBankLoad::setDiscreteState (const double dstate[])
+{
+  count_t used = gridLoad::setDiscreteState (dstate);
+  std::copy (dstate + used, dstate + used + motorCount, connected.begin ());
+  used += motorCount;
+  std::copy (dstate + used, dstate + used + motorCount, running.begin ());
+  used += motorCount;
+  opFlags.set (uv_tripped, dstate[used] > 0.5);
+  return used + 1;
+}
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef MOTOR_BANK_LOAD_H_
+#define MOTOR_BANK_LOAD_H_
+
+#include "loadModels/gridLoad.h"
+
+/** @brief a bank of first order induction motors and a static ZIP load on a single bus
+ the motors use the equations of the motorLoad model but are stored as one object,  the parameters and the slip states of
+all the motors are held in contiguous arrays and the residual,  Jacobian,  and output evaluations run as single loops over
+the bank with no per motor objects or virtual calls.  The gridLoad ZIP parameters model the static and electronic part of
+the load.  Stalling,  tripping and reconnection change masks on the motors instead of the state or Jacobian structure,  a
+stalled motor keeps its slip state with a zero derivative and a tripped fraction of a motor stops drawing power,  so the
+solvers never need to be reinitialized for a change in the motor status.
+the parameters of a single motor are set with the parameter name followed by #n with n starting at 1, without the index
+the parameter applies to every motor in the bank.
+*/
+class motorBankLoad : public gridLoad
+{
+public:
+  /** @brief motor bank flags*/
+  enum motor_bank_flags
+  {
+    uv_tripped = object_flag8,  //!< flag indicating the under voltage protection has tripped
+  };
+
+protected:
+  count_t motorCount = 0;  //!< the number of motors in the bank
+  std::vector<double> r1;  //!< the rotor resistance of each motor
+  std::vector<double> xs;  //!< the total leakage reactance of each motor
+  std::vector<double> xm;  //!< the magnetizing reactance of each motor
+  std::vector<double> Hm;  //!< the inertia of each motor
+  std::vector<double> alpha;  //!< the constant torque coefficient of each motor
+  std::vector<double> beta;  //!< the linear torque coefficient of each motor
+  std::vector<double> gamma;  //!< the quadratic torque coefficient of each motor
+  std::vector<double> mscale;  //!< the rating of each motor on the system base
+  std::vector<double> Vcontrol;  //!< the voltage ratio at the terminals of each motor
+  std::vector<double> connected;  //!< the fraction of each motor which is connected
+  std::vector<double> running;  //!< 1.0 for a running motor,  0.0 for a stalled one
+  double Vtrip = 0.0;  //!< the under voltage trip level, 0 to disable the protection
+  double Vreconnect = 0.0;  //!< the voltage at which tripped motors reconnect, 0 for no reconnection
+  double tripFraction = 1.0;  //!< the fraction of the connected motors which trip at the under voltage trip
+  double init_slip = 0.03;  //!< the initial slip guess
+  count_t stalls = 0;  //!< the number of motor stalls
+  count_t trips = 0;  //!< the number of trips
+private:
+  /** @brief scratch arrays of the per motor terms of the kernel*/
+  class bankTerms
+  {
+public:
+    std::vector<double> rp;  //!< the electrical power
+    std::vector<double> qp;  //!< the reactive power
+    std::vector<double> mech;  //!< the mechanical power
+    std::vector<double> drpds;  //!< the derivative of the electrical power with respect to the slip
+    std::vector<double> dqpds;  //!< the derivative of the reactive power with respect to the slip
+    std::vector<double> dmechds;  //!< the derivative of the mechanical power with respect to the slip
+    std::vector<double> drpdv;  //!< the derivative of the electrical power with respect to the voltage
+    std::vector<double> dqpdv;  //!< the derivative of the reactive power with respect to the voltage
+  };
+  bankTerms terms;  //!< the kernel results of the last evaluation
+public:
+  /** @brief constructor
+  @param[in] objName  the name of the object
+  */
+  motorBankLoad (const std::string &objName = "motorbank_$");
+
+  virtual gridCoreObject * clone (gridCoreObject *obj = nullptr) const override;
+protected:
+  virtual void pFlowObjectInitializeA (double time0, unsigned long flags) override;
+  virtual void dynObjectInitializeA (double time, unsigned long flags) override;
+  virtual void dynObjectInitializeB (const IOdata &args, const IOdata &outputSet) override;
+public:
+  virtual int set (const std::string &param,  const std::string &val) override;
+  virtual int set (const std::string &param, double val, gridUnits::units_t unitType = gridUnits::defUnit) override;
+  virtual double get (const std::string &param, gridUnits::units_t unitType = gridUnits::defUnit) const override;
+
+  /** @brief set the number of motors in the bank
+   new motors get the parameters of the first motor or the defaults if the bank is empty
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the bank is already initialized
+  */
+  int setMotorCount (count_t count);
+  count_t getMotorCount () const
+  {
+    return motorCount;
+  }
+  /** @brief disconnect a fraction of the connected part of every motor*/
+  void trip (double fraction);
+  /** @brief reconnect all the tripped motors*/
+  void reconnect ();
+
+  virtual void setState (double ttime, const double state[], const double dstate_dt[], const solverMode &sMode) override;
+  virtual void guess (double ttime, double state[], double dstate_dt[], const solverMode &sMode) override;
+  virtual void loadSizes (const solverMode &sMode, bool dynOnly) override;
+
+  virtual void residual (const IOdata &args, const stateData *sD, double resid[], const solverMode &sMode) override;
+  virtual void derivative (const IOdata &args, const stateData *sD, double deriv[], const solverMode &sMode) override;
+
+  virtual void outputPartialDerivatives (const IOdata &args, const stateData *sD, arrayData<double> *ad, const solverMode &sMode) override;
+  virtual void ioPartialDerivatives (const IOdata &args, const stateData *sD, arrayData<double> *ad, const IOlocs &argLocs, const solverMode &sMode) override;
+  virtual void jacobianElements  (const IOdata &args, const stateData *sD, arrayData<double> *ad, const IOlocs &argLocs, const solverMode &sMode) override;
+  virtual void getStateName (stringVec &stNames, const solverMode &sMode, const std::string &prefix) const override;
+
+  virtual void rootTest (const IOdata &args, const stateData *sD, double roots[], const solverMode &sMode) override;
+  virtual void rootTrigger (double ttime, const IOdata &args, const std::vector<int> &rootMask, const solverMode &sMode) override;
+  virtual change_code rootCheck (const IOdata &args, const stateData *sD, const solverMode &sMode, check_level_t level) override;
+
+  virtual index_t findIndex (const std::string &field, const solverMode &sMode) const override;
+  virtual double timestep (double ttime, const IOdata &args, const solverMode &sMode) override;
+
+  virtual double getRealPower (const IOdata &args, const stateData *sD, const solverMode &sMode) override;
+  virtual double getReactivePower (const IOdata &args, const stateData *sD, const solverMode &sMode) override;
+  virtual double getRealPower (double V) const override;
+  virtual double getReactivePower (double V) const override;
+  virtual double getRealPower () const override;
+  virtual double getReactivePower () const override;
+
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
+private:
+  /** @brief set a motor parameter
+  @param[in] param the parameter name without the motor index
+  @param[in] index the motor index or -1 for all motors
+  @return PARAMETER_FOUND, PARAMETER_NOT_FOUND, or INVALID_PARAMETER_VALUE for an index outside the bank
+  */
+  int setMotorParameter (const std::string &param, int index, double val, gridUnits::units_t unitType);
+  /** @brief get the slip states of the bank for a state and mode,  nullptr if the mode has no slip states*/
+  const double *getSlips (const stateData *sD, const solverMode &sMode) const;
+  /** @brief evaluate the power terms and their partial derivatives of every motor
+  @param[in] slip the slip of each motor
+  @param[in] V the bus voltage
+  */
+  void evaluateTerms (const double slip[], double V);
+  /** @brief the total real power of the connected motors for a set of slips*/
+  double motorRealPower (const double slip[], double V) const;
+  /** @brief the total reactive power of the connected motors for a set of slips*/
+  double motorReactivePower (const double slip[], double V) const;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "vectorOps.hpp"
 #include "submodels/gridControlBlocks.h"
 #include "simulation/contingency.h"
+#include "simulation/networkAdmittance.h"
 //#include "arrayDataSparse.h"
 #include "stringOps.h"
 
@@ -115,6 +116,20 @@ bool acBus::checkCapable ()
   return ((tP < 0) ? false : true);
 }
 
+bool acBus::hasLocalInitialization () const
+{
+  //the proxies and the slaved or direct connected buses adjust objects of other buses
+  if ((!busController.proxyVControlObject.empty ()) || (!busController.proxyPControlObject.empty ()) || (!busController.slaveBusses.empty ()))
+    {
+      return false;
+    }
+  if ((busController.masterBus) || (busController.directBus))
+    {
+      return false;
+    }
+  return gridBus::hasLocalInitialization ();
+}
+
 void acBus::disable ()
 {
   enabled = false;
@@ -1372,6 +1387,38 @@ int acBus::set (const std::string &param, const std::string &vali)
           out = INVALID_PARAMETER_VALUE;
         }
     }
+  else if (param == "qlimit")
+    {
+      //force a PV bus to or from its reactive limit as the power flow adjustments would
+      if (prevType != busType::PV)
+        {
+          return out;
+        }
+      if ((val == "max") || (val == "min"))
+        {
+          for (auto &vco : busController.vControlObjects)
+            {
+              vco->set ("q", val);
+            }
+          if (type != busType::PQ)
+            {
+              type = busType::PQ;
+              alert (this, JAC_COUNT_CHANGE);
+            }
+        }
+      else if (val == "none")
+        {
+          if (type != busType::PV)
+            {
+              type = busType::PV;
+              alert (this, JAC_COUNT_CHANGE);
+            }
+        }
+      else
+        {
+          out = INVALID_PARAMETER_VALUE;
+        }
+    }
   else if (param == "status")
     {
       if ((val == "out") || (val == "off") || (val == "disconnected"))
@@ -2295,8 +2342,17 @@ void acBus::jacobianElements (const stateData *sD, arrayData<double> *ad, const
       od.assign (QoutLocation, offset + 1, 1);
     }
   int gid = getID ();
+  bool assembled = useNetworkModel (sD, sMode);
+  if (assembled)
+    {
+      admittanceModel->outputPartialDerivatives (admittanceIndex, &od, sMode);
+    }
   for (auto &link : attachedLinks)
     {
+      if ((assembled) && (link->checkFlag (gridLink::network_assembled)))
+        {
+          continue;
+        }
       link->outputPartialDerivatives (gid, sD, &od, sMode);
     }
 
@@ -3273,9 +3329,17 @@ void acBus::computeDerivatives (const stateData *sD, const solverMode &sMode)
       return;
     }
   partDeriv.clear ();
-
+  bool assembled = useNetworkModel (sD, sMode);
+  if (assembled)
+    {
+      admittanceModel->ioPartialDerivatives (admittanceIndex, &partDeriv);
+    }
   for (auto &link : attachedLinks)
     {
+      if ((assembled) && (link->checkFlag (gridLink::network_assembled)))
+        {
+          continue;
+        }
       if (link->enabled)
         {
           link->updateLocalCache (sD, sMode);
@@ -3424,6 +3488,14 @@ double acBus::get (const std::string &param, units_t unitType) const
     {
       val = Tw;
     }
+  else if (param == "qlimit")
+    {
+      val = 0.0;
+      if ((prevType == busType::PV) && (type == busType::PQ))
+        {
+          val = (std::abs (S.genQ - busController.Qmax) < std::abs (S.genQ - busController.Qmin)) ? 1.0 : -1.0;
+        }
+    }
   else
     {
       return gridBus::get (param,unitType);
@@ -128,6 +128,7 @@ protected:
   virtual void dynObjectInitializeA (gridDyn_time time0, unsigned long flags) override;
   virtual void dynObjectInitializeB (IOdata &outputSet) override;
 public:
+  virtual bool hasLocalInitialization () const override;
   virtual void disable () override;
   /** @brief  reconnect the bus
   @param[in] mapBus  a bus to pick of startup parameters from*/
@@ -23,8 +23,13 @@
 #include "gridCoreList.h"
 #include "objectInterpreter.h"
 
+#include <algorithm>
 #include <cmath>
 
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace gridUnits;
 
 count_t gridArea::areaCount = 0;
@@ -159,6 +164,7 @@ int addObject (gridArea *area, X* obj, std::vector<X *> &objVector)
       obj->set ("basefreq", area->m_baseFreq);
       area->primaryObjects.push_back (obj);
       obj->locIndex2 = static_cast<index_t> (area->primaryObjects.size ()) - 1;
+      area->structureChanged ();
       if (area->checkFlag (pFlow_initialized))
         {
           area->alert (area, OBJECT_COUNT_INCREASE);
@@ -225,6 +231,7 @@ int removeObject (gridArea *area, X* obj, std::vector<X *> &objVector)
     }
 
   objVector[obj->locIndex]->setParent (nullptr);
+  area->structureChanged ();
   if (area->opFlags[being_deleted])
     {
       objVector[obj->locIndex] = nullptr;
@@ -279,6 +286,10 @@ int gridArea::remove (gridRelay *relay)
 
 void gridArea::alert (gridCoreObject *obj, int code)
 {
+  if (deferAlert (obj, code))
+    {
+      return;
+    }
   switch (code)
     {
     case OBJECT_NAME_CHANGE:
@@ -816,6 +827,7 @@ void gridArea::dynObjectInitializeB (IOdata &outputSet)
         }
     }
   double pmx = 0;
+  std::vector<gridBus *> batch;
   for (auto &bus : m_Buses)
     {
       if (bus->enabled)
@@ -826,7 +838,17 @@ void gridArea::dynObjectInitializeB (IOdata &outputSet)
             }
           else
             {
-              bus->dynInitializeB (outputSet);
+              //consecutive buses with local initializations are run together,  a bus reaching into other buses
+              //waits for the buses before it so the order of any interaction is the same as the sequential order
+              if ((opFlags[parallel_initialization]) && (bus->hasLocalInitialization ()))
+                {
+                  batch.push_back (bus);
+                }
+              else
+                {
+                  initializeBusBatch (batch, outputSet);
+                  bus->dynInitializeB (outputSet);
+                }
               double bmx = bus->getMaxGenReal ();
               if (bmx > pmx)
                 {
@@ -836,6 +858,7 @@ void gridArea::dynObjectInitializeB (IOdata &outputSet)
             }
         }
     }
+  initializeBusBatch (batch, outputSet);
   for (auto &rel : m_Relays)
     {
       if (rel->enabled)
@@ -858,6 +881,58 @@ void gridArea::dynObjectInitializeB (IOdata &outputSet)
   opObjectLists.makePreList (primaryObjects);
 }
 
+void gridArea::initializeBusBatch (std::vector<gridBus *> &batch, IOdata &outputSet)
+{
+  if (batch.empty ())
+    {
+      return;
+    }
+  if (batch.size () == 1)
+    {
+      batch[0]->dynInitializeB (outputSet);
+      batch.clear ();
+      return;
+    }
+  deferredAlerts.clear ();
+  opFlags.set (deferring_alerts);
+  int cnt = static_cast<int> (batch.size ());
+#pragma omp parallel for schedule(dynamic)
+  for (int kk = 0; kk < cnt; ++kk)
+    {
+      batch[kk]->dynInitializeB (outputSet);
+    }
+  opFlags.reset (deferring_alerts);
+  //forward the alerts grouped by bus in the order of the buses,  the alerts of each bus are already in order
+  auto busOrder = [this](gridCoreObject *obj) {
+      while ((obj) && (obj->getParent () != this))
+        {
+          obj = obj->getParent ();
+        }
+      return (obj) ? obj->locIndex : kNullLocation;
+    };
+  std::stable_sort (deferredAlerts.begin (), deferredAlerts.end (), [&busOrder](const std::pair<gridCoreObject *, int> &a1, const std::pair<gridCoreObject *, int> &a2) {
+      return (busOrder (a1.first) < busOrder (a2.first));
+    });
+  auto held = std::move (deferredAlerts);
+  deferredAlerts.clear ();
+  for (auto &al : held)
+    {
+      alert (al.first, al.second);
+    }
+  batch.clear ();
+}
+
+bool gridArea::deferAlert (gridCoreObject *obj, int code)
+{
+  if (!opFlags[deferring_alerts])
+    {
+      return false;
+    }
+#pragma omp critical (gridAreaAlert)
+  deferredAlerts.emplace_back (obj, code);
+  return true;
+}
+
 //TODO:: PT make this do something or remove it
 void gridArea::updateTheta (double /*time*/)
 {
@@ -904,6 +979,10 @@ int gridArea::setFlag (const std::string &flag, bool val)
     {
       opFlags.set (direction_oscillate, val);
     }
+  else if ((flag == "parallel_initialization") || (flag == "parallelinitialization"))
+    {
+      opFlags.set (parallel_initialization, val);
+    }
   else
     {
       return gridPrimary::setFlag (flag, val);
@@ -1578,6 +1657,63 @@ void gridArea::guess (double ttime, double state[], double dstate_dt[], const so
 
 }
 
+void gridArea::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridPrimary::getDiscreteState (dstate);
+  for (auto &obj : primaryObjects)
+    {
+      obj->getDiscreteState (dstate);
+    }
+}
+
+count_t gridArea::setDiscreteState (const double dstate[])
+{
+  count_t used = gridPrimary::setDiscreteState (dstate);
+  for (auto &obj : primaryObjects)
+    {
+      used += obj->setDiscreteState (dstate + used);
+    }
+  return used;
+}
+
+void gridArea::getDiscreteStateBlocks (std::vector<double> &dstate, std::vector<count_t> &blockSizes) const
+{
+  blockSizes.clear ();
+  auto start = dstate.size ();
+  gridPrimary::getDiscreteState (dstate);
+  blockSizes.push_back (static_cast<count_t> (dstate.size () - start));
+  for (auto &obj : primaryObjects)
+    {
+      start = dstate.size ();
+      obj->getDiscreteState (dstate);
+      blockSizes.push_back (static_cast<count_t> (dstate.size () - start));
+    }
+}
+
+int gridArea::setDiscreteStateBlocks (const double dstate[], const std::vector<count_t> &blockSizes)
+{
+  if (blockSizes.size () != primaryObjects.size () + 1)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  int ret = FUNCTION_EXECUTION_SUCCESS;
+  index_t offset = 0;
+  if (gridPrimary::setDiscreteState (dstate) != blockSizes[0])
+    {
+      ret = FUNCTION_EXECUTION_FAILURE;
+    }
+  offset += blockSizes[0];
+  for (size_t kk = 0; kk < primaryObjects.size (); ++kk)
+    {
+      if (primaryObjects[kk]->setDiscreteState (dstate + offset) != blockSizes[kk + 1])
+        {
+          ret = FUNCTION_EXECUTION_FAILURE;
+        }
+      offset += blockSizes[kk + 1];
+    }
+  return ret;
+}
+
 void gridArea::getVariableType (double sdata[], const solverMode &sMode)
 {
 
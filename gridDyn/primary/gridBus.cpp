@@ -23,11 +23,13 @@
 #include "acBus.h"
 #include "dcBus.h"
 #include "objectFactoryTemplates.h"
+#include "simulation/networkAdmittance.h"
 #include "vectorOps.hpp"
 
 #include "stringOps.h"
 
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <cassert>
@@ -197,6 +199,7 @@ int addObject (gridBus *bus, X* obj, std::vector<X *> &objVector)
       obj->locIndex = static_cast<index_t> (objVector.size ());
       objVector.push_back (obj);
       obj->setParent (bus);
+      bus->structureChanged ();
       obj->set ("basepower", bus->systemBasePower);
       obj->set ("basefreq", bus->m_baseFreq);
       obj->set ("basevoltage", bus->baseVoltage);
@@ -283,6 +286,12 @@ int removeObject (X* obj, std::vector<X *> &objVector)
           obj->getParent ()->alert (obj->getParent (), STATE_COUNT_DECREASE);
         }
 
+      //the change is recorded while the object is still attached to the tree
+      auto bus = dynamic_cast<gridPrimary *> (obj->getParent ());
+      if (bus)
+        {
+          bus->structureChanged ();
+        }
       objVector[obj->locIndex]->setParent (nullptr);
       objVector.erase (objVector.begin () + obj->locIndex);
       out = OBJECT_REMOVE_SUCCESS;
@@ -544,6 +553,19 @@ void gridBus::dynObjectInitializeB (IOdata &outputSet)
 
 }
 
+bool gridBus::hasLocalInitialization () const
+{
+  //objects controlling a remote bus read and adjust the remote bus during the initialization
+  auto remote = [](const gridObject *obj) {
+      return ((obj->checkFlag (remote_voltage_control)) || (obj->checkFlag (remote_power_control)));
+    };
+  if (std::any_of (attachedGens.begin (), attachedGens.end (), remote))
+    {
+      return false;
+    }
+  return std::none_of (attachedLoads.begin (), attachedLoads.end (), remote);
+}
+
 void gridBus::powerAdjust (double /*adjustment*/)
 {
 
@@ -1220,6 +1242,33 @@ void gridBus::guess (double ttime, double state[], double dstate_dt[], const sol
 
 }
 
+void gridBus::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridPrimary::getDiscreteState (dstate);
+  for (auto &gen : attachedGens)
+    {
+      gen->getDiscreteState (dstate);
+    }
+  for (auto &load : attachedLoads)
+    {
+      load->getDiscreteState (dstate);
+    }
+}
+
+count_t gridBus::setDiscreteState (const double dstate[])
+{
+  count_t used = gridPrimary::setDiscreteState (dstate);
+  for (auto &gen : attachedGens)
+    {
+      used += gen->setDiscreteState (dstate + used);
+    }
+  for (auto &load : attachedLoads)
+    {
+      used += load->setDiscreteState (dstate + used);
+    }
+  return used;
+}
+
 // set algebraic and dynamic variables assume preset to differential
 void gridBus::getVariableType (double sdata[], const solverMode &sMode)
 {
@@ -1689,6 +1738,16 @@ static const IOlocs inLoc {
   0,1,2
 };
 
+void gridBus::setNetworkModel (networkAdmittance *net, index_t index)
+{
+  admittanceModel = net;
+  admittanceIndex = (net) ? index : kNullLocation;
+}
+
+bool gridBus::useNetworkModel (const stateData *sD, const solverMode &sMode) const
+{
+  return ((admittanceModel) && (admittanceModel->isCurrent (sD, sMode)));
+}
 
 //#define DEBUG_KEY_BUS 1445
 // computed power at bus
@@ -1713,8 +1772,18 @@ void gridBus::updateLocalCache  (const stateData *sD, const solverMode &sMode)
   }
 #endif
   auto cid = getID ();
+  bool assembled = useNetworkModel (sD, sMode);
+  if (assembled)
+    {
+      S.linkP = admittanceModel->getRealPower (admittanceIndex);
+      S.linkQ = admittanceModel->getReactivePower (admittanceIndex);
+    }
   for (auto &link : attachedLinks)
     {
+      if ((assembled) && (link->checkFlag (gridLink::network_assembled)))
+        {
+          continue;
+        }
       if (link->enabled)
         {
           link->updateLocalCache (sD, sMode);
@@ -185,6 +185,11 @@ listMaintainer::listMaintainer(): objectLists(4),partialLists(4),sModeLists(4)
 		return (sModeLists[sMode.offsetIndex].offsetIndex!=kNullLocation);
 	}
 
+	bool listMaintainer::hasPreExObjects() const
+	{
+		return !preExObjs.empty();
+	}
+
 	void listMaintainer::invalidate(const solverMode &sMode)
 	{
 		if (sMode.offsetIndex < objectLists.size())
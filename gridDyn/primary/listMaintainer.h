@@ -50,6 +50,8 @@ public:
   void delayedAlgebraicUpdate (const stateData *sD, double update[], const solverMode &sMode, double alpha);
 
   bool isListValid (const solverMode &sMode) const;
+  /** @brief check if any objects require preexecution*/
+  bool hasPreExObjects () const;
   void invalidate (const solverMode &sMode);
   void invalidate ();
 
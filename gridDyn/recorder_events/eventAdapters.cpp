@@ -42,6 +42,21 @@ void eventAdapter::updateTime ()
 {
 }
 
+void eventAdapter::getState (std::vector<double> &estate) const
+{
+  estate.push_back (m_nextTime);
+  estate.push_back ((partB_turn) ? 1.0 : 0.0);
+  estate.push_back ((m_remove_event) ? 1.0 : 0.0);
+}
+
+count_t eventAdapter::setState (const double estate[])
+{
+  m_nextTime = estate[0];
+  partB_turn = (estate[1] > 0.5);
+  m_remove_event = (estate[2] > 0.5);
+  return 3;
+}
+
 change_code eventAdapter::execute (double cTime)
 {
   if (m_period > 0)
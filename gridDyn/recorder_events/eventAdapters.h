@@ -23,6 +23,7 @@
 #include <memory>
 #include <cstdint>
 #include <algorithm>
+#include <vector>
 
 /** @brief class for managing events of many types
  class is a wrapper around a number of different kinds of discrete events
@@ -63,6 +64,15 @@ public:
   /** @brief update the next event time*/
   virtual void updateTime ();
 
+  /** @brief get the execution state of the adapter and the event it wraps
+  @param[out] estate the vector to append the values to
+  */
+  virtual void getState (std::vector<double> &estate) const;
+  /** @brief restore the execution state of the adapter and the event it wraps
+  @param[in] estate the values written by getState
+  @return the number of values used
+  */
+  virtual count_t setState (const double estate[]);
 };
 
 bool compareEventAdapters (const std::shared_ptr<eventAdapter> e1, const std::shared_ptr<eventAdapter> e2);
@@ -112,6 +122,16 @@ public:
   {
     m_nextTime = m_eventObj->nextTriggerTime ();
   }
+  void getState (std::vector<double> &estate) const override
+  {
+    eventAdapter::getState (estate);
+    m_eventObj->getEventState (estate);
+  }
+  count_t setState (const double estate[]) override
+  {
+    count_t used = eventAdapter::setState (estate);
+    return used + m_eventObj->setEventState (estate + used);
+  }
 };
 
 
@@ -159,6 +179,16 @@ public:
   {
     m_nextTime = m_eventObj->nextTriggerTime ();
   }
+  void getState (std::vector<double> &estate) const override
+  {
+    eventAdapter::getState (estate);
+    m_eventObj->getEventState (estate);
+  }
+  count_t setState (const double estate[]) override
+  {
+    count_t used = eventAdapter::setState (estate);
+    return used + m_eventObj->setEventState (estate + used);
+  }
 };
 
 class gridCoreObject;
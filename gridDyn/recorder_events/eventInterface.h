@@ -16,6 +16,8 @@
 
 #include "gridDynTypes.h"
 
+#include <vector>
+
 enum class event_execution_mode
 {
   normal = 0,
@@ -38,6 +40,20 @@ public:
   {
     return true;
   }
+  /** @brief get the state of the event which changes as it executes
+  @param[out] estate the vector to append the values to
+  */
+  virtual void getEventState (std::vector<double> & /*estate*/) const
+  {
+  }
+  /** @brief restore the state of the event
+  @param[in] estate the values written by getEventState
+  @return the number of values used
+  */
+  virtual count_t setEventState (const double /*estate*/[])
+  {
+    return 0;
+  }
 
 };
 
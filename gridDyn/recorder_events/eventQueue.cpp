@@ -198,6 +198,18 @@ void eventQueue::sort ()
   events.sort (compareEventAdapters);
 }
 
+void eventQueue::getEvents (std::vector<std::shared_ptr<eventAdapter> > &evList) const
+{
+  evList.assign (events.begin (), events.end ());
+}
+
+void eventQueue::setEvents (const std::vector<std::shared_ptr<eventAdapter> > &evList)
+{
+  events.assign (evList.begin (), evList.end ());
+  partB_list.clear ();
+  events.sort (compareEventAdapters);
+}
+
 void eventQueue::checkDuplicates ()
 { //checking for duplicated gridCoreObject updates which could potentially be bad
 
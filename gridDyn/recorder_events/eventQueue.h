@@ -17,6 +17,7 @@
 #include "eventAdapters.h"
 
 #include <list>
+#include <vector>
 #include <cstdint>
 
 
@@ -114,6 +115,17 @@ public:
   /** @brief sort the event Queue by time */
   virtual void sort ();
 
+  /** @brief get the events currently in the queue
+  @param[out] evList the vector to store the events in
+  */
+  void getEvents (std::vector<std::shared_ptr<eventAdapter> > &evList) const;
+
+  /** @brief replace the events in the queue
+   any events awaiting part B execution are dropped
+  @param[in] evList the events to place in the queue
+  */
+  void setEvents (const std::vector<std::shared_ptr<eventAdapter> > &evList);
+
   /** @brief remove an event
   @param[in] eventID the id of the event to remove
   @return OBJECT_REMOVE_SUCCESS if the event is successfully removed
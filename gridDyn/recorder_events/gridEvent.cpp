@@ -93,6 +93,23 @@ void gridEvent::setTimeValue (const std::vector<double> &time, const std::vector
 
 }
 
+void gridEvent::getEventState (std::vector<double> &estate) const
+{
+  estate.push_back (triggerTime);
+  estate.push_back (value);
+  estate.push_back ((currIndex == kNullLocation) ? -1.0 : static_cast<double> (currIndex));
+  estate.push_back ((armed) ? 1.0 : 0.0);
+}
+
+count_t gridEvent::setEventState (const double estate[])
+{
+  triggerTime = estate[0];
+  value = estate[1];
+  currIndex = (estate[2] < 0) ? kNullLocation : static_cast<index_t> (estate[2]);
+  armed = (estate[3] > 0.5);
+  return 4;
+}
+
 void gridEvent::updateTrigger (double time)
 {
   if (currIndex != kNullLocation)             //we have a file operation
@@ -81,6 +81,8 @@ public:
   {
     return event_execution_mode::normal;
   }
+  virtual void getEventState (std::vector<double> &estate) const override;
+  virtual count_t setEventState (const double estate[]) override;
   virtual void setTime (double time);
   virtual void setTimeValue (double time, double val);
   void setTimeValue (const std::vector<double> &time, const std::vector<double> &val);
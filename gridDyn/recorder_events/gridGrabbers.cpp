@@ -20,6 +20,8 @@
 #include "gridArea.h"
 #include "gridBus.h"
 #include "simulation/gridSimulation.h"
+#include "gridDyn.h"
+#include "simulation/trajectorySensitivity.h"
 #include "vectorOps.hpp"
 #include "grabberInterpreter.hpp"
 #include "functionInterpreter.h"
@@ -468,6 +470,40 @@ int gridAreaGrabber::setInfo (std::string fld, gridCoreObject *gdO)
         };
       inputUnits = puMW;
     }
+  else if ((field == "voltagesensitivity") || (field == "anglesensitivity"))
+    {
+      bool voltage = (field == "voltagesensitivity");
+      //the sensitivity parameters may be set after the recorder so the engine is located when the data is grabbed
+      fptrV = [ = ](std::vector<double> &v){
+          auto gds = dynamic_cast<gridDynSimulation *> (area);
+          auto sens = (gds) ? gds->getSensitivity () : nullptr;
+          if (sens == nullptr)
+            {
+              v.clear ();
+            }
+          else if (voltage)
+            {
+              sens->getVoltageSensitivity (v);
+            }
+          else
+            {
+              sens->getAngleSensitivity (v);
+            }
+        };
+      fptrN = [ = ](stringVec &N){
+          auto gds = dynamic_cast<gridDynSimulation *> (area);
+          auto sens = (gds) ? gds->getSensitivity () : nullptr;
+          if (sens == nullptr)
+            {
+              N.clear ();
+            }
+          else
+            {
+              sens->getBusSensitivityNames (N, (voltage) ? "dV" : "dA");
+            }
+        };
+      vectorGrab = true;
+    }
   else
     {
       ret = gridGrabber::setInfo (field, gdO);
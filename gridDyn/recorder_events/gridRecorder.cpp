@@ -133,6 +133,10 @@ int gridRecorder::set (const std::string &param, double val)
     {
       autosave = static_cast<count_t> (val);
     }
+  else if (param == "suspend")
+    {
+      suspended = (val > 0);
+    }
   else if (param == "period_resolution")
     {
       if (val > 0)
@@ -283,6 +287,26 @@ void gridRecorder::setTime (double time)
     }
 }
 
+void gridRecorder::getEventState (std::vector<double> &estate) const
+{
+  estate.push_back (static_cast<double> (dataset.count));
+  estate.push_back (triggerTime);
+  estate.push_back ((armed) ? 1.0 : 0.0);
+}
+
+count_t gridRecorder::setEventState (const double estate[])
+{
+  auto cnt = static_cast<fsize_t> (estate[0]);
+  //an autosave may have cleared the data since the state was taken so only ever drop points
+  if (cnt < dataset.count)
+    {
+      dataset.resize (cnt);
+    }
+  triggerTime = estate[1];
+  armed = (estate[2] > 0.5);
+  return 3;
+}
+
 void gridRecorder::recheckColumns ()
 {
   fsize_t ct = 0;
@@ -339,7 +363,7 @@ change_code gridRecorder::trigger (double time)
     }
   if (time >= triggerTime)
     {
-      for (kk = 0; kk < dataGrabbers.size (); ++kk)
+      for (kk = 0; (kk < dataGrabbers.size ())&&(!suspended); ++kk)
         {
           if (dataGrabbers[kk]->vectorGrab)
             {
@@ -58,6 +58,7 @@ protected:
   bool binaryFile = true;
   bool armed = true;
   bool delayProcess = true;          //!< wait to process recorders until other events have executed
+  bool suspended = false;            //!< skip the data capture while keeping the trigger schedule
   int precision = -1;                //!< precision for writing text files.
   count_t autosave = 0;
 public:
@@ -88,6 +89,11 @@ public:
   {
     return armed;
   }
+  /** @brief get the number of stored points and the trigger schedule
+   stored points beyond the count are dropped if the state is restored
+  */
+  void getEventState (std::vector<double> &estate) const override;
+  count_t setEventState (const double estate[]) override;
 
   int set (const std::string &param, double val);
   int set (const std::string &param, const std::string &val);
@@ -254,6 +254,34 @@ void breaker::conditionTriggered (index_t conditionNum, double triggeredTime)
     }
 }
 
+void breaker::getDiscreteState (std::vector<double> &dstate) const
+{
+  gridRelay::getDiscreteState (dstate);
+  dstate.push_back ((opFlags[breaker_tripped_flag]) ? 1.0 : 0.0);
+  dstate.push_back ((opFlags[overlimit_flag]) ? 1.0 : 0.0);
+  dstate.push_back ((useCTI) ? 1.0 : 0.0);
+  dstate.push_back (static_cast<double> (recloseAttempts));
+  dstate.push_back (lastRecloseTime);
+  dstate.push_back (cTI);
+}
+
+count_t breaker::setDiscreteState (const double dstate[])
+{
+  count_t used = gridRelay::setDiscreteState (dstate);
+  opFlags.set (breaker_tripped_flag, (dstate[used] > 0.5));
+  opFlags.set (overlimit_flag, (dstate[used + 1] > 0.5));
+  bool cti = (dstate[used + 2] > 0.5);
+  if (cti != useCTI)
+    {
+      useCTI = cti;
+      alert (this, (useCTI) ? JAC_COUNT_INCREASE : JAC_COUNT_DECREASE);
+    }
+  recloseAttempts = static_cast<count_t> (dstate[used + 3]);
+  lastRecloseTime = dstate[used + 4];
+  cTI = dstate[used + 5];
+  return used + 6;
+}
+
 void breaker::updateA (double time)
 {
   if (opFlags[breaker_tripped_flag])
@@ -54,6 +54,8 @@ public:
 
   virtual void dynObjectInitializeA (double time0, unsigned long flags) override;
   virtual void updateA (double time) override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
 
   //dynamic state functions
   virtual double timestep (double ttime, const solverMode &sMode) override;
@@ -205,6 +205,56 @@ void gridRelay::setConditionState (index_t conditionNumber, condition_states new
   updateRootCount (true);
 }
 
+void gridRelay::getDiscreteState (std::vector<double> &dstate) const
+{
+  dstate.push_back (triggerTime);
+  dstate.push_back (m_nextSampleTime);
+  for (size_t kk = 0; kk < cStates.size (); ++kk)
+    {
+      dstate.push_back (static_cast<double> (static_cast<int> (cStates[kk])));
+      dstate.push_back (conditionTriggerTimes[kk]);
+    }
+  dstate.push_back (static_cast<double> (condChecks.size ()));
+  for (auto &cond : condChecks)
+    {
+      dstate.push_back (static_cast<double> (cond.conditionNum));
+      dstate.push_back (static_cast<double> (cond.actionNum));
+      dstate.push_back (cond.testTime);
+      dstate.push_back ((cond.multiCondition) ? 1.0 : 0.0);
+    }
+  //the base values go last so the update time is restored after the condition changes
+  gridPrimary::getDiscreteState (dstate);
+}
+
+count_t gridRelay::setDiscreteState (const double dstate[])
+{
+  triggerTime = dstate[0];
+  m_nextSampleTime = dstate[1];
+  count_t used = 2;
+  for (index_t kk = 0; kk < cStates.size (); ++kk)
+    {
+      auto state = static_cast<condition_states> (static_cast<int> (dstate[used]));
+      if (state != cStates[kk])
+        {
+          setConditionState (kk, state);
+        }
+      conditionTriggerTimes[kk] = dstate[used + 1];
+      used += 2;
+    }
+  auto checkCount = static_cast<count_t> (dstate[used++]);
+  condChecks.resize (checkCount);
+  for (auto &cond : condChecks)
+    {
+      cond.conditionNum = static_cast<index_t> (dstate[used]);
+      cond.actionNum = static_cast<index_t> (dstate[used + 1]);
+      cond.testTime = dstate[used + 2];
+      cond.multiCondition = (dstate[used + 3] > 0.5);
+      used += 4;
+    }
+  used += gridPrimary::setDiscreteState (dstate + used);
+  return used;
+}
+
 double gridRelay::getConditionValue (index_t conditionNumber) const
 {
   if (conditionNumber >= conditions.size ())
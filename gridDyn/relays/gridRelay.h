@@ -148,6 +148,8 @@ public:
   virtual void rootTest (const stateData *sD, double roots[], const solverMode &sMode)  override;
   virtual void rootTrigger (double ttime, const std::vector<int> &rootMask, const solverMode &sMode)  override;
   virtual change_code rootCheck (const stateData *sD, const solverMode &sMode,  check_level_t level)  override;
+  virtual void getDiscreteState (std::vector<double> &dstate) const override;
+  virtual count_t setDiscreteState (const double dstate[]) override;
   /** message processing function for use with communicators
   @param[in] sourceID  the source of the comm message
   @param[in] message the actual message to process
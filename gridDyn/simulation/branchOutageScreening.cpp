@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "branchOutageScreening.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/gridLink.h"
+#include "arrayDataSparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+static void collectLinks (const gridArea *area, std::vector<gridLink *> &linkList)
+{
+  index_t kk = 0;
+  gridLink *lnk;
+  while ((lnk = area->getLink (kk)) != nullptr)
+    {
+      linkList.push_back (lnk);
+      ++kk;
+    }
+  kk = 0;
+  gridArea *subArea;
+  while ((subArea = area->getArea (kk)) != nullptr)
+    {
+      collectLinks (subArea, linkList);
+      ++kk;
+    }
+}
+
+static bool inService (const gridLink *lnk)
+{
+  return ((lnk->enabled) && (lnk->isConnected ()) && (lnk->getBus (1) != nullptr) && (lnk->getBus (2) != nullptr) && (lnk->getBus (1) != lnk->getBus (2)));
+}
+
+static double maxNorm (const std::vector<double> &vec)
+{
+  double nrm = 0.0;
+  for (auto &v : vec)
+    {
+      nrm = (std::max)(nrm, std::abs (v));
+    }
+  return nrm;
+}
+
+branchOutageScreening::branchOutageScreening (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+std::vector<bool> branchOutageScreening::findBridges (const std::vector<gridLink *> &linkList) const
+{
+  std::vector<bool> bridge (linkList.size (), false);
+  std::map<gridBus *, index_t> busIndex;
+  for (auto &lnk : linkList)
+    {
+      for (index_t side = 1; side <= 2; ++side)
+        {
+          auto bus = lnk->getBus (side);
+          if (busIndex.find (bus) == busIndex.end ())
+            {
+              index_t ind = static_cast<index_t> (busIndex.size ());
+              busIndex[bus] = ind;
+            }
+        }
+    }
+  count_t nodes = static_cast<count_t> (busIndex.size ());
+  //adjacency lists hold the neighbor and the link index so parallel links are not mistaken for the tree edge
+  std::vector<std::vector<std::pair<index_t, index_t> > > adj (nodes);
+  for (index_t kk = 0; kk < linkList.size (); ++kk)
+    {
+      auto b1 = busIndex[linkList[kk]->getBus (1)];
+      auto b2 = busIndex[linkList[kk]->getBus (2)];
+      adj[b1].emplace_back (b2, kk);
+      adj[b2].emplace_back (b1, kk);
+    }
+  //iterative depth first search computing the discovery order and low link of each bus
+  std::vector<index_t> disc (nodes, kNullLocation);
+  std::vector<index_t> low (nodes, 0);
+  struct searchFrame
+  {
+    index_t node;
+    index_t parentEdge;
+    index_t pos;
+  };
+  std::vector<searchFrame> stack;
+  index_t order = 0;
+  for (index_t root = 0; root < nodes; ++root)
+    {
+      if (disc[root] != kNullLocation)
+        {
+          continue;
+        }
+      disc[root] = low[root] = order++;
+      stack.push_back ({ root, kNullLocation, 0 });
+      while (!stack.empty ())
+        {
+          auto node = stack.back ().node;
+          if (stack.back ().pos < adj[node].size ())
+            {
+              auto next = adj[node][stack.back ().pos++];
+              if (next.second == stack.back ().parentEdge)
+                {
+                  continue;
+                }
+              if (disc[next.first] == kNullLocation)
+                {
+                  disc[next.first] = low[next.first] = order++;
+                  stack.push_back ({ next.first, next.second, 0 });
+                }
+              else
+                {
+                  low[node] = (std::min)(low[node], disc[next.first]);
+                }
+            }
+          else
+            {
+              auto parentEdge = stack.back ().parentEdge;
+              stack.pop_back ();
+              if (!stack.empty ())
+                {
+                  auto parent = stack.back ().node;
+                  low[parent] = (std::min)(low[parent], low[node]);
+                  if (low[node] > disc[parent])
+                    {
+                      bridge[parentEdge] = true;
+                    }
+                }
+            }
+        }
+    }
+  return bridge;
+}
+
+int branchOutageScreening::screen ()
+{
+  std::vector<gridLink *> linkList;
+  collectLinks (sim, linkList);
+  return screen (linkList);
+}
+
+int branchOutageScreening::screen (const std::vector<gridLink *> &linkList)
+{
+  results.clear ();
+  if (sim->currentProcessState () < gridDynSimulation::gridState_t::POWERFLOW_COMPLETE)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  double time = sim->getCurrentTime ();
+  count_t size = sim->stateSize (sm);
+  if (size == 0)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::vector<double> x0 (size);
+  std::vector<double> dx (size, 0.0);
+  sim->guess (time, x0.data (), dx.data (), sm);
+
+  //the delta residual evaluator does not see switching so full residuals are used during the screening
+  bool deltaResidual = sim->controlFlags[delta_residual_evaluation];
+  sim->controlFlags.set (delta_residual_evaluation, false);
+
+  arrayDataSparse ad;
+  ad.reserve (sim->jacSize (sm));
+  sim->jacobianFunction (time, x0.data (), dx.data (), &ad, 0.0, sm);
+  if (solver.setBase (ad, size) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      sim->controlFlags.set (delta_residual_evaluation, deltaResidual);
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::vector<double> V0;
+  sim->getVoltage (V0, x0.data (), sm);
+
+  std::vector<gridLink *> allLinks;
+  collectLinks (sim, allLinks);
+  allLinks.erase (std::remove_if (allLinks.begin (), allLinks.end (), [](const gridLink *lnk) {
+      return !inService (lnk);
+    }), allLinks.end ());
+  auto bridge = findBridges (allLinks);
+  std::set<gridLink *> bridgeLinks;
+  for (index_t kk = 0; kk < allLinks.size (); ++kk)
+    {
+      if (bridge[kk])
+        {
+          bridgeLinks.insert (allLinks[kk]);
+        }
+    }
+
+  std::vector<double> x (size);
+  std::vector<double> F (size);
+  std::vector<double> V;
+  for (auto &lnk : linkList)
+    {
+      if (!inService (lnk))
+        {
+          continue;
+        }
+      outageResult res;
+      res.link = lnk;
+      res.name = lnk->getName ();
+      if (bridgeLinks.find (lnk) != bridgeLinks.end ())
+        {
+          res.islanded = true;
+          results.push_back (res);
+          continue;
+        }
+      lnk->disconnect ();
+      //links with states of their own change the size of the problem and are not screened
+      if (sim->stateSize (sm) == size)
+        {
+          ad.clear ();
+          sim->jacobianFunction (time, x0.data (), dx.data (), &ad, 0.0, sm);
+          if (solver.update (ad, size) == lowRankUpdateSolver::update_mode::singular)
+            {
+              res.islanded = true;
+            }
+          else
+            {
+              x = x0;
+              while (res.iterations < maxIterations)
+                {
+                  sim->residualFunction (time, x.data (), dx.data (), F.data (), sm);
+                  if (maxNorm (F) <= tolerance)
+                    {
+                      res.converged = true;
+                      break;
+                    }
+                  if (solver.solve (F.data (), F.data ()) != FUNCTION_EXECUTION_SUCCESS)
+                    {
+                      break;
+                    }
+                  for (index_t kk = 0; kk < size; ++kk)
+                    {
+                      x[kk] -= F[kk];
+                    }
+                  ++res.iterations;
+                }
+              if (res.converged)
+                {
+                  sim->getVoltage (V, x.data (), sm);
+                  res.minVoltage = kBigNum;
+                  res.maxVoltageChange = 0.0;
+                  for (size_t kk = 0; kk < V.size (); ++kk)
+                    {
+                      res.minVoltage = (std::min)(res.minVoltage, V[kk]);
+                      res.maxVoltageChange = (std::max)(res.maxVoltageChange, std::abs (V[kk] - V0[kk]));
+                    }
+                }
+            }
+        }
+      lnk->reconnect ();
+      results.push_back (res);
+    }
+  solver.clearUpdate ();
+  //put the objects back at the base solution
+  sim->setState (time, x0.data (), dx.data (), sm);
+  sim->updateLocalCache ();
+  sim->controlFlags.set (delta_residual_evaluation, deltaResidual);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef BRANCH_OUTAGE_SCREENING_H_
+#define BRANCH_OUTAGE_SCREENING_H_
+
+#include "gridDynTypes.h"
+#include "solvers/lowRankUpdateSolver.h"
+
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class gridLink;
+
+/** @brief screen single branch outages against a solved power flow
+ the power flow Jacobian at the base solution is factored once,  each outage opens a link, evaluates the Jacobian at the
+base solution and solves the post outage power flow with chord Newton iterations using a low rank update of the base
+factors.  Links whose removal splits the network are reported as islanding without a solve,  the bridges of the network
+graph are found in a single pass before the screening.  The network and the object states are restored after the screening.
+*/
+class branchOutageScreening
+{
+public:
+  /** @brief the result of screening one outage*/
+  class outageResult
+  {
+public:
+    gridLink *link = nullptr;  //!< the link taken out of service
+    std::string name;  //!< the name of the link
+    bool islanded = false;  //!< the outage splits the network
+    bool converged = false;  //!< the post outage solution converged
+    count_t iterations = 0;  //!< the number of chord iterations
+    double minVoltage = kNullVal;  //!< the lowest post outage bus voltage
+    double maxVoltageChange = kNullVal;  //!< the largest change in a bus voltage magnitude from the base case
+  };
+
+  explicit branchOutageScreening (gridDynSimulation *gds);
+
+  /** @brief screen the outage of every connected link in the simulation
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if there is no power flow solution to screen against
+  */
+  int screen ();
+  /** @brief screen the outages of a list of links
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if there is no power flow solution to screen against
+  */
+  int screen (const std::vector<gridLink *> &linkList);
+
+  const std::vector<outageResult> &getResults () const
+  {
+    return results;
+  }
+  /** @brief get the statistics of the linear solver used for the screening*/
+  const lowRankUpdateSolver::solveStats &getSolverStats () const
+  {
+    return solver.getStats ();
+  }
+  /** @brief set the maximum number of chord iterations for an outage*/
+  void setMaxIterations (count_t iterations)
+  {
+    maxIterations = iterations;
+  }
+  /** @brief set the residual tolerance for convergence*/
+  void setTolerance (double tol)
+  {
+    tolerance = tol;
+  }
+  /** @brief set the maximum rank of a Jacobian update before the post outage Jacobian is factored directly*/
+  void setMaxRank (count_t maxR)
+  {
+    solver.setMaxRank (maxR);
+  }
+
+private:
+  gridDynSimulation *sim;  //!< the simulation to screen
+  lowRankUpdateSolver solver;  //!< the linear solver holding the base factorization
+  std::vector<outageResult> results;  //!< the results of the last screening
+  count_t maxIterations = 20;  //!< the maximum number of chord iterations
+  double tolerance = 1e-8;  //!< the residual tolerance
+
+  std::vector<bool> findBridges (const std::vector<gridLink *> &linkList) const;
+};
+
+#endif
@@ -0,0 +1,485 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "coherencyAggregator.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "primary/acBus.h"
+#include "linkModels/acLine.h"
+#include "generators/gridDynGenerator.h"
+#include "submodels/gridDynGenModel.h"
+#include "gridEvent.h"
+#include "objectInterpreter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+//parameters of the equivalent machine computed as machine base weighted averages of the group
+static const std::vector<std::pair<std::string, std::string> > aggregatedParameters {
+  { "genmodel", "h" }, { "genmodel", "d" },
+  { "exciter", "ka" }, { "exciter", "ta" }, { "exciter", "vrmax" }, { "exciter", "vrmin" },
+  { "governor", "k" }, { "governor", "t1" }, { "governor", "t2" }, { "governor", "t3" },
+};
+
+coherencyAggregator::coherencyAggregator (gridDynSimulation *gds) : sim (gds)
+{
+}
+
+void coherencyAggregator::addProbe (const std::string &eventString)
+{
+  probes.push_back (eventString);
+}
+
+void coherencyAggregator::addMonitor (const std::string &field)
+{
+  monitors.push_back (field);
+}
+
+void coherencyAggregator::keep (const std::string &objectName)
+{
+  keepList.push_back (objectName);
+}
+
+void coherencyAggregator::setProbeDuration (double duration)
+{
+  if (duration > 0)
+    {
+      probeDuration = duration;
+    }
+}
+
+void coherencyAggregator::setSampleInterval (double interval)
+{
+  if (interval > 0)
+    {
+      sampleInterval = interval;
+    }
+}
+
+void coherencyAggregator::setCoherencyTolerance (double tol)
+{
+  if (tol > 0)
+    {
+      angleTolerance = tol;
+    }
+}
+
+void coherencyAggregator::setLinkReactance (double x)
+{
+  if (x > 0)
+    {
+      linkReactance = x;
+    }
+}
+
+bool coherencyAggregator::isKept (gridDynGenerator *gen) const
+{
+  auto bus = dynamic_cast<gridBus *> (gen->getParent ());
+  if ((bus) && (bus->getType () == gridBus::busType::SLK))
+    {
+      return true;
+    }
+  gridCoreObject *obj = gen;
+  while (obj)
+    {
+      if (std::find (keepList.begin (), keepList.end (), obj->getName ()) != keepList.end ())
+        {
+          return true;
+        }
+      obj = obj->getParent ();
+    }
+  return false;
+}
+
+std::vector<gridDynGenerator *> coherencyAggregator::candidateGenerators () const
+{
+  std::vector<gridDynGenerator *> gens;
+  std::vector<gridBus *> buses;
+  sim->getBusVector (buses);
+  for (auto &bus : buses)
+    {
+      index_t kk = 0;
+      auto gen = bus->getGen (kk);
+      while (gen)
+        {
+          if ((gen->enabled) && (gen->find ("genmodel")) && (!isKept (gen)))
+            {
+              gens.push_back (gen);
+            }
+          ++kk;
+          gen = bus->getGen (kk);
+        }
+    }
+  return gens;
+}
+
+std::unique_ptr<gridDynSimulation> coherencyAggregator::makeProbeSimulation (gridDynSimulation *base, const std::string &probe) const
+{
+  std::unique_ptr<gridDynSimulation> psim (static_cast<gridDynSimulation *> (base->clone ()));
+  if (!probe.empty ())
+    {
+      auto ev = make_event (probe, psim.get ());
+      if (ev->getObject () == nullptr)
+        {
+          sim->log (sim, GD_ERROR_PRINT, "unable to create probe event " + probe);
+          return nullptr;
+        }
+      psim->add (ev);
+    }
+  if (psim->dynInitialize () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      sim->log (sim, GD_ERROR_PRINT, "unable to initialize probe simulation");
+      return nullptr;
+    }
+  return psim;
+}
+
+int coherencyAggregator::runProbe (gridDynSimulation *psim, const std::function<void (gridDynSimulation *)> &sampler) const
+{
+  double t0 = psim->getCurrentTime ();
+  auto sampleCount = static_cast<count_t> (std::floor (probeDuration / sampleInterval + 0.5));
+  sampler (psim);
+  for (count_t kk = 1; kk <= sampleCount; ++kk)
+    {
+      if (psim->run (t0 + static_cast<double> (kk) * sampleInterval) < FUNCTION_EXECUTION_SUCCESS)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      sampler (psim);
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int coherencyAggregator::identifyGroups ()
+{
+  groups.clear ();
+  if (probes.empty ())
+    {
+      sim->log (sim, GD_ERROR_PRINT, "coherency identification requires at least one probe disturbance");
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  auto gens = candidateGenerators ();
+  report = aggregationReport ();
+  report.originalGenerators = static_cast<count_t> (gens.size ());
+  //the rotor angle deviation trajectory of each generator over all the probes
+  std::vector<std::vector<double> > deviation (gens.size ());
+  for (auto &probe : probes)
+    {
+      auto psim = makeProbeSimulation (sim, probe);
+      if (!psim)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      std::vector<gridDynGenModel *> models (gens.size (), nullptr);
+      for (size_t kk = 0; kk < gens.size (); ++kk)
+        {
+          auto pgen = findMatchingObject (gens[kk], sim, psim.get ());
+          if (pgen)
+            {
+              models[kk] = dynamic_cast<gridDynGenModel *> (pgen->find ("genmodel"));
+            }
+        }
+      std::vector<double> initialAngle;
+      auto sampler = [&](gridDynSimulation *) {
+          bool first = initialAngle.empty ();
+          if (first)
+            {
+              initialAngle.resize (models.size (), 0.0);
+            }
+          for (size_t kk = 0; kk < models.size (); ++kk)
+            {
+              double ang = (models[kk]) ? models[kk]->getAngle (nullptr, cLocalSolverMode) : 0.0;
+              if (first)
+                {
+                  initialAngle[kk] = ang;
+                }
+              deviation[kk].push_back (ang - initialAngle[kk]);
+            }
+        };
+      if (runProbe (psim.get (), sampler) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          sim->log (sim, GD_ERROR_PRINT, "probe simulation failed for " + probe);
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  //greedy grouping around the largest remaining machine
+  std::vector<index_t> order (gens.size ());
+  std::vector<double> mbase (gens.size ());
+  for (index_t kk = 0; kk < gens.size (); ++kk)
+    {
+      order[kk] = kk;
+      mbase[kk] = gens[kk]->get ("mbase");
+    }
+  std::stable_sort (order.begin (), order.end (), [&mbase](index_t a, index_t b) {
+      return (mbase[a] > mbase[b]);
+    });
+  std::vector<bool> assigned (gens.size (), false);
+  for (auto ref : order)
+    {
+      if (assigned[ref])
+        {
+          continue;
+        }
+      assigned[ref] = true;
+      std::vector<gridDynGenerator *> group { gens[ref] };
+      for (auto cand : order)
+        {
+          if (assigned[cand])
+            {
+              continue;
+            }
+          double maxDiff = 0.0;
+          for (size_t tt = 0; tt < deviation[ref].size (); ++tt)
+            {
+              maxDiff = (std::max)(maxDiff, std::abs (deviation[ref][tt] - deviation[cand][tt]));
+            }
+          if (maxDiff <= angleTolerance)
+            {
+              assigned[cand] = true;
+              group.push_back (gens[cand]);
+            }
+        }
+      if (group.size () > 1)
+        {
+          groups.push_back (std::move (group));
+        }
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+static double weightedParameter (const std::vector<gridDynGenerator *> &group, const std::vector<double> &weights, const std::string &model, const std::string &param)
+{
+  double sum = 0.0;
+  double wsum = 0.0;
+  for (size_t kk = 0; kk < group.size (); ++kk)
+    {
+      auto obj = group[kk]->find (model);
+      if (obj == nullptr)
+        {
+          continue;
+        }
+      double val = obj->get (param);
+      if (val == kNullVal)
+        {
+          continue;
+        }
+      sum += weights[kk] * val;
+      wsum += weights[kk];
+    }
+  return (wsum > 0.0) ? sum / wsum : kNullVal;
+}
+
+bool coherencyAggregator::aggregateGroup (gridDynSimulation *solved, gridDynSimulation *reduced, const std::vector<gridDynGenerator *> &group, index_t groupIndex) const
+{
+  std::vector<gridDynGenerator *> rgens;
+  std::vector<gridBus *> rbuses;
+  std::vector<double> weights;
+  std::vector<double> voltage;
+  std::vector<double> angle;
+  double totalBase = 0.0;
+  double totalP = 0.0;
+  for (auto &gen : group)
+    {
+      auto sgen = dynamic_cast<gridDynGenerator *> (findMatchingObject (gen, sim, solved));
+      auto rgen = dynamic_cast<gridDynGenerator *> (findMatchingObject (gen, sim, reduced));
+      if ((sgen == nullptr) || (rgen == nullptr))
+        {
+          return false;
+        }
+      auto sbus = static_cast<gridBus *> (sgen->getParent ());
+      rgens.push_back (rgen);
+      rbuses.push_back (static_cast<gridBus *> (rgen->getParent ()));
+      weights.push_back (gen->get ("mbase"));
+      voltage.push_back (sbus->getVoltage ());
+      angle.push_back (sbus->getAngle ());
+      totalBase += weights.back ();
+      totalP += sgen->getRealPower ();
+    }
+  double Veq = 0.0;
+  double Aeq = 0.0;
+  for (size_t kk = 0; kk < weights.size (); ++kk)
+    {
+      Veq += weights[kk] * voltage[kk] / totalBase;
+      Aeq += weights[kk] * angle[kk] / totalBase;
+    }
+  //the groups are built around the largest machine which is the first member
+  auto eqGen = static_cast<gridDynGenerator *> (rgens[0]->clone ());
+  eqGen->setName ("eqgen_" + std::to_string (groupIndex));
+  for (auto &par : aggregatedParameters)
+    {
+      double val = weightedParameter (rgens, weights, par.first, par.second);
+      auto obj = eqGen->find (par.first);
+      if ((obj) && (val != kNullVal))
+        {
+          obj->set (par.second, val);
+        }
+    }
+  eqGen->set ("mbase", totalBase);
+  eqGen->set ("p", totalP);
+  for (auto &lim : { "pmax", "pmin", "qmax", "qmin" })
+    {
+      double sum = 0.0;
+      bool bounded = true;
+      for (auto &rgen : rgens)
+        {
+          double val = rgen->get (lim);
+          if (std::abs (val) >= kHalfBigNum)
+            {
+              bounded = false;
+              break;
+            }
+          sum += val;
+        }
+      if (bounded)
+        {
+          eqGen->set (lim, sum);
+        }
+    }
+
+  auto eqBus = new acBus (Veq, Aeq, "eqbus_" + std::to_string (groupIndex));
+  eqBus->set ("type", "pv");
+  eqBus->set ("vtarget", Veq);
+  reduced->add (eqBus);
+  eqBus->add (eqGen);
+
+  for (auto &rgen : rgens)
+    {
+      rgen->disable ();
+    }
+  //one phase shifting transformer per distinct terminal bus
+  for (size_t kk = 0; kk < rbuses.size (); ++kk)
+    {
+      if (std::find (rbuses.begin (), rbuses.begin () + kk, rbuses[kk]) != rbuses.begin () + kk)
+        {
+          continue;
+        }
+      auto lnk = new acLine (0.0, linkReactance, "eqlink_" + std::to_string (groupIndex) + "_" + std::to_string (kk));
+      lnk->set ("tap", Veq / voltage[kk]);
+      lnk->set ("tapangle", Aeq - angle[kk]);
+      reduced->add (lnk);
+      lnk->updateBus (eqBus, 1);
+      lnk->updateBus (rbuses[kk], 2);
+      //the terminal bus no longer regulates voltage if all its machines were aggregated
+      bool hasGen = false;
+      index_t gg = 0;
+      auto gen = rbuses[kk]->getGen (gg);
+      while (gen)
+        {
+          hasGen = hasGen || gen->enabled;
+          ++gg;
+          gen = rbuses[kk]->getGen (gg);
+        }
+      if (!hasGen)
+        {
+          rbuses[kk]->set ("type", "pq");
+        }
+    }
+  return true;
+}
+
+std::unique_ptr<gridDynSimulation> coherencyAggregator::buildReducedModel ()
+{
+  if (sim->currentProcessState () != gridDynSimulation::gridState_t::STARTUP)
+    {
+      sim->log (sim, GD_WARNING_PRINT, "building a reduced model from an initialized simulation, the equivalents may not be initialized");
+    }
+  //operating point of the full model
+  std::unique_ptr<gridDynSimulation> solved (static_cast<gridDynSimulation *> (sim->clone ()));
+  if (solved->powerflow () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      sim->log (sim, GD_ERROR_PRINT, "unable to solve the power flow of the full model");
+      return nullptr;
+    }
+  std::unique_ptr<gridDynSimulation> reduced (static_cast<gridDynSimulation *> (sim->clone ()));
+  report.groupCount = 0;
+  report.removedGenerators = 0;
+  for (index_t kk = 0; kk < groups.size (); ++kk)
+    {
+      if (!aggregateGroup (solved.get (), reduced.get (), groups[kk], kk))
+        {
+          sim->log (sim, GD_ERROR_PRINT, "unable to aggregate coherent group " + std::to_string (kk));
+          return nullptr;
+        }
+      ++report.groupCount;
+      report.removedGenerators += static_cast<count_t> (groups[kk].size ());
+    }
+  return reduced;
+}
+
+int coherencyAggregator::evaluate (gridDynSimulation *reduced)
+{
+  auto fullInit = makeProbeSimulation (sim, "");
+  auto reducedInit = makeProbeSimulation (reduced, "");
+  if ((!fullInit) || (!reducedInit))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  report.originalStates = static_cast<count_t> (fullInit->get ("dynstatesize"));
+  report.reducedStates = static_cast<count_t> (reducedInit->get ("dynstatesize"));
+
+  auto fields = monitors;
+  if (fields.empty ())
+    {
+      std::vector<gridBus *> buses;
+      sim->getBusVector (buses);
+      for (auto &bus : buses)
+        {
+          fields.push_back (bus->getName () + ":voltage");
+        }
+    }
+  report.maxError.clear ();
+  report.rmsError.clear ();
+  for (auto &probe : probes)
+    {
+      std::vector<std::vector<double> > values (2);
+      gridDynSimulation *bases[] = { sim, reduced };
+      for (int mm = 0; mm < 2; ++mm)
+        {
+          auto psim = makeProbeSimulation (bases[mm], probe);
+          if (!psim)
+            {
+              return FUNCTION_EXECUTION_FAILURE;
+            }
+          std::vector<objInfo> targets;
+          for (auto &fld : fields)
+            {
+              targets.emplace_back (fld, psim.get ());
+            }
+          auto &vals = values[mm];
+          auto sampler = [&](gridDynSimulation *) {
+              for (auto &oi : targets)
+                {
+                  vals.push_back ((oi.m_obj) ? oi.m_obj->get (oi.m_field, oi.m_unitType) : 0.0);
+                }
+            };
+          if (runProbe (psim.get (), sampler) != FUNCTION_EXECUTION_SUCCESS)
+            {
+              sim->log (sim, GD_ERROR_PRINT, "evaluation simulation failed for " + probe);
+              return FUNCTION_EXECUTION_FAILURE;
+            }
+        }
+      double maxErr = 0.0;
+      double sumSq = 0.0;
+      auto cnt = (std::min)(values[0].size (), values[1].size ());
+      for (size_t kk = 0; kk < cnt; ++kk)
+        {
+          double err = std::abs (values[0][kk] - values[1][kk]);
+          maxErr = (std::max)(maxErr, err);
+          sumSq += err * err;
+        }
+      report.maxError.push_back (maxErr);
+      report.rmsError.push_back ((cnt > 0) ? std::sqrt (sumSq / static_cast<double> (cnt)) : 0.0);
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_COHERENCY_AGGREGATOR_H_
+#define GRIDDYN_COHERENCY_AGGREGATOR_H_
+
+#include "gridDynTypes.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+
+class gridDynSimulation;
+class gridDynGenerator;
+
+/** @brief dynamic equivalencing of a simulation through coherency based generator aggregation
+ coherent groups are identified from short probe simulations, two generators are coherent if the difference between
+their rotor angle deviations stays below a tolerance for every probe disturbance.  Each group with more than one member
+is replaced in a copy of the simulation by a single equivalent machine on a new bus, connected to the terminal buses of the
+original machines through phase shifting transformers which match the pre-disturbance voltages so the power flow is preserved.
+The equivalent machine is a copy of the largest machine in the group on the combined machine base with the inertia, damping,
+exciter and governor parameters replaced by their machine base weighted averages.
+Generators named in the keep list, on a bus or in an area named in the keep list, or on a slack bus are never aggregated.
+*/
+class coherencyAggregator
+{
+public:
+  /** @brief the results of an aggregation*/
+  class aggregationReport
+  {
+public:
+    count_t originalGenerators = 0;  //!< the number of generators considered for aggregation
+    count_t removedGenerators = 0;  //!< the number of generators replaced by equivalents
+    count_t groupCount = 0;  //!< the number of equivalent machines
+    count_t originalStates = 0;  //!< the number of dynamic states in the full model
+    count_t reducedStates = 0;  //!< the number of dynamic states in the reduced model
+    std::vector<double> maxError;  //!< the maximum deviation of the monitored values for each probe
+    std::vector<double> rmsError;  //!< the rms deviation of the monitored values for each probe
+    /** @brief get the fraction of the states removed*/
+    double stateReduction () const
+    {
+      return (originalStates > 0) ? 1.0 - static_cast<double> (reducedStates) / static_cast<double> (originalStates) : 0.0;
+    }
+  };
+
+  /** @brief constructor
+  @param[in] gds the simulation to reduce,  it is not modified
+  */
+  explicit coherencyAggregator (gridDynSimulation *gds);
+
+  /** @brief add a probe disturbance
+  @param[in] eventString an event description in the format accepted by make_event, for example "load3:p=1.2@1.0"
+  */
+  void addProbe (const std::string &eventString);
+  /** @brief add a value to compare between the full and reduced models
+  @param[in] field an object:field string, if no monitors are given the voltages of all buses are compared
+  */
+  void addMonitor (const std::string &field);
+  /** @brief exclude a generator,  a bus, or an area from aggregation*/
+  void keep (const std::string &objectName);
+  /** @brief set the time each probe is simulated [s]*/
+  void setProbeDuration (double duration);
+  /** @brief set the sampling interval of the probe trajectories [s]*/
+  void setSampleInterval (double interval);
+  /** @brief set the maximum rotor angle deviation difference between coherent machines [rad]*/
+  void setCoherencyTolerance (double tol);
+  /** @brief set the reactance of the transformers connecting the equivalent bus [pu]*/
+  void setLinkReactance (double x);
+
+  /** @brief run the probe simulations and compute the coherent groups
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if a probe could not be simulated
+  */
+  int identifyGroups ();
+  /** @brief get the groups with more than one member,  the generators are the ones in the original simulation*/
+  const std::vector<std::vector<gridDynGenerator *> > &getGroups () const
+  {
+    return groups;
+  }
+  /** @brief construct the reduced model from the identified groups
+  @return a new simulation with the equivalent machines or an empty pointer on failure
+  */
+  std::unique_ptr<gridDynSimulation> buildReducedModel ();
+  /** @brief compare a reduced model against the full model on all the probe disturbances
+  @param[in] reduced the reduced simulation, it is not modified
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if either model could not be simulated
+  */
+  int evaluate (gridDynSimulation *reduced);
+  const aggregationReport &getReport () const
+  {
+    return report;
+  }
+
+private:
+  gridDynSimulation *sim;  //!< the full simulation
+  std::vector<std::string> probes;  //!< the probe disturbances
+  std::vector<std::string> monitors;  //!< the fields to compare
+  std::vector<std::string> keepList;  //!< objects excluded from aggregation
+  double probeDuration = 2.0;  //!< [s] the length of the probe simulations
+  double sampleInterval = 0.05;  //!< [s] the sampling interval
+  double angleTolerance = 0.1;  //!< [rad] the coherency tolerance
+  double linkReactance = 1e-3;  //!< [pu] the reactance of the equivalent transformers
+  std::vector<std::vector<gridDynGenerator *> > groups;  //!< the coherent groups
+  aggregationReport report;  //!< the aggregation results
+
+  std::vector<gridDynGenerator *> candidateGenerators () const;
+  bool isKept (gridDynGenerator *gen) const;
+  std::unique_ptr<gridDynSimulation> makeProbeSimulation (gridDynSimulation *base, const std::string &probe) const;
+  int runProbe (gridDynSimulation *psim, const std::function<void (gridDynSimulation *)> &sampler) const;
+  bool aggregateGroup (gridDynSimulation *solved, gridDynSimulation *reduced, const std::vector<gridDynGenerator *> &group, index_t groupIndex) const;
+};
+
+#endif
@@ -19,7 +19,9 @@
 #include "vectorOps.hpp"
 #include "arrayDataSparse.h"
 #include "gridRandom.h"
+#include "internedString.h"
 #include <cassert>
+#include <unordered_set>
 
 double checkResid (gridDynSimulation *gds, double time, const solverMode &sMode, int *loc)
 {
@@ -657,4 +659,50 @@ void dynamicSolverConvergenceTest(gridDynSimulation *gds, const solverMode &sMod
 
 	sd->set("printLevel", tempLevel);
 	std::copy(baseState.begin(), baseState.begin() + ssize, state);
-}
\ No newline at end of file
+}
+
+static void collectObjects (const gridObject *obj, std::vector<const gridObject *> &objs)
+{
+  objs.push_back (obj);
+  for (auto &sub : obj->getSubObjects ())
+    {
+      collectObjects (sub, objs);
+    }
+}
+
+objectMemoryReport memoryReport (const gridObject *root)
+{
+  objectMemoryReport report;
+  if (root == nullptr)
+    {
+      return report;
+    }
+  std::vector<const gridObject *> objs;
+  collectObjects (root, objs);
+  //hash table nodes hold a next pointer and the cached hash beside the value
+  const size_t nodeOverhead = sizeof(void *) + sizeof(size_t);
+  std::unordered_set<const std::string *> names;
+  for (auto &obj : objs)
+    {
+      const std::string &nm = obj->getName ();
+      auto desc = obj->getDescription ();
+      bool hasPosition = static_cast<bool> (obj->getPosition ());
+      report.legacyBytes += 2 * sizeof(std::string) + sizeof(std::shared_ptr<gridPositionInfo>);
+      report.legacyBytes += internedString::stringHeapBytes (nm.size ()) + internedString::stringHeapBytes (desc.size ());
+      report.currentBytes += sizeof(internedString);
+      //the name reference points to the table entry so the addresses of distinct names are distinct
+      if (names.insert (&nm).second)
+        {
+          report.currentBytes += sizeof(internedString::tableEntry) + nodeOverhead + internedString::stringHeapBytes (nm.size ());
+        }
+      if ((!desc.empty ()) || (hasPosition))
+        {
+          ++report.sideEntries;
+          report.currentBytes += sizeof(void *) + sizeof(std::string) + sizeof(std::shared_ptr<gridPositionInfo>) + nodeOverhead;
+          report.currentBytes += internedString::stringHeapBytes (desc.size ());
+        }
+    }
+  report.objects = static_cast<count_t> (objs.size ());
+  report.distinctNames = static_cast<count_t> (names.size ());
+  return report;
+}
@@ -17,7 +17,10 @@
 #include <memory>
 #include <string>
 
+#include "gridDynTypes.h"
+
 class gridDynSimulation;
+class gridObject;
 class solverMode;
 class solverInterface;
 
@@ -69,4 +72,27 @@ int derivativeCheck (gridDynSimulation *gds, double time, const solverMode &sMod
 */
 void dynamicSolverConvergenceTest (gridDynSimulation *gds, const solverMode &sMode, const std::string &file, unsigned int pts = 100000, int mode = 0);
 
+/** @brief a summary of the memory used by the object headers of a tree of objects*/
+class objectMemoryReport
+{
+public:
+  count_t objects = 0;  //!< the number of objects in the tree
+  count_t distinctNames = 0;  //!< the number of distinct names used by the objects
+  count_t sideEntries = 0;  //!< the number of objects with a description or position
+  size_t currentBytes = 0;  //!< the bytes used for the names, descriptions, and positions with interned names and side tables
+  size_t legacyBytes = 0;  //!< the bytes the same data would use stored as strings and pointers in every object
+  /** @brief get the bytes saved per object*/
+  double savingsPerObject () const
+  {
+    return (objects > 0) ? (static_cast<double> (legacyBytes) - static_cast<double> (currentBytes)) / static_cast<double> (objects) : 0.0;
+  }
+};
+
+/** @brief compute the memory used by the names,  descriptions and positions of a tree of objects
+ the report compares the interned names and the side tables to the layout storing a name string,  a description
+string and a position pointer in every object
+@param[in] root the top of the object tree
+*/
+objectMemoryReport memoryReport (const gridObject *root);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "ensembleRunner.h"
+#include "gridDyn.h"
+#include "objectInterpreter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/** @brief a running copy of the simulation*/
+class ensembleRunner::variant
+{
+public:
+  std::unique_ptr<gridDynSimulation> gds;  //!< the copy of the simulation
+  std::vector<objInfo> outputs;  //!< the resolved output fields
+  variantResult *result = nullptr;  //!< the results of the variant
+  std::string error;  //!< a description of a setup failure
+};
+
+ensembleRunner::ensembleRunner (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+ensembleRunner::~ensembleRunner ()
+{
+
+}
+
+index_t ensembleRunner::addVariant (const std::vector<std::pair<std::string, double> > &settings)
+{
+  variants.push_back (settings);
+  return static_cast<index_t> (variants.size () - 1);
+}
+
+void ensembleRunner::addSweep (const std::string &target, const std::vector<double> &values)
+{
+  for (auto &val : values)
+    {
+      variants.push_back (std::vector<std::pair<std::string, double> > { std::make_pair (target, val) });
+    }
+}
+
+void ensembleRunner::addOutput (const std::string &field)
+{
+  outputs.push_back (field);
+}
+
+int ensembleRunner::prepare (variant &var, index_t index)
+{
+  auto &gds = var.gds;
+  //the parameters are set before the initialization so they are part of the initial condition
+  for (auto &setting : variants[index])
+    {
+      objInfo oi (setting.first, gds.get ());
+      if ((!oi.m_obj) || (oi.m_obj->set (oi.m_field, setting.second, oi.m_unitType) != PARAMETER_FOUND))
+        {
+          var.error = "unable to set " + setting.first + " in variant " + std::to_string (index);
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  if (gds->currentProcessState () < gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED)
+    {
+      if (gds->dynInitialize () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          var.error = "variant " + std::to_string (index) + " failed to initialize";
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  for (auto &field : outputs)
+    {
+      var.outputs.emplace_back (field, gds.get ());
+      if (!var.outputs.back ().m_obj)
+        {
+          var.error = "unable to locate output " + field + " in variant " + std::to_string (index);
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  var.result->time = gds->getCurrentTime ();
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void ensembleRunner::advance (variant &var, index_t sample)
+{
+  auto &res = *(var.result);
+  double target = sampleTimes[sample];
+  double actual = res.time;
+  //the step function may return early at internal stopping points so keep going until the sample time is reached
+  while (actual < target - kSmallTime)
+    {
+      double prev = actual;
+      res.status = var.gds->step (target, actual);
+      if (res.status < FUNCTION_EXECUTION_SUCCESS)
+        {
+          break;
+        }
+      if (actual <= prev)
+        {
+          res.status = FUNCTION_EXECUTION_FAILURE;
+          break;
+        }
+    }
+  res.time = actual;
+  if (res.status >= FUNCTION_EXECUTION_SUCCESS)
+    {
+      res.status = FUNCTION_EXECUTION_SUCCESS;
+      record (var, sample);
+    }
+}
+
+void ensembleRunner::record (variant &var, index_t sample)
+{
+  auto &vals = var.result->samples[sample];
+  vals.resize (var.outputs.size ());
+  for (size_t kk = 0; kk < var.outputs.size (); ++kk)
+    {
+      vals[kk] = var.outputs[kk].m_obj->get (var.outputs[kk].m_field, var.outputs[kk].m_unitType);
+    }
+}
+
+int ensembleRunner::run (double stopTime)
+{
+  results.clear ();
+  sampleTimes.clear ();
+  stats = ensembleStats ();
+  if (variants.empty ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  int nvar = static_cast<int> (variants.size ());
+  results.resize (nvar);
+  std::vector<variant> vars (nvar);
+  //the copies are made on the calling thread since cloning adds objects to the structure counters
+  for (int kk = 0; kk < nvar; ++kk)
+    {
+      vars[kk].gds.reset (static_cast<gridDynSimulation *> (sim->clone ()));
+      vars[kk].result = &(results[kk]);
+    }
+  //the first variant builds the Jacobian patterns and orderings the others use
+  results[0].status = prepare (vars[0], 0);
+  //the initialization creates objects,  deferred submodels for instance,  so it stays on the calling thread and only the steps run in parallel
+  for (int kk = 1; kk < nvar; ++kk)
+    {
+      //the patterns are needed by the power flow inside the initialization so they are adopted first, each one is matched
+      //by the pattern version the first variant built it at so the changes made by the initialization do not drop it
+      if (results[0].status == FUNCTION_EXECUTION_SUCCESS)
+        {
+          vars[kk].gds->shareJacobianPatterns (vars[0].gds.get ());
+        }
+      results[kk].status = prepare (vars[kk], static_cast<index_t> (kk));
+    }
+  double t0 = kBigNum;
+  for (int kk = 0; kk < nvar; ++kk)
+    {
+      if (results[kk].status == FUNCTION_EXECUTION_SUCCESS)
+        {
+          t0 = (std::min)(t0, results[kk].time);
+        }
+      else
+        {
+          sim->log (sim, GD_WARNING_PRINT, vars[kk].error);
+        }
+    }
+  if (t0 >= kBigNum)
+    {
+      stats.variants = static_cast<count_t> (nvar);
+      stats.failures = stats.variants;
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  sampleTimes.push_back (t0);
+  if (samplePeriod > 0.0)
+    {
+      auto cnt = static_cast<count_t> (std::ceil ((stopTime - t0) / samplePeriod - kSmallTime));
+      for (count_t kk = 1; kk < cnt; ++kk)
+        {
+          sampleTimes.push_back (t0 + samplePeriod * kk);
+        }
+    }
+  if (stopTime > sampleTimes.back () + kSmallTime)
+    {
+      sampleTimes.push_back (stopTime);
+    }
+  int nsamples = static_cast<int> (sampleTimes.size ());
+  for (int kk = 0; kk < nvar; ++kk)
+    {
+      results[kk].samples.resize (nsamples);
+      if (results[kk].status == FUNCTION_EXECUTION_SUCCESS)
+        {
+          record (vars[kk], 0);
+        }
+    }
+  if (stepControl == step_control::lockstep)
+    {
+      for (int ss = 1; ss < nsamples; ++ss)
+        {
+#pragma omp parallel for schedule(dynamic) if ((parallel) && (nvar > 1))
+          for (int kk = 0; kk < nvar; ++kk)
+            {
+              if (results[kk].status == FUNCTION_EXECUTION_SUCCESS)
+                {
+                  advance (vars[kk], static_cast<index_t> (ss));
+                }
+            }
+        }
+    }
+  else
+    {
+#pragma omp parallel for schedule(dynamic) if ((parallel) && (nvar > 1))
+      for (int kk = 0; kk < nvar; ++kk)
+        {
+          for (int ss = 1; ss < nsamples; ++ss)
+            {
+              if (results[kk].status != FUNCTION_EXECUTION_SUCCESS)
+                {
+                  break;
+                }
+              advance (vars[kk], static_cast<index_t> (ss));
+            }
+        }
+    }
+  stats.variants = static_cast<count_t> (nvar);
+  stats.syncPoints = static_cast<count_t> (nsamples);
+  for (int kk = 0; kk < nvar; ++kk)
+    {
+      if (results[kk].status == FUNCTION_EXECUTION_SUCCESS)
+        {
+          results[kk].finalState = vars[kk].gds->getState ();
+          results[kk].patternDiscoveries = static_cast<count_t> (vars[kk].gds->get ("jacobianpatterndiscoveries"));
+          //a variant shares the analysis if its solvers were served stored patterns without discovering their own
+          if ((kk > 0) && (results[kk].patternDiscoveries == 0) && (vars[kk].gds->get ("jacobianpatternhits") > 0))
+            {
+              ++stats.sharedAnalyses;
+            }
+        }
+      else
+        {
+          ++stats.failures;
+        }
+    }
+  return (stats.failures < stats.variants) ? FUNCTION_EXECUTION_SUCCESS : FUNCTION_EXECUTION_FAILURE;
+}
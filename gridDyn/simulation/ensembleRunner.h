@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef ENSEMBLE_RUNNER_H_
+#define ENSEMBLE_RUNNER_H_
+
+#include "basicDefs.h"
+#include "gridDynTypes.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class gridDynSimulation;
+
+/** @brief run a set of parameter variants of a simulation as an ensemble
+ each variant is a copy of the base simulation with a list of object:parameter values applied before it is initialized,
+the structure and events of the variants are identical.  The first variant is initialized alone and the Jacobian
+patterns and fill reducing orderings it builds are shared with all the other variants,  so the sparse solvers of the
+ensemble do one symbolic analysis and each variant only computes its own numeric factors.  The initialization of the
+variants creates objects so it runs on the calling thread,  the variants are then advanced
+over a common set of sample times in parallel when OpenMP is available with one of two step controls
+- lockstep,  all the variants are advanced to each sample time before any variant moves past it
+- independent,  every variant runs through all the sample times on its own with its own step size control
+the requested output fields of every variant are recorded at each sample time.  A variant which fails is stopped and
+reported without affecting the others.
+*/
+class ensembleRunner
+{
+public:
+  /** @brief the step control across the variants*/
+  enum class step_control
+  {
+    lockstep,  //!< all variants reach each sample time together
+    independent,  //!< each variant runs the full horizon on its own
+  };
+
+  /** @brief the results of one variant*/
+  class variantResult
+  {
+public:
+    int status = FUNCTION_EXECUTION_SUCCESS;  //!< the status of the variant run
+    double time = 0.0;  //!< the time the variant reached
+    std::vector<std::vector<double> > samples;  //!< the output values at each sample time
+    std::vector<double> finalState;  //!< the state of the variant at the end of the run
+    count_t patternDiscoveries = 0;  //!< the number of Jacobian patterns the variant had to discover itself
+  };
+
+  /** @brief statistics of the last run*/
+  class ensembleStats
+  {
+public:
+    count_t variants = 0;  //!< the number of variants run
+    count_t failures = 0;  //!< the number of variants which failed
+    count_t sharedAnalyses = 0;  //!< the number of variants whose solvers only used the patterns of the first variant
+    count_t syncPoints = 0;  //!< the number of sample times
+  };
+
+  explicit ensembleRunner (gridDynSimulation *gds);
+  ~ensembleRunner ();
+
+  /** @brief add a variant
+  @param[in] settings pairs of object:parameter strings and the values to set in the variant
+  @return the index of the variant
+  */
+  index_t addVariant (const std::vector<std::pair<std::string, double> > &settings);
+  /** @brief add one variant for each value of a single parameter
+  @param[in] target the object:parameter string
+  @param[in] values the value of each variant
+  */
+  void addSweep (const std::string &target, const std::vector<double> &values);
+  /** @brief add an object:field output recorded at every sample time*/
+  void addOutput (const std::string &field);
+  void clearVariants ()
+  {
+    variants.clear ();
+  }
+  count_t variantCount () const
+  {
+    return static_cast<count_t> (variants.size ());
+  }
+  /** @brief set the interval between the sample times*/
+  void setSamplePeriod (double period)
+  {
+    samplePeriod = period;
+  }
+  void setStepControl (step_control control)
+  {
+    stepControl = control;
+  }
+  /** @brief allow the variants to run in parallel*/
+  void setParallel (bool par)
+  {
+    parallel = par;
+  }
+  /** @brief run all the variants
+  @param[in] stopTime the time to run the variants to
+  @return FUNCTION_EXECUTION_SUCCESS if at least one variant completed or FUNCTION_EXECUTION_FAILURE
+  */
+  int run (double stopTime);
+
+  const std::vector<variantResult> &getResults () const
+  {
+    return results;
+  }
+  /** @brief get the sample times of the last run*/
+  const std::vector<double> &getSampleTimes () const
+  {
+    return sampleTimes;
+  }
+  const ensembleStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  class variant;
+  gridDynSimulation *sim;  //!< the base simulation
+  std::vector<std::vector<std::pair<std::string, double> > > variants;  //!< the settings of each variant
+  std::vector<std::string> outputs;  //!< the recorded output fields
+  std::vector<variantResult> results;  //!< the results of the last run
+  std::vector<double> sampleTimes;  //!< the sample times of the last run
+  ensembleStats stats;  //!< statistics of the last run
+  double samplePeriod = 1.0;  //!< the interval between the sample times
+  step_control stepControl = step_control::lockstep;  //!< the step control
+  bool parallel = true;  //!< run the variants in parallel
+
+  int prepare (variant &var, index_t index);
+  void advance (variant &var, index_t sample);
+  void record (variant &var, index_t sample);
+};
+
+#endif
@@ -0,0 +1,377 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "federationCoordinator.h"
+#include "gridDyn.h"
+#include "objectInterpreter.h"
+
+#include <algorithm>
+
+federationCoordinator::federationCoordinator ()
+{
+}
+
+federationCoordinator::~federationCoordinator ()
+{
+  stopWorkers ();
+}
+
+index_t federationCoordinator::addFederate (std::shared_ptr<gridDynSimulation> sim, federate_mode mode)
+{
+  auto fd = std::unique_ptr<federate> (new federate);
+  fd->sim = sim;
+  fd->mode = mode;
+  feds.push_back (std::move (fd));
+  return static_cast<index_t> (feds.size () - 1);
+}
+
+void federationCoordinator::setMaxStep (index_t fed, double maxStep)
+{
+  if ((fed < feds.size ()) && (maxStep > 0))
+    {
+      feds[fed]->maxStep = maxStep;
+    }
+}
+
+int federationCoordinator::addLink (index_t source, const std::string &sourceField, index_t dest, const std::string &destField, double latency)
+{
+  if ((source >= feds.size ()) || (dest >= feds.size ()) || (latency < 0.0))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  valueLink lnk;
+  lnk.source = source;
+  lnk.sourceField = sourceField;
+  lnk.dest = dest;
+  lnk.destField = destField;
+  lnk.latency = latency;
+  links.push_back (lnk);
+  feds[source]->lookahead = (std::min)(feds[source]->lookahead, latency);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int federationCoordinator::send (const federateMessage &message)
+{
+  if (message.destination >= feds.size ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::lock_guard<std::mutex> lock (queueLock);
+  auto &fd = *feds[message.destination];
+  if (message.deliveryTime < fd.grantTime - kSmallTime)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  auto loc = std::upper_bound (fd.inbox.begin (), fd.inbox.end (), message, [](const federateMessage &m1, const federateMessage &m2) {
+    return (m1.deliveryTime < m2.deliveryTime);
+  });
+  fd.inbox.insert (loc, message);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+double federationCoordinator::getFederateTime (index_t fed) const
+{
+  return (fed < feds.size ()) ? feds[fed]->currentTime : kNullVal;
+}
+
+double federationCoordinator::getLookahead (index_t fed) const
+{
+  return (fed < feds.size ()) ? feds[fed]->lookahead : kNullVal;
+}
+
+int federationCoordinator::prepare ()
+{
+  for (auto &fd : feds)
+    {
+      auto &sim = fd->sim;
+      int ret = FUNCTION_EXECUTION_SUCCESS;
+      if (fd->mode == federate_mode::dynamic)
+        {
+          if (sim->currentProcessState () < gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED)
+            {
+              ret = sim->dynInitialize ();
+            }
+        }
+      else if (sim->currentProcessState () < gridDynSimulation::gridState_t::POWERFLOW_COMPLETE)
+        {
+          ret = sim->powerflow ();
+        }
+      if (ret != FUNCTION_EXECUTION_SUCCESS)
+        {
+          sim->log (sim.get (), GD_ERROR_PRINT, "federate failed to initialize");
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      fd->currentTime = sim->getCurrentTime ();
+      fd->grantTime = fd->currentTime;
+      fd->result = FUNCTION_EXECUTION_SUCCESS;
+    }
+  for (auto &lnk : links)
+    {
+      objInfo oi (lnk.sourceField, feds[lnk.source]->sim.get ());
+      if (!oi.m_obj)
+        {
+          auto &sim = feds[lnk.source]->sim;
+          sim->log (sim.get (), GD_ERROR_PRINT, "unable to locate federation link source " + lnk.sourceField);
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      lnk.sourceObj = oi.m_obj;
+      lnk.resolvedField = oi.m_field;
+      lnk.unitType = oi.m_unitType;
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int federationCoordinator::run (double stopTime)
+{
+  if (feds.empty ())
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  if (prepare () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  startWorkers ();
+  int ret = FUNCTION_EXECUTION_SUCCESS;
+  while (true)
+    {
+      bool done = true;
+      for (auto &fd : feds)
+        {
+          deliverMessages (*fd);
+          if (fd->currentTime < stopTime - kSmallTime)
+            {
+              done = false;
+            }
+        }
+      if (done)
+        {
+          break;
+        }
+      computeGrants (stopTime);
+      {
+        std::unique_lock<std::mutex> lock (roundLock);
+        pending = static_cast<count_t> (feds.size ());
+        ++roundNumber;
+        roundStart.notify_all ();
+        roundDone.wait (lock, [this] {
+          return (pending == 0);
+        });
+      }
+      ++stats.rounds;
+      for (auto &fd : feds)
+        {
+          if (fd->result < FUNCTION_EXECUTION_SUCCESS)
+            {
+              fd->sim->log (fd->sim.get (), GD_ERROR_PRINT, "federate failed to advance to granted time");
+              ret = FUNCTION_EXECUTION_FAILURE;
+            }
+        }
+      if (ret != FUNCTION_EXECUTION_SUCCESS)
+        {
+          break;
+        }
+      sampleLinks ();
+    }
+  stopWorkers ();
+  return ret;
+}
+
+double federationCoordinator::requestTime (const federate &fd, double stopTime) const
+{
+  double req = (std::min)(stopTime, fd.currentTime + fd.maxStep);
+  double evTime = fd.sim->getEventTime ();
+  if (evTime > fd.currentTime + kSmallTime)
+    {
+      req = (std::min)(req, evTime);
+    }
+  for (auto &msg : fd.inbox)
+    {
+      if (msg.deliveryTime > fd.currentTime + kSmallTime)
+        {
+          req = (std::min)(req, msg.deliveryTime);
+          break;
+        }
+    }
+  return req;
+}
+
+void federationCoordinator::computeGrants (double stopTime)
+{
+  std::vector<double> req (feds.size ());
+  for (size_t kk = 0; kk < feds.size (); ++kk)
+    {
+      req[kk] = requestTime (*feds[kk], stopTime);
+    }
+  bool progress = false;
+  for (size_t kk = 0; kk < feds.size (); ++kk)
+    {
+      double grant = req[kk];
+      for (auto &lnk : links)
+        {
+          if ((lnk.dest == kk) && (lnk.source != kk))
+            {
+              grant = (std::min)(grant, feds[lnk.source]->currentTime + lnk.latency);
+            }
+        }
+      feds[kk]->grantTime = (std::max)(grant, feds[kk]->currentTime);
+      if (feds[kk]->grantTime > feds[kk]->currentTime + kSmallTime)
+        {
+          progress = true;
+        }
+    }
+  if (!progress)
+    {
+      //zero lookahead somewhere in the federation so advance everyone together over the smallest requested window
+      double window = kBigNum;
+      for (size_t kk = 0; kk < feds.size (); ++kk)
+        {
+          if (feds[kk]->currentTime < stopTime - kSmallTime)
+            {
+              window = (std::min)(window, req[kk]);
+            }
+        }
+      for (auto &fd : feds)
+        {
+          fd->grantTime = (std::max)(window, fd->currentTime);
+        }
+      ++stats.windowRounds;
+    }
+}
+
+void federationCoordinator::deliverMessages (federate &fd)
+{
+  std::lock_guard<std::mutex> lock (queueLock);
+  auto mend = fd.inbox.begin ();
+  while ((mend != fd.inbox.end ()) && (mend->deliveryTime <= fd.currentTime + kSmallTime))
+    {
+      objInfo oi (mend->target, fd.sim.get ());
+      if ((oi.m_obj) && (oi.m_obj->set (oi.m_field, mend->value, mend->unitType) == PARAMETER_FOUND))
+        {
+          ++stats.messagesDelivered;
+        }
+      else
+        {
+          fd.sim->log (fd.sim.get (), GD_WARNING_PRINT, "unable to deliver federation message to " + mend->target);
+          ++stats.messageErrors;
+        }
+      ++mend;
+    }
+  fd.inbox.erase (fd.inbox.begin (), mend);
+}
+
+void federationCoordinator::sampleLinks ()
+{
+  for (auto &lnk : links)
+    {
+      auto &src = *feds[lnk.source];
+      federateMessage msg;
+      msg.deliveryTime = src.currentTime + lnk.latency;
+      msg.destination = lnk.dest;
+      msg.target = lnk.destField;
+      msg.value = lnk.sourceObj->get (lnk.resolvedField, lnk.unitType);
+      msg.unitType = lnk.unitType;
+      send (msg);
+    }
+}
+
+void federationCoordinator::startWorkers ()
+{
+  count_t startRound;
+  {
+    std::lock_guard<std::mutex> lock (roundLock);
+    halt = false;
+    startRound = roundNumber;
+  }
+  //the starting round is fixed here, a worker reading it after it starts could miss the first round
+  for (auto &fd : feds)
+    {
+      fd->worker = std::thread (&federationCoordinator::workerLoop, this, fd.get (), startRound);
+    }
+}
+
+void federationCoordinator::stopWorkers ()
+{
+  {
+    std::lock_guard<std::mutex> lock (roundLock);
+    halt = true;
+  }
+  roundStart.notify_all ();
+  for (auto &fd : feds)
+    {
+      if (fd->worker.joinable ())
+        {
+          fd->worker.join ();
+        }
+    }
+}
+
+void federationCoordinator::workerLoop (federate *fd, count_t startRound)
+{
+  count_t lastRound = startRound;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (roundLock);
+        roundStart.wait (lock, [this, lastRound] {
+          return ((halt) || (roundNumber != lastRound));
+        });
+        if (halt)
+          {
+            return;
+          }
+        lastRound = roundNumber;
+      }
+      if (fd->grantTime > fd->currentTime + kSmallTime)
+        {
+          advance (*fd);
+        }
+      std::lock_guard<std::mutex> lock (roundLock);
+      --pending;
+      if (pending == 0)
+        {
+          roundDone.notify_one ();
+        }
+    }
+}
+
+void federationCoordinator::advance (federate &fd)
+{
+  auto &sim = fd.sim;
+  if (fd.mode == federate_mode::event_driven)
+    {
+      fd.result = sim->eventDrivenPowerflow (fd.grantTime);
+      if (fd.result >= FUNCTION_EXECUTION_SUCCESS)
+        {
+          fd.currentTime = fd.grantTime;
+        }
+      return;
+    }
+  double actual = fd.currentTime;
+  //the step function may return early at internal stopping points so keep going until the grant is reached
+  while (actual < fd.grantTime - kSmallTime)
+    {
+      double prev = actual;
+      fd.result = sim->step (fd.grantTime, actual);
+      if (fd.result < FUNCTION_EXECUTION_SUCCESS)
+        {
+          break;
+        }
+      if (actual <= prev)
+        {
+          fd.result = FUNCTION_EXECUTION_FAILURE;
+          break;
+        }
+    }
+  fd.currentTime = actual;
+}
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_FEDERATION_COORDINATOR_H_
+#define GRIDDYN_FEDERATION_COORDINATOR_H_
+
+#include "basicDefs.h"
+#include "gridDynTypes.h"
+#include "units.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class gridDynSimulation;
+class gridCoreObject;
+
+/** @brief a value message passed between federates
+ the message is applied to the destination federate through a set call on the object and field named in the target string
+*/
+class federateMessage
+{
+public:
+  double deliveryTime = 0.0;  //!< [s] the simulation time the message becomes visible to the destination
+  index_t destination = kNullLocation;  //!< the index of the destination federate
+  std::string target;  //!< object:field string interpreted in the destination federate
+  double value = 0.0;  //!< the value to set
+  gridUnits::units_t unitType = gridUnits::defUnit;  //!< the units of the value
+};
+
+/** @brief in process coordinator for a set of gridDyn simulations running concurrently
+ each federate runs on its own thread and is granted time in rounds using conservative lookahead
+the grant for a federate is the minimum of its own requested time (next event, next message, or step boundary) and
+the earliest time any other federate could produce a message for it (its current time plus its outgoing latency)
+messages are exchanged between rounds while all federates are idle so no object is ever touched from two threads
+If all latencies are zero the coordinator falls back to a synchronous time window where all federates advance to the
+minimum requested time together, matching the behavior of a granted time window scheduler
+Federates share some process wide state while they advance concurrently.  Object ids come from an atomic counter and
+console output from all simulations is serialized by the logger, but the per type counters used to assign automatic
+user ids (buses, links, generators, areas, relays) are not synchronized, so all objects should be created before run is
+called and events which construct new objects should not be used in federates.
+*/
+class federationCoordinator
+{
+public:
+  /** @brief federate execution modes*/
+  enum class federate_mode
+  {
+    dynamic,  //!< advance using the dynamic step function
+    event_driven,  //!< advance using the event driven power flow
+  };
+
+  /** @brief statistics from the coordination*/
+  class coordinationStats
+  {
+public:
+    count_t rounds = 0;  //!< the number of grant rounds executed
+    count_t windowRounds = 0;  //!< the number of rounds which required the synchronous window fallback
+    count_t messagesDelivered = 0;  //!< the number of messages applied to destination federates
+    count_t messageErrors = 0;  //!< the number of messages whose target could not be resolved
+  };
+
+  federationCoordinator ();
+  ~federationCoordinator ();
+  federationCoordinator (const federationCoordinator &) = delete;
+  federationCoordinator &operator= (const federationCoordinator &) = delete;
+
+  /** @brief add a simulation to the federation
+  @param[in] sim the simulation to add
+  @param[in] mode the mode the federate should be advanced with
+  @return the index of the federate in the federation
+  */
+  index_t addFederate (std::shared_ptr<gridDynSimulation> sim, federate_mode mode = federate_mode::dynamic);
+
+  /** @brief set the maximum step a federate takes in a single grant if it has no events
+  @param[in] fed the federate index
+  @param[in] maxStep the maximum step [s]
+  */
+  void setMaxStep (index_t fed, double maxStep);
+
+  /** @brief add a periodic value link between two federates
+   the source field is sampled at the end of every grant of the source federate and delivered to the destination after
+  latency seconds
+  @param[in] source the index of the sending federate
+  @param[in] sourceField object:field string in the sending federate
+  @param[in] dest the index of the receiving federate
+  @param[in] destField object:field string in the receiving federate
+  @param[in] latency the communication delay of the link [s], the minimum latency on the links out of a federate is its lookahead
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if either federate is unknown or latency is negative
+  */
+  int addLink (index_t source, const std::string &sourceField, index_t dest, const std::string &destField, double latency);
+
+  /** @brief send a message to a federate
+   this function is thread safe and may be called from objects running inside a federate
+  the message must not be timestamped earlier than the destination has been granted
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the destination is unknown or the message is in the past of the destination
+  */
+  int send (const federateMessage &message);
+
+  /** @brief run all federates to a stop time
+  @param[in] stopTime the time to run to
+  @return FUNCTION_EXECUTION_SUCCESS if all federates reached the stop time or FUNCTION_EXECUTION_FAILURE
+  */
+  int run (double stopTime);
+
+  /** @brief get the time a federate has advanced to*/
+  double getFederateTime (index_t fed) const;
+  /** @brief get the lookahead of a federate, the minimum latency on its outgoing links*/
+  double getLookahead (index_t fed) const;
+  /** @brief get the number of federates*/
+  count_t federateCount () const
+  {
+    return static_cast<count_t> (feds.size ());
+  }
+  const coordinationStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  class valueLink
+  {
+public:
+    index_t source;
+    std::string sourceField;
+    index_t dest;
+    std::string destField;
+    double latency;
+    gridCoreObject *sourceObj = nullptr;  //!< resolved source object
+    std::string resolvedField;  //!< resolved source field
+    gridUnits::units_t unitType = gridUnits::defUnit;  //!< units of the sampled value
+  };
+  class federate
+  {
+public:
+    std::shared_ptr<gridDynSimulation> sim;
+    federate_mode mode = federate_mode::dynamic;
+    double currentTime = 0.0;
+    double grantTime = 0.0;
+    double maxStep = kBigNum;
+    double lookahead = kBigNum;
+    std::vector<federateMessage> inbox;  //!< pending messages sorted by delivery time
+    std::thread worker;
+    int result = FUNCTION_EXECUTION_SUCCESS;
+  };
+
+  std::vector<std::unique_ptr<federate> > feds;
+  std::vector<valueLink> links;
+  coordinationStats stats;
+
+  std::mutex queueLock;  //!< protects the inboxes during a round
+  std::mutex roundLock;  //!< protects the round counters
+  std::condition_variable roundStart;
+  std::condition_variable roundDone;
+  count_t roundNumber = 0;
+  count_t pending = 0;
+  bool halt = false;
+
+  double requestTime (const federate &fd, double stopTime) const;
+  void computeGrants (double stopTime);
+  void deliverMessages (federate &fd);
+  void sampleLinks ();
+  int prepare ();
+  void startWorkers ();
+  void stopWorkers ();
+  void workerLoop (federate *fd, count_t startRound);
+  void advance (federate &fd);
+};
+
+#endif
@@ -22,6 +22,13 @@
 #include "faultResetRecovery.h"
 #include "dynamicInitialConditionRecovery.h"
 #include "simulation/diagnostics.h"
+#include "residualDeltaEvaluator.h"
+#include "realTimePacer.h"
+#include "trajectorySensitivity.h"
+#include "networkAdmittance.h"
+#include "rollbackBuffer.h"
+#include "residualValidator.h"
+#include "partitionedCoupling.h"
 #include "arrayData.h"
 //system libraries
 #include <algorithm>
@@ -151,6 +158,13 @@ int gridDynSimulation::dynInitialize (double tStart)
 int gridDynSimulation::runDynamicSolverStep (std::shared_ptr<solverInterface> &dynData, double nextStop, double &timeAct)
 {
   int retval = FUNCTION_EXECUTION_SUCCESS;
+  realTimePacer::sectionTimer solverTimer (pacer, realTimePacer::frame_section::solver);
+  //sensitivities follow the DAE solution only
+  bool trackSensitivity = ((sensitivity) && (isDAE (dynData->getSolverMode ())));
+  if (trackSensitivity)
+    {
+      sensitivity->beginStep (timeAct, dynData->getSolverMode ());
+    }
   if (controlFlags[single_step_mode])
     {
       while ((timeAct + tols.timeTol < nextStop) && (retval == FUNCTION_EXECUTION_SUCCESS))
@@ -162,12 +176,20 @@ int gridDynSimulation::runDynamicSolverStep (std::shared_ptr<solverInterface> &d
                 {
                   sso->setState (timeAct, dynData->state_data (), dynData->deriv_data (), dynData->getSolverMode ());
                 }
+              if (trackSensitivity)
+                {
+                  sensitivity->advance (timeAct, dynData->state_data (), dynData->deriv_data ());
+                }
             }
         }
     }
   else
     {
       retval = dynData->solve (nextStop, timeAct);
+      if ((retval == FUNCTION_EXECUTION_SUCCESS) && (trackSensitivity))
+        {
+          sensitivity->advance (timeAct, dynData->state_data (), dynData->deriv_data ());
+        }
     }
   if (retval != FUNCTION_EXECUTION_SUCCESS)
     {
@@ -267,7 +289,7 @@ int gridDynSimulation::dynamicDAE ( double tStop)
       return retval;
     }
 
-  nextStopTime = std::min (tStop, EvQ->getNextTime ());
+  nextStopTime = std::min (tStop, checkRollbackCapture ());
   //go into the main loop
   int smStep = 0;
   while (timeReturn < tStop)
@@ -356,7 +378,7 @@ int gridDynSimulation::dynamicDAE ( double tStop)
               return FUNCTION_EXECUTION_FAILURE;
             }
         }
-      nextStopTime = EvQ->getNextTime ();
+      nextStopTime = checkRollbackCapture ();
     }
   if ((consolePrintLevel >= GD_TRACE_PRINT)||(logPrintLevel >= GD_TRACE_PRINT))
     {
@@ -451,6 +473,11 @@ int gridDynSimulation::dynamicPartitioned (double tStop, double tStep)
 
   int tstep = 0;
   int retval = dynamicPartitionedStartupConditions (dynDataDiff, dynDataAlg, sModeDiff, sModeAlg);
+  bool coupled = ((coupling) && (coupling->isActive ()));
+  if (coupled)
+    {
+      coupling->reset ();
+    }
 
   //go into the main loop
   int smStep = 0;
@@ -475,7 +502,12 @@ int gridDynSimulation::dynamicPartitioned (double tStop, double tStep)
                 }
               dynDataAlg->printResid = true;
             }
-          if (retval >= FUNCTION_EXECUTION_SUCCESS)               //can return a 1
+          if ((retval >= FUNCTION_EXECUTION_SUCCESS) && (coupled))
+            {
+              retval = coupling->advance (dynDataDiff, dynDataAlg, nextStopTime, timeReturn);
+              timeCurr = timeReturn;
+            }
+          else if (retval >= FUNCTION_EXECUTION_SUCCESS)               //can return a 1
             {
               retval = runDynamicSolverStep (dynDataDiff, nextStopTime, timeReturn);
               timeCurr = timeReturn;
@@ -495,7 +527,16 @@ int gridDynSimulation::dynamicPartitioned (double tStop, double tStep)
               LOG_ERROR (dynDataDiff->getLastErrorString ());
               return FUNCTION_EXECUTION_FAILURE;
             }
-          retval = runDynamicSolverStep (dynDataDiff, nextStopTime, timeReturn);
+          if (coupled)
+            {
+              //the step was interrupted so the extrapolation history no longer applies
+              coupling->reset ();
+              retval = coupling->advance (dynDataDiff, dynDataAlg, nextStopTime, timeReturn);
+            }
+          else
+            {
+              retval = runDynamicSolverStep (dynDataDiff, nextStopTime, timeReturn);
+            }
           timeCurr = timeReturn;
 
           // CSW Changed this from 2e-3 to 1e-7: need to rethink this in light of rootfinding
@@ -545,6 +586,10 @@ int gridDynSimulation::dynamicPartitioned (double tStop, double tStep)
           auto ret = EvQ->executeEvents (timeCurr);
           if (ret > change_code::non_state_change)
             {
+              if (coupled)
+                {
+                  coupling->reset ();
+                }
               dynamicCheckAndReset (sModeDiff);
               retval = generatePartitionedDynamicInitialConditions (sModeAlg,sModeDiff);
               if (retval != FUNCTION_EXECUTION_SUCCESS)
@@ -555,7 +600,7 @@ int gridDynSimulation::dynamicPartitioned (double tStop, double tStep)
                   return FUNCTION_EXECUTION_FAILURE;
                 }
             }
-          nextEventTime = EvQ->getNextTime ();
+          nextEventTime = checkRollbackCapture ();
         }
       if (nextStepTime - tols.timeTol < timeCurr)
         {
@@ -707,7 +752,7 @@ int gridDynSimulation::step (double nextStep, double &timeActual)
       //transmit the current state to the various objects for updates and recorders
       setState (timeCurr, dynData->state_data (), dynData->deriv_data (), sm);
 
-      auto ret = EvQ->executeEvents (timeCurr);
+      auto ret = (pacer) ? executeTimedEvents (timeCurr) : EvQ->executeEvents (timeCurr);
       if (ret > change_code::no_change)
         {
           dynamicCheckAndReset (sm);
@@ -724,10 +769,26 @@ int gridDynSimulation::step (double nextStep, double &timeActual)
   return retval;
 }
 
+change_code gridDynSimulation::executeTimedEvents (double time)
+{
+  //same sequence as eventQueue::executeEvents,  recorders are delayed events so they run in the second part
+  change_code ret;
+  {
+    realTimePacer::sectionTimer eventTimer (pacer, realTimePacer::frame_section::events);
+    ret = EvQ->executeEventsAonly (time);
+  }
+  realTimePacer::sectionTimer recorderTimer (pacer, realTimePacer::frame_section::recorders);
+  auto eret = EvQ->executeEventsBonly (time);
+  return (std::max)(ret, eret);
+}
+
 void gridDynSimulation::handleEarlySolverReturn (int retval, double time, std::shared_ptr<solverInterface> &dynData)
 {
   ++haltCount;
-
+  if (deltaEval)
+    {
+      deltaEval->clearReference ();
+    }
   if (opFlags[has_roots])
     {
       if (retval == SOLVER_ROOT_FOUND)             // a root was found in IDASolve
@@ -761,9 +822,24 @@ void gridDynSimulation::handleEarlySolverReturn (int retval, double time, std::s
     }
 }
 
+double gridDynSimulation::checkRollbackCapture ()
+{
+  if (!rollback)
+    {
+      return EvQ->getNextTime ();
+    }
+  rollback->checkCapture (timeCurr);
+  return std::min (EvQ->getNextTime (), rollback->getNextCaptureTime ());
+}
+
 bool gridDynSimulation::dynamicCheckAndReset (const solverMode &sMode, change_code change)
 {
   auto dynData = getSolverInterface (sMode);
+  if (deltaEval)
+    {
+      //something other than the states changed so the stored residual is no longer valid
+      deltaEval->clearReference ();
+    }
   if (opFlags[connectivity_change_flag])
     {
       checkNetwork (network_check_type::simplified);
@@ -993,6 +1069,10 @@ int gridDynSimulation::handleStateChange (const solverMode &sMode)
 
 void gridDynSimulation::handleRootChange (const solverMode &sMode, std::shared_ptr<solverInterface> &dynData)
 {
+  if (deltaEval)
+    {
+      deltaEval->clearReference ();
+    }
   if (opFlags[root_change_flag])               //something with the roots changed
     {
       auto rs = rootSize (sMode);
@@ -1036,10 +1116,18 @@ void gridDynSimulation::updateOffsets (const solverMode &sMode)
 {
   setupOffsets (sMode, default_ordering);
   setMaxNonZeros (sMode, jacSize (sMode));
+  if (deltaEval)
+    {
+      deltaEval->invalidate (sMode);
+    }
 }
 
 int gridDynSimulation::reInitDyn (const solverMode &sMode)
 {
+  if (deltaEval)
+    {
+      deltaEval->clearReference ();
+    }
   auto dynData = getSolverInterface (sMode);
   updateOffsets (sMode);
 
@@ -1086,8 +1174,6 @@ int gridDynSimulation::reInitDyn (const solverMode &sMode)
 
 
 #define DEBUG_RESID 0
-#define CHECK_RESID 1
-#define CHECK_STATE 1
 
 #if DEBUG_RESID > 0
 const static double resid_print_tol = 1e-7;
@@ -1097,23 +1183,26 @@ int gridDynSimulation::residualFunction (double ttime, const double state[], con
 {
   ++residCount;
   stateData sD (ttime, state,dstate_dt,residCount);
-
-#if (CHECK_STATE > 0)
-  auto dynDataa = getSolverInterface (sMode);
-  for (size_t kk = 0; kk < dynDataa->size (); ++kk)
+  if (!validator->checkState (ttime, state, sMode))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  fillExtraStateData (&sD, sMode);
+  if (controlFlags[delta_residual_evaluation])
     {
-      if (!std::isfinite (state[kk]))
+      if (!deltaEval)
         {
-          LOG_ERROR ("state[" + std::to_string (kk) + "] is not finite");
-		  printStateNames(this,sMode);
-          return FUNCTION_EXECUTION_FAILURE;
+          deltaEval = std::unique_ptr<residualDeltaEvaluator> (new residualDeltaEvaluator (this));
+          deltaEval->setTolerance (deltaResidualTolerance);
+        }
+      if (deltaEval->residual (&sD, resid, sMode))
+        {
+          return (validator->checkResult (ttime, state, resid, sMode)) ? FUNCTION_EXECUTION_SUCCESS : 1;
         }
     }
-#endif
-
-  fillExtraStateData (&sD, sMode);
   //call the area based function to handle the looping
   preEx (&sD, sMode);
+  networkEvaluation (&sD, sMode);
   residual (&sD, resid, sMode);
   delayedResidual (&sD, resid, sMode);
  // if (sourceFile == "case2383wp.m") //active debugging
@@ -1122,18 +1211,12 @@ int gridDynSimulation::residualFunction (double ttime, const double state[], con
 	 // updateLocalCache();
 	 // saveBusData(this, "BusData"+std::to_string(residCount)+".csv");
  // }
-#if (CHECK_RESID > 0)
-  auto dynDatab = getSolverInterface (sMode);
-  for (size_t kk = 0; kk < dynDatab->size (); ++kk)
+  if (!validator->checkResult (ttime, state, resid, sMode))
     {
-      if (!std::isfinite (resid[kk]))
-        {
-          LOG_ERROR ("resid[" + std::to_string (kk) + "] is not finite");
-          printStateNames (this, sMode);
-          assert (std::isfinite (resid[kk]));
-        }
+      //a non-finite residual from a finite state is a recoverable failure so the solver can cut the step
+      opFlags.reset (invalid_state_flag);
+      return 1;
     }
-#endif
 
 #if (DEBUG_RESID >= 1)
   static std::vector<double> rvals;
@@ -1236,23 +1319,16 @@ int gridDynSimulation::derivativeFunction (double ttime, const double state[], d
   ++residCount;
   stateData sD (ttime,state,dstate_dt,residCount);
   fillExtraStateData (&sD, sMode);
-#if (CHECK_STATE > 0)
-  auto dynDataa = getSolverInterface (sMode);
-  for (size_t kk = 0; kk < dynDataa->size (); ++kk)
+  if (!validator->checkState (ttime, state, sMode))
     {
-      if (!std::isfinite (state[kk]))
-        {
-          LOG_ERROR ("state[" + std::to_string (kk) + "] is not finite");
-          return FUNCTION_EXECUTION_FAILURE;
-        }
+      return FUNCTION_EXECUTION_FAILURE;
     }
-#endif
 
   //call the area based function to handle the looping
   preEx (&sD, sMode);
   derivative (&sD, dstate_dt, sMode);
   delayedDerivative (&sD, dstate_dt, sMode);
-  return FUNCTION_EXECUTION_SUCCESS;
+  return (validator->checkResult (ttime, state, dstate_dt, sMode)) ? FUNCTION_EXECUTION_SUCCESS : 1;
 }
 
 // Jacobian computation
@@ -1265,6 +1341,7 @@ int gridDynSimulation::jacobianFunction (double ttime, const double state[], con
   fillExtraStateData (&sD, sMode);
   //the area function to evaluate the Jacobian elements
   preEx (&sD, sMode);
+  networkEvaluation (&sD, sMode);
   ad->clear ();
   jacobianElements (&sD, ad, sMode);
   delayedJacobian (&sD, ad, sMode);
@@ -1273,6 +1350,25 @@ int gridDynSimulation::jacobianFunction (double ttime, const double state[], con
 }
 
 
+void gridDynSimulation::networkEvaluation (const stateData *sD, const solverMode &sMode)
+{
+  if (!controlFlags[assembled_network])
+    {
+      if (network)
+        {
+          //detach the buses before dropping the model so they go back to the link objects
+          network->clear ();
+          network = nullptr;
+        }
+      return;
+    }
+  if (!network)
+    {
+      network = std::unique_ptr<networkAdmittance> (new networkAdmittance (this));
+    }
+  network->evaluate (sD, sMode);
+}
+
 int gridDynSimulation::rootFindingFunction (double ttime, const double state[], const double dstate_dt[], double roots[], const solverMode &sMode)
 {
   stateData sD (ttime,state,dstate_dt,residCount);
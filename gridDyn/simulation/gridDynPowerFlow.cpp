@@ -20,6 +20,8 @@
 #include "solvers/solverInterface.h"
 #include "simulation/diagnostics.h"
 #include "powerFlowErrorRecovery.h"
+#include "powerFlowCache.h"
+#include "branchOutageScreening.h"
 #include "gridDynSimulationFileOps.h"
 
 #include "continuation.h"
@@ -52,6 +54,25 @@ int gridDynSimulation::powerflow ()
   //Create the error recovery object to use if necessary
   powerFlowErrorRecovery pfer (this, pFlowData);
 
+  bool useCache = (controlFlags[powerflow_cache_enabled]) && (pFlowData->size () > 0);
+  bool loadCachedState = false;
+  double startEvaluations = 0.0;
+  if (useCache)
+    {
+      if (!pfCache)
+        {
+          pfCache = std::unique_ptr<powerFlowCache> (new powerFlowCache (this));
+        }
+      auto cacheResult = pfCache->lookup (sm);
+      if (pfCache->settingsChanged ())
+        {
+          reInitpFlow (sm, change_code::jacobian_change);
+        }
+      loadCachedState = (cacheResult != powerFlowCache::cache_result::miss);
+      LOG_DEBUG ("power flow cache " + std::string ((cacheResult == powerFlowCache::cache_result::miss) ? "miss" : ((cacheResult == powerFlowCache::cache_result::exact) ? "exact hit" : "blended hit")));
+      startEvaluations = pFlowData->get ("funccallcount");
+    }
+
   if (pFlowData->size () > 0)        //handle the condition when all buses are swing buses hence nothing to solve
     {
       power_iteration_count = 0;
@@ -71,6 +92,12 @@ int gridDynSimulation::powerflow ()
           do
             {
               guess (timeCurr, pFlowData->state_data (), nullptr,sm);
+              //the cached start only applies to the first solve,  later passes start from the adjusted solution
+              if (loadCachedState)
+                {
+                  pfCache->loadState (pFlowData->state_data (), pFlowData->size ());
+                  loadCachedState = false;
+                }
 
               // solve
               retval = pFlowData->solve (timeCurr, timeCurr);
@@ -198,6 +225,13 @@ int gridDynSimulation::powerflow ()
         {
           pFlowData->logSolverStats (GD_TRACE_PRINT);
         }
+      if (useCache)
+        {
+          double evaluations = pFlowData->get ("funccallcount");
+          //the count restarts if the solver was reinitialized during the solution
+          evaluations = (evaluations >= startEvaluations) ? evaluations - startEvaluations : evaluations;
+          pfCache->store (pFlowData->state_data (), pFlowData->size (), evaluations);
+        }
 
     }
   else
@@ -434,6 +468,39 @@ bool gridDynSimulation::loadBalance (double prevPower, const std::vector<double>
 
 void gridDynSimulation::contingencyAnalysis (contingency_mode_t mode)
 {
+  if (mode == contingency_mode_t::N_1)
+    {
+      //single branch outages are screened against the base factorization instead of solving each case from scratch
+      branchOutageScreening screening (this);
+      if (screening.screen () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          LOG_WARNING ("N-1 screening requires a solved power flow");
+          return;
+        }
+      count_t islanded = 0;
+      count_t failed = 0;
+      for (auto &res : screening.getResults ())
+        {
+          if (res.islanded)
+            {
+              ++islanded;
+              LOG_NORMAL ("outage of " + res.name + " islands part of the network");
+            }
+          else if (!res.converged)
+            {
+              ++failed;
+              LOG_WARNING ("outage of " + res.name + " did not converge");
+            }
+          else
+            {
+              LOG_DEBUG ("outage of " + res.name + " minimum voltage " + std::to_string (res.minVoltage));
+            }
+        }
+      const auto &stats = screening.getSolverStats ();
+      LOG_SUMMARY ("N-1 screening of " + std::to_string (screening.getResults ().size ()) + " outages, " + std::to_string (islanded) + " islanding, "
+                   + std::to_string (failed) + " not converged, " + std::to_string (stats.baseFactorizations + stats.refactorizations) + " factorizations");
+      return;
+    }
 #ifdef USE_THREADS
 #else
   //no threads
@@ -16,6 +16,7 @@
 #include "eventQueue.h"
 #include "loadModels/gridLabDLoad.h"
 #include "gridBus.h"
+#include "generators/gridDynGenerator.h"
 #include "objectFactoryTemplates.h"
 #include "griddyn-tracer.h"
 #include "objectInterpreter.h"
@@ -23,6 +24,17 @@
 #include "stringOps.h"
 #include "gridDynSimulationFileOps.h"
 #include "gridCoreTemplates.h"
+#include "residualDeltaEvaluator.h"
+#include "powerFlowCache.h"
+#include "trajectorySensitivity.h"
+#include "networkAdmittance.h"
+#include "rollbackBuffer.h"
+#include "partitionedCoupling.h"
+#include "objectRegistry.h"
+#include "jacobianPatternCache.h"
+#include "residualValidator.h"
+#include "diagnostics.h"
+#include "solvers/sparseLU.h"
 
 #include <cstdio>
 #include <iostream>
@@ -43,7 +55,34 @@ gridDynSimulation::gridDynSimulation (const std::string &objName) : gridSimulati
 #ifndef KLU_ENABLE
   controlFlags.set (dense_solver);
 #endif
+  registry = std::unique_ptr<objectRegistry> (new objectRegistry (this));
+  validator = std::unique_ptr<residualValidator> (new residualValidator (this));
+}
+
+gridDynSimulation::~gridDynSimulation ()
+{
+}
 
+std::shared_ptr<const sparsePattern> gridDynSimulation::getJacobianPattern (const solverMode &sMode)
+{
+  if (!jacPatterns)
+    {
+      jacPatterns = std::unique_ptr<jacobianPatternCache> (new jacobianPatternCache (this));
+    }
+  return jacPatterns->getPattern (sMode);
+}
+
+void gridDynSimulation::shareJacobianPatterns (const gridDynSimulation *source)
+{
+  if ((source == nullptr) || (!source->jacPatterns))
+    {
+      return;
+    }
+  if (!jacPatterns)
+    {
+      jacPatterns = std::unique_ptr<jacobianPatternCache> (new jacobianPatternCache (this));
+    }
+  jacPatterns->adopt (*(source->jacPatterns));
 }
 
 void gridDynSimulation::setInstance (gridDynSimulation* s)
@@ -72,6 +111,10 @@ gridCoreObject *gridDynSimulation::clone (gridCoreObject *obj) const
   sim->powerAdjustThreshold = powerAdjustThreshold;  
   sim->powerFlowStartTime = powerFlowStartTime;     
   sim->tols = tols;
+  sim->deltaResidualTolerance = deltaResidualTolerance;
+  sim->validator->setPeriod (validator->getPeriod ());
+  sim->validator->setWindow (validator->getWindow ());
+  sim->validator->setReportLimit (validator->getReportLimit ());
 
 
   sim->default_ordering = default_ordering; 
@@ -727,8 +770,35 @@ int gridDynSimulation::execute (const gridDynAction &cmd)
       break;
 
     case gridDynAction::gd_action_t::rollback:
+      if (!rollback)
+        {
+          LOG_WARNING ("no checkpoints available for rollback");
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      out = (cmd.val_double != kNullVal) ? rollback->restore (cmd.val_double) : rollback->restore (cmd.string1);
+      if (out != FUNCTION_EXECUTION_SUCCESS)
+        {
+          LOG_WARNING ("unable to restore checkpoint " + ((cmd.val_double != kNullVal) ? std::to_string (cmd.val_double) : cmd.string1));
+        }
       break;
     case gridDynAction::gd_action_t::checkpoint:
+      if (!rollback)
+        {
+          rollback = std::unique_ptr<rollbackBuffer> (new rollbackBuffer (this));
+        }
+      if (cmd.val_double != kNullVal)
+        {
+          //a numerical argument sets the period of the automatic checkpoints
+          rollback->setPeriod (cmd.val_double);
+        }
+      else
+        {
+          out = rollback->capture (cmd.string1);
+          if (out != FUNCTION_EXECUTION_SUCCESS)
+            {
+              LOG_WARNING ("checkpoints require an initialized dynamic simulation");
+            }
+        }
       break;
     }
   return out;
@@ -772,6 +842,22 @@ int gridDynSimulation::set (const std::string &param, const std::string &val)
     {
       out = setDefaultMode (solution_modes_t::differential_mode, getSolverMode (val));
     }
+  else if ((param == "sensitivity") || (param == "sensitivityparameter"))
+    {
+      if (!sensitivity)
+        {
+          sensitivity = std::unique_ptr<trajectorySensitivity> (new trajectorySensitivity (this));
+        }
+      auto v = splitlineTrim (val, ';');
+      for (auto &paramString : v)
+        {
+          if (sensitivity->addParameter (paramString) != FUNCTION_EXECUTION_SUCCESS)
+            {
+              LOG_WARNING ("unable to locate sensitivity parameter " + paramString);
+              out = INVALID_PARAMETER_VALUE;
+            }
+        }
+    }
   else if (param == "action")
     {
       auto v = splitlineTrim (val, ';');
@@ -963,6 +1049,9 @@ std::map<std::string, int> flagControlMap
   {"low_voltage_check",low_voltage_checking},
   {"no_powerflow_error_recovery",no_powerflow_error_recovery},
   {"dae_initialization_for_partitioned",	dae_initialization_for_partitioned },
+  {"delta_residual",delta_residual_evaluation},
+  {"powerflow_cache",powerflow_cache_enabled},
+  {"assembled_network",assembled_network},
 };
 
 /* *INDENT-ON* */
@@ -1058,6 +1147,133 @@ int gridDynSimulation::set (const std::string &param, double val, gridUnits::uni
     {
       max_Vadjust_iterations = static_cast<count_t> (val);
     }
+  else if (param == "deltaresidualtolerance")
+    {
+      if (val < 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      deltaResidualTolerance = val;
+      if (deltaEval)
+        {
+          deltaEval->setTolerance (val);
+        }
+    }
+  else if ((param == "residualcheckperiod") || (param == "residualcheckwindow") || (param == "residualcheckreports"))
+    {
+      if (val < 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      if (param == "residualcheckperiod")
+        {
+          //a period of 0 turns off the checks
+          validator->setPeriod (static_cast<count_t> (val));
+        }
+      else if (param == "residualcheckwindow")
+        {
+          validator->setWindow (static_cast<count_t> (val));
+        }
+      else
+        {
+          validator->setReportLimit (static_cast<count_t> (val));
+        }
+    }
+  else if (param == "jacobianpatternderivation")
+    {
+      if (!jacPatterns)
+        {
+          jacPatterns = std::unique_ptr<jacobianPatternCache> (new jacobianPatternCache (this));
+        }
+      jacPatterns->setDerivation (val > 0.1);
+    }
+  else if (param == "sensitivityperturbation")
+    {
+      if (val <= 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      if (!sensitivity)
+        {
+          sensitivity = std::unique_ptr<trajectorySensitivity> (new trajectorySensitivity (this));
+        }
+      sensitivity->setPerturbation (val);
+    }
+  else if ((param == "rollbackperiod") || (param == "rollbackcapacity") || (param == "rollbackfullinterval"))
+    {
+      if (val < 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      if (!rollback)
+        {
+          rollback = std::unique_ptr<rollbackBuffer> (new rollbackBuffer (this));
+        }
+      if (param == "rollbackperiod")
+        {
+          rollback->setPeriod (val);
+        }
+      else if (param == "rollbackcapacity")
+        {
+          rollback->setCapacity (static_cast<count_t> (val));
+        }
+      else
+        {
+          rollback->setFullInterval (static_cast<count_t> (val));
+        }
+    }
+  else if ((param == "partitionedtolerance") || (param == "partitionediterations") || (param == "partitionedorder") || (param == "partitionedjacobianreuse"))
+    {
+      if (val < 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      if (!coupling)
+        {
+          coupling = std::unique_ptr<partitionedCoupling> (new partitionedCoupling (this));
+        }
+      if (param == "partitionedtolerance")
+        {
+          //a tolerance of 0 returns to the constant algebraic states of the plain partitioned solution
+          coupling->setTolerance (val);
+          coupling->setActive (val > 0.0);
+        }
+      else if (param == "partitionediterations")
+        {
+          coupling->setMaxIterations (static_cast<count_t> (val));
+        }
+      else if (param == "partitionedjacobianreuse")
+        {
+          coupling->setJacobianReuse (static_cast<count_t> (val));
+        }
+      else
+        {
+          coupling->setOrder (static_cast<int> (val));
+        }
+    }
+  else if ((param == "powerflowcachesize") || (param == "powerflowcachetolerance") || (param == "powerflowcacheneighbors"))
+    {
+      if (val < 0.0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      if (!pfCache)
+        {
+          pfCache = std::unique_ptr<powerFlowCache> (new powerFlowCache (this));
+        }
+      if (param == "powerflowcachesize")
+        {
+          pfCache->setCapacity (static_cast<count_t> (val));
+        }
+      else if (param == "powerflowcachetolerance")
+        {
+          pfCache->setMatchTolerance (val);
+        }
+      else
+        {
+          pfCache->setNeighbors (static_cast<count_t> (val));
+        }
+    }
   else
     {
       //out = setFlags (param, val);
@@ -1180,6 +1396,164 @@ double gridDynSimulation::get (const std::string &param, gridUnits::units_t unit
     {
       fval = powerAdjustThreshold;
     }
+  else if (param == "deltaresidualtolerance")
+    {
+      fval = deltaResidualTolerance;
+    }
+  else if (param == "residualskipfraction")
+    {
+      fval = (deltaEval) ? deltaEval->getStats ().skipFraction () : 0.0;
+    }
+  else if (param == "fullresidualcount")
+    {
+      val = (deltaEval) ? deltaEval->getStats ().fullEvaluations : 0;
+    }
+  else if (param == "residualcheckperiod")
+    {
+      val = validator->getPeriod ();
+    }
+  else if (param == "residualchecks")
+    {
+      val = validator->getStats ().checks;
+    }
+  else if (param == "residualanomalies")
+    {
+      val = validator->getStats ().anomalies;
+    }
+  else if (param == "residualanomalyindex")
+    {
+      //the index of the first located non-finite value
+      auto &anom = validator->getAnomalies ();
+      fval = (anom.empty ()) ? kNullVal : static_cast<double> (anom.front ().index);
+    }
+  else if (param == "sensitivitycount")
+    {
+      val = (sensitivity) ? sensitivity->parameterCount () : 0;
+    }
+  else if (param == "sensitivitysteps")
+    {
+      val = (sensitivity) ? sensitivity->stepCount () : 0;
+    }
+  else if (param == "networkbuilds")
+    {
+      val = (network) ? network->getStats ().builds : 0;
+    }
+  else if (param == "networkrestamps")
+    {
+      val = (network) ? network->getStats ().restamps : 0;
+    }
+  else if (param == "networkevaluations")
+    {
+      val = (network) ? network->getStats ().evaluations : 0;
+    }
+  else if (param == "rollbacksnapshots")
+    {
+      val = (rollback) ? rollback->size () : 0;
+    }
+  else if (param == "rollbackcaptures")
+    {
+      val = (rollback) ? rollback->getStats ().captures : 0;
+    }
+  else if (param == "rollbackrestores")
+    {
+      val = (rollback) ? rollback->getStats ().restores : 0;
+    }
+  else if (param == "couplingsteps")
+    {
+      val = (coupling) ? coupling->getStats ().macroSteps : 0;
+    }
+  else if (param == "couplingrejections")
+    {
+      val = (coupling) ? coupling->getStats ().rejectedSteps : 0;
+    }
+  else if (param == "couplingiterations")
+    {
+      val = (coupling) ? coupling->getStats ().interfaceIterations : 0;
+    }
+  else if (param == "ioallocations")
+    {
+      val = static_cast<count_t> (ioVectorAllocations ());
+    }
+  else if ((param == "totalbuscount") || (param == "totalareacount") || (param == "totalrelaycount") || (param == "gencount") || (param == "loadcount"))
+    {
+      //the registry holds the flat object lists so the counts don't walk the object tree
+      objectRegistry::object_type otype = objectRegistry::object_type::bus;
+      if (param == "totalareacount")
+        {
+          otype = objectRegistry::object_type::area;
+        }
+      else if (param == "totalrelaycount")
+        {
+          otype = objectRegistry::object_type::relay;
+        }
+      else if (param == "gencount")
+        {
+          otype = objectRegistry::object_type::generator;
+        }
+      else if (param == "loadcount")
+        {
+          otype = objectRegistry::object_type::load;
+        }
+      val = registry->count (otype);
+    }
+  else if (param == "registrybuilds")
+    {
+      val = registry->getBuildCount ();
+    }
+  else if (param == "deferreddynamicmodels")
+    {
+      double cnt = 0.0;
+      for (auto &gen : registry->getObjects (objectRegistry::object_type::generator))
+        {
+          cnt += static_cast<gridDynGenerator *> (gen)->deferredModelCount ();
+        }
+      val = cnt;
+    }
+  else if (param == "internednames")
+    {
+      val = memoryReport (this).distinctNames;
+    }
+  else if (param == "objectmemorysavings")
+    {
+      //bytes per object saved by the interned names and the description and position side tables
+      val = memoryReport (this).savingsPerObject ();
+    }
+  else if (param == "jacobianpatterndiscoveries")
+    {
+      val = (jacPatterns) ? jacPatterns->getStats ().discoveries : 0;
+    }
+  else if (param == "jacobianpatternderivations")
+    {
+      val = (jacPatterns) ? jacPatterns->getStats ().derivations : 0;
+    }
+  else if (param == "jacobianpatternhits")
+    {
+      val = (jacPatterns) ? jacPatterns->getStats ().hits : 0;
+    }
+  else if (param == "jacobianpatternadoptions")
+    {
+      val = (jacPatterns) ? jacPatterns->getStats ().adoptions : 0;
+    }
+  else if (param == "powerflowcachehitrate")
+    {
+      fval = (pfCache) ? pfCache->getStats ().hitRate () : 0.0;
+    }
+  else if (param == "powerflowcachehits")
+    {
+      val = (pfCache) ? pfCache->getStats ().exactHits + pfCache->getStats ().blendedHits : 0;
+    }
+  else if (param == "powerflowcachelookups")
+    {
+      val = (pfCache) ? pfCache->getStats ().lookups : 0;
+    }
+  else if (param == "powerflowcachesize")
+    {
+      val = (pfCache) ? pfCache->size () : 0;
+    }
+  else if (param == "powerflowcachesavings")
+    {
+      fval = (pfCache) ? pfCache->getStats ().evaluationSavings () : 0.0;
+    }
   else
     {
       fval = gridSimulation::get (param, unitType);
@@ -1187,6 +1561,21 @@ double gridDynSimulation::get (const std::string &param, gridUnits::units_t unit
   return (val != kInvalidCount) ? static_cast<double> (val) : fval;
 }
 
+void gridDynSimulation::setAll (const std::string &type, std::string param, double val, gridUnits::units_t unitType)
+{
+  objectRegistry::object_type otype;
+  if (!objectRegistry::getObjectType (type, otype))
+    {
+      gridArea::setAll (type, param, val, unitType);
+      return;
+    }
+  if (otype == objectRegistry::object_type::area)
+    {
+      set (param, val, unitType);
+    }
+  registry->setAll (otype, param, val, unitType);
+}
+
 static std::map<int, size_t> alertFlags {
   std::make_pair (STATE_COUNT_CHANGE, state_change_flag),
   std::make_pair (STATE_COUNT_INCREASE, state_change_flag),
@@ -1213,6 +1602,10 @@ static std::map<int, size_t> alertFlags {
 
 void gridDynSimulation::alert (gridCoreObject *object, int code)
 {
+  if (deferAlert (object, code))
+    {
+      return;
+    }
   if ((code >= MIN_CHANGE_ALERT) && (code < MAX_CHANGE_ALERT))
     {
 
@@ -1226,7 +1619,28 @@ void gridDynSimulation::alert (gridCoreObject *object, int code)
         {
           gridSimulation::alert (object, code);
         }
-
+      if (deltaEval)
+        {
+          deltaEval->invalidate ();
+        }
+      if (network)
+        {
+          network->checkStructure ();
+        }
+      if ((rollback) && ((code == OBJECT_COUNT_CHANGE) || (code == OBJECT_COUNT_INCREASE) || (code == OBJECT_COUNT_DECREASE)))
+        {
+          //the snapshots may reference objects which no longer exist
+          rollback->clear ();
+        }
+      if ((code != FLAG_CHANGE) && (((code >= STATE_COUNT_CHANGE) && (code <= SLACK_BUS_CHANGE)) || (code == VOLTAGE_CONTROL_CHANGE)))
+        {
+          //changes in the states or the Jacobian entries of an object alter the patterns
+          ++jacobianChanges;
+          if (jacPatterns)
+            {
+              jacPatterns->invalidate ();
+            }
+        }
       gridArea::alert (object, code);
     }
   else if (code == SINGLE_STEP_REQUIRED)
@@ -1764,7 +2178,8 @@ void gridDynSimulation::fillExtraStateData (stateData *sD, const solverMode &sMo
             }
           else if (isAlgebraicOnly (pSMode))
             {
-              sD->algState = solverInterfaces[pSMode.offsetIndex]->state_data ();
+              const double *algState = solverInterfaces[pSMode.offsetIndex]->state_data ();
+              sD->algState = ((coupling) && (coupling->isActive ())) ? coupling->predict (sD->time, algState) : algState;
               sD->pairIndex = pSMode.offsetIndex;
             }
           else if (isDAE (pSMode))
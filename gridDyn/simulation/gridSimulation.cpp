@@ -23,14 +23,16 @@
 #include "generators/gridDynGenerator.h"
 #include "stringOps.h"
 #include "gridCoreList.h"
+#include "gridLogger.h"
 
 #include <map>
+#include <algorithm>
 #include <utility>
 
 #include <cstdio>
 #include <iostream>
 
-gridSimulation::gridSimulation (const std::string &objName) : gridArea (objName)
+gridSimulation::gridSimulation (const std::string &objName) : gridArea (objName), logger (new gridLogger ())
 {
   EvQ = std::make_shared<eventQueue> ();
 }
@@ -68,6 +70,8 @@ gridCoreObject *gridSimulation::clone (gridCoreObject *obj) const
   sim->pState = pState;
   sim->state_record_period = state_record_period;
   sim->consolePrintLevel = consolePrintLevel;
+  sim->logRateLimit = logRateLimit;
+  sim->logRateWindow = logRateWindow;
   sim->errorCode = errorCode;
 
 
@@ -156,6 +160,7 @@ int gridSimulation::step ()
 
 void gridSimulation::saveRecorders ()
 {
+  logger->flush ();
   int ret;
   //save the recorder files
   for (auto gr : recordList)
@@ -304,11 +309,40 @@ int gridSimulation::set (const std::string &param,  const std::string &val)
   else if (param == "logfile")
     {
       logFile = val;
-      if (logFileStream.is_open ())
+      logger->openFile (val);
+    }
+  else if (param == "logformat")
+    {
+      gridLogger::log_format fmt;
+      if (gridLogger::formatFromString (convertToLowerCase (val), fmt))
+        {
+          logger->setFormat (fmt);
+          if (!logFile.empty ())
+            {
+              //reopen the file so the stream mode matches the format
+              logger->openFile (logFile);
+            }
+        }
+      else
         {
-          logFileStream.close ();
+          out = INVALID_PARAMETER_VALUE;
+        }
+    }
+  else if (param == "logmode")
+    {
+      temp = convertToLowerCase (val);
+      if ((temp == "async") || (temp == "asynchronous"))
+        {
+          logger->setAsynchronous (true);
+        }
+      else if ((temp == "sync") || (temp == "synchronous"))
+        {
+          logger->setAsynchronous (false);
+        }
+      else
+        {
+          out = INVALID_PARAMETER_VALUE;
         }
-      logFileStream.open (val.c_str (), std::ios::out | std::ios::trunc);
     }
   else if (param == "statefile")
     {
@@ -373,6 +407,18 @@ int gridSimulation::set (const std::string &param, double val, gridUnits::units_
     {
       logPrintLevel = static_cast<int> (val);
     }
+  else if ((param == "logratelimit") || (param == "lograte"))
+    {
+      logRateLimit = (val > 0) ? static_cast<count_t> (val) : 0;
+    }
+  else if (param == "logratewindow")
+    {
+      if (val <= 0)
+        {
+          return INVALID_PARAMETER_VALUE;
+        }
+      logRateWindow = gridUnits::unitConversionTime (val, unitType, gridUnits::sec);
+    }
   else if ((param == "steptime") || (param == "step") || (param == "timestep"))
     {
       stepTime = gridUnits::unitConversionTime (val, unitType, gridUnits::sec);
@@ -385,6 +431,13 @@ int gridSimulation::set (const std::string &param, double val, gridUnits::units_
     {
       maxUpdateTime = gridUnits::unitConversionTime (val, unitType, gridUnits::sec);
     }
+  else if (param == "suspendrecorders")
+    {
+      for (auto &gr : recordList)
+        {
+          gr->set ("suspend", val);
+        }
+    }
   else if (param == "staterecordperiod")
     {
       state_record_period = gridUnits::unitConversionTime (val, unitType, gridUnits::sec);
@@ -441,7 +494,21 @@ std::shared_ptr<gridRecorder> gridSimulation::findRecorder (std::string recordna
 
 void gridSimulation::log (gridCoreObject *object, int level, const std::string &message)
 {
-  if ((level > consolePrintLevel) && (level > logPrintLevel))
+  //warnings and errors are counted even if they are not printed
+  if ((level == GD_WARNING_PRINT) || (level == GD_ERROR_PRINT))
+    {
+      std::lock_guard<std::mutex> lock (logLock);
+      if (level == GD_WARNING_PRINT)
+        {
+          ++warnCount;
+        }
+      else
+        {
+          ++errorCount;
+        }
+    }
+  int fileLevel = (logger->isFileOpen ()) ? logPrintLevel : GD_NO_PRINT;
+  if ((level > consolePrintLevel) && (level > fileLevel))
     {
       return;
     }
@@ -449,32 +516,64 @@ void gridSimulation::log (gridCoreObject *object, int level, const std::string &
     {
       object = this;
     }
-  std::string cname = '[' + ((object->getID () == getID ()) ? "sim" : (fullObjectName (object) + '(' + std::to_string (object->getUserID ()) + ')')) + ']';
-  std::string simtime = ((timeCurr > kNullVal / 2) ? '(' + std::to_string (timeCurr) + ')' : std::string ("(PRESTART)"));
-  std::string key;
-  if (level == GD_WARNING_PRINT)
-    {
-      key = "||WARNING||";
-      ++warnCount;
-    }
-  else if (level == GD_ERROR_PRINT)
-    {
-      key = "||ERROR||";
-      ++errorCount;
-    }
-  if (logFileStream.is_open ())
-    {
-      if (level <= logPrintLevel)
-        {
+  logRecord rec;
+  rec.time = timeCurr;
+  rec.level = level;
+  rec.source = static_cast<std::uint32_t> (object->getID ());
+  rec.toConsole = (level <= consolePrintLevel);
+  rec.toFile = (level <= fileLevel);
+  {
+    std::lock_guard<std::mutex> lock (logLock);
+    auto &src = logSources[object->getID ()];
+    if ((src.prefix.empty ()) || (src.parentObj != object->getParent ()) || (src.userID != object->getUserID ()) || (src.name != object->getName ()))
+      {
+        src.prefix = '[' + ((object->getID () == getID ()) ? "sim" : (fullObjectName (object) + '(' + std::to_string (object->getUserID ()) + ')')) + ']';
+        src.name = object->getName ();
+        src.parentObj = object->getParent ();
+        src.userID = object->getUserID ();
+      }
+    if ((logRateLimit > 0) && (level > GD_ERROR_PRINT))
+      {
+        if ((timeCurr - src.windowStart >= logRateWindow) || (timeCurr < src.windowStart))
+          {
+            if (src.suppressed > 0)
+              {
+                logRecord srec;
+                srec.time = timeCurr;
+                srec.level = GD_WARNING_PRINT;
+                srec.source = rec.source;
+                srec.objectName = src.prefix;
+                srec.message = std::to_string (src.suppressed) + " log messages suppressed by the rate limit";
+                srec.toConsole = (GD_WARNING_PRINT <= consolePrintLevel);
+                srec.toFile = (GD_WARNING_PRINT <= fileLevel);
+                logger->write (std::move (srec));
+              }
+            src.windowStart = timeCurr;
+            src.windowCount = 0;
+            src.suppressed = 0;
+          }
+        if (++src.windowCount > logRateLimit)
+          {
+            ++src.suppressed;
+            return;
+          }
+      }
+    rec.objectName = src.prefix;
+  }
+  rec.message = message;
+  logger->write (std::move (rec));
+}
 
-          logFileStream << simtime  << cname << "::" << key << message << '\n';
-        }
-    }
+int gridSimulation::logLevelLimit () const
+{
+  //the file level only matters if there is a file, warnings and errors always pass so they get counted
+  int fileLevel = (logger->isFileOpen ()) ? logPrintLevel : GD_NO_PRINT;
+  return (std::max)((std::max)(consolePrintLevel, fileLevel), GD_WARNING_PRINT);
+}
 
-  if (level <= consolePrintLevel)
-    {
-      std::cout << simtime << cname << "::" << key << message << '\n';
-    }
+void gridSimulation::flushLog ()
+{
+  logger->flush ();
 }
 
 
@@ -519,6 +618,10 @@ static const std::map<int, std::string> alertStrings {
 
 void gridSimulation::alert (gridCoreObject *object, int code)
 {
+  if (deferAlert (object, code))
+    {
+      return;
+    }
 
 
   if (code > MAX_CHANGE_ALERT)
@@ -535,6 +638,13 @@ void gridSimulation::alert (gridCoreObject *object, int code)
           break;
         case OBJECT_NAME_CHANGE:
         case OBJECT_ID_CHANGE:
+          {
+            //a name change can invalidate the cached names of any children
+            std::lock_guard<std::mutex> lock (logLock);
+            logSources.clear ();
+          }
+          gridArea::alert (object, code);
+          break;
         case OBJECT_IS_SEARCHABLE:
           gridArea::alert (object, code);
           break;
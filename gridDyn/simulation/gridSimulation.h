@@ -17,6 +17,9 @@
 // libraries
 #include <list>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 // header files
 #include "gridArea.h"
@@ -43,6 +46,7 @@ class gridRelay;
 class eventQueue;
 class eventAdapter;
 class functionEventAdapter;
+class gridLogger;
 /** @brief Grid simulation object
  GridSimulation is a base simulation class its intention is to handle some of the basic
 simulation bookkeeping tasks that would be common to all simulations in Griddyn including things like
@@ -75,7 +79,9 @@ protected:
   double state_record_period = -1.0;                            //!<how often to record the state
 
 
-  std::ofstream logFileStream;  //!< logging file stream
+  std::unique_ptr<gridLogger> logger;  //!< the logging sink for the console and log file
+  count_t logRateLimit = 0;  //!< the maximum number of messages per object in a log rate window (0 for no limit)
+  double logRateWindow = 1.0;  //!< [s] the simulation time window for the log rate limit
 
 
   std::shared_ptr<functionEventAdapter> stateRecorder;          //!<a recorder for recording the state on a periodic basis
@@ -117,6 +123,21 @@ protected:
   interact with other simulations
   */
   std::vector<std::shared_ptr<gridCoreObject> > extraObjects;
+private:
+  /** @brief cached name information for an object generating log messages*/
+  class logSourceInfo
+  {
+public:
+    std::string prefix;  //!< the formatted name prefix
+    std::string name;  //!< the object name the prefix was built with
+    const gridCoreObject *parentObj = nullptr;  //!< the parent the prefix was built with
+    index_t userID = kNullLocation;  //!< the user id the prefix was built with
+    double windowStart = -kBigNum;  //!< the start of the current rate limit window
+    count_t windowCount = 0;  //!< the number of messages in the current window
+    count_t suppressed = 0;  //!< the number of messages suppressed in the current window
+  };
+  std::unordered_map<index_t, logSourceInfo> logSources;  //!< cache of log source information indexed by object id
+  std::mutex logLock;  //!< protects the log source cache
 public:
   /** @brief constructor*/
   gridSimulation (const std::string &objName = "sim_#");
@@ -191,6 +212,9 @@ public:
 
   void alert (gridCoreObject *object, int code) override;
   virtual void log (gridCoreObject *object,int level, const std::string &message) override;
+  virtual int logLevelLimit () const override;
+  /** @brief wait for all pending log messages to be written*/
+  void flushLog ();
 
   /** @brief save all the recorder data to files
    all the recorders have files associated with them that get automatically saved at certain points this function forces them
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "jacobianPatternCache.h"
+#include "gridDyn.h"
+#include "solvers/solverInterface.h"
+#include "solvers/sparseLU.h"
+#include "arrayDataSparse.h"
+
+#include <algorithm>
+
+jacobianPatternCache::jacobianPatternCache (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+jacobianPatternCache::~jacobianPatternCache ()
+{
+
+}
+
+void jacobianPatternCache::invalidate ()
+{
+  if (!patterns.empty ())
+    {
+      patterns.clear ();
+      ++stats.invalidations;
+    }
+}
+
+void jacobianPatternCache::adopt (const jacobianPatternCache &source)
+{
+  //the patterns keep the version they were built at in the source,  a copy going through the same initialization
+  //reaches the same version at the point it needs the pattern even if the initialization changes the version
+  for (auto &ent : source.patterns)
+    {
+      adopted[ent.first] = ent.second;
+      ++stats.adoptions;
+    }
+}
+
+std::shared_ptr<const sparsePattern> jacobianPatternCache::getPattern (const solverMode &sMode)
+{
+  if (sMode.offsetIndex == kNullLocation)
+    {
+      return nullptr;
+    }
+  count_t size = sim->stateSize (sMode);
+  count_t version = sim->patternVersion ();
+  auto fnd = patterns.find (sMode.offsetIndex);
+  if (fnd != patterns.end ())
+    {
+      if ((fnd->second.structure == version) && (fnd->second.pattern->n == size))
+        {
+          ++stats.hits;
+          return fnd->second.pattern;
+        }
+      patterns.erase (fnd);
+    }
+  auto afnd = adopted.find (sMode.offsetIndex);
+  if (afnd != adopted.end ())
+    {
+      if ((afnd->second.structure == version) && (afnd->second.pattern->n == size))
+        {
+          patterns[sMode.offsetIndex] = afnd->second;
+          adopted.erase (afnd);
+          ++stats.hits;
+          return patterns[sMode.offsetIndex].pattern;
+        }
+      //the version only increases so an adopted pattern from an earlier version can never match
+      if (afnd->second.structure < version)
+        {
+          adopted.erase (afnd);
+        }
+    }
+  if (size == 0)
+    {
+      return nullptr;
+    }
+  std::shared_ptr<sparsePattern> pat;
+  if ((derivation) && ((isAlgebraicOnly (sMode)) || (isDifferentialOnly (sMode))))
+    {
+      pat = derive (sMode);
+    }
+  if (!pat)
+    {
+      pat = discover (sMode);
+    }
+  if (!pat)
+    {
+      return nullptr;
+    }
+  pat->order ();
+  patternEntry entry;
+  entry.pattern = pat;
+  entry.structure = version;
+  patterns[sMode.offsetIndex] = entry;
+  return pat;
+}
+
+std::shared_ptr<sparsePattern> jacobianPatternCache::discover (const solverMode &sMode)
+{
+  count_t size = sim->stateSize (sMode);
+  //the partitioned modes read the states of the other partition from the paired solver
+  if ((!isDAE (sMode)) && (isDynamic (sMode)) && (sMode.pairedOffsetIndex != kNullLocation))
+    {
+      auto pair = sim->getSolverInterface (sMode.pairedOffsetIndex);
+      if ((!pair) || (pair->state_data () == nullptr) || (pair->size () != sim->stateSize (pair->getSolverMode ())))
+        {
+          return nullptr;
+        }
+    }
+  std::vector<double> state (size);
+  std::vector<double> deriv (size, 0.0);
+  double time = sim->getCurrentTime ();
+  sim->guess (time, state.data (), deriv.data (), sMode);
+  //a sequence id of 0 keeps the objects from treating the evaluation as the current state
+  stateData sD (time, state.data (), deriv.data (), 0);
+  sD.cj = 1.0;
+  sim->fillExtraStateData (&sD, sMode);
+  arrayDataSparse ad;
+  ad.reserve (sim->jacSize (sMode));
+  ad.setRowLimit (size);
+  ad.setColLimit (size);
+  sim->preEx (&sD, sMode);
+  sim->networkEvaluation (&sD, sMode);
+  sim->jacobianElements (&sD, &ad, sMode);
+  sim->delayedJacobian (&sD, &ad, sMode);
+  cscMatrix<double> mat;
+  mat.load (ad, size);
+  auto pat = std::make_shared<sparsePattern> ();
+  pat->n = size;
+  pat->colStart.swap (mat.colStart);
+  pat->rows.swap (mat.rows);
+  ++stats.discoveries;
+  return pat;
+}
+
+static void mapRange (std::vector<index_t> &stateMap, std::vector<count_t> &hits, index_t from, index_t to, count_t cnt, bool &valid)
+{
+  if (cnt == 0)
+    {
+      return;
+    }
+  if ((from == kNullLocation) || (to == kNullLocation) || (from + cnt > stateMap.size ()) || (to + cnt > hits.size ()))
+    {
+      valid = false;
+      return;
+    }
+  for (index_t kk = 0; kk < cnt; ++kk)
+    {
+      stateMap[from + kk] = to + kk;
+      ++hits[to + kk];
+    }
+}
+
+bool jacobianPatternCache::mapStates (const solverMode &from, const solverMode &to, std::vector<index_t> &stateMap) const
+{
+  count_t fromSize = sim->stateSize (from);
+  count_t toSize = sim->stateSize (to);
+  stateMap.assign (fromSize, kNullLocation);
+  if ((!sim->opObjectLists.isListValid (from)) || (toSize == 0))
+    {
+      return false;
+    }
+  std::vector<count_t> hits (toSize, 0);
+  bool valid = true;
+  bool alg = ((hasAlgebraic (from)) && (hasAlgebraic (to)));
+  bool diff = ((hasDifferential (from)) && (hasDifferential (to)));
+  auto obeg = sim->opObjectLists.cbegin (from);
+  auto oend = sim->opObjectLists.cend (from);
+  while ((obeg != oend) && (valid))
+    {
+      //the states of an object and its sub objects are in contiguous blocks of each type in every mode
+      auto fso = (*obeg)->getOffsets (from);
+      auto tso = (*obeg)->getOffsets (to);
+      if (alg)
+        {
+          if ((fso->total.vSize != tso->total.vSize) || (fso->total.aSize != tso->total.aSize) || (fso->total.algSize != tso->total.algSize))
+            {
+              return false;
+            }
+          mapRange (stateMap, hits, fso->vOffset, tso->vOffset, fso->total.vSize, valid);
+          mapRange (stateMap, hits, fso->aOffset, tso->aOffset, fso->total.aSize, valid);
+          mapRange (stateMap, hits, fso->algOffset, tso->algOffset, fso->total.algSize, valid);
+        }
+      if (diff)
+        {
+          if (fso->total.diffSize != tso->total.diffSize)
+            {
+              return false;
+            }
+          mapRange (stateMap, hits, fso->diffOffset, tso->diffOffset, fso->total.diffSize, valid);
+        }
+      ++obeg;
+    }
+  return ((valid) && (std::all_of (hits.begin (), hits.end (), [](count_t h) {
+      return (h == 1);
+    })));
+}
+
+std::shared_ptr<sparsePattern> jacobianPatternCache::derive (const solverMode &sMode)
+{
+  const solverMode &daeMode = *(sim->defDAEMode);
+  //the DAE pattern is found first if it is not stored,  one evaluation then covers both partitions
+  sim->checkOffsets (daeMode);
+  auto daePattern = getPattern (daeMode);
+  if (!daePattern)
+    {
+      return nullptr;
+    }
+  std::vector<index_t> stateMap;
+  if (!mapStates (daeMode, sMode, stateMap))
+    {
+      return nullptr;
+    }
+  const sparsePattern &dae = *daePattern;
+  count_t size = sim->stateSize (sMode);
+  //the block of the DAE pattern in the target mode,  the columns map in order so only the rows need sorting
+  std::vector<index_t> colCount (size + 1, 0);
+  std::vector<std::pair<index_t, index_t> > entries;
+  entries.reserve (dae.nonZeros ());
+  for (index_t col = 0; col < dae.n; ++col)
+    {
+      auto tcol = stateMap[col];
+      if (tcol == kNullLocation)
+        {
+          continue;
+        }
+      for (auto kk = dae.colStart[col]; kk < dae.colStart[col + 1]; ++kk)
+        {
+          auto trow = stateMap[dae.rows[kk]];
+          if (trow != kNullLocation)
+            {
+              entries.emplace_back (tcol, trow);
+            }
+        }
+    }
+  std::sort (entries.begin (), entries.end ());
+  auto pat = std::make_shared<sparsePattern> ();
+  pat->n = size;
+  pat->colStart.assign (size + 1, 0);
+  pat->rows.reserve (entries.size ());
+  for (auto &ent : entries)
+    {
+      ++pat->colStart[ent.first + 1];
+      pat->rows.push_back (ent.second);
+    }
+  for (index_t kk = 0; kk < size; ++kk)
+    {
+      pat->colStart[kk + 1] += pat->colStart[kk];
+    }
+  ++stats.derivations;
+  return pat;
+}
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef JACOBIAN_PATTERN_CACHE_H_
+#define JACOBIAN_PATTERN_CACHE_H_
+
+#include "gridDynTypes.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class gridDynSimulation;
+class solverMode;
+class sparsePattern;
+
+/** @brief store of the Jacobian sparsity patterns and their symbolic analysis for the solver modes of a simulation
+ the pattern of a mode is found once with a pass of jacobianElements at the initial guess and the fill reducing ordering
+is computed with it,  solver interfaces created later for the same mode get the stored pattern instead of discovering and
+analyzing their own.  The patterns of the partitioned algebraic and differential modes are derived from the DAE pattern,
+so a single evaluation covers both partitions and needs no paired solver.  The state indices of the two modes are matched
+through the offset tables of the top level objects and the pattern is the block of the DAE pattern with both indices in
+the target mode.  The stored patterns are dropped when the structure of the simulation changes.
+*/
+class jacobianPatternCache
+{
+public:
+  /** @brief statistics on the cache usage*/
+  class cacheStats
+  {
+public:
+    count_t discoveries = 0;  //!< the number of patterns found from a Jacobian evaluation
+    count_t derivations = 0;  //!< the number of patterns derived from another mode
+    count_t hits = 0;  //!< the number of requests served from the store
+    count_t invalidations = 0;  //!< the number of times the store was cleared
+    count_t adoptions = 0;  //!< the number of patterns taken from another cache
+  };
+
+  explicit jacobianPatternCache (gridDynSimulation *gds);
+  ~jacobianPatternCache ();
+  /** @brief get the pattern of a solver mode
+  @return the pattern or nullptr if the mode has no states or its paired solver is not ready
+  */
+  std::shared_ptr<const sparsePattern> getPattern (const solverMode &sMode);
+  /** @brief build the map from the state indices of one mode to another
+  @param[out] stateMap the index in the to mode of each state of the from mode,  kNullLocation if the state is not in it
+  @return true if every state of the to mode was matched to exactly one state of the from mode
+  */
+  bool mapStates (const solverMode &from, const solverMode &to, std::vector<index_t> &stateMap) const;
+  /** @brief share the patterns of another cache
+   used for copies of a simulation with the same structure,  the patterns are shared rather than copied.  The copy may
+  adopt before it is initialized,  each pattern is used once the copy reaches the pattern version the source built it at
+  */
+  void adopt (const jacobianPatternCache &source);
+  /** @brief drop all the stored patterns,  adopted patterns are kept since they are matched by version*/
+  void invalidate ();
+  /** @brief enable the derivation of the partitioned mode patterns from the DAE pattern*/
+  void setDerivation (bool derive)
+  {
+    derivation = derive;
+  }
+  const cacheStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  /** @brief a stored pattern*/
+  class patternEntry
+  {
+public:
+    std::shared_ptr<sparsePattern> pattern;  //!< the pattern and its analysis
+    count_t structure = 0;  //!< the pattern version of the simulation the pattern was built at
+  };
+  gridDynSimulation *sim;  //!< the simulation the patterns belong to
+  std::map<index_t, patternEntry> patterns;  //!< the patterns by the offset index of the mode
+  std::map<index_t, patternEntry> adopted;  //!< patterns from another cache not yet matched by this simulation
+  cacheStats stats;  //!< cache statistics
+  bool derivation = true;  //!< derive the partitioned patterns from the DAE pattern
+
+  std::shared_ptr<sparsePattern> discover (const solverMode &sMode);
+  std::shared_ptr<sparsePattern> derive (const solverMode &sMode);
+};
+
+#endif
@@ -0,0 +1,339 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "networkAdmittance.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/acLine.h"
+#include "arrayData.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef std::complex<double> complexd;
+
+static const complexd jcomp (0.0, 1.0);
+
+networkAdmittance::networkAdmittance (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+void networkAdmittance::collect (std::vector<gridBus *> &busList, std::vector<acLine *> &lineList) const
+{
+  busList.clear ();
+  lineList.clear ();
+  sim->getBusVector (busList);
+  busList.erase (std::remove_if (busList.begin (), busList.end (), [](const gridBus *bus) {
+      return (!bus->enabled);
+    }), busList.end ());
+  std::map<gridBus *, index_t> index;
+  for (index_t kk = 0; kk < busList.size (); ++kk)
+    {
+      index[busList[kk]] = kk;
+    }
+  for (auto &bus : busList)
+    {
+      index_t ll = 0;
+      gridLink *lnk;
+      while ((lnk = bus->getLink (ll++)) != nullptr)
+        {
+          //each link is added once from its first terminal,  disabled links are included so they can be switched back in
+          if (lnk->getBus (1) != bus)
+            {
+              continue;
+            }
+          auto line = dynamic_cast<acLine *> (lnk);
+          if (!line)
+            {
+              continue;
+            }
+          auto fnd = index.find (line->getBus (2));
+          if ((fnd == index.end ()) || (fnd->second == index[bus]))
+            {
+              continue;
+            }
+          lineList.push_back (line);
+        }
+    }
+}
+
+int networkAdmittance::build ()
+{
+  clear ();
+  std::vector<acLine *> lines;
+  collect (buses, lines);
+  count_t n = static_cast<count_t> (buses.size ());
+  if (n == 0)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  busIndex.clear ();
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      busIndex[buses[kk]] = kk;
+    }
+  //the pattern holds every diagonal and the entries of every candidate branch
+  std::vector<std::vector<index_t> > rowCols (n);
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      rowCols[kk].push_back (kk);
+    }
+  branches.clear ();
+  branches.resize (lines.size ());
+  std::vector<index_t> from (lines.size ());
+  std::vector<index_t> to (lines.size ());
+  for (size_t bb = 0; bb < lines.size (); ++bb)
+    {
+      from[bb] = busIndex[lines[bb]->getBus (1)];
+      to[bb] = busIndex[lines[bb]->getBus (2)];
+      rowCols[from[bb]].push_back (to[bb]);
+      rowCols[to[bb]].push_back (from[bb]);
+    }
+  rowStart.assign (n + 1, 0);
+  colIndex.clear ();
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      auto &cols = rowCols[kk];
+      std::sort (cols.begin (), cols.end ());
+      cols.erase (std::unique (cols.begin (), cols.end ()), cols.end ());
+      colIndex.insert (colIndex.end (), cols.begin (), cols.end ());
+      rowStart[kk + 1] = static_cast<index_t> (colIndex.size ());
+    }
+  auto position = [this](index_t row, index_t col) {
+      auto cbeg = colIndex.begin () + rowStart[row];
+      auto cend = colIndex.begin () + rowStart[row + 1];
+      return static_cast<index_t> (std::lower_bound (cbeg, cend, col) - colIndex.begin ());
+    };
+  for (size_t bb = 0; bb < lines.size (); ++bb)
+    {
+      auto &br = branches[bb];
+      br.line = lines[bb];
+      br.adjustable = (dynamic_cast<adjustableTransformer *> (lines[bb]) != nullptr);
+      br.stamped = false;
+      br.pos[0] = position (from[bb], from[bb]);
+      br.pos[1] = position (to[bb], to[bb]);
+      br.pos[2] = position (from[bb], to[bb]);
+      br.pos[3] = position (to[bb], from[bb]);
+      std::fill (br.params, br.params + 6, 0.0);
+      std::fill (br.y, br.y + 4, complexd (0.0, 0.0));
+    }
+  vals.assign (colIndex.size (), complexd (0.0, 0.0));
+  V.assign (n, complexd (1.0, 0.0));
+  S.assign (n, complexd (0.0, 0.0));
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      buses[kk]->setNetworkModel (this, kk);
+    }
+  //the initial stamps are not counted as restamps
+  auto restamps = stats.restamps;
+  update ();
+  stats.restamps = restamps;
+  ++stats.builds;
+  built = true;
+  structureCheck = false;
+  seqID = 0;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void networkAdmittance::clear ()
+{
+  //detach everything currently in the simulation since stored objects may have been removed
+  std::vector<gridBus *> busList;
+  std::vector<acLine *> lineList;
+  collect (busList, lineList);
+  for (auto &bus : busList)
+    {
+      bus->setNetworkModel (nullptr, kNullLocation);
+    }
+  for (auto &line : lineList)
+    {
+      line->opFlags.reset (gridLink::network_assembled);
+    }
+  buses.clear ();
+  busIndex.clear ();
+  branches.clear ();
+  built = false;
+  seqID = 0;
+}
+
+bool networkAdmittance::isValidMode (const solverMode &sMode)
+{
+  return ((hasAlgebraic (sMode)) && (!isDC (sMode)) && (!isLocal (sMode)) && (getLinkApprox (sMode) == 0));
+}
+
+bool networkAdmittance::update ()
+{
+  bool changed = false;
+  for (auto &br : branches)
+    {
+      auto line = br.line;
+      bool active = ((line->enabled) && (line->isConnected ()) && (line->fault < 0));
+      if ((active) && (br.adjustable))
+        {
+          //continuous tap controls have states and compute their own flows
+          active = !line->opFlags[adjustableTransformer::continuous_flag];
+        }
+      if (active)
+        {
+          const double params[6] = { line->g, line->b, line->mp_G, line->mp_B, line->tap, line->tapAngle };
+          if ((br.stamped) && (std::equal (params, params + 6, br.params)))
+            {
+              continue;
+            }
+          std::copy (params, params + 6, br.params);
+          complexd ys (line->g, line->b);
+          complexd yshunt (0.5 * line->mp_G, 0.5 * line->mp_B);
+          complexd tap = std::polar (line->tap, line->tapAngle);
+          br.y[0] = (ys + yshunt) / std::norm (tap);
+          br.y[1] = ys + yshunt;
+          br.y[2] = -ys / std::conj (tap);
+          br.y[3] = -ys / tap;
+          br.stamped = true;
+          line->opFlags.set (gridLink::network_assembled);
+        }
+      else
+        {
+          if (!br.stamped)
+            {
+              continue;
+            }
+          std::fill (br.y, br.y + 4, complexd (0.0, 0.0));
+          br.stamped = false;
+          line->opFlags.reset (gridLink::network_assembled);
+        }
+      ++stats.restamps;
+      changed = true;
+    }
+  if (changed)
+    {
+      //summing the stamps again instead of applying differences keeps the values exact after many changes
+      std::fill (vals.begin (), vals.end (), complexd (0.0, 0.0));
+      for (auto &br : branches)
+        {
+          if (br.stamped)
+            {
+              for (int ee = 0; ee < 4; ++ee)
+                {
+                  vals[br.pos[ee]] += br.y[ee];
+                }
+            }
+        }
+    }
+  return changed;
+}
+
+void networkAdmittance::evaluate (const stateData *sD, const solverMode &sMode)
+{
+  seqID = 0;
+  if ((sD == nullptr) || (sD->seqID == 0) || (!isValidMode (sMode)))
+    {
+      return;
+    }
+  if ((built) && (structureCheck))
+    {
+      std::vector<gridBus *> busList;
+      std::vector<acLine *> lineList;
+      collect (busList, lineList);
+      bool same = ((busList == buses) && (lineList.size () == branches.size ()));
+      for (size_t bb = 0; (same) && (bb < lineList.size ()); ++bb)
+        {
+          same = (lineList[bb] == branches[bb].line);
+        }
+      built = same;
+      structureCheck = false;
+    }
+  if (!built)
+    {
+      if (build () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          return;
+        }
+    }
+  update ();
+  count_t n = static_cast<count_t> (buses.size ());
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      V[kk] = std::polar (buses[kk]->getVoltage (sD, sMode), buses[kk]->getAngle (sD, sMode));
+    }
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      complexd I (0.0, 0.0);
+      for (index_t pp = rowStart[kk]; pp < rowStart[kk + 1]; ++pp)
+        {
+          I += vals[pp] * V[colIndex[pp]];
+        }
+      S[kk] = V[kk] * std::conj (I);
+    }
+  seqID = sD->seqID;
+  modeIndex = sMode.offsetIndex;
+  ++stats.evaluations;
+}
+
+bool networkAdmittance::isCurrent (const stateData *sD, const solverMode &sMode) const
+{
+  return ((sD != nullptr) && (seqID != 0) && (sD->seqID == seqID) && (sMode.offsetIndex == modeIndex));
+}
+
+void networkAdmittance::ioPartialDerivatives (index_t bus, arrayData<double> *ad) const
+{
+  complexd Vi = V[bus];
+  double vm = std::abs (Vi);
+  complexd u = (vm > 0.0) ? Vi / vm : complexd (1.0, 0.0);
+  complexd Yii (0.0, 0.0);
+  complexd I (0.0, 0.0);
+  for (index_t pp = rowStart[bus]; pp < rowStart[bus + 1]; ++pp)
+    {
+      if (colIndex[pp] == bus)
+        {
+          Yii = vals[pp];
+        }
+      I += vals[pp] * V[colIndex[pp]];
+    }
+  complexd dSdA = jcomp * (S[bus] - vm * vm * std::conj (Yii));
+  complexd dSdV = u * std::conj (I) + vm * std::conj (Yii);
+  ad->assign (PoutLocation, angleInLocation, dSdA.real ());
+  ad->assign (QoutLocation, angleInLocation, dSdA.imag ());
+  ad->assign (PoutLocation, voltageInLocation, dSdV.real ());
+  ad->assign (QoutLocation, voltageInLocation, dSdV.imag ());
+}
+
+void networkAdmittance::outputPartialDerivatives (index_t bus, arrayData<double> *ad, const solverMode &sMode) const
+{
+  complexd Vi = V[bus];
+  for (index_t pp = rowStart[bus]; pp < rowStart[bus + 1]; ++pp)
+    {
+      auto col = colIndex[pp];
+      if (col == bus)
+        {
+          continue;
+        }
+      double vmj = std::abs (V[col]);
+      complexd uj = (vmj > 0.0) ? V[col] / vmj : complexd (1.0, 0.0);
+      //the flow term Vi*conj(Yij*Vj) and its derivatives with respect to the angle and magnitude of Vj
+      complexd dSdV = Vi * std::conj (vals[pp] * uj);
+      complexd dSdA = -jcomp * vmj * dSdV;
+      auto Aloc = buses[col]->getOutputLoc (sMode, angleInLocation);
+      auto Vloc = buses[col]->getOutputLoc (sMode, voltageInLocation);
+      if (Aloc != kNullLocation)
+        {
+          ad->assign (PoutLocation, Aloc, dSdA.real ());
+          ad->assign (QoutLocation, Aloc, dSdA.imag ());
+        }
+      if (Vloc != kNullLocation)
+        {
+          ad->assign (PoutLocation, Vloc, dSdV.real ());
+          ad->assign (QoutLocation, Vloc, dSdV.imag ());
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef NETWORK_ADMITTANCE_H_
+#define NETWORK_ADMITTANCE_H_
+
+#include "gridDynTypes.h"
+
+#include <complex>
+#include <map>
+#include <vector>
+
+class gridDynSimulation;
+class gridBus;
+class acLine;
+class stateData;
+class solverMode;
+
+template <class X>
+class arrayData;
+
+/** @brief assembled bus admittance model of the passive links in a simulation
+ the admittance matrix is assembled once from the acLine objects and adjustable transformers without continuous controls,
+each evaluation computes the flows into the network at every bus from a single sparse complex matrix vector product and
+the buses take their partial derivatives directly from the matrix.  The pattern of the matrix includes every candidate
+link,  the parameters and switch state of the links are checked at each evaluation and only the changed branches are
+restamped so switching and tap changes do not require a rebuild.  Links that are open,  faulted,  or not acLines remain
+objects and are evaluated by the buses as before.
+The model is only used in modes with the full ac link model,  other modes use the link objects.
+*/
+class networkAdmittance
+{
+public:
+  /** @brief counters for the network work*/
+  class networkStats
+  {
+public:
+    count_t builds = 0;  //!< the number of times the matrix pattern was built
+    count_t restamps = 0;  //!< the number of branch restamps from parameter or status changes
+    count_t evaluations = 0;  //!< the number of network evaluations
+  };
+
+  explicit networkAdmittance (gridDynSimulation *gds);
+
+  /** @brief build the admittance matrix from the current network and attach the buses to the model
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if there are no buses
+  */
+  int build ();
+  /** @brief detach the buses and links from the model*/
+  void clear ();
+  /** @brief check the bus and link structure against the model at the next evaluation*/
+  void checkStructure ()
+  {
+    structureCheck = true;
+  }
+  /** @brief check if the model can be used for a solver mode*/
+  static bool isValidMode (const solverMode &sMode);
+  /** @brief compute the network injections for a state
+   the buses use the model for the same state data,  otherwise they compute the link flows themselves
+  */
+  void evaluate (const stateData *sD, const solverMode &sMode);
+  /** @brief check if the stored injections were computed from a particular state*/
+  bool isCurrent (const stateData *sD, const solverMode &sMode) const;
+  /** @brief get the real power flowing from a bus into the assembled links*/
+  double getRealPower (index_t bus) const
+  {
+    return S[bus].real ();
+  }
+  /** @brief get the reactive power flowing from a bus into the assembled links*/
+  double getReactivePower (index_t bus) const
+  {
+    return S[bus].imag ();
+  }
+  /** @brief add the partial derivatives of the flows at a bus with respect to the bus voltage and angle
+  @param[in] bus the index of the bus
+  @param[out] ad the array to add the derivatives to with rows PoutLocation,QoutLocation and columns voltageInLocation,angleInLocation
+  */
+  void ioPartialDerivatives (index_t bus, arrayData<double> *ad) const;
+  /** @brief add the partial derivatives of the flows at a bus with respect to the voltages and angles of the other buses
+  @param[in] bus the index of the bus
+  @param[out] ad the array to add the derivatives to with rows PoutLocation,QoutLocation and columns in the solver state
+  @param[in] sMode the solverMode of the state
+  */
+  void outputPartialDerivatives (index_t bus, arrayData<double> *ad, const solverMode &sMode) const;
+  count_t busCount () const
+  {
+    return static_cast<count_t> (buses.size ());
+  }
+  count_t branchCount () const
+  {
+    return static_cast<count_t> (branches.size ());
+  }
+  const networkStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  /** @brief the stamp of a single branch in the admittance matrix*/
+  class branch
+  {
+public:
+    acLine *line = nullptr;  //!< the link
+    bool adjustable = false;  //!< the link is an adjustable transformer
+    bool stamped = false;  //!< the branch is included in the matrix values
+    index_t pos[4];  //!< the value locations of the from-from,to-to,from-to,and to-from entries
+    double params[6];  //!< the link parameters of the current stamp
+    std::complex<double> y[4];  //!< the current stamp
+  };
+
+  gridDynSimulation *sim;  //!< the simulation
+  std::vector<gridBus *> buses;  //!< the buses in matrix order
+  std::map<gridBus *, index_t> busIndex;  //!< the matrix index of each bus
+  std::vector<branch> branches;  //!< the candidate passive links
+  std::vector<index_t> rowStart;  //!< the start of each row in the compressed row storage
+  std::vector<index_t> colIndex;  //!< the column of each entry
+  std::vector<std::complex<double> > vals;  //!< the admittance values
+  std::vector<std::complex<double> > V;  //!< the bus voltage phasors of the last evaluation
+  std::vector<std::complex<double> > S;  //!< the power flowing from each bus into the network
+  networkStats stats;  //!< the network counters
+  index_t seqID = 0;  //!< the sequence id of the state of the last evaluation
+  index_t modeIndex = kNullLocation;  //!< the offset index of the mode of the last evaluation
+  bool built = false;  //!< the matrix pattern matches the network
+  bool structureCheck = false;  //!< the simulation reported a change which may alter the structure
+
+  /** @brief collect the buses and candidate links of the simulation*/
+  void collect (std::vector<gridBus *> &busList, std::vector<acLine *> &lineList) const;
+  /** @brief check the links for changes and restamp the changed branches
+  @return true if any branch was restamped
+  */
+  bool update ();
+};
+
+#endif
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "objectRegistry.h"
+#include "gridArea.h"
+#include "gridBus.h"
+#include "linkModels/gridLink.h"
+#include "relays/gridRelay.h"
+#include "loadModels/gridLoad.h"
+#include "generators/gridDynGenerator.h"
+
+objectRegistry::objectRegistry (const gridArea *rootArea) : root (rootArea)
+{
+
+}
+
+bool objectRegistry::getObjectType (const std::string &typeName, object_type &type)
+{
+  if (typeName == "area")
+    {
+      type = object_type::area;
+    }
+  else if (typeName == "bus")
+    {
+      type = object_type::bus;
+    }
+  else if (typeName == "link")
+    {
+      type = object_type::link;
+    }
+  else if (typeName == "relay")
+    {
+      type = object_type::relay;
+    }
+  else if ((typeName == "gen") || (typeName == "generator"))
+    {
+      type = object_type::generator;
+    }
+  else if (typeName == "load")
+    {
+      type = object_type::load;
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+const std::vector<gridCoreObject *> &objectRegistry::getObjects (object_type type)
+{
+  update ();
+  return typeLists[static_cast<int> (type)];
+}
+
+const std::vector<gridCoreObject *> &objectRegistry::getClassObjects (const std::type_index &cls)
+{
+  update ();
+  auto fnd = classLists.find (cls);
+  return (fnd != classLists.end ()) ? fnd->second : emptyList;
+}
+
+count_t objectRegistry::setAll (object_type type, const std::string &param, double val, gridUnits::units_t unitType)
+{
+  count_t cnt = 0;
+  //set can trigger alerts up the object tree so it stays on the calling thread
+  for (auto &obj : getObjects (type))
+    {
+      if (obj->set (param, val, unitType) == PARAMETER_FOUND)
+        {
+          ++cnt;
+        }
+    }
+  return cnt;
+}
+
+count_t objectRegistry::setAll (object_type type, const std::string &param, const std::vector<double> &vals, gridUnits::units_t unitType)
+{
+  count_t cnt = 0;
+  auto &objs = getObjects (type);
+  auto sz = (std::min)(objs.size (), vals.size ());
+  for (size_t kk = 0; kk < sz; ++kk)
+    {
+      if (objs[kk]->set (param, vals[kk], unitType) == PARAMETER_FOUND)
+        {
+          ++cnt;
+        }
+    }
+  return cnt;
+}
+
+count_t objectRegistry::getAll (object_type type, const std::string &param, std::vector<double> &vals, gridUnits::units_t unitType)
+{
+  auto &objs = getObjects (type);
+  int cnt = static_cast<int> (objs.size ());
+  vals.resize (objs.size ());
+#pragma omp parallel for if (cnt > static_cast<int> (parallelThreshold))
+  for (int kk = 0; kk < cnt; ++kk)
+    {
+      vals[kk] = objs[kk]->get (param, unitType);
+    }
+  return static_cast<count_t> (cnt);
+}
+
+void objectRegistry::update ()
+{
+  if ((valid) && (version == root->structureVersion ()))
+    {
+      return;
+    }
+  for (auto &tlist : typeLists)
+    {
+      tlist.clear ();
+    }
+  classLists.clear ();
+  loadArea (root);
+  version = root->structureVersion ();
+  valid = true;
+  ++buildCount;
+}
+
+void objectRegistry::addObject (object_type type, gridCoreObject *obj)
+{
+  typeLists[static_cast<int> (type)].push_back (obj);
+  classLists[std::type_index (typeid(*obj))].push_back (obj);
+}
+
+void objectRegistry::loadArea (const gridArea *area)
+{
+  index_t kk = 0;
+  gridArea *subArea;
+  while ((subArea = area->getArea (kk++)) != nullptr)
+    {
+      addObject (object_type::area, subArea);
+      loadArea (subArea);
+    }
+  kk = 0;
+  gridBus *bus;
+  while ((bus = area->getBus (kk++)) != nullptr)
+    {
+      addObject (object_type::bus, bus);
+      loadBus (bus);
+    }
+  kk = 0;
+  gridLink *lnk;
+  while ((lnk = area->getLink (kk++)) != nullptr)
+    {
+      addObject (object_type::link, lnk);
+      //subsystems hold their contents in an internal area which is not an area of the simulation
+      auto contents = lnk->getArea (0);
+      if (contents != nullptr)
+        {
+          loadArea (contents);
+        }
+    }
+  kk = 0;
+  gridRelay *rel;
+  while ((rel = area->getRelay (kk++)) != nullptr)
+    {
+      addObject (object_type::relay, rel);
+    }
+}
+
+void objectRegistry::loadBus (const gridBus *bus)
+{
+  index_t kk = 0;
+  gridDynGenerator *gen;
+  while ((gen = bus->getGen (kk++)) != nullptr)
+    {
+      addObject (object_type::generator, gen);
+    }
+  kk = 0;
+  gridLoad *ld;
+  while ((ld = bus->getLoad (kk++)) != nullptr)
+    {
+      addObject (object_type::load, ld);
+    }
+}
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef OBJECT_REGISTRY_H_
+#define OBJECT_REGISTRY_H_
+
+#include "gridDynTypes.h"
+#include "units.h"
+
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+class gridCoreObject;
+class gridArea;
+class gridBus;
+
+/** @brief flat lists of the objects in a simulation by object type and by concrete class
+ the lists cover the areas,  buses,  links,  relays,  generators,  and loads of the whole object tree including the
+contents of subsystems.  The registry checks the structure change counter of the primary objects on every access and
+rebuilds the lists when objects have been added or removed since they were built,  so between structural changes the bulk
+operations are a loop over a flat array instead of a walk over the object tree.
+*/
+class objectRegistry
+{
+public:
+  /** @brief the object types tracked by the registry*/
+  enum class object_type
+  {
+    area = 0,
+    bus = 1,
+    link = 2,
+    relay = 3,
+    generator = 4,
+    load = 5,
+  };
+  static const int typeCount = 6;  //!< the number of object types
+  /** @brief the array size above which the bulk reads are spread over threads*/
+  static const count_t parallelThreshold = 512;
+
+  /** @brief constructor
+  @param[in] rootArea the top of the object tree,  the root itself is not part of the area list
+  */
+  explicit objectRegistry (const gridArea *rootArea);
+  /** @brief translate a type string as used in setAll to an object type
+  @return true if the string names a type tracked by the registry
+  */
+  static bool getObjectType (const std::string &typeName, object_type &type);
+  /** @brief get all the objects of a particular type*/
+  const std::vector<gridCoreObject *> &getObjects (object_type type);
+  /** @brief get all the objects of a particular concrete class*/
+  const std::vector<gridCoreObject *> &getClassObjects (const std::type_index &cls);
+  /** @brief get all the objects of a particular concrete class*/
+  template <class X>
+  const std::vector<gridCoreObject *> &getClassObjects ()
+  {
+    return getClassObjects (std::type_index (typeid(X)));
+  }
+  /** @brief get the number of objects of a type*/
+  count_t count (object_type type)
+  {
+    return static_cast<count_t> (getObjects (type).size ());
+  }
+  /** @brief set a parameter on all the objects of a type
+  @return the number of objects which accepted the parameter
+  */
+  count_t setAll (object_type type, const std::string &param, double val, gridUnits::units_t unitType = gridUnits::defUnit);
+  /** @brief set a parameter on all the objects of a type to individual values
+  @param[in] vals the values in the order of getObjects
+  @return the number of objects which accepted the parameter
+  */
+  count_t setAll (object_type type, const std::string &param, const std::vector<double> &vals, gridUnits::units_t unitType = gridUnits::defUnit);
+  /** @brief get a parameter from all the objects of a type
+   reads of large arrays are spread over threads
+  @param[out] vals the values in the order of getObjects
+  @return the number of values
+  */
+  count_t getAll (object_type type, const std::string &param, std::vector<double> &vals, gridUnits::units_t unitType = gridUnits::defUnit);
+  /** @brief force the lists to be rebuilt on the next access*/
+  void invalidate ()
+  {
+    valid = false;
+  }
+  /** @brief get the number of times the lists have been built*/
+  count_t getBuildCount () const
+  {
+    return buildCount;
+  }
+
+private:
+  const gridArea *root;  //!< the top of the object tree
+  std::vector<gridCoreObject *> typeLists[typeCount];  //!< the objects by type
+  std::unordered_map<std::type_index, std::vector<gridCoreObject *> > classLists;  //!< the objects by concrete class
+  std::vector<gridCoreObject *> emptyList;  //!< returned for classes with no objects
+  count_t version = 0;  //!< the structure change count the lists were built at
+  count_t buildCount = 0;  //!< the number of builds
+  bool valid = false;  //!< indicator that the lists have been built
+
+  /** @brief rebuild the lists if the structure has changed*/
+  void update ();
+  void addObject (object_type type, gridCoreObject *obj);
+  void loadArea (const gridArea *area);
+  void loadBus (const gridBus *bus);
+};
+
+#endif
@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "partitionedCoupling.h"
+#include "gridDyn.h"
+#include "solvers/solverInterface.h"
+
+#include <algorithm>
+#include <cmath>
+
+partitionedCoupling::partitionedCoupling (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+void partitionedCoupling::reset ()
+{
+  prevTime = kNullVal;
+  baseTime = kNullVal;
+  prevAlg.clear ();
+  baseAlg.clear ();
+  pmode = predict_mode::none;
+}
+
+const double *partitionedCoupling::predict (double time, const double *algState)
+{
+  if ((pmode == predict_mode::none) || (baseAlg.empty ()))
+    {
+      return algState;
+    }
+  fillPrediction (time);
+  return predicted.data ();
+}
+
+void partitionedCoupling::fillPrediction (double time)
+{
+  predicted.resize (baseAlg.size ());
+  if (pmode == predict_mode::interpolate)
+    {
+      double frac = (endTime > baseTime) ? (time - baseTime) / (endTime - baseTime) : 1.0;
+      for (size_t kk = 0; kk < baseAlg.size (); ++kk)
+        {
+          predicted[kk] = baseAlg[kk] + frac * (endAlg[kk] - baseAlg[kk]);
+        }
+    }
+  else if ((order > 0) && (prevAlg.size () == baseAlg.size ()) && (baseTime - prevTime > sim->tols.timeTol))
+    {
+      double frac = (time - baseTime) / (baseTime - prevTime);
+      for (size_t kk = 0; kk < baseAlg.size (); ++kk)
+        {
+          predicted[kk] = baseAlg[kk] + frac * (baseAlg[kk] - prevAlg[kk]);
+        }
+    }
+  else
+    {
+      predicted = baseAlg;
+    }
+}
+
+double partitionedCoupling::predictionError (const double *algState) const
+{
+  if (predicted.empty ())
+    {
+      return 0.0;
+    }
+  double sum = 0.0;
+  for (size_t kk = 0; kk < predicted.size (); ++kk)
+    {
+      double err = (algState[kk] - predicted[kk]) / (tolerance + tolerance * std::abs (algState[kk]));
+      sum += err * err;
+    }
+  return std::sqrt (sum / static_cast<double> (predicted.size ()));
+}
+
+int partitionedCoupling::restoreStart (std::shared_ptr<solverInterface> &diff, double time)
+{
+  std::copy (diffSave.begin (), diffSave.end (), diff->state_data ());
+  if (!derivSave.empty ())
+    {
+      std::copy (derivSave.begin (), derivSave.end (), diff->deriv_data ());
+    }
+  sim->timeCurr = time;
+  return diff->calcIC (time, 0.0, solverInterface::ic_modes::fixed_diff, false);
+}
+
+int partitionedCoupling::advance (std::shared_ptr<solverInterface> &diff, std::shared_ptr<solverInterface> &alg, double tStop, double &tReturn)
+{
+  int retval = FUNCTION_EXECUTION_SUCCESS;
+  double timeTol = sim->tols.timeTol;
+  double tStart = sim->getCurrentTime ();
+  auto asize = alg->size ();
+  auto dsize = diff->size ();
+  tReturn = tStart;
+  if (reusePending)
+    {
+      alg->set ("maxsetupcalls", static_cast<double> (jacobianReuse));
+      reusePending = false;
+    }
+  if ((baseAlg.size () != asize) || (baseTime > tStart + timeTol))
+    {
+      reset ();
+    }
+  //the algebraic solution at the start of the interval becomes the latest history point
+  if ((baseTime != kNullVal) && (tStart - baseTime > timeTol))
+    {
+      prevAlg.swap (baseAlg);
+      prevTime = baseTime;
+    }
+  baseAlg.assign (alg->state_data (), alg->state_data () + asize);
+  baseTime = tStart;
+
+  double h = ((stepSize > 0) && (stepSize < tStop - tStart)) ? stepSize : tStop - tStart;
+  while (tStart + timeTol < tStop)
+    {
+      //don't leave a sliver of a step at the end of the interval
+      bool limited = (tStop - tStart < 1.05 * h);
+      double tNext = (limited) ? tStop : tStart + h;
+      diffSave.assign (diff->state_data (), diff->state_data () + dsize);
+      if (diff->deriv_data () != nullptr)
+        {
+          derivSave.assign (diff->deriv_data (), diff->deriv_data () + dsize);
+        }
+      else
+        {
+          derivSave.clear ();
+        }
+      double tRet = tStart;
+      pmode = predict_mode::extrapolate;
+      retval = sim->runDynamicSolverStep (diff, tNext, tRet);
+      pmode = predict_mode::none;
+      if (retval < 0)
+        {
+          tReturn = tRet;
+          return retval;
+        }
+      fillPrediction (tRet);
+      double tAlg;
+      int aret = alg->solve (tRet, tAlg);
+      if (aret < 0)
+        {
+          tReturn = tRet;
+          return aret;
+        }
+      double err = predictionError (alg->state_data ());
+      //repeat the step with the algebraic states moving toward the new solution until the two agree
+      count_t iter = 0;
+      while ((err > 1.0) && (canRedo) && (iter < maxIterations) && (retval != SOLVER_ROOT_FOUND))
+        {
+          endAlg.assign (alg->state_data (), alg->state_data () + asize);
+          endTime = tRet;
+          if (restoreStart (diff, tStart) < 0)
+            {
+              canRedo = false;
+              break;
+            }
+          ++iter;
+          ++stats.interfaceIterations;
+          double tRet2 = tStart;
+          pmode = predict_mode::interpolate;
+          retval = sim->runDynamicSolverStep (diff, tRet, tRet2);
+          fillPrediction (tRet2);
+          pmode = predict_mode::none;
+          tRet = tRet2;
+          if (retval < 0)
+            {
+              tReturn = tRet;
+              return retval;
+            }
+          aret = alg->solve (tRet, tAlg);
+          if (aret < 0)
+            {
+              tReturn = tRet;
+              return aret;
+            }
+          err = predictionError (alg->state_data ());
+        }
+      double fact = (err > 0) ? 0.9 * std::pow (err, -1.0 / static_cast<double> (order + 1)) : 2.0;
+      fact = std::max (0.2, std::min (fact, 2.0));
+      if ((err > 1.0) && (canRedo) && (h > minStep) && (retval != SOLVER_ROOT_FOUND))
+        {
+          if (restoreStart (diff, tStart) >= 0)
+            {
+              std::copy (baseAlg.begin (), baseAlg.end (), alg->state_data ());
+              ++stats.rejectedSteps;
+              h = std::max (minStep, (tRet - tStart) * fact);
+              continue;
+            }
+          canRedo = false;
+        }
+      ++stats.macroSteps;
+      stats.maxError = std::max (stats.maxError, err);
+      double hTaken = tRet - tStart;
+      if ((!limited) || (fact < 1.0))
+        {
+          h = std::max (minStep, hTaken * fact);
+        }
+      prevAlg.swap (baseAlg);
+      prevTime = baseTime;
+      baseAlg.assign (alg->state_data (), alg->state_data () + asize);
+      baseTime = tRet;
+      tStart = tRet;
+      sim->timeCurr = tRet;
+      if ((retval != FUNCTION_EXECUTION_SUCCESS) || (tRet + timeTol < tNext))
+        {
+          break;
+        }
+    }
+  stepSize = h;
+  tReturn = tStart;
+  return retval;
+}
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef PARTITIONED_COUPLING_H_
+#define PARTITIONED_COUPLING_H_
+
+#include "gridDynTypes.h"
+
+#include <memory>
+#include <vector>
+
+class gridDynSimulation;
+class solverInterface;
+
+/** @brief error controlled coupling between the differential and algebraic solvers of the partitioned dynamic solution
+ the partitioned solution normally holds the algebraic states constant while the differential solver advances.  The
+coupling instead feeds the differential solver a polynomial extrapolation of the algebraic states from the previous
+macro steps,  compares the prediction against the algebraic solution at the end of each macro step,  and uses the
+difference as an estimate of the coupling error.  Steps with too large an error are repeated with the algebraic states
+interpolated toward the new solution,  and if that does not converge the step is rejected and retaken with a smaller
+size.  The macro step size is adapted from the error estimate.
+*/
+class partitionedCoupling
+{
+public:
+  /** @brief counters for the coupled solution*/
+  class couplingStats
+  {
+public:
+    count_t macroSteps = 0;  //!< the number of accepted macro steps
+    count_t rejectedSteps = 0;  //!< the number of rejected macro steps
+    count_t interfaceIterations = 0;  //!< the number of repeated macro step solutions
+    double maxError = 0.0;  //!< the largest accepted normalized coupling error
+  };
+
+  explicit partitionedCoupling (gridDynSimulation *gds);
+
+  /** @brief set the tolerance on the algebraic state prediction error*/
+  void setTolerance (double tol)
+  {
+    tolerance = tol;
+  }
+  double getTolerance () const
+  {
+    return tolerance;
+  }
+  /** @brief set the order of the algebraic state extrapolation 0 for a constant or 1 for linear extrapolation*/
+  void setOrder (int ord)
+  {
+    order = (ord > 0) ? 1 : 0;
+  }
+  /** @brief set the maximum number of repeated solutions of a macro step before it is rejected*/
+  void setMaxIterations (count_t iter)
+  {
+    maxIterations = iter;
+  }
+  /** @brief set the number of nonlinear iterations the algebraic solver may take between Jacobian updates
+   the algebraic solutions at the end of consecutive macro steps are close so the Jacobian can be reused across them
+  */
+  void setJacobianReuse (count_t reuse)
+  {
+    jacobianReuse = reuse;
+    reusePending = (reuse > 0);
+  }
+  /** @brief set the smallest macro step the error control may shrink to*/
+  void setMinStep (double step)
+  {
+    minStep = step;
+  }
+  /** @brief turn the coupling on or off*/
+  void setActive (bool act)
+  {
+    active = act;
+    reset ();
+  }
+  bool isActive () const
+  {
+    return active;
+  }
+  /** @brief clear the extrapolation history,  called when a discrete change invalidates the previous steps*/
+  void reset ();
+  const couplingStats &getStats () const
+  {
+    return stats;
+  }
+  /** @brief get the algebraic states the differential solver should use at a particular time
+  @param[in] time the time of the evaluation
+  @param[in] algState the current state of the algebraic solver
+  @return a pointer to the algebraic states to use,  algState if no prediction is being made
+  */
+  const double *predict (double time, const double *algState);
+  /** @brief advance the partitioned solution to a stop time with error controlled macro steps
+   the algebraic solver must hold a solution at the current simulation time
+  @param[in] diff the differential solver
+  @param[in] alg the algebraic solver
+  @param[in] tStop the time to advance to
+  @param[out] tReturn the time actually reached
+  @return the return code of the solvers,  SOLVER_ROOT_FOUND if the differential solver stopped at a root
+  */
+  int advance (std::shared_ptr<solverInterface> &diff, std::shared_ptr<solverInterface> &alg, double tStop, double &tReturn);
+
+private:
+  /** @brief the way the algebraic states are predicted*/
+  enum class predict_mode
+  {
+    none,  //!< use the algebraic solver states
+    extrapolate,  //!< extrapolate from the previous macro steps
+    interpolate,  //!< interpolate to the solution at the end of the macro step
+  };
+  gridDynSimulation *sim;  //!< the simulation
+  couplingStats stats;  //!< the coupling counters
+  double tolerance = 1e-4;  //!< the relative and absolute tolerance on the prediction error
+  double minStep = 1e-4;  //!< the smallest macro step
+  double stepSize = 0.0;  //!< the current macro step size,  0 to use the full interval
+  count_t maxIterations = 2;  //!< the maximum number of repeated solutions of a macro step
+  count_t jacobianReuse = 0;  //!< the number of iterations between Jacobian updates in the algebraic solver,  0 to leave the solver setting
+  int order = 1;  //!< the order of the extrapolation
+  bool active = false;  //!< indicator that the coupling is used
+  bool reusePending = false;  //!< indicator that the Jacobian reuse has not been passed to the algebraic solver
+  bool canRedo = true;  //!< indicator that the differential solver can be reset to repeat a step
+  predict_mode pmode = predict_mode::none;  //!< the current prediction mode
+  double prevTime = kNullVal;  //!< the time of the previous accepted algebraic solution
+  double baseTime = kNullVal;  //!< the time of the latest accepted algebraic solution
+  double endTime = 0.0;  //!< the end time of the macro step during the interface iterations
+  std::vector<double> prevAlg;  //!< the previous accepted algebraic solution
+  std::vector<double> baseAlg;  //!< the latest accepted algebraic solution
+  std::vector<double> endAlg;  //!< the algebraic solution at the end of the macro step
+  std::vector<double> predicted;  //!< storage for the predicted algebraic states
+  std::vector<double> diffSave;  //!< the differential states at the start of the macro step
+  std::vector<double> derivSave;  //!< the derivatives at the start of the macro step
+
+  /** @brief fill the prediction storage for a particular time*/
+  void fillPrediction (double time);
+  /** @brief compute the normalized error between the algebraic solution and the prediction storage*/
+  double predictionError (const double *algState) const;
+  /** @brief load the saved differential states back into the differential solver*/
+  int restoreStart (std::shared_ptr<solverInterface> &diff, double time);
+};
+
+#endif
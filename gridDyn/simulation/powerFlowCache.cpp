@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "powerFlowCache.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/gridLink.h"
+#include "loadModels/gridLoad.h"
+#include "generators/gridDynGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+//FNV-1a hash of a sequence of integers
+static void hashCombine (std::uint64_t &hash, std::uint64_t val)
+{
+  for (int kk = 0; kk < 8; ++kk)
+    {
+      hash ^= (val >> (8 * kk)) & 0xFF;
+      hash *= 1099511628211ULL;
+    }
+}
+
+static void collectLinks (const gridArea *area, std::vector<gridLink *> &linkList)
+{
+  index_t kk = 0;
+  gridLink *lnk;
+  while ((lnk = area->getLink (kk)) != nullptr)
+    {
+      linkList.push_back (lnk);
+      ++kk;
+    }
+  kk = 0;
+  gridArea *subArea;
+  while ((subArea = area->getArea (kk)) != nullptr)
+    {
+      collectLinks (subArea, linkList);
+      ++kk;
+    }
+}
+
+static double distance (const std::vector<double> &a, const std::vector<double> &b)
+{
+  double sum = 0.0;
+  for (size_t kk = 0; kk < a.size (); ++kk)
+    {
+      sum += (a[kk] - b[kk]) * (a[kk] - b[kk]);
+    }
+  return std::sqrt (sum);
+}
+
+powerFlowCache::powerFlowCache (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+void powerFlowCache::setCapacity (count_t cap)
+{
+  capacity = cap;
+  if (entries.size () > capacity)
+    {
+      //keep the most recently used entries
+      std::sort (entries.begin (), entries.end (), [](const cacheEntry &e1, const cacheEntry &e2) {
+          return (e1.lastUse > e2.lastUse);
+        });
+      entries.resize (capacity);
+    }
+}
+
+void powerFlowCache::clear ()
+{
+  entries.clear ();
+  stats = cacheStats ();
+  lastResult = cache_result::miss;
+  matchIndex = kNullLocation;
+}
+
+void powerFlowCache::loadNetwork (const solverMode &sMode)
+{
+  buses.clear ();
+  sim->getBusVector (buses);
+  links.clear ();
+  collectLinks (sim, links);
+
+  currentStateSize = sim->stateSize (sMode);
+  currentTopology = 14695981039346656037ULL;
+  hashCombine (currentTopology, currentStateSize);
+  for (auto &bus : buses)
+    {
+      hashCombine (currentTopology, bus->getID ());
+      hashCombine (currentTopology, (bus->enabled) ? 1 : 0);
+      hashCombine (currentTopology, (bus->isConnected ()) ? 1 : 0);
+    }
+  for (auto &lnk : links)
+    {
+      hashCombine (currentTopology, lnk->getID ());
+      hashCombine (currentTopology, (lnk->enabled) ? 1 : 0);
+      hashCombine (currentTopology, (lnk->isConnected ()) ? 1 : 0);
+      auto b1 = lnk->getBus (1);
+      auto b2 = lnk->getBus (2);
+      hashCombine (currentTopology, (b1) ? b1->getID () : kNullLocation);
+      hashCombine (currentTopology, (b2) ? b2->getID () : kNullLocation);
+    }
+
+  //the injections are evaluated at nominal voltage so they do not depend on the previous solution
+  currentInjections.assign (2 * buses.size (), 0.0);
+  for (size_t kk = 0; kk < buses.size (); ++kk)
+    {
+      index_t ii = 0;
+      gridLoad *ld;
+      while ((ld = buses[kk]->getLoad (ii)) != nullptr)
+        {
+          if (ld->enabled)
+            {
+              currentInjections[2 * kk] -= ld->getRealPower (1.0);
+              currentInjections[2 * kk + 1] -= ld->getReactivePower (1.0);
+            }
+          ++ii;
+        }
+      ii = 0;
+      gridDynGenerator *gen;
+      while ((gen = buses[kk]->getGen (ii)) != nullptr)
+        {
+          if (gen->enabled)
+            {
+              currentInjections[2 * kk] += gen->get ("pset");
+            }
+          ++ii;
+        }
+    }
+}
+
+void powerFlowCache::applySettings (const cacheEntry &entry)
+{
+  changedSettings = false;
+  for (size_t kk = 0; kk < links.size (); ++kk)
+    {
+      if (entry.taps[kk] == kNullVal)
+        {
+          continue;
+        }
+      if (std::abs (links[kk]->get ("tap") - entry.taps[kk]) > 1e-12)
+        {
+          if (links[kk]->set ("currenttap", entry.taps[kk]) == PARAMETER_FOUND)
+            {
+              changedSettings = true;
+            }
+        }
+    }
+  for (size_t kk = 0; kk < buses.size (); ++kk)
+    {
+      auto lim = buses[kk]->get ("qlimit");
+      if (lim == kNullVal)
+        {
+          continue;
+        }
+      if (static_cast<int> (lim) != entry.qLimits[kk])
+        {
+          buses[kk]->set ("qlimit", (entry.qLimits[kk] > 0) ? "max" : ((entry.qLimits[kk] < 0) ? "min" : "none"));
+          changedSettings = true;
+        }
+    }
+}
+
+powerFlowCache::cache_result powerFlowCache::lookup (const solverMode &sMode)
+{
+  ++stats.lookups;
+  loadNetwork (sMode);
+  lastResult = cache_result::miss;
+  matchIndex = kNullLocation;
+  changedSettings = false;
+  startState.clear ();
+
+  double injNorm = 0.0;
+  for (auto &inj : currentInjections)
+    {
+      injNorm += inj * inj;
+    }
+  injNorm = (std::max)(std::sqrt (injNorm), 1e-6);
+
+  //find the candidate entries sorted by distance
+  std::vector<std::pair<double, index_t> > candidates;
+  for (index_t kk = 0; kk < entries.size (); ++kk)
+    {
+      const auto &entry = entries[kk];
+      if ((entry.topology != currentTopology) || (entry.injections.size () != currentInjections.size ()))
+        {
+          continue;
+        }
+      double dist = distance (entry.injections, currentInjections) / injNorm;
+      if (dist <= matchTolerance)
+        {
+          candidates.emplace_back (dist, kk);
+        }
+    }
+  if (candidates.empty ())
+    {
+      return lastResult;
+    }
+  std::sort (candidates.begin (), candidates.end ());
+  if (candidates.size () > neighbors)
+    {
+      candidates.resize (neighbors);
+    }
+  auto &nearest = entries[candidates[0].second];
+  nearest.lastUse = stats.lookups;
+  applySettings (nearest);
+  if (candidates[0].first <= exactTolerance)
+    {
+      startState = nearest.state;
+      matchIndex = candidates[0].second;
+      lastResult = cache_result::exact;
+      ++stats.exactHits;
+      return lastResult;
+    }
+  //inverse distance weighting of the neighboring states
+  startState.assign (nearest.state.size (), 0.0);
+  double wsum = 0.0;
+  for (auto &cand : candidates)
+    {
+      auto &entry = entries[cand.second];
+      if (entry.state.size () != startState.size ())
+        {
+          continue;
+        }
+      entry.lastUse = stats.lookups;
+      double wt = 1.0 / cand.first;
+      wsum += wt;
+      for (size_t ii = 0; ii < startState.size (); ++ii)
+        {
+          startState[ii] += wt * entry.state[ii];
+        }
+    }
+  for (auto &st : startState)
+    {
+      st /= wsum;
+    }
+  lastResult = cache_result::blended;
+  ++stats.blendedHits;
+  return lastResult;
+}
+
+bool powerFlowCache::loadState (double state[], count_t size) const
+{
+  if ((lastResult == cache_result::miss) || (startState.size () != size))
+    {
+      return false;
+    }
+  std::copy (startState.begin (), startState.end (), state);
+  return true;
+}
+
+void powerFlowCache::store (const double state[], count_t size, double evaluations)
+{
+  if (lastResult == cache_result::miss)
+    {
+      stats.missEvaluations += evaluations;
+      ++stats.missSolves;
+    }
+  else
+    {
+      stats.hitEvaluations += evaluations;
+      ++stats.hitSolves;
+    }
+  if (capacity == 0)
+    {
+      return;
+    }
+  //the network may have changed during the solution, in that case the solution does not belong to the lookup key
+  if ((buses.empty ()) || (size != currentStateSize))
+    {
+      return;
+    }
+  cacheEntry *entry;
+  if (matchIndex != kNullLocation)
+    {
+      entry = &(entries[matchIndex]);
+    }
+  else if (entries.size () < capacity)
+    {
+      entries.emplace_back ();
+      entry = &(entries.back ());
+    }
+  else
+    {
+      auto lru = std::min_element (entries.begin (), entries.end (), [](const cacheEntry &e1, const cacheEntry &e2) {
+          return (e1.lastUse < e2.lastUse);
+        });
+      entry = &(*lru);
+      ++stats.evictions;
+    }
+  entry->topology = currentTopology;
+  entry->injections = currentInjections;
+  entry->state.assign (state, state + size);
+  entry->lastUse = stats.lookups;
+  entry->taps.resize (links.size ());
+  for (size_t kk = 0; kk < links.size (); ++kk)
+    {
+      entry->taps[kk] = links[kk]->get ("tap");
+    }
+  entry->qLimits.resize (buses.size ());
+  for (size_t kk = 0; kk < buses.size (); ++kk)
+    {
+      auto lim = buses[kk]->get ("qlimit");
+      entry->qLimits[kk] = (lim == kNullVal) ? 0 : static_cast<int> (lim);
+    }
+  ++stats.stores;
+  //only one store per lookup
+  matchIndex = kNullLocation;
+  buses.clear ();
+  links.clear ();
+}
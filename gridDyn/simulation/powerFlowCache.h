@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef POWER_FLOW_CACHE_H_
+#define POWER_FLOW_CACHE_H_
+
+#include "gridDynTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+class gridDynSimulation;
+class gridBus;
+class gridLink;
+class solverMode;
+
+/** @brief cache of converged power flow solutions used to warm start later solutions
+ entries are keyed by a signature of the network topology and the vector of bus injections at nominal voltage.  Each
+entry holds the converged power flow state along with the transformer taps and the reactive limit status of the PV buses.
+A lookup selects the entries with the same topology whose injections are within the match tolerance,  the discrete settings of the
+nearest entry are applied to the network and the starting state is the nearest state or an inverse distance blend of up to
+the neighbor count entries.  The least recently used entry is replaced when the cache is full.
+*/
+class powerFlowCache
+{
+public:
+  /** @brief the result of a cache lookup*/
+  enum class cache_result
+  {
+    miss,  //!< no entry was close enough
+    exact,  //!< an entry had the same injections
+    blended,  //!< the start was taken from one or more nearby entries
+  };
+
+  /** @brief statistics on the cache usage*/
+  class cacheStats
+  {
+public:
+    count_t lookups = 0;  //!< the number of lookups
+    count_t exactHits = 0;  //!< the number of lookups matching an entry exactly
+    count_t blendedHits = 0;  //!< the number of lookups starting from nearby entries
+    count_t stores = 0;  //!< the number of solutions stored
+    count_t evictions = 0;  //!< the number of entries replaced
+    double hitEvaluations = 0;  //!< the residual evaluations used by solutions started from the cache
+    double missEvaluations = 0;  //!< the residual evaluations used by solutions without a cached start
+    count_t hitSolves = 0;  //!< the number of solutions started from the cache that converged
+    count_t missSolves = 0;  //!< the number of solutions without a cached start that converged
+
+    /** @brief get the fraction of lookups with a cached start*/
+    double hitRate () const
+    {
+      return (lookups > 0) ? static_cast<double> (exactHits + blendedHits) / static_cast<double> (lookups) : 0.0;
+    }
+    /** @brief get the average number of residual evaluations saved by a cached start*/
+    double evaluationSavings () const
+    {
+      if ((hitSolves == 0) || (missSolves == 0))
+        {
+          return 0.0;
+        }
+      return missEvaluations / static_cast<double> (missSolves) - hitEvaluations / static_cast<double> (hitSolves);
+    }
+  };
+
+  explicit powerFlowCache (gridDynSimulation *gds);
+
+  /** @brief look up a starting point for the power flow
+   applies the discrete settings of the nearest entry to the network,  the caller should reinitialize the solver if
+  settingsChanged() returns true and then call loadState after the initial guess
+  @param[in] sMode the power flow solver mode
+  @return the type of match found
+  */
+  cache_result lookup (const solverMode &sMode);
+  /** @brief check if the last lookup changed a tap or a reactive limit status*/
+  bool settingsChanged () const
+  {
+    return changedSettings;
+  }
+  /** @brief overwrite a state vector with the cached starting point from the last lookup
+  @param[out] state the state vector to load
+  @param[in] size the size of the state vector
+  @return true if the state was loaded
+  */
+  bool loadState (double state[], count_t size) const;
+  /** @brief store a converged solution under the key from the last lookup
+  @param[in] state the converged state vector
+  @param[in] size the size of the state vector
+  @param[in] evaluations the number of residual evaluations used in the solution
+  */
+  void store (const double state[], count_t size, double evaluations);
+
+  /** @brief set the maximum number of entries, setting 0 clears the cache*/
+  void setCapacity (count_t cap);
+  /** @brief set the relative injection distance beyond which entries are not used*/
+  void setMatchTolerance (double tol)
+  {
+    matchTolerance = tol;
+  }
+  /** @brief set the number of entries blended for the starting state*/
+  void setNeighbors (count_t count)
+  {
+    neighbors = (count > 0) ? count : 1;
+  }
+  count_t size () const
+  {
+    return static_cast<count_t> (entries.size ());
+  }
+  const cacheStats &getStats () const
+  {
+    return stats;
+  }
+  /** @brief remove all the entries and clear the statistics*/
+  void clear ();
+
+private:
+  /** @brief a cached power flow solution*/
+  class cacheEntry
+  {
+public:
+    std::uint64_t topology = 0;  //!< the topology signature
+    std::vector<double> injections;  //!< the bus injections the solution was computed for
+    std::vector<double> state;  //!< the converged state
+    std::vector<double> taps;  //!< the link taps, kNullVal for links without a tap
+    std::vector<int> qLimits;  //!< the reactive limit status of each bus 1 at max -1 at min 0 otherwise
+    count_t lastUse = 0;  //!< the lookup count at the last use of the entry
+  };
+
+  gridDynSimulation *sim;  //!< the simulation the cache works on
+  std::vector<cacheEntry> entries;  //!< the cached solutions
+  count_t capacity = 100;  //!< the maximum number of entries
+  double matchTolerance = 0.2;  //!< the maximum relative injection distance for a cached start
+  count_t neighbors = 3;  //!< the maximum number of entries blended
+  double exactTolerance = 1e-10;  //!< relative distance at which a match is treated as exact
+
+  std::vector<gridBus *> buses;  //!< the buses of the network at the last lookup
+  std::vector<gridLink *> links;  //!< the links of the network at the last lookup
+  std::uint64_t currentTopology = 0;  //!< the topology signature of the last lookup
+  count_t currentStateSize = 0;  //!< the power flow state size at the last lookup
+  std::vector<double> currentInjections;  //!< the injections of the last lookup
+  std::vector<double> startState;  //!< the starting state from the last lookup
+  cache_result lastResult = cache_result::miss;  //!< the result of the last lookup
+  index_t matchIndex = kNullLocation;  //!< the entry matched exactly in the last lookup
+  bool changedSettings = false;  //!< the last lookup changed the discrete settings
+  cacheStats stats;  //!< the usage statistics
+
+  void loadNetwork (const solverMode &sMode);
+  void applySettings (const cacheEntry &entry);
+};
+
+#endif
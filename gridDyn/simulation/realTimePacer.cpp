@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "realTimePacer.h"
+#include "basicDefs.h"
+#include "stringOps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+static const char *sectionNames[] = {
+  "solver", "events", "recorders", "io", "other", "total"
+};
+
+realTimePacer::timingHistogram::timingHistogram (double mTime, count_t bPerDecade, count_t decades) : minTime (mTime), binsPerDecade (static_cast<double> (bPerDecade)),
+  counts (bPerDecade * decades + 2, 0)
+{
+
+}
+
+void realTimePacer::timingHistogram::add (double time)
+{
+  index_t bin = 0;
+  if (time >= minTime)
+    {
+      auto fbin = std::floor (std::log10 (time / minTime) * binsPerDecade) + 1.0;
+      bin = (fbin >= static_cast<double> (counts.size () - 1)) ? static_cast<index_t> (counts.size () - 1) : static_cast<index_t> (fbin);
+    }
+  ++counts[bin];
+  ++total;
+  sum += time;
+  maxVal = (std::max)(maxVal, time);
+}
+
+double realTimePacer::timingHistogram::binLow (index_t bin) const
+{
+  if (bin == 0)
+    {
+      return 0.0;
+    }
+  return minTime * std::pow (10.0, static_cast<double> (bin - 1) / binsPerDecade);
+}
+
+double realTimePacer::timingHistogram::binHigh (index_t bin) const
+{
+  if (bin + 1 >= counts.size ())
+    {
+      return kBigNum;
+    }
+  return binLow (bin + 1);
+}
+
+double realTimePacer::timingHistogram::quantile (double q) const
+{
+  if (total == 0)
+    {
+      return 0.0;
+    }
+  double target = q * static_cast<double> (total);
+  double cumulative = 0.0;
+  for (index_t kk = 0; kk < counts.size (); ++kk)
+    {
+      cumulative += static_cast<double> (counts[kk]);
+      if (cumulative >= target)
+        {
+          return (std::min)(binHigh (kk), maxVal);
+        }
+    }
+  return maxVal;
+}
+
+void realTimePacer::timingHistogram::clear ()
+{
+  std::fill (counts.begin (), counts.end (), 0);
+  total = 0;
+  sum = 0.0;
+  maxVal = 0.0;
+}
+
+realTimePacer::realTimePacer (double newRatio) : ratio (newRatio), histograms (sectionCount)
+{
+  sectionTime.fill (0.0);
+}
+
+void realTimePacer::setRatio (double newRatio)
+{
+  ratio = newRatio;
+  //the deadlines have to be recomputed from the current time with the new ratio
+  if (started)
+    {
+      wallAnchor = pacerClock::now ();
+      simAnchor = simTarget;
+    }
+}
+
+int realTimePacer::setDegradation (const std::string &steps)
+{
+  unsigned int flags = 0;
+  auto stepList = splitlineTrim (convertToLowerCase (steps));
+  for (auto &step : stepList)
+    {
+      if ((step == "recorders") || (step == "recorder"))
+        {
+          flags |= degrade_recorders;
+        }
+      else if (step == "jacobian")
+        {
+          flags |= degrade_jacobian;
+        }
+      else if (step == "all")
+        {
+          flags |= (degrade_recorders | degrade_jacobian);
+        }
+      else if ((step == "none") || (step.empty ()))
+        {
+        }
+      else
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  degradeSteps = flags;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void realTimePacer::start (double simTime)
+{
+  simAnchor = simTime;
+  simTarget = simTime;
+  wallAnchor = pacerClock::now ();
+  lastFrameEnd = wallAnchor;
+  started = true;
+}
+
+void realTimePacer::beginFrame (double target)
+{
+  if (!started)
+    {
+      start (target);
+    }
+  auto now = pacerClock::now ();
+  sectionTime.fill (0.0);
+  std::chrono::duration<double> between = now - lastFrameEnd;
+  sectionTime[static_cast<int> (frame_section::io)] = between.count ();
+  frameStart = now;
+  simTarget = target;
+  if (ratio > 0)
+    {
+      deadline = wallAnchor + std::chrono::duration_cast<pacerClock::duration> (std::chrono::duration<double> ((target - simAnchor) / ratio));
+    }
+  if (degradeActive)
+    {
+      ++stats.degradedFrames;
+    }
+  inFrame = true;
+}
+
+bool realTimePacer::endFrame ()
+{
+  if (!inFrame)
+    {
+      return false;
+    }
+  inFrame = false;
+  auto now = pacerClock::now ();
+  std::chrono::duration<double> work = now - frameStart;
+  std::chrono::duration<double> frameTime = now - lastFrameEnd;
+  double covered = sectionTime[static_cast<int> (frame_section::solver)] + sectionTime[static_cast<int> (frame_section::events)] + sectionTime[static_cast<int> (frame_section::recorders)];
+  sectionTime[static_cast<int> (frame_section::other)] = (std::max)(work.count () - covered, 0.0);
+  sectionTime[static_cast<int> (frame_section::total)] = frameTime.count ();
+  for (int kk = 0; kk < sectionCount; ++kk)
+    {
+      histograms[kk].add (sectionTime[kk]);
+    }
+  ++stats.frames;
+
+  bool overrun = false;
+  if (ratio > 0)
+    {
+      std::chrono::duration<double> budget = deadline - lastFrameEnd;
+      std::chrono::duration<double> lateness = now - deadline;
+      lastFrameLateness = lateness.count ();
+      lastFrameUsage = (budget.count () > 0) ? frameTime.count () / budget.count () : kBigNum;
+      if (lastFrameLateness > 0)
+        {
+          overrun = true;
+          ++stats.overruns;
+          ++consecutiveOverruns;
+          stats.maxConsecutiveOverruns = (std::max)(stats.maxConsecutiveOverruns, consecutiveOverruns);
+          stats.worstOverrun = (std::max)(stats.worstOverrun, lastFrameLateness);
+          if (resyncOnOverrun)
+            {
+              wallAnchor = now;
+              simAnchor = simTarget;
+            }
+        }
+      else
+        {
+          consecutiveOverruns = 0;
+          stats.totalSlack -= lastFrameLateness;
+          std::this_thread::sleep_until (deadline);
+        }
+    }
+  else
+    {
+      lastFrameLateness = 0.0;
+      lastFrameUsage = 0.0;
+    }
+  //hysteresis on the degradation so the frames do not toggle between degraded and normal operation
+  if (degradeSteps != 0)
+    {
+      if ((!degradeActive) && (lastFrameUsage > riskThreshold))
+        {
+          degradeActive = true;
+        }
+      else if ((degradeActive) && (lastFrameUsage < 0.5 * riskThreshold))
+        {
+          degradeActive = false;
+        }
+    }
+  lastFrameEnd = pacerClock::now ();
+  return overrun;
+}
+
+std::string realTimePacer::getSummary () const
+{
+  std::string out = "real time frames=" + std::to_string (stats.frames) + " overruns=" + std::to_string (stats.overruns);
+  out += " degraded=" + std::to_string (stats.degradedFrames) + " max consecutive overruns=" + std::to_string (stats.maxConsecutiveOverruns);
+  out += " worst overrun=" + std::to_string (stats.worstOverrun) + "s\n";
+  for (int kk = 0; kk < sectionCount; ++kk)
+    {
+      const auto &hist = histograms[kk];
+      out += std::string (sectionNames[kk]) + ": mean=" + std::to_string (hist.mean ()) + "s p50=" + std::to_string (hist.quantile (0.5));
+      out += "s p99=" + std::to_string (hist.quantile (0.99)) + "s max=" + std::to_string (hist.maxTime ()) + "s\n";
+    }
+  return out;
+}
+
+int realTimePacer::exportHistograms (const std::string &fileName) const
+{
+  std::ofstream out (fileName);
+  if (!out)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  out << "bin_low,bin_high";
+  for (int kk = 0; kk < sectionCount; ++kk)
+    {
+      out << ',' << sectionNames[kk];
+    }
+  out << '\n';
+  const auto &reference = histograms[0];
+  auto binCount = reference.getCounts ().size ();
+  for (index_t bb = 0; bb < binCount; ++bb)
+    {
+      out << reference.binLow (bb) << ',';
+      if (bb + 1 < binCount)
+        {
+          out << reference.binHigh (bb);
+        }
+      else
+        {
+          out << "inf";
+        }
+      for (int kk = 0; kk < sectionCount; ++kk)
+        {
+          out << ',' << histograms[kk].getCounts ()[bb];
+        }
+      out << '\n';
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void realTimePacer::reset ()
+{
+  for (auto &hist : histograms)
+    {
+      hist.clear ();
+    }
+  stats = frameStats ();
+  consecutiveOverruns = 0;
+  degradeActive = false;
+  started = false;
+  inFrame = false;
+}
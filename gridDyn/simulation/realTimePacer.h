@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_REAL_TIME_PACER_H_
+#define GRIDDYN_REAL_TIME_PACER_H_
+
+#include "gridDynTypes.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/** @brief pace simulation steps against a monotonic clock and account for the time spent in each frame
+ a frame is one call to advance the simulation to a requested time,  the deadline for a frame is the wall clock time at which
+the requested simulation time is due given the pacing ratio.  Frames that finish early wait for the deadline,  frames that finish
+late are counted as overruns.  The time inside each frame is split into solver, event, recorder, io, and other sections and
+accumulated into log scaled histograms.  When the fraction of the frame budget used rises above the risk threshold the pacer
+reports the next frames as degraded until the usage falls back below half the threshold.
+*/
+class realTimePacer
+{
+public:
+  /** @brief the sections of a frame that are timed separately*/
+  enum class frame_section
+  {
+    solver = 0,  //!< time in the dynamic or power flow solver
+    events = 1,  //!< time executing events
+    recorders = 2,  //!< time executing recorders and other delayed events
+    io = 3,  //!< time spent by the caller between frames
+    other = 4,  //!< time in the frame not covered by another section
+    total = 5,  //!< the total time of the frame
+  };
+  static const int sectionCount = 6;
+
+  /** @brief flags for the degradation steps taken when a frame is at risk*/
+  enum degrade_flags
+  {
+    degrade_recorders = 1,  //!< suspend recorder sampling
+    degrade_jacobian = 2,  //!< reuse the existing Jacobian in the dynamic solver
+  };
+
+  /** @brief histogram of frame times with log scaled bins
+   the first and last bins collect all values below and above the bin range
+  */
+  class timingHistogram
+  {
+public:
+    /** @brief constructor
+    @param[in] minTime the upper edge of the first bin in seconds
+    @param[in] binsPerDecade the number of bins in each factor of 10
+    @param[in] decades the number of decades covered by the histogram
+    */
+    timingHistogram (double minTime = 1e-6, count_t binsPerDecade = 10, count_t decades = 7);
+    /** @brief add a time to the histogram*/
+    void add (double time);
+    /** @brief get the lower edge of a bin*/
+    double binLow (index_t bin) const;
+    /** @brief get the upper edge of a bin*/
+    double binHigh (index_t bin) const;
+    /** @brief get an estimate of a quantile from the bin counts
+    @param[in] q the quantile in [0,1]
+    @return the upper edge of the bin containing the quantile or the maximum if it is in the last bin
+    */
+    double quantile (double q) const;
+    const std::vector<count_t> &getCounts () const
+    {
+      return counts;
+    }
+    count_t count () const
+    {
+      return total;
+    }
+    double maxTime () const
+    {
+      return maxVal;
+    }
+    double mean () const
+    {
+      return (total > 0) ? sum / static_cast<double> (total) : 0.0;
+    }
+    void clear ();
+private:
+    double minTime;  //!< the upper edge of the first bin
+    double binsPerDecade;  //!< the number of bins in each decade
+    std::vector<count_t> counts;  //!< the bin counts
+    count_t total = 0;  //!< the number of entries
+    double sum = 0.0;  //!< the sum of all entries
+    double maxVal = 0.0;  //!< the largest entry
+  };
+
+  /** @brief summary statistics of the frames*/
+  class frameStats
+  {
+public:
+    count_t frames = 0;  //!< the number of completed frames
+    count_t overruns = 0;  //!< the number of frames that missed their deadline
+    count_t degradedFrames = 0;  //!< the number of frames run with degradation active
+    count_t maxConsecutiveOverruns = 0;  //!< the longest run of frames that missed their deadline
+    double worstOverrun = 0.0;  //!< the largest amount a deadline was missed by in seconds
+    double totalSlack = 0.0;  //!< the total time spent waiting for deadlines in seconds
+  };
+
+  /** @brief constructor
+  @param[in] ratio the simulated seconds per wall clock second, a ratio <=0 runs as fast as possible with timing only
+  */
+  explicit realTimePacer (double ratio = 1.0);
+
+  /** @brief anchor simulation time to the current wall clock time*/
+  void start (double simTime);
+  /** @brief check if the clock has been anchored*/
+  bool isStarted () const
+  {
+    return started;
+  }
+  /** @brief begin a frame which should advance the simulation to simTarget
+   if the clock has not been anchored it is anchored at simTarget so the first frame has no budget
+  */
+  void beginFrame (double simTarget);
+  /** @brief add time to a section of the current frame*/
+  void addTime (frame_section section, double seconds)
+  {
+    sectionTime[static_cast<int> (section)] += seconds;
+  }
+  /** @brief end the current frame and wait for its deadline
+  @return true if the frame missed its deadline
+  */
+  bool endFrame ();
+
+  /** @brief check if degradation is active for the current frame*/
+  bool degraded () const
+  {
+    return degradeActive;
+  }
+  /** @brief get the degradation steps to take when degraded*/
+  unsigned int getDegradation () const
+  {
+    return degradeSteps;
+  }
+  /** @brief set the degradation steps to take when a frame is at risk as a combination of degrade_flags*/
+  void setDegradation (unsigned int flags)
+  {
+    degradeSteps = flags;
+  }
+  /** @brief set the degradation steps from a comma separated list of "recorders" and "jacobian"
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if a step is not recognized
+  */
+  int setDegradation (const std::string &steps);
+  /** @brief set the fraction of the frame budget above which a frame is considered at risk*/
+  void setRiskThreshold (double fraction)
+  {
+    riskThreshold = fraction;
+  }
+  /** @brief set the simulated seconds per wall clock second*/
+  void setRatio (double newRatio);
+  double getRatio () const
+  {
+    return ratio;
+  }
+  /** @brief set whether the clock is reanchored after an overrun so a single late frame does not make later frames late*/
+  void setResync (bool resync)
+  {
+    resyncOnOverrun = resync;
+  }
+  /** @brief get the fraction of the budget used by the last frame*/
+  double lastUsage () const
+  {
+    return lastFrameUsage;
+  }
+  /** @brief get the lateness of the last frame in seconds, negative if it finished early*/
+  double lastLateness () const
+  {
+    return lastFrameLateness;
+  }
+  const frameStats &getStats () const
+  {
+    return stats;
+  }
+  const timingHistogram &getHistogram (frame_section section) const
+  {
+    return histograms[static_cast<int> (section)];
+  }
+  /** @brief get a multiline summary of the frame statistics*/
+  std::string getSummary () const;
+  /** @brief write the section histograms to a csv file
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the file could not be opened
+  */
+  int exportHistograms (const std::string &fileName) const;
+  /** @brief clear the statistics and histograms*/
+  void reset ();
+
+  /** @brief helper object to add the time of a scope to a section of the current frame
+   does nothing if constructed with a null pacer
+  */
+  class sectionTimer
+  {
+public:
+    sectionTimer (realTimePacer *rtp, frame_section sec) : pacer (rtp), section (sec)
+    {
+      if (pacer)
+        {
+          tstart = std::chrono::steady_clock::now ();
+        }
+    }
+    ~sectionTimer ()
+    {
+      if (pacer)
+        {
+          std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - tstart;
+          pacer->addTime (section, elapsed.count ());
+        }
+    }
+private:
+    realTimePacer *pacer;
+    frame_section section;
+    std::chrono::steady_clock::time_point tstart;
+  };
+
+private:
+  using pacerClock = std::chrono::steady_clock;
+  double ratio = 1.0;  //!< simulated seconds per wall clock second
+  double riskThreshold = 0.8;  //!< the fraction of the budget at which a frame is at risk
+  unsigned int degradeSteps = 0;  //!< the degradation steps to take
+  bool degradeActive = false;  //!< degradation is active for the current frame
+  bool resyncOnOverrun = true;  //!< reanchor the clock after an overrun
+  bool started = false;  //!< the clock has been anchored
+  bool inFrame = false;  //!< a frame is in progress
+  double simAnchor = 0.0;  //!< the simulation time at the anchor
+  pacerClock::time_point wallAnchor;  //!< the wall time at the anchor
+  pacerClock::time_point frameStart;  //!< the wall time at the start of the current frame
+  pacerClock::time_point lastFrameEnd;  //!< the wall time the last frame ended including the wait
+  pacerClock::time_point deadline;  //!< the deadline of the current frame
+  double simTarget = 0.0;  //!< the target simulation time of the current frame
+  double lastFrameUsage = 0.0;  //!< the fraction of the budget used by the last frame
+  double lastFrameLateness = 0.0;  //!< the lateness of the last frame
+  count_t consecutiveOverruns = 0;  //!< the current run of late frames
+  std::array<double, sectionCount> sectionTime;  //!< the section times of the current frame
+  std::vector<timingHistogram> histograms;  //!< a histogram for each section
+  frameStats stats;  //!< the frame statistics
+};
+
+#endif
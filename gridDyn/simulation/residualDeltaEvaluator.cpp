@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "residualDeltaEvaluator.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/gridLink.h"
+#include "solvers/solverInterface.h"
+#include "arrayDataSparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+residualDeltaEvaluator::residualDeltaEvaluator (gridDynSimulation *gds) : sim (gds)
+{
+}
+
+void residualDeltaEvaluator::setTolerance (double tol)
+{
+  tolerance = (tol > 0.0) ? tol : 0.0;
+  clearReference ();
+}
+
+void residualDeltaEvaluator::clearReference ()
+{
+  for (auto &mc : caches)
+    {
+      mc.hasReference = false;
+    }
+}
+
+void residualDeltaEvaluator::invalidate ()
+{
+  caches.clear ();
+}
+
+void residualDeltaEvaluator::invalidate (const solverMode &sMode)
+{
+  if (sMode.offsetIndex < caches.size ())
+    {
+      caches[sMode.offsetIndex] = modeCache ();
+    }
+}
+
+bool residualDeltaEvaluator::changed (double val, double ref) const
+{
+  if (tolerance == 0.0)
+    {
+      return (val != ref);
+    }
+  return (std::abs (val - ref) > tolerance * (1.0 + std::abs (ref)));
+}
+
+bool residualDeltaEvaluator::residual (const stateData *sD, double resid[], const solverMode &sMode)
+{
+  if (sMode.offsetIndex >= caches.size ())
+    {
+      caches.resize (sMode.offsetIndex + 1);
+    }
+  auto &mc = caches[sMode.offsetIndex];
+  if (!mc.built)
+    {
+      build (mc, sD, sMode);
+    }
+  if (!mc.usable)
+    {
+      return false;
+    }
+  ++stats.evaluations;
+  if ((!mc.hasReference) || (sD->time != mc.lastTime))
+    {
+      fullEvaluation (mc, sD, resid, sMode);
+      return true;
+    }
+
+  ++markCount;
+  for (index_t kk = 0; kk < mc.size; ++kk)
+    {
+      bool colChange = changed (sD->state[kk], mc.lastState[kk]);
+      if ((sD->dstate_dt) && (changed (sD->dstate_dt[kk], mc.lastDeriv[kk])))
+        {
+          colChange = true;
+        }
+      if (!colChange)
+        {
+          continue;
+        }
+      mc.lastState[kk] = sD->state[kk];
+      if (sD->dstate_dt)
+        {
+          mc.lastDeriv[kk] = sD->dstate_dt[kk];
+        }
+      for (index_t pp = mc.depStart[kk]; pp < mc.depStart[kk + 1]; ++pp)
+        {
+          mc.evalMark[mc.depObjects[pp]] = markCount;
+        }
+    }
+  //objects write every row they own so the rows of the skipped objects just need the previous values
+  std::copy (mc.lastResid.begin (), mc.lastResid.end (), resid);
+  count_t objCount = static_cast<count_t> (mc.objects.size ());
+  for (index_t kk = 0; kk < objCount; ++kk)
+    {
+      if (mc.evalMark[kk] == markCount)
+        {
+          mc.objects[kk]->residual (sD, resid, sMode);
+          ++stats.objectsEvaluated;
+        }
+      else
+        {
+          ++stats.objectsSkipped;
+        }
+    }
+  std::copy (resid, resid + mc.size, mc.lastResid.begin ());
+  return true;
+}
+
+void residualDeltaEvaluator::fullEvaluation (modeCache &mc, const stateData *sD, double resid[], const solverMode &sMode)
+{
+  for (auto &obj : mc.objects)
+    {
+      obj->residual (sD, resid, sMode);
+    }
+  stats.objectsEvaluated += static_cast<count_t> (mc.objects.size ());
+  ++stats.fullEvaluations;
+  std::copy (sD->state, sD->state + mc.size, mc.lastState.begin ());
+  if (sD->dstate_dt)
+    {
+      std::copy (sD->dstate_dt, sD->dstate_dt + mc.size, mc.lastDeriv.begin ());
+    }
+  std::copy (resid, resid + mc.size, mc.lastResid.begin ());
+  mc.lastTime = sD->time;
+  mc.hasReference = true;
+}
+
+static void addRange (std::vector<index_t> &rowOwner, index_t start, count_t cnt, index_t obj, bool &valid)
+{
+  if (cnt == 0)
+    {
+      return;
+    }
+  if ((start == kNullLocation) || (start + cnt > rowOwner.size ()))
+    {
+      valid = false;
+      return;
+    }
+  for (index_t kk = start; kk < start + cnt; ++kk)
+    {
+      if (rowOwner[kk] != kNullLocation)
+        {
+          valid = false;
+          return;
+        }
+      rowOwner[kk] = obj;
+    }
+}
+
+void residualDeltaEvaluator::build (modeCache &mc, const stateData *sD, const solverMode &sMode)
+{
+  mc = modeCache ();
+  mc.built = true;
+  //the delta scheme requires the full state in the state array and every object to be independently evaluated
+  //power flow adjustments change parameters without passing through the dynamic reset points so only dynamic modes are handled
+  if ((!isDynamic (sMode)) || (sD->pairIndex != kNullLocation) || (sim->opObjectLists.hasPreExObjects ()) || (!sim->opObjectLists.isListValid (sMode)))
+    {
+      return;
+    }
+  auto sInterface = sim->getSolverInterface (sMode);
+  if (!sInterface)
+    {
+      return;
+    }
+  mc.size = sInterface->size ();
+  mc.objects.assign (sim->opObjectLists.begin (sMode), sim->opObjectLists.end (sMode));
+  if ((mc.size == 0) || (mc.objects.empty ()))
+    {
+      return;
+    }
+  //assign each row to a single object
+  std::vector<index_t> rowOwner (mc.size, kNullLocation);
+  bool valid = true;
+  count_t objCount = static_cast<count_t> (mc.objects.size ());
+  for (index_t kk = 0; kk < objCount; ++kk)
+    {
+      auto so = mc.objects[kk]->getOffsets (sMode);
+      addRange (rowOwner, so->algOffset, so->total.algSize, kk, valid);
+      addRange (rowOwner, so->diffOffset, so->total.diffSize, kk, valid);
+      addRange (rowOwner, so->vOffset, so->total.vSize, kk, valid);
+      addRange (rowOwner, so->aOffset, so->total.aSize, kk, valid);
+    }
+  if ((!valid) || (std::find (rowOwner.begin (), rowOwner.end (), kNullLocation) != rowOwner.end ()))
+    {
+      sim->log (sim, GD_DEBUG_PRINT, "residual rows could not be assigned to objects, using full residual evaluation");
+      return;
+    }
+  //dependencies from the Jacobian structure
+  std::vector<std::pair<index_t, index_t> > deps;
+  arrayDataSparse pattern (sim->nonZeros (sMode));
+  pattern.setRowLimit (mc.size);
+  pattern.setColLimit (mc.size);
+  sim->jacobianElements (sD, &pattern, sMode);
+  deps.reserve (pattern.size () + mc.size);
+  for (index_t kk = 0; kk < pattern.size (); ++kk)
+    {
+      if ((pattern.rowIndex (kk) < mc.size) && (pattern.colIndex (kk) < mc.size))
+        {
+          deps.emplace_back (pattern.colIndex (kk), rowOwner[pattern.rowIndex (kk)]);
+        }
+    }
+  for (index_t kk = 0; kk < mc.size; ++kk)
+    {
+      deps.emplace_back (kk, rowOwner[kk]);
+    }
+  //the bus flows depend on the voltages at the far end of each link, add them in case a Jacobian entry was dropped
+  for (index_t kk = 0; kk < objCount; ++kk)
+    {
+      auto bus = dynamic_cast<gridBus *> (mc.objects[kk]);
+      if (bus == nullptr)
+        {
+          continue;
+        }
+      index_t ll = 0;
+      auto lnk = bus->getLink (0);
+      while (lnk)
+        {
+          for (index_t bb = 1; bb <= 2; ++bb)
+            {
+              auto obus = lnk->getBus (bb);
+              if ((obus) && (obus != bus))
+                {
+                  for (auto loc : obus->getOutputLocs (sMode))
+                    {
+                      if (loc < mc.size)
+                        {
+                          deps.emplace_back (loc, kk);
+                        }
+                    }
+                }
+            }
+          ++ll;
+          lnk = bus->getLink (ll);
+        }
+    }
+  std::sort (deps.begin (), deps.end ());
+  deps.erase (std::unique (deps.begin (), deps.end ()), deps.end ());
+  mc.depStart.assign (mc.size + 1, 0);
+  mc.depObjects.resize (deps.size ());
+  for (size_t kk = 0; kk < deps.size (); ++kk)
+    {
+      ++mc.depStart[deps[kk].first + 1];
+      mc.depObjects[kk] = deps[kk].second;
+    }
+  for (index_t kk = 0; kk < mc.size; ++kk)
+    {
+      mc.depStart[kk + 1] += mc.depStart[kk];
+    }
+  mc.evalMark.assign (objCount, 0);
+  mc.lastState.resize (mc.size);
+  mc.lastDeriv.resize (mc.size);
+  mc.lastResid.resize (mc.size);
+  mc.usable = true;
+}
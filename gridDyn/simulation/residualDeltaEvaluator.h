@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef RESIDUAL_DELTA_EVALUATOR_H_
+#define RESIDUAL_DELTA_EVALUATOR_H_
+
+#include "gridDynTypes.h"
+
+#include <vector>
+
+class gridDynSimulation;
+class gridPrimary;
+class stateData;
+class solverMode;
+
+/** @brief change driven evaluation of the simulation residual
+ the evaluator keeps the state, derivative, and residual from the previous evaluation at the same time point and
+on the next call only calls the residual function of the objects whose inputs changed, the residual rows of the other
+objects are copied from the previous evaluation.  The dependencies of each object are taken from the structure of the
+Jacobian, every state column appearing in a row owned by an object is an input of that object.
+In exact mode (tolerance==0) any bitwise change in a state or derivative triggers a reevaluation so the result is
+identical to a full evaluation, with a positive tolerance changes below tol*(1+|x|) are ignored and the reference
+value is kept so small changes cannot accumulate unnoticed.
+The evaluator only handles dynamic modes, a mode is evaluated in full if the simulation has objects requiring
+preexecution, if the rows cannot be uniquely assigned to objects, or if the mode uses state data paired from another solver
+*/
+class residualDeltaEvaluator
+{
+public:
+  /** @brief statistics on the evaluations*/
+  class deltaStats
+  {
+public:
+    count_t evaluations = 0;  //!< the number of residual evaluations handled
+    count_t fullEvaluations = 0;  //!< the number of evaluations which called every object
+    count_t objectsEvaluated = 0;  //!< the total number of object residual calls
+    count_t objectsSkipped = 0;  //!< the total number of object residual calls skipped
+    /** @brief get the fraction of object evaluations which were skipped*/
+    double skipFraction () const
+    {
+      auto total = objectsEvaluated + objectsSkipped;
+      return (total > 0) ? static_cast<double> (objectsSkipped) / static_cast<double> (total) : 0.0;
+    }
+  };
+
+  explicit residualDeltaEvaluator (gridDynSimulation *gds);
+
+  /** @brief set the change tolerance, 0 for the exact mode*/
+  void setTolerance (double tol);
+  double getTolerance () const
+  {
+    return tolerance;
+  }
+  /** @brief compute the residual
+  @param[in] sD the state data to evaluate
+  @param[out] resid the residual array
+  @param[in] sMode the solverMode corresponding to the state data
+  @return true if the residual was computed, false if the mode is not supported and the caller must do the evaluation
+  */
+  bool residual (const stateData *sD, double resid[], const solverMode &sMode);
+
+  /** @brief drop the stored reference data so the next evaluation of each mode is a full evaluation
+   should be called whenever something other than the states may have changed the residual such as events or parameter changes
+  */
+  void clearReference ();
+  /** @brief drop all the structural information,  called when the offsets or objects change*/
+  void invalidate ();
+  /** @brief drop the structural information for a single mode*/
+  void invalidate (const solverMode &sMode);
+
+  const deltaStats &getStats () const
+  {
+    return stats;
+  }
+  void resetStats ()
+  {
+    stats = deltaStats ();
+  }
+
+private:
+  class modeCache
+  {
+public:
+    bool built = false;  //!< the structural information has been loaded
+    bool usable = false;  //!< the mode can be evaluated with the delta scheme
+    bool hasReference = false;  //!< the reference data is valid
+    count_t size = 0;  //!< the number of states in the mode
+    double lastTime = 0.0;  //!< the time of the reference data
+    std::vector<gridPrimary *> objects;  //!< the objects in the mode
+    std::vector<index_t> depStart;  //!< start of the dependent objects for each state column
+    std::vector<index_t> depObjects;  //!< the objects depending on each column
+    std::vector<count_t> evalMark;  //!< marker for objects needing evaluation
+    std::vector<double> lastState;  //!< the reference state
+    std::vector<double> lastDeriv;  //!< the reference derivative
+    std::vector<double> lastResid;  //!< the residual from the last evaluation
+  };
+
+  gridDynSimulation *sim;  //!< the simulation to evaluate
+  double tolerance = 0.0;  //!< the change detection tolerance
+  count_t markCount = 0;  //!< the current marker value
+  std::vector<modeCache> caches;  //!< the cached information for each mode
+  deltaStats stats;  //!< the evaluation statistics
+
+  void build (modeCache &mc, const stateData *sD, const solverMode &sMode);
+  void fullEvaluation (modeCache &mc, const stateData *sD, double resid[], const solverMode &sMode);
+  bool changed (double val, double ref) const;
+};
+
+#endif
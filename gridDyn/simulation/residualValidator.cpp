@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "residualValidator.h"
+#include "gridDyn.h"
+
+#include <cmath>
+
+residualValidator::residualValidator (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+bool residualValidator::allFinite (const double vals[], count_t size)
+{
+  //four independent sums so the loop does not depend on the order of the additions
+  double acc[4] = { 0.0, 0.0, 0.0, 0.0 };
+  count_t kk = 0;
+  for (; kk + 3 < size; kk += 4)
+    {
+      acc[0] += vals[kk] * 0.0;
+      acc[1] += vals[kk + 1] * 0.0;
+      acc[2] += vals[kk + 2] * 0.0;
+      acc[3] += vals[kk + 3] * 0.0;
+    }
+  for (; kk < size; ++kk)
+    {
+      acc[0] += vals[kk] * 0.0;
+    }
+  return ((acc[0] + acc[1] + acc[2] + acc[3]) == 0.0);
+}
+
+bool residualValidator::checkState (double time, const double state[], const solverMode &sMode)
+{
+  ++stats.evaluations;
+  sampled = false;
+  if (windowRemaining > 0)
+    {
+      --windowRemaining;
+    }
+  else
+    {
+      if (checkPeriod == 0)
+        {
+          return true;
+        }
+      if (++sinceCheck < checkPeriod)
+        {
+          return true;
+        }
+    }
+  sinceCheck = 0;
+  sampled = true;
+  ++stats.checks;
+  count_t size = sim->stateSize (sMode);
+  if (allFinite (state, size))
+    {
+      return true;
+    }
+  ++stats.anomalies;
+  escalate (time, state, nullptr, size, sMode);
+  return false;
+}
+
+bool residualValidator::checkResult (double time, const double state[], const double result[], const solverMode &sMode)
+{
+  if (!sampled)
+    {
+      return true;
+    }
+  sampled = false;
+  count_t size = sim->stateSize (sMode);
+  if (allFinite (result, size))
+    {
+      return true;
+    }
+  ++stats.anomalies;
+  escalate (time, state, result, size, sMode);
+  return false;
+}
+
+void residualValidator::escalate (double time, const double state[], const double result[], count_t size, const solverMode &sMode)
+{
+  ++stats.escalations;
+  anomalies.clear ();
+  windowRemaining = escalationWindow;
+  stringVec stNames;
+  sim->getStateName (stNames, sMode);
+  //the state values come first,  with a finite state the non-finite results come from the models
+  for (int pass = 0; pass < 2; ++pass)
+    {
+      const double *vals = (pass == 0) ? state : result;
+      if (!vals)
+        {
+          continue;
+        }
+      for (index_t kk = 0; kk < size; ++kk)
+        {
+          if (std::isfinite (vals[kk]))
+            {
+              continue;
+            }
+          if (anomalies.size () >= reportLimit)
+            {
+              break;
+            }
+          anomaly an;
+          an.time = time;
+          an.index = kk;
+          an.value = vals[kk];
+          an.inState = (pass == 0);
+          if (kk < stNames.size ())
+            {
+              an.stateName = stNames[kk];
+            }
+          locate (an, sMode);
+          anomalies.push_back (an);
+        }
+    }
+  for (auto &an : anomalies)
+    {
+      std::string message = ((an.inState) ? "state[" : "resid[") + std::to_string (an.index) + "] is not finite";
+      if (!an.stateName.empty ())
+        {
+          message += " (" + an.stateName + ")";
+        }
+      message += " in " + ((an.owner.empty ()) ? std::string ("unknown object") : an.owner) + " at time " + std::to_string (an.time);
+      sim->log (sim, GD_ERROR_PRINT, message);
+    }
+}
+
+static bool inRange (index_t loc, index_t offset, count_t cnt)
+{
+  return ((offset != kNullLocation) && (loc >= offset) && (loc < offset + cnt));
+}
+
+void residualValidator::locate (anomaly &an, const solverMode &sMode) const
+{
+  if (!sim->opObjectLists.isListValid (sMode))
+    {
+      return;
+    }
+  auto obeg = sim->opObjectLists.cbegin (sMode);
+  auto oend = sim->opObjectLists.cend (sMode);
+  while (obeg != oend)
+    {
+      //the offsets of a primary object cover the states of all its sub objects
+      auto so = (*obeg)->getOffsets (sMode);
+      if ((inRange (an.index, so->vOffset, so->total.vSize)) || (inRange (an.index, so->aOffset, so->total.aSize))
+          || (inRange (an.index, so->algOffset, so->total.algSize)) || (inRange (an.index, so->diffOffset, so->total.diffSize)))
+        {
+          an.owner = (*obeg)->getName ();
+          return;
+        }
+      ++obeg;
+    }
+}
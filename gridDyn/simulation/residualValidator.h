@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef RESIDUAL_VALIDATOR_H_
+#define RESIDUAL_VALIDATOR_H_
+
+#include "gridDynTypes.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class solverMode;
+
+/** @brief tiered checking of the states and residuals passed through the solver callbacks for non-finite values
+ the check runs in two tiers.  The first tier is a single branch free pass over the state before an evaluation and
+over the residual after it which only determines whether every value is finite,  it runs on every period-th evaluation so
+the cost can be amortized over several evaluations or turned off completely with a period of 0.  Only when the first tier sees a
+non-finite value does the second tier run,  it locates every non-finite value,  maps it back to the object owning the
+state through the offset tables, logs the object and state names,  and checks every evaluation for a window of following
+evaluations to follow the anomaly until it clears.
+*/
+class residualValidator
+{
+public:
+  /** @brief a located non-finite value*/
+  class anomaly
+  {
+public:
+    double time = 0.0;  //!< the time of the evaluation
+    index_t index = kNullLocation;  //!< the index of the value in the state vector
+    double value = 0.0;  //!< the non-finite value
+    bool inState = false;  //!< true if the value was in the state,  false if it was in the residual
+    std::string owner;  //!< the name of the object owning the state
+    std::string stateName;  //!< the name of the state
+  };
+
+  /** @brief statistics on the checks*/
+  class validationStats
+  {
+public:
+    count_t evaluations = 0;  //!< the number of evaluations seen
+    count_t checks = 0;  //!< the number of evaluations scanned
+    count_t anomalies = 0;  //!< the number of scans finding a non-finite value
+    count_t escalations = 0;  //!< the number of second tier localizations run
+  };
+
+  explicit residualValidator (gridDynSimulation *gds);
+
+  /** @brief set the number of evaluations between checks, 0 to disable the checks*/
+  void setPeriod (count_t period)
+  {
+    checkPeriod = period;
+  }
+  count_t getPeriod () const
+  {
+    return checkPeriod;
+  }
+  /** @brief set the number of evaluations checked after an anomaly regardless of the period*/
+  void setWindow (count_t window)
+  {
+    escalationWindow = window;
+    windowRemaining = (std::min)(windowRemaining, window);
+  }
+  count_t getWindow () const
+  {
+    return escalationWindow;
+  }
+  /** @brief set the maximum number of anomalies stored and logged per escalation*/
+  void setReportLimit (count_t limit)
+  {
+    reportLimit = limit;
+  }
+  count_t getReportLimit () const
+  {
+    return reportLimit;
+  }
+  /** @brief check the state passed to an evaluation
+   this also decides if the evaluation is sampled,  the result is only checked for sampled evaluations
+  @param[in] time the time of the evaluation
+  @param[in] state the state vector
+  @param[in] sMode the solverMode of the state
+  @return true if the values are finite or the evaluation was not checked
+  */
+  bool checkState (double time, const double state[], const solverMode &sMode);
+  /** @brief check the residual or derivative produced by an evaluation
+  @param[in] time the time of the evaluation
+  @param[in] state the state vector the result was computed from
+  @param[in] result the residual or derivative
+  @param[in] sMode the solverMode of the data
+  @return true if the values are finite or the evaluation was not sampled
+  */
+  bool checkResult (double time, const double state[], const double result[], const solverMode &sMode);
+  /** @brief get the anomalies located by the last escalation*/
+  const std::vector<anomaly> &getAnomalies () const
+  {
+    return anomalies;
+  }
+  const validationStats &getStats () const
+  {
+    return stats;
+  }
+  void resetStats ()
+  {
+    stats = validationStats ();
+  }
+
+  /** @brief check if a vector is finite
+   the values are multiplied by zero and summed which gives zero for finite values and NaN if any value is infinite or NaN,
+  the loop has no branches so it can be vectorized by the compiler
+  */
+  static bool allFinite (const double vals[], count_t size);
+
+private:
+  gridDynSimulation *sim;  //!< the simulation being checked
+  count_t checkPeriod = 1;  //!< the number of evaluations between checks
+  count_t escalationWindow = 20;  //!< the number of evaluations checked after an anomaly
+  count_t reportLimit = 10;  //!< the maximum number of anomalies located per escalation
+  count_t sinceCheck = 0;  //!< the evaluations since the last check
+  count_t windowRemaining = 0;  //!< the evaluations left in the escalation window
+  bool sampled = false;  //!< the current evaluation is checked
+  std::vector<anomaly> anomalies;  //!< the anomalies from the last escalation
+  validationStats stats;  //!< the check statistics
+
+  void escalate (double time, const double state[], const double result[], count_t size, const solverMode &sMode);
+  void locate (anomaly &an, const solverMode &sMode) const;
+};
+
+#endif
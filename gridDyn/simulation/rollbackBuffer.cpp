@@ -0,0 +1,286 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "rollbackBuffer.h"
+#include "gridDyn.h"
+#include "eventQueue.h"
+#include "solvers/solverInterface.h"
+
+#include <algorithm>
+#include <cmath>
+
+rollbackBuffer::rollbackBuffer (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+void rollbackBuffer::setCapacity (count_t cap)
+{
+  capacity = (cap > 0) ? cap : 1;
+  while (snapshots.size () > capacity)
+    {
+      snapshots.pop_front ();
+    }
+}
+
+void rollbackBuffer::setPeriod (double period)
+{
+  capturePeriod = period;
+  nextCapture = (period > 0) ? sim->getCurrentTime () : kBigNum;
+}
+
+void rollbackBuffer::checkCapture (double time)
+{
+  if (time + sim->tols.timeTol < nextCapture)
+    {
+      return;
+    }
+  capture ();
+  if (capturePeriod > 0)
+    {
+      //time may be up to timeTol short of nextCapture so the number of skipped periods must not go negative
+      double skipped = std::floor ((time - nextCapture + sim->tols.timeTol) / capturePeriod);
+      if (skipped < 0.0)
+        {
+          skipped = 0.0;
+        }
+      nextCapture += skipped * capturePeriod + capturePeriod;
+    }
+  else
+    {
+      nextCapture = kBigNum;
+    }
+}
+
+void rollbackBuffer::collect (std::vector<double> &vals, snapshotLayout &lay, eventList &evList) const
+{
+  vals.clear ();
+  for (index_t kk = 0; kk < sim->solverInterfaces.size (); ++kk)
+    {
+      auto &sd = sim->solverInterfaces[kk];
+      if ((!sd) || (!sd->isInitialized ()) || (!isDynamic (sd->getSolverMode ())))
+        {
+          continue;
+        }
+      const auto &csd = *sd;
+      auto sz = csd.size ();
+      lay.solvers.push_back (kk);
+      lay.sizes.push_back (sz);
+      vals.insert (vals.end (), csd.state_data (), csd.state_data () + sz);
+      bool hasDeriv = (csd.deriv_data () != nullptr);
+      lay.derivs.push_back (hasDeriv);
+      if (hasDeriv)
+        {
+          vals.insert (vals.end (), csd.deriv_data (), csd.deriv_data () + sz);
+        }
+    }
+  auto start = vals.size ();
+  sim->getDiscreteStateBlocks (vals, lay.discreteBlocks);
+  lay.discreteSize = static_cast<count_t> (vals.size () - start);
+  start = vals.size ();
+  sim->EvQ->getEvents (evList);
+  for (auto &ev : evList)
+    {
+      ev->getState (vals);
+    }
+  lay.eventSize = static_cast<count_t> (vals.size () - start);
+}
+
+int rollbackBuffer::capture (const std::string &name)
+{
+  if (sim->pState < gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  auto lay = std::make_shared<snapshotLayout> ();
+  auto evList = std::make_shared<eventList> ();
+  collect (values, *lay, *evList);
+  if (lay->solvers.empty ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  snapshot snap;
+  snap.time = sim->getCurrentTime ();
+  snap.name = name;
+  //reuse the event list if the queue holds the same events
+  if ((lastEvents) && (*lastEvents == *evList))
+    {
+      snap.events = lastEvents;
+    }
+  else
+    {
+      snap.events = evList;
+      lastEvents = snap.events;
+    }
+  bool full = ((!lastBase) || (sinceFull + 1 >= fullInterval) || (lastBase->size () != values.size ()) || (!(*lastLayout == *lay)));
+  if (!full)
+    {
+      auto &base = *lastBase;
+      for (index_t kk = 0; kk < values.size (); ++kk)
+        {
+          if (values[kk] != base[kk])
+            {
+              snap.changedIndex.push_back (kk);
+              snap.changedValues.push_back (values[kk]);
+            }
+        }
+      //a delta larger than half the state costs more to store and apply than the full values
+      full = (2 * snap.changedIndex.size () > values.size ());
+    }
+  if (full)
+    {
+      snap.changedIndex.clear ();
+      snap.changedValues.clear ();
+      lastBase = std::make_shared<const std::vector<double> > (values);
+      lastLayout = lay;
+      sinceFull = 0;
+      ++stats.fullCaptures;
+    }
+  else
+    {
+      ++sinceFull;
+      stats.deltaValues += static_cast<count_t> (snap.changedIndex.size ());
+    }
+  snap.base = lastBase;
+  snap.layout = lastLayout;
+  snapshots.push_back (std::move (snap));
+  while (snapshots.size () > capacity)
+    {
+      snapshots.pop_front ();
+    }
+  ++stats.captures;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int rollbackBuffer::restore (double time)
+{
+  auto tol = sim->tols.timeTol;
+  auto rit = std::find_if (snapshots.rbegin (), snapshots.rend (), [time, tol](const snapshot &snap) {
+      return (snap.time <= time + tol);
+    });
+  if (rit == snapshots.rend ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  //drop the snapshots of the abandoned trajectory
+  snapshots.erase (rit.base (), snapshots.end ());
+  return apply (snapshots.back ());
+}
+
+int rollbackBuffer::restore (const std::string &name)
+{
+  if ((name.empty ()) || (name == "last"))
+    {
+      if (snapshots.empty ())
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      return apply (snapshots.back ());
+    }
+  auto rit = std::find_if (snapshots.rbegin (), snapshots.rend (), [&name](const snapshot &snap) {
+      return (snap.name == name);
+    });
+  if (rit == snapshots.rend ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  snapshots.erase (rit.base (), snapshots.end ());
+  return apply (snapshots.back ());
+}
+
+void rollbackBuffer::clear ()
+{
+  snapshots.clear ();
+  lastBase = nullptr;
+  lastLayout = nullptr;
+  lastEvents = nullptr;
+  sinceFull = 0;
+}
+
+int rollbackBuffer::apply (const snapshot &snap)
+{
+  auto &lay = *snap.layout;
+  values = *snap.base;
+  for (size_t kk = 0; kk < snap.changedIndex.size (); ++kk)
+    {
+      values[snap.changedIndex[kk]] = snap.changedValues[kk];
+    }
+  //the solvers must still match the layout
+  for (size_t ss = 0; ss < lay.solvers.size (); ++ss)
+    {
+      auto sd = sim->getSolverInterface (lay.solvers[ss]);
+      if ((!sd) || (!sd->isInitialized ()) || (sd->size () != lay.sizes[ss]))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  //the discrete state is loaded per object so only the object count has to match
+  if (lay.discreteBlocks.size () != sim->primaryObjects.size () + 1)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  index_t offset = 0;
+  for (size_t ss = 0; ss < lay.solvers.size (); ++ss)
+    {
+      offset += (lay.derivs[ss]) ? 2 * lay.sizes[ss] : lay.sizes[ss];
+    }
+  sim->timeCurr = snap.time;
+  sim->timeReturn = snap.time;
+  if (sim->setDiscreteStateBlocks (values.data () + offset, lay.discreteBlocks) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  offset += lay.discreteSize;
+  sim->EvQ->setEvents (*snap.events);
+  for (auto &ev : *snap.events)
+    {
+      offset += ev->setState (values.data () + offset);
+    }
+  //the discrete changes may require the solvers to be reset before the states are loaded
+  for (auto &sindex : lay.solvers)
+    {
+      auto sd = sim->getSolverInterface (sindex);
+      const solverMode &sMode = sd->getSolverMode ();
+      if (hasDifferential (sMode))
+        {
+          sim->dynamicCheckAndReset (sMode);
+        }
+    }
+  offset = 0;
+  for (size_t ss = 0; ss < lay.solvers.size (); ++ss)
+    {
+      auto sd = sim->getSolverInterface (lay.solvers[ss]);
+      auto sz = lay.sizes[ss];
+      if (sd->size () != sz)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      std::copy (values.data () + offset, values.data () + offset + sz, sd->state_data ());
+      offset += sz;
+      if (lay.derivs[ss])
+        {
+          std::copy (values.data () + offset, values.data () + offset + sz, sd->deriv_data ());
+          offset += sz;
+        }
+      sim->setState (snap.time, sd->state_data (), (lay.derivs[ss]) ? sd->deriv_data () : nullptr, sd->getSolverMode ());
+    }
+  sim->updateLocalCache ();
+  //the solver is reinitialized from the loaded state when the dynamic solution continues
+  sim->pState = gridDynSimulation::gridState_t::DYNAMIC_PARTIAL;
+  lastBase = snap.base;
+  lastLayout = snap.layout;
+  lastEvents = snap.events;
+  nextCapture = (capturePeriod > 0) ? snap.time + capturePeriod : kBigNum;
+  ++stats.restores;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
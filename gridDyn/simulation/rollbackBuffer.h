@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef ROLLBACK_BUFFER_H_
+#define ROLLBACK_BUFFER_H_
+
+#include "gridDynTypes.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class eventAdapter;
+
+/** @brief in memory ring of dynamic simulation snapshots used for the checkpoint and rollback actions
+ a snapshot holds the state and derivative vectors of the initialized dynamic solvers,  the discrete state of the
+objects (switch positions,  relay conditions,  taps,  and scheduler targets),  the events in the queue with their
+execution state,  and the recorder point counts.  Every full interval captures a full snapshot,  the captures in between
+store only the values which differ from the last full snapshot.  Restoring a snapshot loads all of it back into the
+simulation and leaves the simulation ready to continue the dynamic solution from the snapshot time.
+Captures are only taken at solver stop points,  setting a period makes the dynamic solvers stop at the capture times.
+*/
+class rollbackBuffer
+{
+public:
+  /** @brief counters for the buffer operations*/
+  class rollbackStats
+  {
+public:
+    count_t captures = 0;  //!< the number of snapshots taken
+    count_t fullCaptures = 0;  //!< the number of snapshots which stored the full state
+    count_t restores = 0;  //!< the number of snapshots restored
+    count_t deltaValues = 0;  //!< the total number of values stored in delta snapshots
+  };
+
+  explicit rollbackBuffer (gridDynSimulation *gds);
+
+  /** @brief set the maximum number of snapshots retained,  the oldest snapshots are dropped first*/
+  void setCapacity (count_t cap);
+  /** @brief set the number of captures between full snapshots,  1 makes every snapshot a full snapshot*/
+  void setFullInterval (count_t interval)
+  {
+    fullInterval = (interval > 0) ? interval : 1;
+  }
+  /** @brief set the period of the automatic captures,  a period <=0 turns the automatic captures off*/
+  void setPeriod (double period);
+  double getPeriod () const
+  {
+    return capturePeriod;
+  }
+  /** @brief get the time of the next automatic capture*/
+  double getNextCaptureTime () const
+  {
+    return nextCapture;
+  }
+  /** @brief take a snapshot if an automatic capture is due
+  @param[in] time the current simulation time
+  */
+  void checkCapture (double time);
+  /** @brief take a snapshot of the current simulation state
+  @param[in] name an optional name for the snapshot
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if there is no dynamic state to capture
+  */
+  int capture (const std::string &name = "");
+  /** @brief restore the latest snapshot taken at or before a time
+   the snapshots taken after the restored one are dropped
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if no snapshot could be restored
+  */
+  int restore (double time);
+  /** @brief restore the latest snapshot with a particular name,  "last" restores the latest snapshot*/
+  int restore (const std::string &name);
+  /** @brief drop all the snapshots*/
+  void clear ();
+  count_t size () const
+  {
+    return static_cast<count_t> (snapshots.size ());
+  }
+  const rollbackStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  /** @brief the arrangement of the values in a snapshot*/
+  class snapshotLayout
+  {
+public:
+    std::vector<index_t> solvers;  //!< the solverInterface index of each captured solver
+    std::vector<count_t> sizes;  //!< the state size of each captured solver
+    std::vector<bool> derivs;  //!< indicator that the derivatives of the solver are captured
+    count_t discreteSize = 0;  //!< the number of discrete state values
+    std::vector<count_t> discreteBlocks;  //!< the number of discrete state values of each object of the simulation
+    count_t eventSize = 0;  //!< the number of event state values
+    bool operator== (const snapshotLayout &lay) const
+    {
+      return ((solvers == lay.solvers) && (sizes == lay.sizes) && (derivs == lay.derivs) && (discreteSize == lay.discreteSize) && (discreteBlocks == lay.discreteBlocks) && (eventSize == lay.eventSize));
+    }
+  };
+  typedef std::vector<std::shared_ptr<eventAdapter> > eventList;
+  /** @brief a single snapshot*/
+  class snapshot
+  {
+public:
+    double time = 0.0;  //!< the simulation time of the snapshot
+    std::string name;  //!< the name of the snapshot
+    std::shared_ptr<const std::vector<double> > base;  //!< the values of the full snapshot
+    std::vector<index_t> changedIndex;  //!< the locations which differ from the base,  empty for a full snapshot
+    std::vector<double> changedValues;  //!< the values which differ from the base
+    std::shared_ptr<const snapshotLayout> layout;  //!< the arrangement of the values
+    std::shared_ptr<const eventList> events;  //!< the events in the queue
+  };
+
+  gridDynSimulation *sim;  //!< the simulation
+  std::deque<snapshot> snapshots;  //!< the retained snapshots in time order
+  std::shared_ptr<const std::vector<double> > lastBase;  //!< the values of the latest full snapshot
+  std::shared_ptr<const snapshotLayout> lastLayout;  //!< the layout of the latest full snapshot
+  std::shared_ptr<const eventList> lastEvents;  //!< the latest captured event list
+  std::vector<double> values;  //!< working storage for the snapshot values
+  rollbackStats stats;  //!< the buffer counters
+  count_t capacity = 20;  //!< the maximum number of snapshots
+  count_t fullInterval = 10;  //!< the number of captures between full snapshots
+  count_t sinceFull = 0;  //!< the number of delta captures since the last full snapshot
+  double capturePeriod = 0.0;  //!< the period of the automatic captures
+  double nextCapture = kBigNum;  //!< the time of the next automatic capture
+
+  /** @brief collect the current simulation state
+  @param[out] vals the snapshot values
+  @param[out] lay the arrangement of the values
+  @param[out] evList the events in the queue
+  */
+  void collect (std::vector<double> &vals, snapshotLayout &lay, eventList &evList) const;
+  /** @brief load a snapshot into the simulation*/
+  int apply (const snapshot &snap);
+};
+
+#endif
@@ -0,0 +1,379 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "shortCircuitAnalysis.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/acLine.h"
+#include "loadModels/gridLoad.h"
+#include "generators/gridDynGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef std::complex<double> complexd;
+
+static const complexd phaseShiftA = std::polar (1.0, 2.0 * kPI / 3.0);
+
+/** @brief compute the admittance entries of a pi model branch with an ideal transformer at the from side
+ the entries are ordered from-from,to-to,from-to,to-from
+*/
+static void branchEntries (complexd ys, complexd yshunt, complexd tap, complexd entries[4])
+{
+  entries[0] = (ys + yshunt) / std::norm (tap);
+  entries[1] = ys + yshunt;
+  entries[2] = -ys / std::conj (tap);
+  entries[3] = -ys / tap;
+}
+
+static void addEntry (std::vector<index_t> &rows, std::vector<index_t> &cols, std::vector<complexd> &vals, index_t row, index_t col, complexd y)
+{
+  rows.push_back (row);
+  cols.push_back (col);
+  vals.push_back (y);
+}
+
+static double maxPhaseMagnitude (complexd X0, complexd X1, complexd X2)
+{
+  double mA = std::abs (X0 + X1 + X2);
+  double mB = std::abs (X0 + phaseShiftA * phaseShiftA * X1 + phaseShiftA * X2);
+  double mC = std::abs (X0 + phaseShiftA * X1 + phaseShiftA * phaseShiftA * X2);
+  return (std::max)(mA, (std::max)(mB, mC));
+}
+
+shortCircuitAnalysis::shortCircuitAnalysis (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+int shortCircuitAnalysis::build ()
+{
+  built = false;
+  buses.clear ();
+  busIndex.clear ();
+  sim->getBusVector (buses);
+  buses.erase (std::remove_if (buses.begin (), buses.end (), [](const gridBus *bus) {
+      return ((!bus->enabled) || (!bus->isConnected ()));
+    }), buses.end ());
+  count_t n = static_cast<count_t> (buses.size ());
+  if (n == 0)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  Vpre.resize (n);
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      busIndex[buses[kk]] = kk;
+      Vpre[kk] = (flatPrefault) ? complexd (1.0, 0.0) : std::polar (buses[kk]->getVoltage (), buses[kk]->getAngle ());
+    }
+  //the positive and negative sequence networks share the triplet pattern
+  std::vector<index_t> rows;
+  std::vector<index_t> cols;
+  std::vector<complexd> vals1;
+  std::vector<complexd> vals2;
+  std::vector<index_t> rows0;
+  std::vector<index_t> cols0;
+  std::vector<complexd> vals0;
+  phaseShift = false;
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      auto bus = buses[kk];
+      index_t ll = 0;
+      gridLink *lnk;
+      while ((lnk = bus->getLink (ll++)) != nullptr)
+        {
+          //each link is added once from its first terminal
+          if (lnk->getBus (1) != bus)
+            {
+              continue;
+            }
+          auto line = dynamic_cast<acLine *> (lnk);
+          if ((!line) || (!line->enabled) || (!line->isConnected ()))
+            {
+              continue;
+            }
+          auto fnd = busIndex.find (line->getBus (2));
+          if ((fnd == busIndex.end ()) || (fnd->second == kk))
+            {
+              continue;
+            }
+          index_t to = fnd->second;
+          complexd z (line->get ("r"), line->get ("x"));
+          if (std::abs (z) == 0.0)
+            {
+              continue;
+            }
+          complexd ys = 1.0 / z;
+          complexd yshunt = 0.5 * complexd (line->get ("g"), line->get ("b"));
+          double tap = line->get ("tap");
+          double tapAngle = line->get ("tapangle");
+          if (tapAngle != 0.0)
+            {
+              phaseShift = true;
+            }
+          bool transformer = ((tap != 1.0) || (tapAngle != 0.0) || (dynamic_cast<adjustableTransformer *> (line) != nullptr));
+          complexd ys0 = ((transformer) || (lineZeroRatio <= 0.0)) ? ys : ys / lineZeroRatio;
+          complexd y1[4];
+          complexd y2[4];
+          complexd y0[4];
+          branchEntries (ys, yshunt, std::polar (tap, tapAngle), y1);
+          branchEntries (ys, yshunt, std::polar (tap, -tapAngle), y2);
+          branchEntries (ys0, yshunt, complexd (tap, 0.0), y0);
+          const index_t brows[4] = { kk, to, kk, to };
+          const index_t bcols[4] = { kk, to, to, kk };
+          for (int ee = 0; ee < 4; ++ee)
+            {
+              rows.push_back (brows[ee]);
+              cols.push_back (bcols[ee]);
+              vals1.push_back (y1[ee]);
+              vals2.push_back (y2[ee]);
+              addEntry (rows0, cols0, vals0, brows[ee], bcols[ee], y0[ee]);
+            }
+        }
+      index_t gg = 0;
+      gridDynGenerator *gen;
+      while ((gen = bus->getGen (gg++)) != nullptr)
+        {
+          if (!gen->enabled)
+            {
+              continue;
+            }
+          double mbase = gen->get ("mbase");
+          double scale = (mbase > 0.0) ? gen->get ("basepower") / mbase : 1.0;
+          complexd zg = complexd (gen->get ("rs"), gen->get ("xs")) * scale;
+          if (std::abs (zg) == 0.0)
+            {
+              continue;
+            }
+          rows.push_back (kk);
+          cols.push_back (kk);
+          vals1.push_back (1.0 / zg);
+          vals2.push_back (1.0 / zg);
+          if (genZeroRatio > 0.0)
+            {
+              addEntry (rows0, cols0, vals0, kk, kk, 1.0 / (genZeroRatio * zg));
+            }
+        }
+      if (includeLoads)
+        {
+          double vsq = std::norm (Vpre[kk]);
+          index_t ld = 0;
+          gridLoad *load;
+          while ((load = bus->getLoad (ld++)) != nullptr)
+            {
+              if (!load->enabled)
+                {
+                  continue;
+                }
+              complexd yl = complexd (load->getRealPower (), -load->getReactivePower ()) / vsq;
+              rows.push_back (kk);
+              cols.push_back (kk);
+              vals1.push_back (yl);
+              vals2.push_back (yl);
+            }
+        }
+    }
+  Y1.loadTriplets (rows, cols, vals1, n);
+  if (LU1.factor (Y1) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  if (phaseShift)
+    {
+      Y2.loadTriplets (rows, cols, vals2, n);
+      if (LU2.factor (Y2) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  //without a ground path the zero sequence network is singular and only the ungrounded faults are computed
+  Y0.loadTriplets (rows0, cols0, vals0, n);
+  zeroValid = (LU0.factor (Y0) == FUNCTION_EXECUTION_SUCCESS);
+  built = true;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void shortCircuitAnalysis::sequenceCurrents (fault_type type, complexd Vf, complexd Z1, complexd Z2, complexd Z0, complexd I[3]) const
+{
+  I[0] = I[1] = I[2] = 0.0;
+  switch (type)
+    {
+    case fault_type::three_phase:
+      I[1] = Vf / (Z1 + faultZ);
+      break;
+    case fault_type::line_ground:
+      I[1] = Vf / (Z1 + Z2 + Z0 + 3.0 * faultZ);
+      I[0] = I[2] = I[1];
+      break;
+    case fault_type::line_line:
+      I[1] = Vf / (Z1 + Z2 + faultZ);
+      I[2] = -I[1];
+      break;
+    case fault_type::double_line_ground:
+      {
+        complexd Z0f = Z0 + 3.0 * faultZ;
+        I[1] = Vf / (Z1 + Z2 * Z0f / (Z2 + Z0f));
+        I[2] = -I[1] * Z0f / (Z2 + Z0f);
+        I[0] = -I[1] * Z2 / (Z2 + Z0f);
+      }
+      break;
+    }
+}
+
+void shortCircuitAnalysis::zbusColumns (index_t bus, std::vector<complexd> &z1, std::vector<complexd> &z2, std::vector<complexd> &z0, std::vector<complexd> &work) const
+{
+  count_t n = static_cast<count_t> (buses.size ());
+  z1.assign (n, 0.0);
+  z1[bus] = 1.0;
+  LU1.solve (z1.data (), work.data ());
+  if (phaseShift)
+    {
+      z2.assign (n, 0.0);
+      z2[bus] = 1.0;
+      LU2.solve (z2.data (), work.data ());
+    }
+  if (zeroValid)
+    {
+      z0.assign (n, 0.0);
+      z0[bus] = 1.0;
+      LU0.solve (z0.data (), work.data ());
+    }
+}
+
+void shortCircuitAnalysis::computeFault (index_t bus, faultResult &res, std::vector<complexd> &z1, std::vector<complexd> &z2, std::vector<complexd> &z0, std::vector<complexd> &work) const
+{
+  zbusColumns (bus, z1, z2, z0, work);
+  //without phase shifts the negative sequence network is the positive sequence network
+  const auto &z2col = (phaseShift) ? z2 : z1;
+  count_t n = static_cast<count_t> (buses.size ());
+  res.bus = buses[bus];
+  res.name = buses[bus]->getName ();
+  res.prefaultVoltage = Vpre[bus];
+  res.Z1 = z1[bus];
+  res.Z0 = (zeroValid) ? z0[bus] : complexd (kNullVal, 0.0);
+  complexd I[3];
+  for (index_t tt = 0; tt < faultTypeCount; ++tt)
+    {
+      auto type = static_cast<fault_type> (tt);
+      bool ground = ((type == fault_type::line_ground) || (type == fault_type::double_line_ground));
+      res.current[tt] = kNullVal;
+      res.minVoltage[tt] = kNullVal;
+      if ((ground) && (!zeroValid))
+        {
+          continue;
+        }
+      sequenceCurrents (type, Vpre[bus], z1[bus], z2col[bus], (ground) ? z0[bus] : complexd (0.0), I);
+      res.current[tt] = maxPhaseMagnitude (I[0], I[1], I[2]);
+      if ((!computeVoltages) || (n < 2))
+        {
+          continue;
+        }
+      double vmin = kBigNum;
+      for (index_t kk = 0; kk < n; ++kk)
+        {
+          if (kk == bus)
+            {
+              continue;
+            }
+          complexd V1 = Vpre[kk] - z1[kk] * I[1];
+          complexd V2 = -z2col[kk] * I[2];
+          complexd V0 = (ground) ? -z0[kk] * I[0] : complexd (0.0);
+          vmin = (std::min)(vmin, std::abs (V0 + V1 + V2));
+          vmin = (std::min)(vmin, std::abs (V0 + phaseShiftA * phaseShiftA * V1 + phaseShiftA * V2));
+          vmin = (std::min)(vmin, std::abs (V0 + phaseShiftA * V1 + phaseShiftA * phaseShiftA * V2));
+        }
+      res.minVoltage[tt] = vmin;
+    }
+}
+
+int shortCircuitAnalysis::sweep ()
+{
+  if (build () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  return sweep (buses);
+}
+
+int shortCircuitAnalysis::sweep (const std::vector<gridBus *> &faultBuses)
+{
+  results.clear ();
+  if ((!built) && (build () != FUNCTION_EXECUTION_SUCCESS))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::vector<index_t> locations;
+  locations.reserve (faultBuses.size ());
+  for (auto &bus : faultBuses)
+    {
+      auto fnd = busIndex.find (bus);
+      if (fnd != busIndex.end ())
+        {
+          locations.push_back (fnd->second);
+        }
+    }
+  results.resize (locations.size ());
+  count_t n = static_cast<count_t> (buses.size ());
+  int cnt = static_cast<int> (locations.size ());
+  //the factors are shared read only,  each thread keeps its own Zbus columns and solve work space
+#pragma omp parallel
+  {
+    std::vector<complexd> z1 (n);
+    std::vector<complexd> z2;
+    std::vector<complexd> z0;
+    std::vector<complexd> work (n);
+#pragma omp for schedule(dynamic, 16)
+    for (int kk = 0; kk < cnt; ++kk)
+      {
+        computeFault (locations[kk], results[kk], z1, z2, z0, work);
+      }
+  }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int shortCircuitAnalysis::faultVoltages (gridBus *faultBus, fault_type type, std::vector<double> &Va, std::vector<double> &Vb, std::vector<double> &Vc)
+{
+  if ((!built) && (build () != FUNCTION_EXECUTION_SUCCESS))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  auto fnd = busIndex.find (faultBus);
+  bool ground = ((type == fault_type::line_ground) || (type == fault_type::double_line_ground));
+  if ((fnd == busIndex.end ()) || ((ground) && (!zeroValid)))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  auto bus = fnd->second;
+  count_t n = static_cast<count_t> (buses.size ());
+  std::vector<complexd> z1 (n);
+  std::vector<complexd> z2;
+  std::vector<complexd> z0;
+  std::vector<complexd> work (n);
+  zbusColumns (bus, z1, z2, z0, work);
+  const auto &z2col = (phaseShift) ? z2 : z1;
+  complexd I[3];
+  sequenceCurrents (type, Vpre[bus], z1[bus], z2col[bus], (ground) ? z0[bus] : complexd (0.0), I);
+  Va.resize (n);
+  Vb.resize (n);
+  Vc.resize (n);
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      complexd V1 = Vpre[kk] - z1[kk] * I[1];
+      complexd V2 = -z2col[kk] * I[2];
+      complexd V0 = (ground) ? -z0[kk] * I[0] : complexd (0.0);
+      Va[kk] = std::abs (V0 + V1 + V2);
+      Vb[kk] = std::abs (V0 + phaseShiftA * phaseShiftA * V1 + phaseShiftA * V2);
+      Vc[kk] = std::abs (V0 + phaseShiftA * V1 + phaseShiftA * phaseShiftA * V2);
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
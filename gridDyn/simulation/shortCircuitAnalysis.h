@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef SHORT_CIRCUIT_ANALYSIS_H_
+#define SHORT_CIRCUIT_ANALYSIS_H_
+
+#include "gridDynTypes.h"
+#include "solvers/sparseLU.h"
+
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class gridBus;
+
+/** @brief classical sequence network short circuit calculations
+ the positive,negative,and zero sequence bus admittance matrices are built from the acLine data and the generator source
+impedances and factored once.  The fault at each bus takes one sparse solve per sequence network for the Zbus column of the
+bus,  which gives the Thevenin impedance for the fault currents and the transfer impedances for the post fault voltages at
+every bus.  The fault locations are independent and are computed in parallel with OpenMP when it is available.
+The models carry no sequence data so the negative sequence network matches the positive sequence network with the phase
+shifts reversed,  zero sequence line impedances are a multiple of the positive sequence impedance,  transformers are
+treated as grounded wye-grounded wye,  and generators are grounded through a multiple of their source impedance.
+*/
+class shortCircuitAnalysis
+{
+public:
+  static const count_t faultTypeCount = 4;  //!< the number of fault types
+  /** @brief the fault types*/
+  enum class fault_type
+  {
+    three_phase = 0, line_ground = 1, line_line = 2, double_line_ground = 3,
+  };
+  /** @brief the results for faults at one bus*/
+  class faultResult
+  {
+public:
+    gridBus *bus = nullptr;  //!< the faulted bus
+    std::string name;  //!< the name of the bus
+    std::complex<double> prefaultVoltage;  //!< the prefault voltage at the bus
+    std::complex<double> Z1;  //!< the positive sequence Thevenin impedance
+    std::complex<double> Z0;  //!< the zero sequence Thevenin impedance
+    double current[faultTypeCount];  //!< the largest phase fault current for each fault type [pu]
+    double minVoltage[faultTypeCount];  //!< the lowest post fault phase voltage at any other bus for each fault type [pu]
+  };
+
+  explicit shortCircuitAnalysis (gridDynSimulation *gds);
+
+  /** @brief build and factor the sequence admittance matrices from the current network state
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the positive sequence matrix is singular
+  */
+  int build ();
+  /** @brief compute the faults at every bus*/
+  int sweep ();
+  /** @brief compute the faults at a list of buses
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the sequence networks could not be built
+  */
+  int sweep (const std::vector<gridBus *> &faultBuses);
+  /** @brief compute the post fault phase voltage magnitudes at every bus for a single fault
+  @param[in] faultBus the faulted bus
+  @param[in] type the fault type
+  @param[out] Va,Vb,Vc the phase voltage magnitudes of the connected buses in the order of the simulation bus list
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the bus is not part of the network
+  */
+  int faultVoltages (gridBus *faultBus, fault_type type, std::vector<double> &Va, std::vector<double> &Vb, std::vector<double> &Vc);
+  const std::vector<faultResult> &getResults () const
+  {
+    return results;
+  }
+  /** @brief set the fault impedance [pu]*/
+  void setFaultImpedance (std::complex<double> Zf)
+  {
+    faultZ = Zf;
+  }
+  /** @brief set the ratio of the zero sequence to positive sequence impedance of the lines*/
+  void setLineZeroSequenceRatio (double ratio)
+  {
+    lineZeroRatio = ratio;
+    built = false;
+  }
+  /** @brief set the ratio of the generator zero sequence impedance to the source impedance,  0 for ungrounded generators*/
+  void setGeneratorZeroSequenceRatio (double ratio)
+  {
+    genZeroRatio = ratio;
+    built = false;
+  }
+  /** @brief include the loads as constant admittances at the prefault voltage*/
+  void setIncludeLoads (bool include)
+  {
+    includeLoads = include;
+    built = false;
+  }
+  /** @brief use a flat 1.0 pu prefault voltage instead of the network solution*/
+  void setFlatPrefault (bool flat)
+  {
+    flatPrefault = flat;
+    built = false;
+  }
+  /** @brief compute the post fault voltages at every bus during a sweep*/
+  void setComputeVoltages (bool compute)
+  {
+    computeVoltages = compute;
+  }
+
+private:
+  gridDynSimulation *sim;  //!< the simulation
+  std::vector<gridBus *> buses;  //!< the buses in matrix order
+  std::map<gridBus *, index_t> busIndex;  //!< the matrix index of each bus
+  std::vector<std::complex<double> > Vpre;  //!< the prefault voltages
+  cscMatrix<std::complex<double> > Y1;  //!< the positive sequence admittance matrix
+  cscMatrix<std::complex<double> > Y2;  //!< the negative sequence admittance matrix if it differs from Y1
+  cscMatrix<std::complex<double> > Y0;  //!< the zero sequence admittance matrix
+  sparseLU<std::complex<double> > LU1;  //!< the positive sequence factors
+  sparseLU<std::complex<double> > LU2;  //!< the negative sequence factors
+  sparseLU<std::complex<double> > LU0;  //!< the zero sequence factors
+  std::vector<faultResult> results;  //!< the results of the last sweep
+  std::complex<double> faultZ = 0.0;  //!< the fault impedance
+  double lineZeroRatio = 3.0;  //!< zero sequence to positive sequence line impedance ratio
+  double genZeroRatio = 1.0;  //!< zero sequence to source impedance ratio for generators
+  bool includeLoads = false;  //!< include the loads in the sequence networks
+  bool flatPrefault = false;  //!< use a flat prefault voltage
+  bool computeVoltages = true;  //!< compute the post fault voltages during a sweep
+  bool built = false;  //!< the sequence networks are built and factored
+  bool phaseShift = false;  //!< the network has phase shifting transformers so Y2 is factored separately
+  bool zeroValid = false;  //!< the zero sequence factorization succeeded
+
+  /** @brief compute the sequence fault currents of a fault type from the Thevenin impedances*/
+  void sequenceCurrents (fault_type type, std::complex<double> Vf, std::complex<double> Z1, std::complex<double> Z2, std::complex<double> Z0, std::complex<double> I[3]) const;
+  /** @brief solve for the Zbus columns of a bus in each sequence network
+   z2 is only computed when the network has phase shifts and z0 when the zero sequence network is valid
+  */
+  void zbusColumns (index_t bus, std::vector<std::complex<double> > &z1, std::vector<std::complex<double> > &z2, std::vector<std::complex<double> > &z0, std::vector<std::complex<double> > &work) const;
+  void computeFault (index_t bus, faultResult &res, std::vector<std::complex<double> > &z1, std::vector<std::complex<double> > &z2, std::vector<std::complex<double> > &z0, std::vector<std::complex<double> > &work) const;
+};
+
+#endif
@@ -0,0 +1,587 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "stateEstimator.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "linkModels/gridLink.h"
+#include "arrayDataSparse.h"
+#include "objectInterpreter.h"
+#include "stringOps.h"
+
+#include <algorithm>
+#include <cmath>
+
+static double maxNorm (const std::vector<double> &vec)
+{
+  double nrm = 0.0;
+  for (auto &v : vec)
+    {
+      nrm = (std::max)(nrm, std::abs (v));
+    }
+  return nrm;
+}
+
+stateEstimator::stateEstimator (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+index_t stateEstimator::terminalIndex (gridLink *lnk, gridBus *bus)
+{
+  for (index_t kk = 0; kk < terminals.size (); ++kk)
+    {
+      if ((terminals[kk].link == lnk) && (terminals[kk].bus == bus))
+        {
+          return kk;
+        }
+    }
+  linkTerminal term;
+  term.link = lnk;
+  term.bus = bus;
+  terminals.push_back (term);
+  return static_cast<index_t> (terminals.size () - 1);
+}
+
+index_t stateEstimator::addMeasurement (const std::string &location, double value, double sigma)
+{
+  objInfo oi (location, sim);
+  if ((oi.m_obj == nullptr) || (oi.m_field.empty ()))
+    {
+      return kNullLocation;
+    }
+  return addMeasurement (oi.m_obj, oi.m_field, value, sigma);
+}
+
+index_t stateEstimator::addMeasurement (gridCoreObject *obj, const std::string &field, double value, double sigma)
+{
+  if ((obj == nullptr) || (sigma <= 0.0))
+    {
+      return kNullLocation;
+    }
+  std::string fld = field;
+  makeLowerCase (fld);
+  measurement m;
+  m.name = obj->getName () + ":" + fld;
+  m.value = value;
+  m.sigma = sigma;
+  std::vector<index_t> mterms;
+  auto bus = dynamic_cast<gridBus *> (obj);
+  if (bus)
+    {
+      m.bus = bus;
+      if ((fld == "voltage") || (fld == "v"))
+        {
+          m.type = measurement_type::voltage;
+        }
+      else if ((fld == "angle") || (fld == "phase") || (fld == "a"))
+        {
+          m.type = measurement_type::angle;
+        }
+      else if ((fld == "linkp") || (fld == "link") || (fld == "linkq"))
+        {
+          m.type = (fld == "linkq") ? measurement_type::injection_reactive : measurement_type::injection_real;
+          index_t kk = 0;
+          gridLink *lnk;
+          while ((lnk = bus->getLink (kk)) != nullptr)
+            {
+              mterms.push_back (terminalIndex (lnk, bus));
+              ++kk;
+            }
+        }
+      else
+        {
+          return kNullLocation;
+        }
+    }
+  else
+    {
+      auto lnk = dynamic_cast<gridLink *> (obj);
+      if (!lnk)
+        {
+          return kNullLocation;
+        }
+      std::string base;
+      int num = trailingStringInt (fld, base, 1);
+      if ((base == "p") || (base == "power") || (base == "realpower"))
+        {
+          m.type = measurement_type::flow_real;
+        }
+      else if ((base == "q") || (base == "reactivepower"))
+        {
+          m.type = measurement_type::flow_reactive;
+        }
+      else
+        {
+          return kNullLocation;
+        }
+      if ((num != 1) && (num != 2))
+        {
+          return kNullLocation;
+        }
+      m.link = lnk;
+      m.terminal = static_cast<index_t> (num);
+      m.bus = lnk->getBus (m.terminal);
+      if (m.bus == nullptr)
+        {
+          return kNullLocation;
+        }
+      mterms.push_back (terminalIndex (lnk, m.bus));
+    }
+  meas.push_back (m);
+  measTerminals.push_back (mterms);
+  setupValid = false;
+  gainValid = false;
+  return static_cast<index_t> (meas.size () - 1);
+}
+
+void stateEstimator::setMeasurement (index_t index, double value)
+{
+  if (index < meas.size ())
+    {
+      meas[index].value = value;
+    }
+}
+
+void stateEstimator::restoreMeasurement (index_t index)
+{
+  if ((index < meas.size ()) && (!meas[index].active))
+    {
+      meas[index].active = true;
+      meas[index].badData = false;
+      gainValid = false;
+    }
+}
+
+void stateEstimator::reset ()
+{
+  setupValid = false;
+  gainValid = false;
+  gainCurrent = false;
+  haveEstimate = false;
+}
+
+int stateEstimator::setup ()
+{
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  stateCount = sim->stateSize (sm);
+  if (stateCount == 0)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  x.resize (stateCount);
+  dx.assign (stateCount, 0.0);
+  sim->guess (sim->getCurrentTime (), x.data (), dx.data (), sm);
+
+  bool angleMeasured = false;
+  for (auto &m : meas)
+    {
+      if ((m.active) && (m.type == measurement_type::angle))
+        {
+          angleMeasured = true;
+        }
+    }
+  std::vector<gridBus *> busList;
+  sim->getBusVector (busList);
+  gridBus *refBus = nullptr;
+  if (!angleMeasured)
+    {
+      for (auto &bus : busList)
+        {
+          if ((bus->getType () == gridBus::busType::SLK) && (bus->getOutputLoc (sm, angleInLocation) < stateCount))
+            {
+              refBus = bus;
+              break;
+            }
+        }
+      if ((refBus == nullptr) && (!busList.empty ()))
+        {
+          refBus = busList.front ();
+        }
+    }
+  colMap.assign (stateCount, kNullLocation);
+  stateLoc.clear ();
+  double refAngle = 0.0;
+  if (refBus)
+    {
+      auto aloc = refBus->getOutputLoc (sm, angleInLocation);
+      refAngle = (aloc < stateCount) ? x[aloc] : 0.0;
+    }
+  for (auto &bus : busList)
+    {
+      auto vloc = bus->getOutputLoc (sm, voltageInLocation);
+      auto aloc = bus->getOutputLoc (sm, angleInLocation);
+      //slave buses share the states of their master so each state is only added once
+      if ((vloc < stateCount) && (colMap[vloc] == kNullLocation))
+        {
+          colMap[vloc] = static_cast<index_t> (stateLoc.size ());
+          stateLoc.push_back (vloc);
+          if ((flatStart) && (!haveEstimate))
+            {
+              x[vloc] = 1.0;
+            }
+        }
+      if ((bus != refBus) && (aloc < stateCount) && (colMap[aloc] == kNullLocation))
+        {
+          colMap[aloc] = static_cast<index_t> (stateLoc.size ());
+          stateLoc.push_back (aloc);
+          if ((flatStart) && (!haveEstimate))
+            {
+              x[aloc] = refAngle;
+            }
+        }
+    }
+  resid.assign (meas.size (), 0.0);
+  setupValid = true;
+  gainValid = false;
+  gainCurrent = false;
+  return (stateLoc.empty ()) ? FUNCTION_EXECUTION_FAILURE : FUNCTION_EXECUTION_SUCCESS;
+}
+
+void stateEstimator::evaluate ()
+{
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  //a zero sequence id forces the links to recompute their flows and derivatives for every evaluation
+  stateData sD (sim->getCurrentTime (), x.data (), dx.data (), 0);
+  arrayDataSparse ad;
+  for (auto &term : terminals)
+    {
+      term.cols.clear ();
+      term.dP.clear ();
+      term.dQ.clear ();
+      if (!term.link->enabled)
+        {
+          term.P = 0.0;
+          term.Q = 0.0;
+          continue;
+        }
+      term.link->updateLocalCache (&sD, sm);
+      auto busId = term.bus->getID ();
+      term.P = term.link->getRealPower (busId);
+      term.Q = term.link->getReactivePower (busId);
+      ad.clear ();
+      term.link->ioPartialDerivatives (busId, &sD, &ad, term.bus->getOutputLocs (sm), sm);
+      term.link->outputPartialDerivatives (busId, &sD, &ad, sm);
+      for (index_t kk = 0; kk < ad.size (); ++kk)
+        {
+          auto col = ad.colIndex (kk);
+          if ((col >= stateCount) || (colMap[col] == kNullLocation))
+            {
+              continue;
+            }
+          auto ecol = colMap[col];
+          auto fnd = std::find (term.cols.begin (), term.cols.end (), ecol);
+          auto pos = fnd - term.cols.begin ();
+          if (fnd == term.cols.end ())
+            {
+              term.cols.push_back (ecol);
+              term.dP.push_back (0.0);
+              term.dQ.push_back (0.0);
+            }
+          if (ad.rowIndex (kk) == PoutLocation)
+            {
+              term.dP[pos] += ad.val (kk);
+            }
+          else if (ad.rowIndex (kk) == QoutLocation)
+            {
+              term.dQ[pos] += ad.val (kk);
+            }
+        }
+    }
+
+  Hstart.clear ();
+  Hcols.clear ();
+  Hvals.clear ();
+  //rowPos merges the entries an injection row collects from several terminals
+  std::vector<index_t> rowPos (stateLoc.size (), kNullLocation);
+  for (index_t ii = 0; ii < meas.size (); ++ii)
+    {
+      auto &m = meas[ii];
+      auto rowStart = static_cast<index_t> (Hcols.size ());
+      Hstart.push_back (rowStart);
+      double h = 0.0;
+      index_t col = kNullLocation;
+      switch (m.type)
+        {
+        case measurement_type::voltage:
+          h = m.bus->getVoltage (&sD, sm);
+          col = m.bus->getOutputLoc (sm, voltageInLocation);
+          break;
+        case measurement_type::angle:
+          h = m.bus->getAngle (&sD, sm);
+          col = m.bus->getOutputLoc (sm, angleInLocation);
+          break;
+        default:
+          {
+            bool real = ((m.type == measurement_type::flow_real) || (m.type == measurement_type::injection_real));
+            for (auto &tind : measTerminals[ii])
+              {
+                auto &term = terminals[tind];
+                h += (real) ? term.P : term.Q;
+                for (size_t kk = 0; kk < term.cols.size (); ++kk)
+                  {
+                    double dv = (real) ? term.dP[kk] : term.dQ[kk];
+                    if (rowPos[term.cols[kk]] == kNullLocation)
+                      {
+                        rowPos[term.cols[kk]] = static_cast<index_t> (Hcols.size ());
+                        Hcols.push_back (term.cols[kk]);
+                        Hvals.push_back (dv);
+                      }
+                    else
+                      {
+                        Hvals[rowPos[term.cols[kk]]] += dv;
+                      }
+                  }
+              }
+            for (auto kk = rowStart; kk < Hcols.size (); ++kk)
+              {
+                rowPos[Hcols[kk]] = kNullLocation;
+              }
+          }
+          break;
+        }
+      if ((col < stateCount) && (colMap[col] != kNullLocation))
+        {
+          Hcols.push_back (colMap[col]);
+          Hvals.push_back (1.0);
+        }
+      m.estimate = h;
+      resid[ii] = m.value - h;
+    }
+  Hstart.push_back (static_cast<index_t> (Hcols.size ()));
+  gainCurrent = false;
+}
+
+int stateEstimator::factorGain ()
+{
+  arrayDataSparse ad;
+  for (index_t ii = 0; ii < meas.size (); ++ii)
+    {
+      if (!meas[ii].active)
+        {
+          continue;
+        }
+      double w = 1.0 / (meas[ii].sigma * meas[ii].sigma);
+      for (auto aa = Hstart[ii]; aa < Hstart[ii + 1]; ++aa)
+        {
+          for (auto bb = Hstart[ii]; bb < Hstart[ii + 1]; ++bb)
+            {
+              ad.assign (Hcols[aa], Hcols[bb], w * Hvals[aa] * Hvals[bb]);
+            }
+        }
+    }
+  gain.load (ad, static_cast<count_t> (stateLoc.size ()));
+  ++stats.factorizations;
+  gainPattern = Hcols;
+  int ret = gainLU.factor (gain);
+  gainValid = (ret == FUNCTION_EXECUTION_SUCCESS);
+  gainCurrent = gainValid;
+  return ret;
+}
+
+int stateEstimator::solveScan ()
+{
+  std::vector<double> rhs (stateLoc.size ());
+  double lastStep = kBigNum;
+  bool refactor = false;
+  for (count_t iter = 0; iter < maxIterations; ++iter)
+    {
+      evaluate ();
+      ++stats.iterations;
+      if ((refactor) || (!gainValid) || (Hcols != gainPattern))
+        {
+          if (factorGain () != FUNCTION_EXECUTION_SUCCESS)
+            {
+              //the gain matrix is singular if the measurements do not make the network observable
+              return FUNCTION_EXECUTION_FAILURE;
+            }
+        }
+      else
+        {
+          ++stats.reusedIterations;
+        }
+      //rhs=H'W(z-h(x))
+      std::fill (rhs.begin (), rhs.end (), 0.0);
+      for (index_t ii = 0; ii < meas.size (); ++ii)
+        {
+          if (!meas[ii].active)
+            {
+              continue;
+            }
+          double wr = resid[ii] / (meas[ii].sigma * meas[ii].sigma);
+          for (auto aa = Hstart[ii]; aa < Hstart[ii + 1]; ++aa)
+            {
+              rhs[Hcols[aa]] += Hvals[aa] * wr;
+            }
+        }
+      gainLU.solve (rhs.data ());
+      double step = maxNorm (rhs);
+      if (!std::isfinite (step))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      for (index_t kk = 0; kk < stateLoc.size (); ++kk)
+        {
+          x[stateLoc[kk]] += rhs[kk];
+        }
+      if (step <= tolerance)
+        {
+          bool current = gainCurrent;
+          evaluate ();
+          //the gain from the last iteration is current to within the tolerance
+          gainCurrent = current;
+          return FUNCTION_EXECUTION_SUCCESS;
+        }
+      //refactor when the stored gain no longer gives fast contraction
+      refactor = ((lastStep < kBigNum) && (step > contractionLimit * lastStep));
+      lastStep = step;
+    }
+  return FUNCTION_EXECUTION_FAILURE;
+}
+
+index_t stateEstimator::findBadData ()
+{
+  count_t nActive = 0;
+  for (auto &m : meas)
+    {
+      if (m.active)
+        {
+          ++nActive;
+        }
+    }
+  if (nActive <= stateLoc.size ())
+    {
+      return kNullLocation;
+    }
+  //the objective is chi-square distributed with m-n degrees of freedom without bad data
+  double dof = static_cast<double> (nActive - stateLoc.size ());
+  if (stats.objective <= dof + 3.0 * std::sqrt (2.0 * dof))
+    {
+      return kNullLocation;
+    }
+  if ((!gainCurrent) && (factorGain () != FUNCTION_EXECUTION_SUCCESS))
+    {
+      return kNullLocation;
+    }
+  std::vector<double> col (stateLoc.size ());
+  index_t worst = kNullLocation;
+  double worstVal = badDataThreshold;
+  for (index_t ii = 0; ii < meas.size (); ++ii)
+    {
+      auto &m = meas[ii];
+      m.normalizedResidual = 0.0;
+      if (!m.active)
+        {
+          continue;
+        }
+      //the residual covariance diagonal is sigma^2-h'G^-1h
+      std::fill (col.begin (), col.end (), 0.0);
+      for (auto aa = Hstart[ii]; aa < Hstart[ii + 1]; ++aa)
+        {
+          col[Hcols[aa]] = Hvals[aa];
+        }
+      gainLU.solve (col.data ());
+      double hGh = 0.0;
+      for (auto aa = Hstart[ii]; aa < Hstart[ii + 1]; ++aa)
+        {
+          hGh += Hvals[aa] * col[Hcols[aa]];
+        }
+      double omega = m.sigma * m.sigma - hGh;
+      //critical measurements have no redundancy and a zero residual covariance
+      if (omega <= 1e-10 * m.sigma * m.sigma)
+        {
+          continue;
+        }
+      m.normalizedResidual = std::abs (resid[ii]) / std::sqrt (omega);
+      if (m.normalizedResidual > worstVal)
+        {
+          worstVal = m.normalizedResidual;
+          worst = ii;
+        }
+    }
+  return worst;
+}
+
+int stateEstimator::estimate ()
+{
+  ++stats.scans;
+  if (sim->currentProcessState () < gridDynSimulation::gridState_t::INITIALIZED)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  if ((!setupValid) || (sim->stateSize (sm) != stateCount))
+    {
+      if (setup () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  count_t removed = 0;
+  while (true)
+    {
+      if (solveScan () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          gainValid = false;
+          //start the next scan from the network state instead of a diverged estimate
+          setupValid = false;
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      stats.objective = 0.0;
+      for (index_t ii = 0; ii < meas.size (); ++ii)
+        {
+          if (meas[ii].active)
+            {
+              stats.objective += resid[ii] * resid[ii] / (meas[ii].sigma * meas[ii].sigma);
+            }
+        }
+      if ((badDataThreshold <= 0.0) || (removed >= maxBadData))
+        {
+          break;
+        }
+      auto bad = findBadData ();
+      if (bad == kNullLocation)
+        {
+          break;
+        }
+      meas[bad].active = false;
+      meas[bad].badData = true;
+      ++removed;
+      ++stats.badDataRemoved;
+      gainValid = false;
+    }
+  sim->setState (sim->getCurrentTime (), x.data (), dx.data (), sm);
+  sim->updateLocalCache ();
+  haveEstimate = true;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void stateEstimator::sampleMeasurements ()
+{
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  if ((!setupValid) || (sim->stateSize (sm) != stateCount))
+    {
+      if (setup () != FUNCTION_EXECUTION_SUCCESS)
+        {
+          return;
+        }
+    }
+  auto xEst = x;
+  sim->guess (sim->getCurrentTime (), x.data (), dx.data (), sm);
+  evaluate ();
+  for (auto &m : meas)
+    {
+      m.value = m.estimate;
+    }
+  x = xEst;
+}
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef STATE_ESTIMATOR_H_
+#define STATE_ESTIMATOR_H_
+
+#include "gridDynTypes.h"
+#include "solvers/sparseLU.h"
+
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class gridCoreObject;
+class gridBus;
+class gridLink;
+
+/** @brief weighted least squares estimation of the bus voltages and angles from a set of measurements
+ the estimated states are the bus voltage and angle states of the power flow mode,  the angle of the reference bus is held
+fixed unless angles are measured.  Measurements are addressed like grabbers,  bus fields voltage,angle,linkp and linkq
+(the net link flow out of the bus) and link fields p1,q1,p2,q2.  The measurement Jacobian uses the link partial derivatives
+used in the power flow Jacobian,  and the Gauss-Newton steps solve the gain matrix H'WH with the sparse LU factorization.
+The factorization is kept between scans and reused while the iterations contract quickly,  since the estimate is a fixed
+point of the weighted residual equations for any gain matrix a stale factorization only slows convergence.
+Bad data is identified by the largest normalized residual once the objective fails a chi-square test.
+*/
+class stateEstimator
+{
+public:
+  /** @brief the quantity a measurement observes*/
+  enum class measurement_type
+  {
+    voltage, angle, flow_real, flow_reactive, injection_real, injection_reactive,
+  };
+  /** @brief a single measurement*/
+  class measurement
+  {
+public:
+    std::string name;  //!< the location string of the measurement
+    measurement_type type = measurement_type::voltage;  //!< the measured quantity
+    gridBus *bus = nullptr;  //!< the bus for voltage,angle,and injection measurements
+    gridLink *link = nullptr;  //!< the link for flow measurements
+    index_t terminal = 1;  //!< the link terminal of a flow measurement
+    double value = 0.0;  //!< the measured value
+    double sigma = 0.01;  //!< the standard deviation of the measurement
+    double estimate = kNullVal;  //!< the value at the estimated state
+    double normalizedResidual = 0.0;  //!< the normalized residual from the last bad data check
+    bool active = true;  //!< the measurement is used in the estimation
+    bool badData = false;  //!< the measurement was removed as bad data
+  };
+  /** @brief counters for the estimation work*/
+  class estimationStats
+  {
+public:
+    count_t scans = 0;  //!< the number of calls to estimate
+    count_t iterations = 0;  //!< the total number of Gauss-Newton iterations
+    count_t factorizations = 0;  //!< the number of gain matrix factorizations
+    count_t reusedIterations = 0;  //!< the number of iterations using an existing factorization
+    count_t badDataRemoved = 0;  //!< the number of measurements removed as bad data
+    double objective = 0.0;  //!< the weighted sum of squared residuals at the last estimate
+  };
+
+  explicit stateEstimator (gridDynSimulation *gds);
+
+  /** @brief add a measurement from a location string of the form object:field
+  @return the index of the measurement or kNullLocation if the location was not a valid measurement
+  */
+  index_t addMeasurement (const std::string &location, double value, double sigma);
+  /** @brief add a measurement of a field of a bus or link
+  @return the index of the measurement or kNullLocation if the field was not a valid measurement
+  */
+  index_t addMeasurement (gridCoreObject *obj, const std::string &field, double value, double sigma);
+  /** @brief update the value of a measurement for the next scan*/
+  void setMeasurement (index_t index, double value);
+  /** @brief put a measurement back into the estimation after it was removed as bad data*/
+  void restoreMeasurement (index_t index);
+  /** @brief set the values of all the measurements from the current state of the network*/
+  void sampleMeasurements ();
+  count_t measurementCount () const
+  {
+    return static_cast<count_t> (meas.size ());
+  }
+  const measurement &getMeasurement (index_t index) const
+  {
+    return meas[index];
+  }
+  /** @brief estimate the state from the current measurement values
+   the estimated state is loaded into the network objects on success
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the network is not observable or the iterations did
+  not converge
+  */
+  int estimate ();
+  /** @brief discard the stored factorization and estimate so the next scan starts over*/
+  void reset ();
+  const estimationStats &getStats () const
+  {
+    return stats;
+  }
+  /** @brief set the convergence tolerance on the state update*/
+  void setTolerance (double tol)
+  {
+    tolerance = tol;
+  }
+  /** @brief set the maximum number of Gauss-Newton iterations in a scan*/
+  void setMaxIterations (count_t iterations)
+  {
+    maxIterations = iterations;
+  }
+  /** @brief set the normalized residual above which a measurement is bad data,  0 turns off bad data detection*/
+  void setBadDataThreshold (double threshold)
+  {
+    badDataThreshold = threshold;
+  }
+  /** @brief set the maximum number of measurements removed as bad data in a scan*/
+  void setMaxBadData (count_t maxBad)
+  {
+    maxBadData = maxBad;
+  }
+  /** @brief start the first scan from a flat voltage profile instead of the state of the network*/
+  void setFlatStart (bool flat)
+  {
+    flatStart = flat;
+  }
+
+private:
+  /** @brief the flows and partial derivatives at one terminal of a link*/
+  class linkTerminal
+  {
+public:
+    gridLink *link = nullptr;  //!< the link
+    gridBus *bus = nullptr;  //!< the bus at the terminal
+    double P = 0.0;  //!< the real power flow into the link at the terminal
+    double Q = 0.0;  //!< the reactive power flow into the link at the terminal
+    std::vector<index_t> cols;  //!< the estimated states the flows depend on
+    std::vector<double> dP;  //!< the real power partial derivatives
+    std::vector<double> dQ;  //!< the reactive power partial derivatives
+  };
+
+  gridDynSimulation *sim;  //!< the simulation
+  std::vector<measurement> meas;  //!< the measurements
+  std::vector<std::vector<index_t> > measTerminals;  //!< the link terminals contributing to each measurement
+  std::vector<linkTerminal> terminals;  //!< the link terminals used by the measurements
+  std::vector<index_t> stateLoc;  //!< the location of each estimated state in the power flow state vector
+  std::vector<index_t> colMap;  //!< the estimated state index of each power flow state or kNullLocation
+  std::vector<double> x;  //!< the full power flow state vector at the estimate
+  std::vector<double> dx;  //!< the state derivatives (zero)
+  std::vector<index_t> Hstart;  //!< the start of each measurement row in the measurement Jacobian
+  std::vector<index_t> Hcols;  //!< the columns of the measurement Jacobian
+  std::vector<double> Hvals;  //!< the values of the measurement Jacobian
+  std::vector<index_t> gainPattern;  //!< the Jacobian columns when the gain matrix was factored
+  std::vector<double> resid;  //!< the measurement residuals
+  cscMatrix<double> gain;  //!< the gain matrix
+  sparseLU<double> gainLU;  //!< the factors of the gain matrix
+  estimationStats stats;  //!< the estimation counters
+  count_t stateCount = 0;  //!< the number of power flow states when the estimate was set up
+  bool setupValid = false;  //!< the bus and terminal structures match the measurements
+  bool gainValid = false;  //!< the gain factorization can be used
+  bool gainCurrent = false;  //!< the gain was factored at the last Jacobian evaluation
+  bool haveEstimate = false;  //!< the state vector holds a previous estimate
+  bool flatStart = false;  //!< start the first scan from a flat profile
+  double tolerance = 1e-6;  //!< the convergence tolerance on the state update
+  count_t maxIterations = 30;  //!< the maximum number of iterations in a scan
+  double contractionLimit = 0.25;  //!< the step ratio above which the gain matrix is refactored
+  double badDataThreshold = 3.0;  //!< the normalized residual threshold for bad data
+  count_t maxBadData = 10;  //!< the maximum number of bad data removals in a scan
+
+  index_t terminalIndex (gridLink *lnk, gridBus *bus);
+  int setup ();
+  void evaluate ();
+  int factorGain ();
+  int solveScan ();
+  index_t findBadData ();
+};
+
+#endif
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "trajectorySensitivity.h"
+#include "gridDyn.h"
+#include "arrayDataSparse.h"
+#include "objectInterpreter.h"
+
+#include <algorithm>
+#include <cmath>
+
+trajectorySensitivity::trajectorySensitivity (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+int trajectorySensitivity::addParameter (gridCoreObject *obj, const std::string &param)
+{
+  if (obj == nullptr)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  if (obj->get (param) == kNullVal)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  sensitivityParameter sp;
+  sp.obj = obj;
+  sp.param = param;
+  sp.label = obj->getName () + ":" + param;
+  params.push_back (sp);
+  //the new parameter needs a starting sensitivity so all the sensitivities restart
+  mode = nullptr;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int trajectorySensitivity::addParameter (const std::string &paramString)
+{
+  objInfo oi (paramString, sim);
+  if ((oi.m_obj == nullptr) || (oi.m_field.empty ()))
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  return addParameter (oi.m_obj, oi.m_field);
+}
+
+void trajectorySensitivity::beginStep (double time, const solverMode &sMode)
+{
+  if ((mode == &sMode) && (sim->stateSize (sMode) == size))
+    {
+      return;
+    }
+  mode = &sMode;
+  size = sim->stateSize (sMode);
+  lastTime = time;
+  sens.assign (params.size (), std::vector<double> (size, 0.0));
+  resid1.resize (size);
+  resid2.resize (size);
+  work.resize (size);
+}
+
+void trajectorySensitivity::parameterPartial (index_t param, double time, const double state[], const double dstate_dt[], double partial[])
+{
+  auto &sp = params[param];
+  double pval = sp.obj->get (sp.param);
+  double delta = perturbation * (std::max)(std::abs (pval), 1.0);
+  sp.obj->set (sp.param, pval + delta);
+  sim->residualFunction (time, state, dstate_dt, resid1.data (), *mode);
+  sp.obj->set (sp.param, pval - delta);
+  sim->residualFunction (time, state, dstate_dt, resid2.data (), *mode);
+  sp.obj->set (sp.param, pval);
+  for (index_t kk = 0; kk < size; ++kk)
+    {
+      partial[kk] = (resid1[kk] - resid2[kk]) / (2.0 * delta);
+    }
+}
+
+int trajectorySensitivity::advance (double time, const double state[], const double dstate_dt[])
+{
+  if ((mode == nullptr) || (params.empty ()))
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  double h = time - lastTime;
+  if (h <= 1e-12)
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  double cj = 1.0 / h;
+  //the delta residual evaluator would return cached residuals for the parameter perturbations
+  bool deltaResidual = sim->controlFlags[delta_residual_evaluation];
+  sim->controlFlags.set (delta_residual_evaluation, false);
+  arrayDataSparse ad;
+  ad.reserve (sim->jacSize (*mode));
+  sim->jacobianFunction (time, state, dstate_dt, &ad, cj, *mode);
+  stepMatrix.load (ad, size);
+  ad.clear ();
+  sim->jacobianFunction (time, state, dstate_dt, &ad, 0.0, *mode);
+  algMatrix.load (ad, size);
+  int ret = stepLU.factor (stepMatrix);
+  if (ret == FUNCTION_EXECUTION_SUCCESS)
+    {
+      std::vector<double> partial (size);
+      for (index_t pp = 0; pp < params.size (); ++pp)
+        {
+          auto &sp = sens[pp];
+          //rhs=(dF/dx+cj*dF/dx')*s_n-dF/dx*s_n-dF/dp
+          parameterPartial (pp, time, state, dstate_dt, partial.data ());
+          stepMatrix.multiply (sp.data (), work.data ());
+          algMatrix.residual (work.data (), sp.data (), resid1.data ());
+          for (index_t kk = 0; kk < size; ++kk)
+            {
+              sp[kk] = resid1[kk] - partial[kk];
+            }
+          stepLU.solve (sp.data ());
+        }
+      ++steps;
+    }
+  //put the objects back at the solver state after the perturbed evaluations
+  sim->residualFunction (time, state, dstate_dt, resid1.data (), *mode);
+  sim->controlFlags.set (delta_residual_evaluation, deltaResidual);
+  lastTime = time;
+  return ret;
+}
+
+void trajectorySensitivity::getVoltageSensitivity (std::vector<double> &dV) const
+{
+  dV.clear ();
+  if (mode == nullptr)
+    {
+      return;
+    }
+  //buses without a voltage state return their stored voltage for any state vector so a zero reference cancels them
+  std::vector<double> zero (size, 0.0);
+  std::vector<double> Vref;
+  sim->getVoltage (Vref, zero.data (), *mode);
+  std::vector<double> V;
+  for (auto &sp : sens)
+    {
+      sim->getVoltage (V, sp.data (), *mode);
+      for (size_t kk = 0; kk < V.size (); ++kk)
+        {
+          dV.push_back (V[kk] - Vref[kk]);
+        }
+    }
+}
+
+void trajectorySensitivity::getAngleSensitivity (std::vector<double> &dA) const
+{
+  dA.clear ();
+  if (mode == nullptr)
+    {
+      return;
+    }
+  std::vector<double> zero (size, 0.0);
+  std::vector<double> Aref;
+  sim->getAngle (Aref, zero.data (), *mode);
+  std::vector<double> A;
+  for (auto &sp : sens)
+    {
+      sim->getAngle (A, sp.data (), *mode);
+      for (size_t kk = 0; kk < A.size (); ++kk)
+        {
+          dA.push_back (A[kk] - Aref[kk]);
+        }
+    }
+}
+
+void trajectorySensitivity::getBusSensitivityNames (stringVec &names, const std::string &prefix) const
+{
+  names.clear ();
+  stringVec busNames;
+  sim->getBusName (busNames);
+  for (auto &sp : params)
+    {
+      for (auto &bn : busNames)
+        {
+          names.push_back (prefix + "(" + bn + ")/d(" + sp.label + ")");
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef TRAJECTORY_SENSITIVITY_H_
+#define TRAJECTORY_SENSITIVITY_H_
+
+#include "gridDynTypes.h"
+#include "solvers/sparseLU.h"
+
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class gridCoreObject;
+class solverMode;
+
+/** @brief forward sensitivities of the dynamic trajectory with respect to model parameters
+ the sensitivity s=dx/dp of the DAE F(t,x,x',p)=0 solves (dF/dx+cj*dF/dx')*s_n+1=dF/dx'*cj*s_n-dF/dp with cj=1/h,  a backward
+Euler step over each step taken by the dynamic solver.  The Jacobian is factored once per step and shared by all the
+parameters.  The parameter partials dF/dp are central differences of the residual at the current state, so any object
+parameter accessible through set and get can be used.  The sensitivities start at zero when the dynamic simulation starts,
+they describe the response to a parameter change with the initialized operating point and setpoints held fixed.
+*/
+class trajectorySensitivity
+{
+public:
+  explicit trajectorySensitivity (gridDynSimulation *gds);
+
+  /** @brief add a parameter
+  @param[in] obj the object holding the parameter
+  @param[in] param the name of the parameter
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the object does not have the parameter
+  */
+  int addParameter (gridCoreObject *obj, const std::string &param);
+  /** @brief add a parameter from a string of the form object::subobject:parameter
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the object or parameter was not found
+  */
+  int addParameter (const std::string &paramString);
+  count_t parameterCount () const
+  {
+    return static_cast<count_t> (params.size ());
+  }
+  /** @brief prepare for a solver step starting at time
+   resets the sensitivities to zero if the solver mode or the number of states changed
+  */
+  void beginStep (double time, const solverMode &sMode);
+  /** @brief advance the sensitivities to the end of a solver step
+  @param[in] time the time at the end of the step
+  @param[in] state the state at the end of the step
+  @param[in] dstate_dt the state derivatives at the end of the step
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the step matrix was singular
+  */
+  int advance (double time, const double state[], const double dstate_dt[]);
+  /** @brief get the state sensitivities to a parameter*/
+  const std::vector<double> &getSensitivity (index_t param) const
+  {
+    return sens[param];
+  }
+  /** @brief get the bus voltage sensitivities to all the parameters, ordered by parameter then bus*/
+  void getVoltageSensitivity (std::vector<double> &dV) const;
+  /** @brief get the bus angle sensitivities to all the parameters, ordered by parameter then bus*/
+  void getAngleSensitivity (std::vector<double> &dA) const;
+  /** @brief get the names of the voltage or angle sensitivities in the same order*/
+  void getBusSensitivityNames (std::vector<std::string> &names, const std::string &prefix) const;
+  /** @brief set the relative perturbation used for the parameter partials*/
+  void setPerturbation (double delta)
+  {
+    perturbation = delta;
+  }
+  /** @brief get the number of steps the sensitivities have been advanced*/
+  count_t stepCount () const
+  {
+    return steps;
+  }
+  /** @brief reset the sensitivities to zero at the next step*/
+  void reset ()
+  {
+    mode = nullptr;
+  }
+
+private:
+  /** @brief a parameter with its location*/
+  class sensitivityParameter
+  {
+public:
+    gridCoreObject *obj;  //!< the object holding the parameter
+    std::string param;  //!< the parameter name
+    std::string label;  //!< the name used for output
+  };
+
+  gridDynSimulation *sim;  //!< the simulation
+  std::vector<sensitivityParameter> params;  //!< the parameters
+  std::vector<std::vector<double> > sens;  //!< the sensitivities for each parameter
+  const solverMode *mode = nullptr;  //!< the solver mode the sensitivities belong to
+  count_t size = 0;  //!< the number of states
+  double lastTime = 0.0;  //!< the time of the current sensitivities
+  double perturbation = 1e-6;  //!< relative perturbation for the parameter partials
+  count_t steps = 0;  //!< the number of steps taken
+  cscMatrix<double> stepMatrix;  //!< dF/dx+cj*dF/dx'
+  cscMatrix<double> algMatrix;  //!< dF/dx
+  sparseLU<double> stepLU;  //!< the factors of the step matrix
+  std::vector<double> resid1;  //!< residual work vector
+  std::vector<double> resid2;  //!< residual work vector
+  std::vector<double> work;  //!< work vector
+
+  void parameterPartial (index_t param, double time, const double state[], const double dstate_dt[], double partial[]);
+};
+
+#endif
@@ -0,0 +1,580 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "voltageStabilityScreening.h"
+#include "objectRegistry.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "loadModels/gridLoad.h"
+#include "generators/gridDynGenerator.h"
+#include "solvers/sparseLU.h"
+#include "arrayDataSparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+static double maxNorm (const std::vector<double> &vec)
+{
+  double nrm = 0.0;
+  for (auto &v : vec)
+    {
+      nrm = (std::max)(nrm, std::abs (v));
+    }
+  return nrm;
+}
+
+/** @brief the working data for evaluating directions on one simulation*/
+class voltageStabilityScreening::marginCase
+{
+public:
+  gridDynSimulation *gds = nullptr;  //!< the simulation used for the solves
+  const solverMode *sm = nullptr;  //!< the power flow solver mode
+  double time = 0.0;  //!< the time of the base solution
+  count_t size = 0;  //!< the number of power flow states
+  std::vector<gridBus *> buses;  //!< the connected buses
+  std::vector<gridLoad *> loads;  //!< the loads of the current direction
+  std::vector<double> loadP0;  //!< the base real power of the loads
+  std::vector<double> loadQ0;  //!< the base reactive power of the loads
+  std::vector<double> loadW;  //!< the weights of the loads
+  std::vector<gridDynGenerator *> gens;  //!< the generators of the current direction
+  std::vector<double> genP0;  //!< the base real power of the generators
+  std::vector<double> genShare;  //!< the normalized shares of the generators
+  double transfer = 0.0;  //!< the load increase per unit lambda
+  arrayDataSparse ad;  //!< Jacobian entries
+  cscMatrix<double> J;  //!< the Jacobian
+  sparseLU<double> LU;  //!< the most recent factorization
+  std::vector<double> x0;  //!< the base solution
+  std::vector<double> x;  //!< the current state
+  std::vector<double> dx;  //!< zero derivatives
+  std::vector<double> F;  //!< residual work vector
+  std::vector<double> dFdl;  //!< the derivative of the residual with respect to lambda
+  std::vector<double> t;  //!< the tangent vector dx/dlambda
+  std::vector<double> work;  //!< solve work vector
+  count_t solves = 0;  //!< the number of solves
+  count_t factorizations = 0;  //!< the number of factorizations
+
+  /** @brief set the direction objects from the base definition
+  @param[in] base the simulation the direction was defined on,  objects of a copy are found by their position in the registry
+  */
+  void bind (const transferDirection &dir, gridDynSimulation *base);
+  /** @brief set the load and generation for a loading level*/
+  void setLambda (double lambda);
+  /** @brief get the voltage of every bus for a state vector*/
+  void busVoltages (const double state[], std::vector<double> &V) const
+  {
+    V.resize (buses.size ());
+    for (size_t kk = 0; kk < buses.size (); ++kk)
+      {
+        V[kk] = buses[kk]->getVoltage (state, *sm);
+      }
+  }
+};
+
+template <class X>
+static X *translate (X *obj, gridDynSimulation *base, gridDynSimulation *gds, objectRegistry::object_type type)
+{
+  if (gds == base)
+    {
+      return obj;
+    }
+  auto &baseList = base->getObjectRegistry ()->getObjects (type);
+  auto fnd = std::find (baseList.begin (), baseList.end (), obj);
+  auto &newList = gds->getObjectRegistry ()->getObjects (type);
+  index_t ind = static_cast<index_t> (fnd - baseList.begin ());
+  return (ind < newList.size ()) ? dynamic_cast<X *> (newList[ind]) : nullptr;
+}
+
+void voltageStabilityScreening::marginCase::bind (const transferDirection &dir, gridDynSimulation *base)
+{
+  loads.clear ();
+  loadP0.clear ();
+  loadQ0.clear ();
+  loadW.clear ();
+  transfer = 0.0;
+  for (size_t kk = 0; kk < dir.loads.size (); ++kk)
+    {
+      auto ld = translate (dir.loads[kk], base, gds, objectRegistry::object_type::load);
+      if (ld == nullptr)
+        {
+          continue;
+        }
+      loads.push_back (ld);
+      loadP0.push_back (ld->get ("p"));
+      loadQ0.push_back (ld->get ("q"));
+      loadW.push_back ((kk < dir.loadWeights.size ()) ? dir.loadWeights[kk] : 1.0);
+      transfer += loadW.back () * loadP0.back ();
+    }
+  gens.clear ();
+  genP0.clear ();
+  genShare.clear ();
+  double shareSum = 0.0;
+  for (size_t kk = 0; kk < dir.generators.size (); ++kk)
+    {
+      auto gen = translate (dir.generators[kk], base, gds, objectRegistry::object_type::generator);
+      if (gen == nullptr)
+        {
+          continue;
+        }
+      gens.push_back (gen);
+      genP0.push_back (-gen->getRealPower ());
+      genShare.push_back ((kk < dir.generatorShares.size ()) ? dir.generatorShares[kk] : 1.0);
+      shareSum += genShare.back ();
+    }
+  for (auto &share : genShare)
+    {
+      share = (shareSum != 0.0) ? share / shareSum : 0.0;
+    }
+}
+
+void voltageStabilityScreening::marginCase::setLambda (double lambda)
+{
+  for (size_t kk = 0; kk < loads.size (); ++kk)
+    {
+      loads[kk]->set ("p", loadP0[kk] * (1.0 + lambda * loadW[kk]));
+      loads[kk]->set ("q", loadQ0[kk] * (1.0 + lambda * loadW[kk]));
+    }
+  for (size_t kk = 0; kk < gens.size (); ++kk)
+    {
+      gens[kk]->set ("p", genP0[kk] + lambda * genShare[kk] * transfer);
+    }
+}
+
+voltageStabilityScreening::voltageStabilityScreening (gridDynSimulation *gds) : sim (gds)
+{
+
+}
+
+voltageStabilityScreening::~voltageStabilityScreening ()
+{
+
+}
+
+void voltageStabilityScreening::addDirection (const transferDirection &dir)
+{
+  directions.push_back (dir);
+}
+
+void voltageStabilityScreening::addSystemLoadDirection (const std::string &dirName)
+{
+  transferDirection dir;
+  dir.name = dirName;
+  for (auto &obj : sim->getObjectRegistry ()->getObjects (objectRegistry::object_type::load))
+    {
+      dir.loads.push_back (static_cast<gridLoad *> (obj));
+    }
+  directions.push_back (dir);
+}
+
+int voltageStabilityScreening::solve (marginCase &mc, double lambda)
+{
+  mc.setLambda (lambda);
+  ++mc.solves;
+  double lastStep = kBigNum;
+  bool refactor = !mc.LU.isFactored ();
+  for (count_t iter = 0; iter < maxIterations; ++iter)
+    {
+      mc.gds->residualFunction (mc.time, mc.x.data (), mc.dx.data (), mc.F.data (), *(mc.sm));
+      double res = maxNorm (mc.F);
+      if (res <= tolerance)
+        {
+          return FUNCTION_EXECUTION_SUCCESS;
+        }
+      if (!std::isfinite (res))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      if (refactor)
+        {
+          mc.ad.clear ();
+          mc.gds->jacobianFunction (mc.time, mc.x.data (), mc.dx.data (), &(mc.ad), 0.0, *(mc.sm));
+          mc.J.load (mc.ad, mc.size);
+          ++mc.factorizations;
+          //the ordering from the base analysis is reused since the pattern does not change with the loading
+          if (mc.LU.factor (mc.J) != FUNCTION_EXECUTION_SUCCESS)
+            {
+              return FUNCTION_EXECUTION_FAILURE;
+            }
+        }
+      mc.LU.solve (mc.F.data (), mc.work.data ());
+      double stepNorm = maxNorm (mc.F);
+      for (index_t kk = 0; kk < mc.size; ++kk)
+        {
+          mc.x[kk] -= mc.F[kk];
+        }
+      //refactor when the stored factors no longer give fast contraction
+      refactor = ((lastStep < kBigNum) && (stepNorm > contractionLimit * lastStep));
+      lastStep = stepNorm;
+    }
+  return FUNCTION_EXECUTION_FAILURE;
+}
+
+int voltageStabilityScreening::tangent (marginCase &mc, double lambda)
+{
+  //the tangent needs the Jacobian at the solution
+  mc.ad.clear ();
+  mc.gds->jacobianFunction (mc.time, mc.x.data (), mc.dx.data (), &(mc.ad), 0.0, *(mc.sm));
+  mc.J.load (mc.ad, mc.size);
+  ++mc.factorizations;
+  if (mc.LU.factor (mc.J) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  //the loading enters the residual linearly so a finite difference gives the derivative
+  const double dl = 1e-3;
+  mc.gds->residualFunction (mc.time, mc.x.data (), mc.dx.data (), mc.F.data (), *(mc.sm));
+  mc.setLambda (lambda + dl);
+  mc.gds->residualFunction (mc.time, mc.x.data (), mc.dx.data (), mc.dFdl.data (), *(mc.sm));
+  mc.setLambda (lambda);
+  for (index_t kk = 0; kk < mc.size; ++kk)
+    {
+      mc.t[kk] = -(mc.dFdl[kk] - mc.F[kk]) / dl;
+    }
+  mc.LU.solve (mc.t.data (), mc.work.data ());
+  return (std::isfinite (maxNorm (mc.t))) ? FUNCTION_EXECUTION_SUCCESS : FUNCTION_EXECUTION_FAILURE;
+}
+
+/** @brief the quadratic through three points of lambda(V) has its maximum at the nose
+@return the maximum or kNullVal if the points do not bend toward a nose
+*/
+static double quadraticNose (const double V[3], const double lam[3])
+{
+  if ((V[0] == V[1]) || (V[1] == V[2]) || (V[0] == V[2]))
+    {
+      return kNullVal;
+    }
+  double d01 = (lam[1] - lam[0]) / (V[1] - V[0]);
+  double d12 = (lam[2] - lam[1]) / (V[2] - V[1]);
+  double c = (d12 - d01) / (V[2] - V[0]);
+  if (c >= 0.0)
+    {
+      return kNullVal;
+    }
+  double b = d01 - c * (V[1] + V[0]);
+  double a = lam[0] - b * V[0] - c * V[0] * V[0];
+  return a - b * b / (4.0 * c);
+}
+
+/** @brief near the nose 1/(dV/dlambda)^2 falls linearly to zero at the point of collapse
+@return the extrapolated zero or kNullVal if the sensitivity is not growing
+*/
+static double tangentNose (double lam1, double dV1, double lam2, double dV2)
+{
+  if ((dV1 == 0.0) || (dV2 == 0.0))
+    {
+      return kNullVal;
+    }
+  double s1 = 1.0 / (dV1 * dV1);
+  double s2 = 1.0 / (dV2 * dV2);
+  if ((s1 <= s2) || (lam2 <= lam1))
+    {
+      return kNullVal;
+    }
+  return lam2 + s2 * (lam2 - lam1) / (s1 - s2);
+}
+
+void voltageStabilityScreening::runDirection (marginCase &mc, index_t dirIndex, marginResult &res)
+{
+  res.name = directions[dirIndex].name;
+  mc.bind (directions[dirIndex], sim);
+  mc.solves = 0;
+  mc.factorizations = 0;
+  mc.x = mc.x0;
+
+  std::vector<double> V;
+  std::vector<double> xt;
+  //look ahead points at lambda = 0,step,2*step unless the steps have to be shortened
+  double lam[3] = { 0.0, 0.0, 0.0 };
+  std::vector<double> Vpts[3];
+  std::vector<double> dVpts[3];
+  std::vector<double> xLo;
+  double lamLo = 0.0;
+  count_t npts = 0;
+  double h = step;
+  while (npts < 3)
+    {
+      double target = (npts == 0) ? 0.0 : lamLo + h;
+      if (npts > 0)
+        {
+          xLo = mc.x;
+          for (index_t kk = 0; kk < mc.size; ++kk)
+            {
+              mc.x[kk] += h * mc.t[kk];
+            }
+        }
+      if (solve (mc, target) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          if ((npts == 0) || (h < marginTolerance * step))
+            {
+              break;
+            }
+          //the step passed the nose,  shorten it
+          mc.x = xLo;
+          h *= 0.5;
+          continue;
+        }
+      if (tangent (mc, target) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          break;
+        }
+      mc.busVoltages (mc.x.data (), Vpts[npts]);
+      xt = mc.x;
+      for (index_t kk = 0; kk < mc.size; ++kk)
+        {
+          xt[kk] += mc.t[kk];
+        }
+      mc.busVoltages (xt.data (), V);
+      dVpts[npts].resize (V.size ());
+      for (index_t kk = 0; kk < V.size (); ++kk)
+        {
+          dVpts[npts][kk] = std::abs (V[kk] - Vpts[npts][kk]);
+        }
+      lamLo = target;
+      lam[npts] = target;
+      ++npts;
+    }
+  res.solvedLoading = lamLo;
+  res.solves = mc.solves;
+  res.factorizations = mc.factorizations;
+  if ((npts < 3) || (mc.buses.empty ()))
+    {
+      return;
+    }
+  res.converged = true;
+  //the critical bus has the largest voltage drop per unit loading at the last point
+  auto crit = static_cast<index_t> (std::max_element (dVpts[2].begin (), dVpts[2].end ()) - dVpts[2].begin ());
+  res.criticalBusName = mc.buses[crit]->getName ();
+  double Vc[3] = { Vpts[0][crit], Vpts[1][crit], Vpts[2][crit] };
+  res.lookAheadMargin = quadraticNose (Vc, lam);
+  double dVcrit = dVpts[2][crit];
+  double est = tangentNose (lam[1], dVpts[1][crit], lam[2], dVcrit);
+  if (est == kNullVal)
+    {
+      est = res.lookAheadMargin;
+    }
+  res.estimatedError = ((est != kNullVal) && (res.lookAheadMargin != kNullVal)) ? std::abs (est - res.lookAheadMargin) : kNullVal;
+
+  //tangent predictor steps toward the point of collapse estimate
+  std::vector<double> Vsol;
+  double lamHi = kBigNum;
+  double approach = 0.8;
+  for (count_t rr = 0; (rr < maxRefinements) && (est != kNullVal); ++rr)
+    {
+      double gap = (std::min)(est, lamHi) - lamLo;
+      if (gap <= marginTolerance * (1.0 + std::abs (est)))
+        {
+          break;
+        }
+      double target = lamLo + approach * gap;
+      xLo = mc.x;
+      for (index_t kk = 0; kk < mc.size; ++kk)
+        {
+          mc.x[kk] += (target - lamLo) * mc.t[kk];
+        }
+      if ((solve (mc, target) != FUNCTION_EXECUTION_SUCCESS) || (tangent (mc, target) != FUNCTION_EXECUTION_SUCCESS))
+        {
+          mc.x = xLo;
+          lamHi = target;
+          approach *= 0.5;
+          //restore the factors and tangent of the last solved point
+          mc.setLambda (lamLo);
+          tangent (mc, lamLo);
+          continue;
+        }
+      mc.busVoltages (mc.x.data (), Vsol);
+      xt = mc.x;
+      for (index_t kk = 0; kk < mc.size; ++kk)
+        {
+          xt[kk] += mc.t[kk];
+        }
+      mc.busVoltages (xt.data (), V);
+      double dVnew = std::abs (V[crit] - Vsol[crit]);
+      double newEst = tangentNose (lamLo, dVcrit, target, dVnew);
+      lamLo = target;
+      dVcrit = dVnew;
+      if (newEst == kNullVal)
+        {
+          break;
+        }
+      res.estimatedError = std::abs (newEst - est);
+      est = newEst;
+    }
+  res.directMargin = est;
+  res.solvedLoading = lamLo;
+  res.solves = mc.solves;
+  res.factorizations = mc.factorizations;
+}
+
+double voltageStabilityScreening::continuation (marginCase &mc, index_t dirIndex)
+{
+  mc.bind (directions[dirIndex], sim);
+  mc.x = mc.x0;
+  if ((solve (mc, 0.0) != FUNCTION_EXECUTION_SUCCESS) || (tangent (mc, 0.0) != FUNCTION_EXECUTION_SUCCESS))
+    {
+      return kNullVal;
+    }
+  double lambda = 0.0;
+  double h = step;
+  std::vector<double> xLo;
+  while (h > marginTolerance * (1.0 + lambda) * 0.5)
+    {
+      xLo = mc.x;
+      for (index_t kk = 0; kk < mc.size; ++kk)
+        {
+          mc.x[kk] += h * mc.t[kk];
+        }
+      if ((solve (mc, lambda + h) == FUNCTION_EXECUTION_SUCCESS) && (tangent (mc, lambda + h) == FUNCTION_EXECUTION_SUCCESS))
+        {
+          lambda += h;
+          continue;
+        }
+      mc.x = xLo;
+      mc.setLambda (lambda);
+      tangent (mc, lambda);
+      h *= 0.5;
+    }
+  return lambda;
+}
+
+int voltageStabilityScreening::screen ()
+{
+  results.clear ();
+  if (sim->currentProcessState () < gridDynSimulation::gridState_t::POWERFLOW_COMPLETE)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  const solverMode &sm = *(sim->defPowerFlowMode);
+  count_t size = sim->stateSize (sm);
+  if (size == 0)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  results.resize (directions.size ());
+  if (directions.empty ())
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  //the delta residual evaluator does not see the parameter changes so full residuals are used during the screening
+  bool deltaResidual = sim->controlFlags[delta_residual_evaluation];
+  sim->controlFlags.set (delta_residual_evaluation, false);
+
+  marginCase base;
+  base.gds = sim;
+  base.sm = &sm;
+  base.time = sim->getCurrentTime ();
+  base.size = size;
+  base.x0.resize (size);
+  base.dx.assign (size, 0.0);
+  sim->guess (base.time, base.x0.data (), base.dx.data (), sm);
+  base.F.resize (size);
+  base.dFdl.resize (size);
+  base.t.resize (size);
+  base.work.resize (size);
+  sim->getBusVector (base.buses);
+  base.buses.erase (std::remove_if (base.buses.begin (), base.buses.end (), [](const gridBus *bus) {
+      return ((!bus->enabled) || (!bus->isConnected ()));
+    }), base.buses.end ());
+  base.ad.reserve (sim->jacSize (sm));
+  sim->jacobianFunction (base.time, base.x0.data (), base.dx.data (), &(base.ad), 0.0, sm);
+  base.J.load (base.ad, size);
+  //the pattern is analyzed and the base Jacobian factored once for all the directions
+  base.LU.analyze (base.J);
+  if (base.LU.factor (base.J) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      sim->controlFlags.set (delta_residual_evaluation, deltaResidual);
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  //each additional thread works on its own copy of the simulation
+  std::vector<std::unique_ptr<gridDynSimulation> > copies;
+  std::vector<std::unique_ptr<marginCase> > cases;
+  count_t threads = 1;
+#ifdef HAVE_OPENMP
+  if (parallel)
+    {
+      threads = static_cast<count_t> ((std::min)(static_cast<size_t> (omp_get_max_threads ()), directions.size ()));
+    }
+#endif
+  for (count_t kk = 1; kk < threads; ++kk)
+    {
+      std::unique_ptr<marginCase> mc (new marginCase (base));
+      copies.emplace_back (static_cast<gridDynSimulation *> (sim->clone ()));
+      mc->gds = copies.back ().get ();
+      mc->gds->controlFlags.set (delta_residual_evaluation, false);
+      mc->gds->pFlowInitialize (base.time);
+      mc->sm = mc->gds->defPowerFlowMode;
+      //a copy is only usable if it produces the same state layout
+      if (mc->gds->stateSize (*(mc->sm)) != size)
+        {
+          break;
+        }
+      mc->buses.clear ();
+      mc->gds->getBusVector (mc->buses);
+      mc->buses.erase (std::remove_if (mc->buses.begin (), mc->buses.end (), [](const gridBus *bus) {
+          return ((!bus->enabled) || (!bus->isConnected ()));
+        }), mc->buses.end ());
+      if (mc->buses.size () != base.buses.size ())
+        {
+          break;
+        }
+      cases.push_back (std::move (mc));
+    }
+  //build the object lists before the threads read them
+  sim->getObjectRegistry ()->getObjects (objectRegistry::object_type::load);
+  for (auto &cp : copies)
+    {
+      cp->getObjectRegistry ()->getObjects (objectRegistry::object_type::load);
+    }
+  base.x = base.x0;
+  int ndir = static_cast<int> (directions.size ());
+  int ncases = static_cast<int> (cases.size ()) + 1;
+#pragma omp parallel for schedule(dynamic) num_threads(ncases) if (ncases > 1)
+  for (int kk = 0; kk < ndir; ++kk)
+    {
+      int thread = 0;
+#ifdef HAVE_OPENMP
+      thread = omp_get_thread_num ();
+#endif
+      marginCase &mc = (thread == 0) ? base : *(cases[thread - 1]);
+      runDirection (mc, static_cast<index_t> (kk), results[kk]);
+      if (verification)
+        {
+          results[kk].continuationMargin = continuation (mc, static_cast<index_t> (kk));
+          if ((results[kk].continuationMargin != kNullVal) && (results[kk].directMargin != kNullVal))
+            {
+              results[kk].continuationError = results[kk].directMargin - results[kk].continuationMargin;
+            }
+        }
+      mc.setLambda (0.0);
+    }
+  //the critical buses are reported as objects of the screened simulation
+  for (auto &res : results)
+    {
+      for (auto &bus : base.buses)
+        {
+          if ((!res.criticalBusName.empty ()) && (bus->getName () == res.criticalBusName))
+            {
+              res.criticalBus = bus;
+              break;
+            }
+        }
+    }
+  //put the objects back at the base solution
+  sim->setState (base.time, base.x0.data (), base.dx.data (), sm);
+  sim->updateLocalCache ();
+  sim->controlFlags.set (delta_residual_evaluation, deltaResidual);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
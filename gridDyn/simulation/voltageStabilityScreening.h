@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef VOLTAGE_STABILITY_SCREENING_H_
+#define VOLTAGE_STABILITY_SCREENING_H_
+
+#include "gridDynTypes.h"
+
+#include <string>
+#include <vector>
+
+class gridDynSimulation;
+class gridLoad;
+class gridDynGenerator;
+class gridBus;
+
+/** @brief approximate loadability margins for a set of transfer directions
+ a transfer direction scales a set of loads by (1+lambda*weight) at constant power factor with the increase picked up by a
+set of generators in proportion to their shares,  or by the swing bus if no generators are given.  The margin is the value
+of lambda at the nose of the PV curve.  For each direction a few power flows are solved at increasing lambda and two
+estimates are made
+- a look ahead estimate from a quadratic fit of lambda against the voltage of the critical bus through the solved points
+- a point of collapse estimate from the tangent vector dx/dlambda,  near the nose 1/(dV/dlambda)^2 falls linearly to zero
+so it is extrapolated from the last two points and refined with tangent predictor steps toward the estimate
+the critical bus is the bus with the largest component of the tangent vector.  The base power flow Jacobian is analyzed and
+factored once,  every direction starts from a copy of those factors and its solves are chord iterations which refactor
+with the stored ordering only when the contraction slows.  Directions are independent and are evaluated in parallel on
+copies of the simulation when OpenMP is available.  Optionally each direction is also traced with a full continuation run
+to report the error of the estimates.  The simulation is returned to the base solution after the screening.
+*/
+class voltageStabilityScreening
+{
+public:
+  /** @brief the definition of a transfer direction*/
+  class transferDirection
+  {
+public:
+    std::string name;  //!< the name of the direction
+    std::vector<gridLoad *> loads;  //!< the loads which are increased
+    std::vector<double> loadWeights;  //!< the weight of each load, all 1.0 if empty
+    std::vector<gridDynGenerator *> generators;  //!< the generators picking up the increase
+    std::vector<double> generatorShares;  //!< the share of the increase of each generator, equal shares if empty
+  };
+
+  /** @brief the margin of one transfer direction*/
+  class marginResult
+  {
+public:
+    std::string name;  //!< the name of the direction
+    bool converged = false;  //!< the look ahead points were solved
+    double lookAheadMargin = kNullVal;  //!< the margin from the curve fit
+    double directMargin = kNullVal;  //!< the margin from the tangent vector point of collapse estimate
+    double solvedLoading = 0.0;  //!< the largest lambda with a solved power flow
+    double estimatedError = kNullVal;  //!< the change in the margin estimate over the last refinement
+    gridBus *criticalBus = nullptr;  //!< the bus with the largest voltage sensitivity at the last solved point
+    std::string criticalBusName;  //!< the name of the critical bus
+    double continuationMargin = kNullVal;  //!< the margin from a full continuation run if verification is on
+    double continuationError = kNullVal;  //!< the difference between the direct and continuation margins
+    count_t solves = 0;  //!< the number of power flow solves
+    count_t factorizations = 0;  //!< the number of Jacobian factorizations
+  };
+
+  explicit voltageStabilityScreening (gridDynSimulation *gds);
+  ~voltageStabilityScreening ();
+
+  /** @brief add a transfer direction*/
+  void addDirection (const transferDirection &dir);
+  /** @brief add a direction increasing every load in the simulation uniformly with the swing bus picking up the increase*/
+  void addSystemLoadDirection (const std::string &dirName = "system");
+  void clearDirections ()
+  {
+    directions.clear ();
+  }
+  /** @brief compute the margins of all the directions
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if there is no power flow solution to screen against
+  */
+  int screen ();
+
+  const std::vector<marginResult> &getResults () const
+  {
+    return results;
+  }
+  /** @brief set the loading step between the look ahead points*/
+  void setStep (double lambdaStep)
+  {
+    step = lambdaStep;
+  }
+  /** @brief set the number of tangent predictor steps toward the point of collapse estimate*/
+  void setMaxRefinements (count_t refinements)
+  {
+    maxRefinements = refinements;
+  }
+  /** @brief set the relative margin tolerance of the refinement and the verification runs*/
+  void setMarginTolerance (double tol)
+  {
+    marginTolerance = tol;
+  }
+  /** @brief set the maximum number of iterations of a power flow solve*/
+  void setMaxIterations (count_t iterations)
+  {
+    maxIterations = iterations;
+  }
+  /** @brief set the residual tolerance of a power flow solve*/
+  void setTolerance (double tol)
+  {
+    tolerance = tol;
+  }
+  /** @brief turn on the full continuation runs used to check the estimates*/
+  void setVerification (bool verify)
+  {
+    verification = verify;
+  }
+  /** @brief allow the directions to be evaluated in parallel*/
+  void setParallel (bool par)
+  {
+    parallel = par;
+  }
+
+private:
+  class marginCase;
+  gridDynSimulation *sim;  //!< the simulation to screen
+  std::vector<transferDirection> directions;  //!< the directions to screen
+  std::vector<marginResult> results;  //!< the results of the last screening
+  double step = 0.1;  //!< the loading step between the look ahead points
+  double marginTolerance = 1e-3;  //!< relative tolerance on the margin
+  double tolerance = 1e-8;  //!< the residual tolerance
+  double contractionLimit = 0.25;  //!< the step ratio above which a chord iteration refactors the Jacobian
+  count_t maxIterations = 20;  //!< the maximum number of iterations of a solve
+  count_t maxRefinements = 4;  //!< the maximum number of point of collapse refinement steps
+  bool verification = false;  //!< run full continuations to check the estimates
+  bool parallel = true;  //!< evaluate the directions in parallel
+
+  int solve (marginCase &mc, double lambda);
+  int tangent (marginCase &mc, double lambda);
+  void runDirection (marginCase &mc, index_t dirIndex, marginResult &res);
+  double continuation (marginCase &mc, index_t dirIndex);
+};
+
+#endif
@@ -91,6 +91,16 @@ int basicOdeSolver::initialize(double /*t0*/)
 	return FUNCTION_EXECUTION_SUCCESS;
 }
 
+int basicOdeSolver::calcIC(double t0, double tstep0, ic_modes initCondMode, bool constraints)
+{
+	if (initCondMode != ic_modes::fixed_diff)
+	{
+		return solverInterface::calcIC(t0, tstep0, initCondMode, constraints);
+	}
+	solveTime = t0;
+	return FUNCTION_EXECUTION_SUCCESS;
+}
+
 double basicOdeSolver::get(const std::string & param) const
 {
 	if (param == "deltat")
@@ -494,6 +494,22 @@ int cvodeInterface::setRootFinding (count_t numRoots)
   return FUNCTION_EXECUTION_SUCCESS;
 }
 
+int cvodeInterface::calcIC (double t0, double /*tstep0*/, ic_modes initCondMode, bool /*constraints*/)
+{
+  if (initCondMode != ic_modes::fixed_diff)
+    {
+      return solverInterface::calcIC (t0, 0.0, initCondMode, false);
+    }
+  ++icCount;
+  //restart the integration from the states currently loaded in the solver
+  int retval = CVodeReInit (solverMem, t0, state);
+  if (check_flag (&retval, "CVodeReInit", 1))
+    {
+      return retval;
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
 int cvodeInterface::getCurrentData ()
 {
   /*
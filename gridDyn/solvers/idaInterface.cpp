@@ -18,6 +18,7 @@
 
 #include <ida/ida.h>
 #include <ida/ida_dense.h>
+#include <ida/ida_spgmr.h>
 #include <sundials/sundials_math.h>
 #include "core/helperTemplates.h"
 
@@ -39,6 +40,8 @@ int idaJacDense (long int Neq, realtype ttime, realtype cj, N_Vector state, N_Ve
 int idaJacSparse (realtype ttime, realtype sD, N_Vector state, N_Vector dstate_dt, N_Vector resid, SlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
 #endif
 int idaRootFunc (realtype ttime, N_Vector state, N_Vector dstate_dt, realtype *gout, void *user_data);
+int idaPrecSetup (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, realtype cj, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+int idaPrecSolve (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, N_Vector rvec, N_Vector zvec, realtype cj, realtype delta, void *user_data, N_Vector tmp);
 
 
 idaInterface::idaInterface ()
@@ -104,6 +107,7 @@ void idaInterface::setMaxNonZeros (count_t nonZeroCount)
 	maxNNZ = nonZeroCount;
   a1.reserve (nonZeroCount);
   a1.clear ();
+  jacReady = false;
 }
 
 
@@ -122,11 +126,18 @@ double idaInterface::get (const std::string &param) const
     }
   else if (param == "jac calls")
     {
+      if ((mixedPrecision) && (!dense))
+        {
+          IDASpilsGetNumPrecEvals (solverMem, &val);
+        }
+      else
+        {
 #ifdef KLU_ENABLE
-      IDASlsGetNumJacEvals (solverMem, &val);
+          IDASlsGetNumJacEvals (solverMem, &val);
 #else
-      IDADlsGetNumJacEvals (solverMem, &val);
+          IDADlsGetNumJacEvals (solverMem, &val);
 #endif
+        }
     }
   else
     {
@@ -153,8 +164,16 @@ void idaInterface::logSolverStats (int logLevel, bool iconly) const
 
   int retval = IDAGetNumResEvals (solverMem, &nre);
   check_flag (&retval, "IDAGetNumResEvals", 1);
-  retval = IDADlsGetNumJacEvals (solverMem, &nje);
-  check_flag (&retval, "IDADlsGetNumJacEvals", 1);
+  if ((mixedPrecision) && (!dense))
+    {
+      retval = IDASpilsGetNumPrecEvals (solverMem, &nje);
+      check_flag (&retval, "IDASpilsGetNumPrecEvals", 1);
+    }
+  else
+    {
+      retval = IDADlsGetNumJacEvals (solverMem, &nje);
+      check_flag (&retval, "IDADlsGetNumJacEvals", 1);
+    }
   retval = IDAGetNumNonlinSolvIters (solverMem, &nni);
   check_flag (&retval, "IDAGetNumNonlinSolvIters", 1);
   retval = IDAGetNumNonlinSolvConvFails (solverMem, &ncfn);
@@ -165,8 +184,16 @@ void idaInterface::logSolverStats (int logLevel, bool iconly) const
       check_flag (&retval, "IDAGetNumSteps", 1);
       retval = IDAGetNumErrTestFails (solverMem, &netf);
       check_flag (&retval, "IDAGetNumErrTestFails", 1);
-      retval = IDADlsGetNumResEvals (solverMem, &nreLS);
-      check_flag (&retval, "IDADlsGetNumResEvals", 1);
+      if ((mixedPrecision) && (!dense))
+        {
+          retval = IDASpilsGetNumResEvals (solverMem, &nreLS);
+          check_flag (&retval, "IDASpilsGetNumResEvals", 1);
+        }
+      else
+        {
+          retval = IDADlsGetNumResEvals (solverMem, &nreLS);
+          check_flag (&retval, "IDADlsGetNumResEvals", 1);
+        }
       retval = IDAGetNumGEvals (solverMem, &nge);
       check_flag (&retval, "IDAGetNumGEvals", 1);
       retval = IDAGetCurrentOrder (solverMem, &kcur);
@@ -318,6 +345,7 @@ int idaInterface::initialize (double t0)
       printf ("ERROR,  ida data not allocated\n");
       return -2;
     }
+  jacReady = false;
   int retval;
   auto jsize = m_gds->jacSize (mode);
 
@@ -361,8 +389,30 @@ int idaInterface::initialize (double t0)
     {
       return(1);
     }
+  if ((mixedPrecision) && (!dense))
+    {
+      //the preconditioner is a refined direct solve so the Krylov iteration converges in one or two steps
+      if (!mpSolver)
+        {
+          mpSolver.reset (new mixedPrecisionSolver ());
+        }
+      mpSolver->reset ();
+      //start from the stored pattern and analysis of the mode if the simulation has one
+      mpSolver->setPattern (m_gds->getJacobianPattern (mode));
+      retval = IDASpgmr (solverMem, 5);
+      if (check_flag (&retval, "IDASpgmr", 1))
+        {
+          return(1);
+        }
+
+      retval = IDASpilsSetPreconditioner (solverMem, idaPrecSetup, idaPrecSolve);
+      if (check_flag (&retval, "IDASpilsSetPreconditioner", 1))
+        {
+          return(1);
+        }
+    }
 #ifdef KLU_ENABLE
-  if (dense)
+  else if (dense)
     {
       retval = IDADense (solverMem, svsize);
       if (check_flag (&retval, "IDADense", 1))
@@ -392,18 +442,21 @@ int idaInterface::initialize (double t0)
         }
     }
 #else
-  retval = IDADense (solverMem, svsize);
-  if (check_flag (&retval, "IDADense", 1))
+  else
     {
-      return(1);
-    }
+      retval = IDADense (solverMem, svsize);
+      if (check_flag (&retval, "IDADense", 1))
+        {
+          return(1);
+        }
 
-  retval = IDADlsSetDenseJacFn (solverMem, idaJacDense);
-  if (check_flag (&retval, "IDADlsSetDenseJacFn", 1))
-    {
-      return(1);
+      retval = IDADlsSetDenseJacFn (solverMem, idaJacDense);
+      if (check_flag (&retval, "IDADlsSetDenseJacFn", 1))
+        {
+          return(1);
+        }
     }
-  #endif
+#endif
 
 
 
@@ -438,8 +491,10 @@ int idaInterface::initialize (double t0)
 
 int idaInterface::sparseReInit (sparse_reinit_modes sparseReinitMode)
 {
+  jacReady = false;
 #ifdef KLU_ENABLE
-  if (dense)
+  //the mixed precision solver reanalyzes automatically when the pattern changes
+  if ((dense) || (mixedPrecision))
     {
       return FUNCTION_EXECUTION_SUCCESS;
     }
@@ -480,6 +535,8 @@ int idaInterface::calcIC (double t0, double tstep0, ic_modes initCondMode, bool
   int retval;
   ++icCount;
   assert (icCount < 200);
+  //the conditions have changed so a held Jacobian is no longer useful
+  jacReady = false;
   if (initCondMode == ic_modes::fixed_masked_and_deriv) //mainly for use upon startup from steady state
     {
       //do a series of steps to ensure the orginal algebraic states are fixed and the derivatives are fixed
@@ -711,6 +768,61 @@ int idaRootFunc (realtype ttime, N_Vector state, N_Vector dstate_dt, realtype *g
   return FUNCTION_EXECUTION_SUCCESS;
 }
 
+bool idaInterface::canReuseJacobian () const
+{
+  if ((!constantJacobian) || (!jacReady))
+    {
+      return false;
+    }
+  long int fails = 0;
+  IDAGetNumNonlinSolvConvFails (solverMem, &fails);
+  return (fails == jacConvFails);
+}
+
+void idaInterface::holdJacobian ()
+{
+  jacReady = true;
+  IDAGetNumNonlinSolvConvFails (solverMem, &jacConvFails);
+}
+
+void idaInterface::loadJacobian (double ttime, const double state[], const double dstate_dt[], double cj, double maskValue)
+{
+  if (!constantJacobian)
+    {
+      m_gds->jacobianFunction (ttime, state, dstate_dt, &a1, cj, mode);
+    }
+  else
+    {
+      if (!canReuseJacobian ())
+        {
+          //the Jacobian is linear in cj so the parts are split once and recombined whenever IDA changes cj
+          m_gds->jacobianFunction (ttime, state, dstate_dt, &jacY, 0.0, mode);
+          m_gds->jacobianFunction (ttime, state, dstate_dt, &jacYp, 1.0, mode);
+          for (index_t kk = 0; kk < jacY.size (); ++kk)
+            {
+              jacYp.assign (jacY.rowIndex (kk), jacY.colIndex (kk), -jacY.val (kk));
+            }
+          jacYp.compact ();
+          holdJacobian ();
+        }
+      a1.clear ();
+      a1.merge (&jacY);
+      for (index_t kk = 0; kk < jacYp.size (); ++kk)
+        {
+          a1.assign (jacYp.rowIndex (kk), jacYp.colIndex (kk), cj * jacYp.val (kk));
+        }
+    }
+  if (useMask)
+    {
+      for (auto &v : maskElements)
+        {
+          a1.translateRow (v, kNullLocation);
+          a1.assign (v, v, maskValue);
+        }
+      a1.filter ();
+    }
+}
+
 #define CHECK_JACOBIAN 0
 int idaJacDense (long int Neq, realtype ttime, realtype cj, N_Vector state, N_Vector dstate_dt, N_Vector /*resid*/, DlsMat J, void *user_data, N_Vector /*tmp1*/, N_Vector /*tmp2*/, N_Vector /*tmp3*/)
 {
@@ -720,18 +832,7 @@ int idaJacDense (long int Neq, realtype ttime, realtype cj, N_Vector state, N_Ve
   assert (Neq == static_cast<int> (sd->svsize));
   _unused(Neq);
   arrayDataSparse *a1 = &(sd->a1);
-  sd->m_gds->jacobianFunction (ttime, NVECTOR_DATA(sd->use_omp, state), NVECTOR_DATA(sd->use_omp, dstate_dt), a1,cj, sd->mode);
-
-
-  if (sd->useMask)
-    {
-      for (auto &v : sd->maskElements)
-        {
-          a1->translateRow (v,kNullLocation);
-          a1->assign (v,v,100);
-        }
-      a1->filter ();
-    }
+  sd->loadJacobian (ttime, NVECTOR_DATA(sd->use_omp, state), NVECTOR_DATA(sd->use_omp, dstate_dt), cj, 100);
 
   //assign the elements
   for (kk = 0; kk < a1->size (); ++kk)
@@ -759,19 +860,8 @@ int idaJacSparse (realtype ttime, realtype cj, N_Vector state, N_Vector dstate_d
   idaInterface *sd = reinterpret_cast<idaInterface *> (user_data);
 
   arrayDataSparse *a1 = &(sd->a1);
-
-  sd->m_gds->jacobianFunction (ttime, NVECTOR_DATA(sd->use_omp, state), NVECTOR_DATA(sd->use_omp, dstate_dt), a1,cj, sd->mode);
+  sd->loadJacobian (ttime, NVECTOR_DATA(sd->use_omp, state), NVECTOR_DATA(sd->use_omp, dstate_dt), cj, 1);
   a1->sortIndexCol ();
-  if (sd->useMask)
-    {
-      for (auto &v : sd->maskElements)
-        {
-          a1->translateRow (v,kNullLocation);
-          a1->assign (v, v,1);
-        }
-      a1->filter ();
-      a1->sortIndexCol ();
-    }
   a1->compact ();
 
   SlsSetToZero (J);
@@ -804,3 +894,24 @@ int idaJacSparse (realtype ttime, realtype cj, N_Vector state, N_Vector dstate_d
   return 0;
 }
 #endif
+
+int idaPrecSetup (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector /*resid*/, realtype cj, void *user_data, N_Vector, N_Vector, N_Vector)
+{
+  idaInterface *sd = reinterpret_cast<idaInterface *> (user_data);
+  arrayDataSparse *a1 = &(sd->a1);
+  sd->loadJacobian (ttime, NVECTOR_DATA (sd->use_omp, state), NVECTOR_DATA (sd->use_omp, dstate_dt), cj, 1);
+  ++sd->jacCallCount;
+  //a positive return tells IDA the failure is recoverable
+  if (sd->mpSolver->factor (*a1, sd->svsize) != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return 1;
+    }
+  return 0;
+}
+
+int idaPrecSolve (realtype /*ttime*/, N_Vector /*state*/, N_Vector /*dstate_dt*/, N_Vector /*resid*/, N_Vector rvec, N_Vector zvec, realtype /*cj*/, realtype /*delta*/, void *user_data, N_Vector /*tmp*/)
+{
+  idaInterface *sd = reinterpret_cast<idaInterface *> (user_data);
+  int ret = sd->mpSolver->solve (NVECTOR_DATA (sd->use_omp, rvec), NVECTOR_DATA (sd->use_omp, zvec));
+  return (ret == FUNCTION_EXECUTION_SUCCESS) ? 0 : 1;
+}
@@ -16,12 +16,14 @@
 #include "gridDyn.h"
 #include "simulation/gridDynSimulationFileOps.h"
 #include "sundialsArrayData.h"
+#include "sparseLU.h"
 //#include "arrayDataBoost.h"
 #include "arrayDataSparseSM.h"
 #include "core/helperTemplates.h"
 #include <sundials/sundials_math.h>
 #include <kinsol/kinsol.h>
 #include <kinsol/kinsol_dense.h>
+#include <kinsol/kinsol_spgmr.h>
 
 #ifdef KLU_ENABLE
 #include <kinsol/kinsol_klu.h>
@@ -44,6 +46,8 @@ int kinsolJacDense (long int N, N_Vector u, N_Vector f, DlsMat J, void *user_dat
 #ifdef KLU_ENABLE
 int kinsolJacSparse (N_Vector u, N_Vector f, SlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2);
 #endif
+int kinsolPrecSetup (N_Vector u, N_Vector uscale, N_Vector f, N_Vector fscale, void *user_data, N_Vector tmp1, N_Vector tmp2);
+int kinsolPrecSolve (N_Vector u, N_Vector uscale, N_Vector f, N_Vector fscale, N_Vector v, void *user_data, N_Vector tmp);
 //int kinsolAlgFunc (N_Vector u, N_Vector f, void *user_data);
 //int kinsolAlgJacDense (long int N, N_Vector u, N_Vector f, DlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2);
 
@@ -131,6 +135,12 @@ void kinsolInterface::logSolverStats (int logLevel, bool /*iconly*/) const
       flag = KINDlsGetNumFuncEvals (solverMem, &nfeD);
       check_flag (&flag, "KINDlsGetNumFuncEvals", 1);
     }
+  else if (mixedPrecision)
+    {
+      flag = KINSpilsGetNumPrecEvals (solverMem, &nje);
+      check_flag (&flag, "KINSpilsGetNumPrecEvals", 1);
+      nfeD = -1;
+    }
 #ifdef KLU_ENABLE
   else
     {
@@ -283,9 +293,30 @@ int kinsolInterface::initialize (double /*t0*/)
       return FUNCTION_EXECUTION_FAILURE;
     }
 
-#ifdef KLU_ENABLE
   jacCallCount = 0;
-  if (dense)
+  if ((mixedPrecision) && (!dense))
+    {
+      if (!mpSolver)
+        {
+          mpSolver.reset (new mixedPrecisionSolver ());
+        }
+      mpSolver->reset ();
+      //start from the stored pattern and analysis of the mode if the simulation has one
+      mpSolver->setPattern (m_gds->getJacobianPattern (mode));
+      retval = KINSpgmr (solverMem, 5);
+      if (check_flag (&retval, "KINSpgmr", 1))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+
+      retval = KINSpilsSetPreconditioner (solverMem, kinsolPrecSetup, kinsolPrecSolve);
+      if (check_flag (&retval, "KINSpilsSetPreconditioner", 1))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+#ifdef KLU_ENABLE
+  else if (dense)
     {
       retval = KINDense (solverMem, svsize);
       if (check_flag (&retval, "KINDense", 1))
@@ -320,20 +351,23 @@ int kinsolInterface::initialize (double /*t0*/)
         }
     }
 #else
-  retval = KINDense (solverMem, svsize);
-  if (check_flag (&retval, "KINDense", 1))
+  else
     {
-      return FUNCTION_EXECUTION_FAILURE;
-    }
+      retval = KINDense (solverMem, svsize);
+      if (check_flag (&retval, "KINDense", 1))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
 
-  retval = KINDlsSetDenseJacFn (solverMem, kinsolJacDense);
-  if (check_flag (&retval, "KINDlsSetDenseJacFn", 1))
-    {
-      return FUNCTION_EXECUTION_FAILURE;
+      retval = KINDlsSetDenseJacFn (solverMem, kinsolJacDense);
+      if (check_flag (&retval, "KINDlsSetDenseJacFn", 1))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
     }
 #endif
 
-  retval = KINSetMaxSetupCalls (solverMem, 1);         // exact Newton
+  retval = KINSetMaxSetupCalls (solverMem, maxSetupCalls);         // exact Newton by default
   if (check_flag (&retval, "KINSetMaxSetupCalls", 1))
     {
       return FUNCTION_EXECUTION_FAILURE;
@@ -368,6 +402,11 @@ int kinsolInterface::sparseReInit (sparse_reinit_modes sparseReinitMode)
 #ifdef KLU_ENABLE
   int retval;
   jacCallCount = 0;
+  //the mixed precision solver reanalyzes automatically when the pattern changes
+  if ((mixedPrecision) && (!dense))
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
   int kinmode = (sparseReinitMode == sparse_reinit_modes::refactor) ? 1 : 2;
   retval = KINKLUReInit (solverMem, static_cast<int> (svsize), maxNNZ, kinmode);
   if (check_flag (&retval, "KINKLUReInit", 1))
@@ -409,6 +448,18 @@ int kinsolInterface::set(const std::string &param, double val)
 	{
 		fileCapture = (val >= 0.1);
 	}
+	else if (param == "maxsetupcalls")
+	{
+		if (val < 1.0)
+		{
+			return INVALID_PARAMETER_VALUE;
+		}
+		maxSetupCalls = static_cast<long int> (val);
+		if (initialized)
+		{
+			KINSetMaxSetupCalls(solverMem, maxSetupCalls);
+		}
+	}
 	else
 	{
 		out = solverInterface::set(param, val);
@@ -426,6 +477,10 @@ double kinsolInterface::get (const std::string &param) const
         {
           KINDlsGetNumJacEvals (solverMem, &val);
         }
+      else if (mixedPrecision)
+        {
+          KINSpilsGetNumPrecEvals (solverMem, &val);
+        }
       else
         {
 #ifdef KLU_ENABLE
@@ -575,7 +630,20 @@ int kinsolJacSparse (N_Vector u, N_Vector /*f*/, SlsMat J, void *user_data, N_Ve
 #if MEASURE_TIMINGS > 0
   auto start_t = std::chrono::high_resolution_clock::now ();
 #endif
-  if ((sd->jacCallCount == 0)||(!isSlsMatSetup (J)))
+  bool structured = ((sd->jacCallCount > 0) && (isSlsMatSetup (J)));
+  if (!structured)
+    {
+      //a stored pattern for the mode gives the matrix structure without a discovery pass
+      auto pat = sd->m_gds->getJacobianPattern (sd->mode);
+      if ((pat) && (pat->n == sd->svsize) && (pat->nonZeros () <= sd->maxNNZ))
+        {
+          std::copy (pat->colStart.begin (), pat->colStart.end (), J->colptrs);
+          std::copy (pat->rows.begin (), pat->rows.end (), J->rowvals);
+          sd->nnz = pat->nonZeros ();
+          structured = true;
+        }
+    }
+  if (!structured)
     {
       std::unique_ptr<arrayData<double>> a1;
       if (sd->svsize < 65535)
@@ -653,3 +721,32 @@ int kinsolJacSparse (N_Vector u, N_Vector /*f*/, SlsMat J, void *user_data, N_Ve
 }
 
 #endif
+
+int kinsolPrecSetup (N_Vector u, N_Vector /*uscale*/, N_Vector /*f*/, N_Vector /*fscale*/, void *user_data, N_Vector /*tmp1*/, N_Vector /*tmp2*/)
+{
+  kinsolInterface *sd = reinterpret_cast<kinsolInterface *> (user_data);
+  arrayDataSparse *a1 = &(sd->a1);
+  a1->setRowLimit (sd->svsize);
+  a1->setColLimit (sd->svsize);
+  sd->m_gds->jacobianFunction (sd->solveTime, NVECTOR_DATA (sd->use_omp, u), nullptr, a1, 0, sd->mode);
+  sd->jacCallCount++;
+  sd->nnz = a1->size ();
+  if (sd->fileCapture)
+    {
+      if (!sd->jacFile.empty ())
+        {
+          long int val = 0;
+          KINGetNumNonlinSolvIters (sd->solverMem, &val);
+          writeArray (sd->solveTime, 1, val, sd->mode.offsetIndex, a1, sd->jacFile);
+        }
+    }
+  //a positive return tells kinsol the failure is recoverable
+  return (sd->mpSolver->factor (*a1, sd->svsize) == FUNCTION_EXECUTION_SUCCESS) ? 0 : 1;
+}
+
+int kinsolPrecSolve (N_Vector /*u*/, N_Vector /*uscale*/, N_Vector /*f*/, N_Vector /*fscale*/, N_Vector v, void *user_data, N_Vector /*tmp*/)
+{
+  kinsolInterface *sd = reinterpret_cast<kinsolInterface *> (user_data);
+  double *vd = NVECTOR_DATA (sd->use_omp, v);
+  return (sd->mpSolver->solve (vd, vd) == FUNCTION_EXECUTION_SUCCESS) ? 0 : 1;
+}
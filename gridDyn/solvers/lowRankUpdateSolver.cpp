@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "lowRankUpdateSolver.h"
+#include "basicDefs.h"
+
+#include <cmath>
+
+static double maxNorm (const double vec[], count_t size)
+{
+  double nrm = 0.0;
+  for (index_t kk = 0; kk < size; ++kk)
+    {
+      nrm = (std::max)(nrm, std::abs (vec[kk]));
+    }
+  return nrm;
+}
+
+int lowRankUpdateSolver::setBase (const arrayData<double> &ad, count_t size)
+{
+  baseMatrix.load (ad, size);
+  resid.resize (size);
+  rhs.resize (size);
+  updRows.clear ();
+  updCols.clear ();
+  mode = update_mode::base;
+  ++stats.baseFactorizations;
+  return baseLU.factor (baseMatrix);
+}
+
+void lowRankUpdateSolver::clearUpdate ()
+{
+  updRows.clear ();
+  updCols.clear ();
+  mode = update_mode::base;
+}
+
+void lowRankUpdateSolver::refactor ()
+{
+  ++stats.refactorizations;
+  if (fullLU.factor (current) == FUNCTION_EXECUTION_SUCCESS)
+    {
+      mode = update_mode::refactored;
+    }
+  else
+    {
+      mode = update_mode::singular;
+      ++stats.singularUpdates;
+    }
+}
+
+lowRankUpdateSolver::update_mode lowRankUpdateSolver::update (const arrayData<double> &ad, count_t size)
+{
+  ++stats.updates;
+  updRows.clear ();
+  updCols.clear ();
+  current.load (ad, size);
+  if ((size != baseMatrix.n) || (!baseLU.isFactored ()))
+    {
+      resid.resize (size);
+      rhs.resize (size);
+      refactor ();
+      return mode;
+    }
+  //walk the base and updated columns together to find the changed entries
+  std::vector<index_t> dRows;
+  std::vector<index_t> dCols;
+  std::vector<double> dVals;
+  for (index_t col = 0; col < size; ++col)
+    {
+      auto pb = baseMatrix.colStart[col];
+      auto pbEnd = baseMatrix.colStart[col + 1];
+      auto pc = current.colStart[col];
+      auto pcEnd = current.colStart[col + 1];
+      while ((pb < pbEnd) || (pc < pcEnd))
+        {
+          auto rb = (pb < pbEnd) ? baseMatrix.rows[pb] : kNullLocation;
+          auto rc = (pc < pcEnd) ? current.rows[pc] : kNullLocation;
+          double delta;
+          double scale;
+          index_t row;
+          if (rb == rc)
+            {
+              delta = current.vals[pc] - baseMatrix.vals[pb];
+              scale = (std::max)(std::abs (current.vals[pc]), std::abs (baseMatrix.vals[pb]));
+              row = rb;
+              ++pb;
+              ++pc;
+            }
+          else if (rb < rc)
+            {
+              delta = -baseMatrix.vals[pb];
+              scale = std::abs (delta);
+              row = rb;
+              ++pb;
+            }
+          else
+            {
+              delta = current.vals[pc];
+              scale = std::abs (delta);
+              row = rc;
+              ++pc;
+            }
+          //ignore changes at the level of rounding in the Jacobian evaluation
+          if (std::abs (delta) > 1e-14 * scale)
+            {
+              dRows.push_back (row);
+              dCols.push_back (col);
+              dVals.push_back (delta);
+              if ((updCols.empty ()) || (updCols.back () != col))
+                {
+                  updCols.push_back (col);
+                }
+            }
+        }
+    }
+  if (dVals.empty ())
+    {
+      mode = update_mode::base;
+      return mode;
+    }
+  updRows = dRows;
+  std::sort (updRows.begin (), updRows.end ());
+  updRows.erase (std::unique (updRows.begin (), updRows.end ()), updRows.end ());
+  if (rank () > maxRank)
+    {
+      refactor ();
+      return mode;
+    }
+  count_t kr = static_cast<count_t> (updRows.size ());
+  count_t kc = static_cast<count_t> (updCols.size ());
+  //D is the kr x kc matrix of changes stored by row
+  std::vector<double> D (kr * kc, 0.0);
+  for (size_t kk = 0; kk < dVals.size (); ++kk)
+    {
+      auto ri = std::lower_bound (updRows.begin (), updRows.end (), dRows[kk]) - updRows.begin ();
+      auto ci = std::lower_bound (updCols.begin (), updCols.end (), dCols[kk]) - updCols.begin ();
+      D[ri * kc + ci] += dVals[kk];
+    }
+  //WD=A^-1*E_r*D takes one solve with the base factors per changed row
+  WD.assign (size * kc, 0.0);
+  std::vector<double> col (size);
+  for (index_t ri = 0; ri < kr; ++ri)
+    {
+      std::fill (col.begin (), col.end (), 0.0);
+      col[updRows[ri]] = 1.0;
+      baseLU.solve (col.data ());
+      for (index_t ci = 0; ci < kc; ++ci)
+        {
+          double dv = D[ri * kc + ci];
+          if (dv == 0.0)
+            {
+              continue;
+            }
+          auto wdCol = WD.data () + ci * size;
+          for (index_t kk = 0; kk < size; ++kk)
+            {
+              wdCol[kk] += col[kk] * dv;
+            }
+        }
+    }
+  capLU.resize (kc * kc);
+  for (index_t aa = 0; aa < kc; ++aa)
+    {
+      for (index_t bb = 0; bb < kc; ++bb)
+        {
+          capLU[aa * kc + bb] = ((aa == bb) ? 1.0 : 0.0) + WD[bb * size + updCols[aa]];
+        }
+    }
+  if (factorCapacitance () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      mode = update_mode::singular;
+      ++stats.singularUpdates;
+      return mode;
+    }
+  capWork.resize (kc);
+  mode = update_mode::low_rank;
+  ++stats.lowRankUpdates;
+  return mode;
+}
+
+int lowRankUpdateSolver::factorCapacitance ()
+{
+  count_t kc = static_cast<count_t> (updCols.size ());
+  capPiv.resize (kc);
+  double scale = 0.0;
+  for (auto &cv : capLU)
+    {
+      scale = (std::max)(scale, std::abs (cv));
+    }
+  for (index_t kk = 0; kk < kc; ++kk)
+    {
+      index_t prow = kk;
+      double pmax = std::abs (capLU[kk * kc + kk]);
+      for (index_t ii = kk + 1; ii < kc; ++ii)
+        {
+          if (std::abs (capLU[ii * kc + kk]) > pmax)
+            {
+              pmax = std::abs (capLU[ii * kc + kk]);
+              prow = ii;
+            }
+        }
+      if (pmax <= singularTol * scale)
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      capPiv[kk] = prow;
+      if (prow != kk)
+        {
+          std::swap_ranges (capLU.begin () + kk * kc, capLU.begin () + (kk + 1) * kc, capLU.begin () + prow * kc);
+        }
+      double piv = capLU[kk * kc + kk];
+      for (index_t ii = kk + 1; ii < kc; ++ii)
+        {
+          double mult = capLU[ii * kc + kk] / piv;
+          capLU[ii * kc + kk] = mult;
+          for (index_t jj = kk + 1; jj < kc; ++jj)
+            {
+              capLU[ii * kc + jj] -= mult * capLU[kk * kc + jj];
+            }
+        }
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void lowRankUpdateSolver::lowRankSolve (double x[])
+{
+  count_t n = baseMatrix.n;
+  count_t kc = static_cast<count_t> (updCols.size ());
+  baseLU.solve (x);
+  for (index_t aa = 0; aa < kc; ++aa)
+    {
+      capWork[aa] = x[updCols[aa]];
+    }
+  //solve the capacitance system with the stored factors
+  //the factorization swapped whole rows so all the swaps apply to the right hand side before the substitution
+  for (index_t kk = 0; kk < kc; ++kk)
+    {
+      std::swap (capWork[kk], capWork[capPiv[kk]]);
+    }
+  for (index_t kk = 0; kk < kc; ++kk)
+    {
+      for (index_t ii = kk + 1; ii < kc; ++ii)
+        {
+          capWork[ii] -= capLU[ii * kc + kk] * capWork[kk];
+        }
+    }
+  for (index_t kk = kc; kk > 0; --kk)
+    {
+      auto row = kk - 1;
+      double sum = capWork[row];
+      for (index_t jj = row + 1; jj < kc; ++jj)
+        {
+          sum -= capLU[row * kc + jj] * capWork[jj];
+        }
+      capWork[row] = sum / capLU[row * kc + row];
+    }
+  for (index_t bb = 0; bb < kc; ++bb)
+    {
+      auto wdCol = WD.data () + bb * n;
+      double tb = capWork[bb];
+      for (index_t kk = 0; kk < n; ++kk)
+        {
+          x[kk] -= wdCol[kk] * tb;
+        }
+    }
+}
+
+int lowRankUpdateSolver::solve (const double b[], double x[])
+{
+  ++stats.solves;
+  count_t n = (mode == update_mode::base) ? baseMatrix.n : current.n;
+  switch (mode)
+    {
+    case update_mode::singular:
+      return FUNCTION_EXECUTION_FAILURE;
+    case update_mode::base:
+      if (!baseLU.isFactored ())
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      if (x != b)
+        {
+          std::copy (b, b + n, x);
+        }
+      baseLU.solve (x);
+      return FUNCTION_EXECUTION_SUCCESS;
+    case update_mode::refactored:
+      if (x != b)
+        {
+          std::copy (b, b + n, x);
+        }
+      fullLU.solve (x);
+      return FUNCTION_EXECUTION_SUCCESS;
+    case update_mode::low_rank:
+    default:
+      break;
+    }
+  std::copy (b, b + n, rhs.begin ());
+  if (x != b)
+    {
+      std::copy (b, b + n, x);
+    }
+  lowRankSolve (x);
+  //check the solution against the updated matrix and refine once before giving up on the low rank correction
+  double bnorm = (std::max)(maxNorm (rhs.data (), n), 1e-300);
+  current.residual (rhs.data (), x, resid.data ());
+  if (maxNorm (resid.data (), n) <= accuracyTol * bnorm)
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  ++stats.refinementSteps;
+  lowRankSolve (resid.data ());
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      x[kk] += resid[kk];
+    }
+  current.residual (rhs.data (), x, resid.data ());
+  if (maxNorm (resid.data (), n) <= accuracyTol * bnorm)
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  ++stats.accuracyFallbacks;
+  refactor ();
+  if (mode != update_mode::refactored)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::copy (rhs.begin (), rhs.end (), x);
+  fullLU.solve (x);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
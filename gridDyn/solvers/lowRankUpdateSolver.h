@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_LOW_RANK_UPDATE_SOLVER_H_
+#define GRIDDYN_LOW_RANK_UPDATE_SOLVER_H_
+
+#include "sparseLU.h"
+
+#include <algorithm>
+
+/** @brief sparse linear solver for matrices that differ from a factored base matrix in a few rows and columns
+ the base matrix is factored once,  an updated matrix is compared against the base and the difference is written as
+E_r*D*E_c' where E_r and E_c select the rows and columns containing changes.  Solves with the updated matrix use the
+Sherman-Morrison-Woodbury formula so each solve costs one solve with the base factors plus a small dense solve.
+If the number of changed rows or columns exceeds the maximum rank, or a solve does not reach the accuracy tolerance after
+a refinement step, the updated matrix is factored directly.  A singular capacitance matrix indicates the update made the
+matrix singular,  for a network Jacobian this usually means part of the network was islanded.
+*/
+class lowRankUpdateSolver
+{
+public:
+  /** @brief the way solves are performed for the current update*/
+  enum class update_mode
+  {
+    base,  //!< no update is active,  solves use the base factors
+    low_rank,  //!< solves use the base factors with a low rank correction
+    refactored,  //!< the updated matrix was factored directly
+    singular,  //!< the updated matrix is singular
+  };
+
+  /** @brief statistics on the factorizations and solves*/
+  class solveStats
+  {
+public:
+    count_t baseFactorizations = 0;  //!< the number of base matrix factorizations
+    count_t updates = 0;  //!< the number of updates
+    count_t lowRankUpdates = 0;  //!< the number of updates handled with a low rank correction
+    count_t refactorizations = 0;  //!< the number of updated matrices factored directly
+    count_t singularUpdates = 0;  //!< the number of updates producing a singular matrix
+    count_t solves = 0;  //!< the number of solves
+    count_t refinementSteps = 0;  //!< the number of refinement steps
+    count_t accuracyFallbacks = 0;  //!< the number of updates refactored because a solve was inaccurate
+  };
+
+  /** @brief factor the base matrix and clear any update
+  @param[in] ad the matrix entries,  duplicates are summed
+  @param[in] size the matrix dimension
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the base matrix is singular
+  */
+  int setBase (const arrayData<double> &ad, count_t size);
+  /** @brief set the updated matrix for the following solves
+  @param[in] ad the entries of the updated matrix,  duplicates are summed
+  @param[in] size the matrix dimension,  a size different from the base forces a direct factorization
+  @return the mode used for the following solves
+  */
+  update_mode update (const arrayData<double> &ad, count_t size);
+  /** @brief remove the update so solves use the base matrix*/
+  void clearUpdate ();
+  /** @brief solve A*x=b with the current matrix
+  @param[in] b the right hand side
+  @param[out] x the solution, may be the same array as b
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the current matrix is singular or not factored
+  */
+  int solve (const double b[], double x[]);
+
+  update_mode getMode () const
+  {
+    return mode;
+  }
+  /** @brief get the rank of the current update, the larger of the changed row and column counts*/
+  count_t rank () const
+  {
+    return static_cast<count_t> ((std::max)(updRows.size (), updCols.size ()));
+  }
+  /** @brief set the rank above which an update is factored directly*/
+  void setMaxRank (count_t maxR)
+  {
+    maxRank = maxR;
+  }
+  /** @brief set the relative residual a low rank solve must reach before falling back to a direct factorization*/
+  void setAccuracyTolerance (double tol)
+  {
+    accuracyTol = tol;
+  }
+  /** @brief set the relative pivot size below which the capacitance matrix is considered singular*/
+  void setSingularTolerance (double tol)
+  {
+    singularTol = tol;
+  }
+  const solveStats &getStats () const
+  {
+    return stats;
+  }
+
+private:
+  cscMatrix<double> baseMatrix;  //!< the base matrix
+  cscMatrix<double> current;  //!< the updated matrix
+  sparseLU<double> baseLU;  //!< the factors of the base matrix
+  sparseLU<double> fullLU;  //!< the factors of the updated matrix when refactored
+  update_mode mode = update_mode::base;  //!< the current solve mode
+  count_t maxRank = 24;  //!< the maximum rank handled with a low rank correction
+  double accuracyTol = 1e-9;  //!< the relative residual tolerance of a low rank solve
+  double singularTol = 1e-12;  //!< relative pivot tolerance for the capacitance matrix
+  std::vector<index_t> updRows;  //!< the rows containing changes
+  std::vector<index_t> updCols;  //!< the columns containing changes
+  std::vector<double> WD;  //!< A^-1*E_r*D stored by column,  n x updCols.size()
+  std::vector<double> capLU;  //!< the LU factors of the capacitance matrix I+E_c'*A^-1*E_r*D stored by row
+  std::vector<index_t> capPiv;  //!< the row pivots of the capacitance factors
+  std::vector<double> resid;  //!< residual work vector
+  std::vector<double> rhs;  //!< copy of the right hand side
+  std::vector<double> capWork;  //!< work vector the size of the rank
+  solveStats stats;  //!< solver statistics
+
+  int factorCapacitance ();
+  void lowRankSolve (double x[]);
+  void refactor ();
+};
+
+#endif
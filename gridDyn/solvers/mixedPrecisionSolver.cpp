@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "mixedPrecisionSolver.h"
+#include "basicDefs.h"
+
+#include <algorithm>
+#include <cmath>
+
+static double maxNorm (const std::vector<double> &vec)
+{
+  double nrm = 0.0;
+  for (auto &v : vec)
+    {
+      nrm = (std::max)(nrm, std::abs (v));
+    }
+  return nrm;
+}
+
+void mixedPrecisionSolver::reset ()
+{
+  useDouble = false;
+  stallCount = 0;
+}
+
+void mixedPrecisionSolver::setPattern (std::shared_ptr<const sparsePattern> pat)
+{
+  pattern = pat;
+  if (pattern)
+    {
+      lowLU.setAnalysis (*pattern);
+      highLU.setAnalysis (*pattern);
+    }
+}
+
+int mixedPrecisionSolver::factorDouble ()
+{
+  useDouble = true;
+  ++stats.doubleFactorizations;
+  return highLU.factor (matrix);
+}
+
+int mixedPrecisionSolver::factor (const arrayData<double> &ad, count_t size)
+{
+  matrix.load (ad, size);
+  if ((pattern) && (!matrix.expandTo (*pattern)))
+    {
+      pattern = nullptr;
+    }
+  resid.resize (size);
+  rhs.resize (size);
+  lowWork.resize (size);
+  if (stalledThisMatrix)
+    {
+      ++stallCount;
+    }
+  else
+    {
+      stallCount = 0;
+    }
+  stalledThisMatrix = false;
+  if (stallCount >= stallLimit)
+    {
+      return factorDouble ();
+    }
+  useDouble = false;
+  ++stats.factorizations;
+  //a tiny pivot ratio means the single precision factors will not be accurate enough to refine
+  if ((lowLU.factor (matrix) != FUNCTION_EXECUTION_SUCCESS) || (lowLU.pivotRatio () < minPivotRatio))
+    {
+      stalledThisMatrix = true;
+      return factorDouble ();
+    }
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+int mixedPrecisionSolver::solve (const double b[], double x[])
+{
+  auto n = matrix.n;
+  ++stats.solves;
+  if (useDouble)
+    {
+      if (!highLU.isFactored ())
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      std::copy (b, b + n, resid.begin ());
+      highLU.solve (resid.data ());
+      std::copy (resid.begin (), resid.end (), x);
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  if (!lowLU.isFactored ())
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::copy (b, b + n, resid.begin ());
+  double bnorm = maxNorm (resid);
+  if (bnorm == 0.0)
+    {
+      std::fill (x, x + n, 0.0);
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  //the copy of b has to be made before x is overwritten since they may alias
+  rhs.assign (b, b + n);
+  std::fill (x, x + n, 0.0);
+  double lastNorm = bnorm;
+  bool converged = false;
+  for (count_t kk = 0; kk <= maxRefineSteps; ++kk)
+    {
+      std::transform (resid.begin (), resid.end (), lowWork.begin (), [](double v) {
+          return static_cast<float> (v);
+        });
+      lowLU.solve (lowWork.data ());
+      for (index_t ii = 0; ii < n; ++ii)
+        {
+          x[ii] += static_cast<double> (lowWork[ii]);
+        }
+      if (kk > 0)
+        {
+          ++stats.refinementSteps;
+        }
+      matrix.residual (rhs.data (), x, resid.data ());
+      double rnorm = maxNorm (resid);
+      if (rnorm <= refineTol * bnorm)
+        {
+          converged = true;
+          break;
+        }
+      //each step should reduce the residual by a large factor,  anything less is treated as a stall
+      if (rnorm > 0.5 * lastNorm)
+        {
+          break;
+        }
+      lastNorm = rnorm;
+    }
+  if (converged)
+    {
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  ++stats.fallbacks;
+  stalledThisMatrix = true;
+  if (factorDouble () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  std::copy (rhs.begin (), rhs.end (), x);
+  highLU.solve (x);
+  return FUNCTION_EXECUTION_SUCCESS;
+}
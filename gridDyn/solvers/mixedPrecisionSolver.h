@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_MIXED_PRECISION_SOLVER_H_
+#define GRIDDYN_MIXED_PRECISION_SOLVER_H_
+
+#include "sparseLU.h"
+
+#include <memory>
+
+/** @brief sparse linear solver with single precision factors and double precision iterative refinement
+ the Jacobian is kept in double precision and factored in single precision,  each solve applies the single precision
+factors and then refines the solution against the double precision matrix until the relative residual is below the
+refinement tolerance.  If the refinement stalls or does not converge the matrix is refactored in double precision and the
+solve is completed with the double precision factors.  After repeated fallbacks the solver stays in double precision
+until the next call to reset.
+*/
+class mixedPrecisionSolver
+{
+public:
+  /** @brief statistics on the factorizations and solves*/
+  class solveStats
+  {
+public:
+    count_t factorizations = 0;  //!< the number of single precision factorizations
+    count_t doubleFactorizations = 0;  //!< the number of double precision factorizations
+    count_t solves = 0;  //!< the number of solves
+    count_t refinementSteps = 0;  //!< the total number of refinement steps
+    count_t fallbacks = 0;  //!< the number of solves completed in double precision after refinement stalled
+  };
+
+  /** @brief factor a matrix
+  @param[in] ad the matrix entries,  duplicates are summed
+  @param[in] size the matrix dimension
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the matrix is singular in double precision
+  */
+  int factor (const arrayData<double> &ad, count_t size);
+  /** @brief solve A*x=b
+  @param[in] b the right hand side
+  @param[out] x the solution, may be the same array as b
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if no valid factorization exists
+  */
+  int solve (const double b[], double x[]);
+  /** @brief compute y=A*x with the double precision matrix*/
+  void multiply (const double x[], double y[]) const
+  {
+    matrix.multiply (x, y);
+  }
+  /** @brief set the relative residual at which refinement stops*/
+  void setRefinementTolerance (double tol)
+  {
+    refineTol = tol;
+  }
+  /** @brief set the maximum number of refinement steps in a solve*/
+  void setMaxRefinementSteps (count_t steps)
+  {
+    maxRefineSteps = steps;
+  }
+  /** @brief use a prebuilt pattern and analysis for the following matrices
+   a matrix whose entries fit in the pattern is stored in it with explicit zeros so the analysis is reused,  a matrix with
+  entries outside the pattern drops it and is analyzed on its own
+  */
+  void setPattern (std::shared_ptr<const sparsePattern> pat);
+  /** @brief check if a prebuilt pattern is in use*/
+  bool hasPattern () const
+  {
+    return static_cast<bool> (pattern);
+  }
+  /** @brief clear the fallback history so the next factorization is attempted in single precision*/
+  void reset ();
+  /** @brief check if the solver is currently using double precision factors*/
+  bool usingDouble () const
+  {
+    return useDouble;
+  }
+  const solveStats &getStats () const
+  {
+    return stats;
+  }
+  /** @brief get the double precision matrix*/
+  const cscMatrix<double> &getMatrix () const
+  {
+    return matrix;
+  }
+
+private:
+  cscMatrix<double> matrix;  //!< the double precision matrix
+  sparseLU<float> lowLU;  //!< the single precision factors
+  sparseLU<double> highLU;  //!< the double precision factors used on fallback
+  std::shared_ptr<const sparsePattern> pattern;  //!< the prebuilt pattern
+  bool useDouble = false;  //!< the current matrix is factored in double precision
+  count_t stallCount = 0;  //!< the number of consecutive factorizations needing a fallback
+  count_t stallLimit = 3;  //!< the number of consecutive fallbacks before staying in double precision
+  double refineTol = 1e-12;  //!< the relative residual tolerance
+  count_t maxRefineSteps = 6;  //!< the maximum number of refinement steps
+  double minPivotRatio = 1e-6;  //!< pivot ratios below this skip the single precision factors
+  bool stalledThisMatrix = false;  //!< a fallback has occurred for the current matrix
+  std::vector<double> resid;  //!< residual work vector
+  std::vector<double> rhs;  //!< copy of the right hand side
+  std::vector<float> lowWork;  //!< single precision work vector
+  solveStats stats;  //!< solver statistics
+
+  int factorDouble ();
+};
+
+#endif
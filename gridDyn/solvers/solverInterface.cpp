@@ -53,6 +53,7 @@ std::shared_ptr<solverInterface> solverInterface::clone(std::shared_ptr<solverIn
 	si->parallel = parallel;
 	si->locked = locked;
 	si->use_omp = use_omp;
+	si->mixedPrecision = mixedPrecision;
 
 	if (fullCopy)
 	{
@@ -318,6 +319,14 @@ int solverInterface::set (const std::string &param, const std::string &val)
             {
               constantJacobian = true;
             }
+          else if (str == "mixedprecision")
+            {
+              mixedPrecision = true;
+            }
+          else if (str == "doubleprecision")
+            {
+              mixedPrecision = false;
+            }
           else if (str == "mask")
             {
               useMask = true;
@@ -478,6 +487,10 @@ int solverInterface::set (const std::string &param, double val)
     {
       constantJacobian = (val > 0);
     }
+  else if (pstr == "mixedprecision")
+    {
+      mixedPrecision = (val > 0);
+    }
   else if (pstr == "mask")
     {
       useMask = (val > 0);
@@ -77,11 +77,12 @@ protected:
   solverMode mode;                                                        //!< to the solverMode
   double tolerance = 1e-8;												//!<the default solver tolerance
   bool dense = false;													//!< if the solver should use a dense or sparse version
-  bool constantJacobian = false;										//!< if the solver should just keep a constant Jacobian
+  bool constantJacobian = false;										//!< if the solver should hold the model Jacobian while the iterations converge and only rescale it for a new step coefficient
   bool useMask = false;                                                                         //!< if the solver should use a mask to filter out specific states
   bool parallel = false;                                                                        //!< if the solver should use a parallel version
   bool locked = false;                                                                          //!< if the solverMode is locked from further updates
   bool use_omp = false;                                     //!<flag indicating whether to use omp data contructs
+  bool mixedPrecision = false;                              //!< flag indicating the sparse factorization should use single precision with iterative refinement
 
   bool allocated = false;                                                                       //!< if the solver has been allocated
   bool initialized = false;                                                 //!< flag indicating if these vectors have been initialized
@@ -406,6 +407,8 @@ public:
 	const double * type_data() const override;
 	int allocate(count_t size, count_t numroots = 0) override;
 	int initialize(double t0) override;
+	/** @brief restart the integration at a time from the current states,  only the fixed_diff mode is supported*/
+	int calcIC(double t0, double tstep0, ic_modes initCondMode, bool constraints) override;
 
 	virtual double get(const std::string & param) const override;
 	virtual int set(const std::string &param, const std::string &val) override;
@@ -0,0 +1,512 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "sparseLU.h"
+#include "arrayData.h"
+#include "basicDefs.h"
+
+#ifdef KLU_ENABLE
+#include <amd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numeric>
+
+template <class T>
+void cscMatrix<T>::load (const arrayData<double> &ad, count_t size)
+{
+  n = size;
+  colStart.assign (n + 1, 0);
+  count_t cnt = ad.size ();
+  for (index_t kk = 0; kk < cnt; ++kk)
+    {
+      if ((ad.colIndex (kk) < n) && (ad.rowIndex (kk) < n))
+        {
+          ++colStart[ad.colIndex (kk) + 1];
+        }
+    }
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      colStart[kk + 1] += colStart[kk];
+    }
+  std::vector<index_t> next (colStart.begin (), colStart.end () - 1);
+  std::vector<index_t> tRows (colStart[n]);
+  std::vector<T> tVals (colStart[n]);
+  for (index_t kk = 0; kk < cnt; ++kk)
+    {
+      auto col = ad.colIndex (kk);
+      auto row = ad.rowIndex (kk);
+      if ((col < n) && (row < n))
+        {
+          tRows[next[col]] = row;
+          tVals[next[col]] = static_cast<T> (ad.val (kk));
+          ++next[col];
+        }
+    }
+  compress (tRows, tVals);
+}
+
+template <class T>
+void cscMatrix<T>::loadTriplets (const std::vector<index_t> &rowInd, const std::vector<index_t> &colInd, const std::vector<T> &values, count_t size)
+{
+  n = size;
+  colStart.assign (n + 1, 0);
+  count_t cnt = static_cast<count_t> (values.size ());
+  for (index_t kk = 0; kk < cnt; ++kk)
+    {
+      if ((colInd[kk] < n) && (rowInd[kk] < n))
+        {
+          ++colStart[colInd[kk] + 1];
+        }
+    }
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      colStart[kk + 1] += colStart[kk];
+    }
+  std::vector<index_t> next (colStart.begin (), colStart.end () - 1);
+  std::vector<index_t> tRows (colStart[n]);
+  std::vector<T> tVals (colStart[n]);
+  for (index_t kk = 0; kk < cnt; ++kk)
+    {
+      auto col = colInd[kk];
+      if ((col < n) && (rowInd[kk] < n))
+        {
+          tRows[next[col]] = rowInd[kk];
+          tVals[next[col]] = values[kk];
+          ++next[col];
+        }
+    }
+  compress (tRows, tVals);
+}
+
+template <class T>
+void cscMatrix<T>::compress (const std::vector<index_t> &tRows, const std::vector<T> &tVals)
+{
+  //sort each column by row and sum the duplicates
+  rows.clear ();
+  vals.clear ();
+  rows.reserve (tRows.size ());
+  vals.reserve (tRows.size ());
+  std::vector<index_t> order;
+  for (index_t col = 0; col < n; ++col)
+    {
+      auto start = colStart[col];
+      auto stop = colStart[col + 1];
+      colStart[col] = static_cast<index_t> (rows.size ());
+      order.resize (stop - start);
+      std::iota (order.begin (), order.end (), start);
+      std::sort (order.begin (), order.end (), [&tRows](index_t a, index_t b) {
+          return (tRows[a] < tRows[b]);
+        });
+      for (auto ind : order)
+        {
+          if ((rows.size () > colStart[col]) && (rows.back () == tRows[ind]))
+            {
+              vals.back () += tVals[ind];
+            }
+          else
+            {
+              rows.push_back (tRows[ind]);
+              vals.push_back (tVals[ind]);
+            }
+        }
+    }
+  colStart[n] = static_cast<index_t> (rows.size ());
+}
+
+template <class T>
+bool cscMatrix<T>::expandTo (const sparsePattern &pattern)
+{
+  if (pattern.n != n)
+    {
+      return false;
+    }
+  if ((colStart == pattern.colStart) && (rows == pattern.rows))
+    {
+      return true;
+    }
+  std::vector<T> nvals (pattern.rows.size (), T (0));
+  for (index_t col = 0; col < n; ++col)
+    {
+      auto pp = pattern.colStart[col];
+      auto pend = pattern.colStart[col + 1];
+      for (auto kk = colStart[col]; kk < colStart[col + 1]; ++kk)
+        {
+          while ((pp < pend) && (pattern.rows[pp] < rows[kk]))
+            {
+              ++pp;
+            }
+          if ((pp == pend) || (pattern.rows[pp] != rows[kk]))
+            {
+              return false;
+            }
+          nvals[pp] = vals[kk];
+        }
+    }
+  colStart = pattern.colStart;
+  rows = pattern.rows;
+  vals.swap (nvals);
+  return true;
+}
+
+template <class T>
+void cscMatrix<T>::multiply (const T x[], T y[]) const
+{
+  std::fill (y, y + n, T (0));
+  for (index_t col = 0; col < n; ++col)
+    {
+      for (index_t pp = colStart[col]; pp < colStart[col + 1]; ++pp)
+        {
+          y[rows[pp]] += vals[pp] * x[col];
+        }
+    }
+}
+
+template <class T>
+void cscMatrix<T>::residual (const T b[], const T x[], T r[]) const
+{
+  std::copy (b, b + n, r);
+  for (index_t col = 0; col < n; ++col)
+    {
+      for (index_t pp = colStart[col]; pp < colStart[col + 1]; ++pp)
+        {
+          r[rows[pp]] -= vals[pp] * x[col];
+        }
+    }
+}
+
+template <class T>
+void sparseLU<T>::clear ()
+{
+  n = 0;
+  factored = false;
+  patternStart.clear ();
+  patternRows.clear ();
+  colPerm.clear ();
+}
+
+void sparsePattern::order ()
+{
+  colPerm.resize (n);
+  std::iota (colPerm.begin (), colPerm.end (), 0);
+#ifdef KLU_ENABLE
+  if (n > 0)
+    {
+      std::vector<int> Ap (colStart.begin (), colStart.end ());
+      std::vector<int> Ai (rows.begin (), rows.end ());
+      std::vector<int> perm (n);
+      if (amd_order (static_cast<int> (n), Ap.data (), Ai.data (), perm.data (), nullptr, nullptr) >= AMD_OK)
+        {
+          std::copy (perm.begin (), perm.end (), colPerm.begin ());
+        }
+    }
+#endif
+}
+
+template <class T>
+template <class X>
+void sparseLU<T>::analyze (const cscMatrix<X> &mat)
+{
+  sparsePattern pattern;
+  pattern.n = mat.n;
+  pattern.colStart = mat.colStart;
+  pattern.rows = mat.rows;
+  pattern.order ();
+  setAnalysis (pattern);
+}
+
+template <class T>
+void sparseLU<T>::setAnalysis (const sparsePattern &pattern)
+{
+  n = pattern.n;
+  factored = false;
+  patternStart = pattern.colStart;
+  patternRows = pattern.rows;
+  colPerm = pattern.colPerm;
+  if (colPerm.size () != n)
+    {
+      colPerm.resize (n);
+      std::iota (colPerm.begin (), colPerm.end (), 0);
+    }
+  allocateWork ();
+}
+
+template <class T>
+void sparseLU<T>::allocateWork ()
+{
+  pinv.resize (n);
+  work.assign (n, T (0));
+  solveWork.resize (n);
+  reach.resize (n);
+  stack.resize (n);
+  pstack.resize (n);
+  mark.assign (n, 0);
+  markValue = 0;
+}
+
+template <class T>
+void sparseLU<T>::depthFirst (index_t j, index_t &top)
+{
+  index_t head = 0;
+  stack[0] = j;
+  while (true)
+    {
+      j = stack[head];
+      index_t jcol = pinv[j];
+      if (mark[j] != markValue)
+        {
+          mark[j] = markValue;
+          pstack[head] = (jcol == kNullLocation) ? 0 : Lp[jcol] + 1;
+        }
+      bool done = true;
+      index_t pend = (jcol == kNullLocation) ? 0 : Lp[jcol + 1];
+      for (index_t pp = pstack[head]; pp < pend; ++pp)
+        {
+          auto ii = Li[pp];
+          if (mark[ii] == markValue)
+            {
+              continue;
+            }
+          pstack[head] = pp + 1;
+          stack[++head] = ii;
+          done = false;
+          break;
+        }
+      if (done)
+        {
+          reach[--top] = j;
+          if (head == 0)
+            {
+              break;
+            }
+          --head;
+        }
+    }
+}
+
+template <class T>
+index_t sparseLU<T>::computeReach (const std::vector<index_t> &colStarts, const std::vector<index_t> &colRows, index_t col)
+{
+  ++markValue;
+  if (markValue == 0)
+    {
+      std::fill (mark.begin (), mark.end (), 0);
+      markValue = 1;
+    }
+  index_t top = n;
+  for (index_t pp = colStarts[col]; pp < colStarts[col + 1]; ++pp)
+    {
+      if (mark[colRows[pp]] != markValue)
+        {
+          depthFirst (colRows[pp], top);
+        }
+    }
+  return top;
+}
+
+template <class T>
+template <class X>
+int sparseLU<T>::factor (const cscMatrix<X> &mat)
+{
+  if ((mat.n != n) || (mat.colStart != patternStart) || (mat.rows != patternRows))
+    {
+      analyze (mat);
+    }
+  factored = false;
+  std::fill (pinv.begin (), pinv.end (), kNullLocation);
+  Lp.assign (n + 1, 0);
+  Up.assign (n + 1, 0);
+  Li.clear ();
+  Lx.clear ();
+  Ui.clear ();
+  Ux.clear ();
+  Li.reserve (2 * mat.nonZeros () + n);
+  Lx.reserve (2 * mat.nonZeros () + n);
+  Ui.reserve (2 * mat.nonZeros () + n);
+  Ux.reserve (2 * mat.nonZeros () + n);
+  double minPivot = 0.0;
+  double maxPivot = 0.0;
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      Lp[kk] = static_cast<index_t> (Li.size ());
+      Up[kk] = static_cast<index_t> (Ui.size ());
+      auto col = colPerm[kk];
+      //sparse triangular solve x=L\A(:,col) over the reach of the column
+      auto top = computeReach (mat.colStart, mat.rows, col);
+      for (index_t pp = top; pp < n; ++pp)
+        {
+          work[reach[pp]] = T (0);
+        }
+      for (index_t pp = mat.colStart[col]; pp < mat.colStart[col + 1]; ++pp)
+        {
+          work[mat.rows[pp]] = static_cast<T> (mat.vals[pp]);
+        }
+      for (index_t pp = top; pp < n; ++pp)
+        {
+          auto jj = reach[pp];
+          auto jcol = pinv[jj];
+          if (jcol == kNullLocation)
+            {
+              continue;
+            }
+          auto xj = work[jj];
+          for (index_t ll = Lp[jcol] + 1; ll < Lp[jcol + 1]; ++ll)
+            {
+              work[Li[ll]] -= Lx[ll] * xj;
+            }
+        }
+      //select the pivot
+      index_t ipiv = kNullLocation;
+      double amax = -1.0;
+      for (index_t pp = top; pp < n; ++pp)
+        {
+          auto ii = reach[pp];
+          if (pinv[ii] == kNullLocation)
+            {
+              double aval = std::abs (work[ii]);
+              if (aval > amax)
+                {
+                  amax = aval;
+                  ipiv = ii;
+                }
+            }
+          else
+            {
+              Ui.push_back (pinv[ii]);
+              Ux.push_back (work[ii]);
+            }
+        }
+      if ((ipiv == kNullLocation) || (!(amax > 0.0)))
+        {
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+      if ((pinv[col] == kNullLocation) && (mark[col] == markValue) && (std::abs (work[col]) >= amax * pivotTolerance))
+        {
+          ipiv = col;
+        }
+      T pivot = work[ipiv];
+      double apiv = std::abs (pivot);
+      minPivot = (kk == 0) ? apiv : (std::min)(minPivot, apiv);
+      maxPivot = (std::max)(maxPivot, apiv);
+      Ui.push_back (kk);
+      Ux.push_back (pivot);
+      pinv[ipiv] = kk;
+      Li.push_back (ipiv);
+      Lx.push_back (T (1));
+      for (index_t pp = top; pp < n; ++pp)
+        {
+          auto ii = reach[pp];
+          if (pinv[ii] == kNullLocation)
+            {
+              Li.push_back (ii);
+              Lx.push_back (work[ii] / pivot);
+            }
+          work[ii] = T (0);
+        }
+    }
+  Lp[n] = static_cast<index_t> (Li.size ());
+  Up[n] = static_cast<index_t> (Ui.size ());
+  //convert the rows of L to the pivoted order
+  for (auto &ii : Li)
+    {
+      ii = pinv[ii];
+    }
+  pivRatio = (maxPivot > 0.0) ? minPivot / maxPivot : 0.0;
+  factored = true;
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+template <class T>
+void sparseLU<T>::solve (T x[]) const
+{
+  solve (x, solveWork.data ());
+}
+
+template <class T>
+void sparseLU<T>::solve (T x[], T y[]) const
+{
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      y[pinv[kk]] = x[kk];
+    }
+  for (index_t jj = 0; jj < n; ++jj)
+    {
+      auto yj = y[jj];
+      for (index_t pp = Lp[jj] + 1; pp < Lp[jj + 1]; ++pp)
+        {
+          y[Li[pp]] -= Lx[pp] * yj;
+        }
+    }
+  for (index_t jj = n; jj > 0; --jj)
+    {
+      auto col = jj - 1;
+      y[col] /= Ux[Up[col + 1] - 1];
+      auto yj = y[col];
+      for (index_t pp = Up[col]; pp < Up[col + 1] - 1; ++pp)
+        {
+          y[Ui[pp]] -= Ux[pp] * yj;
+        }
+    }
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      x[colPerm[kk]] = y[kk];
+    }
+}
+
+template <class T>
+void sparseLU<T>::solveTranspose (T x[]) const
+{
+  //A=P'LUQ' so A'=QU'L'P and the solve runs through the factors in reverse
+  auto &y = solveWork;
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      y[kk] = x[colPerm[kk]];
+    }
+  for (index_t col = 0; col < n; ++col)
+    {
+      auto sum = y[col];
+      for (index_t pp = Up[col]; pp < Up[col + 1] - 1; ++pp)
+        {
+          sum -= Ux[pp] * y[Ui[pp]];
+        }
+      y[col] = sum / Ux[Up[col + 1] - 1];
+    }
+  for (index_t jj = n; jj > 0; --jj)
+    {
+      auto col = jj - 1;
+      auto sum = y[col];
+      for (index_t pp = Lp[col] + 1; pp < Lp[col + 1]; ++pp)
+        {
+          sum -= Lx[pp] * y[Li[pp]];
+        }
+      y[col] = sum;
+    }
+  for (index_t kk = 0; kk < n; ++kk)
+    {
+      x[kk] = y[pinv[kk]];
+    }
+}
+
+template class cscMatrix<double>;
+template class cscMatrix<std::complex<double> >;
+template class sparseLU<float>;
+template class sparseLU<double>;
+template class sparseLU<std::complex<double> >;
+template void sparseLU<float>::analyze<double> (const cscMatrix<double> &);
+template void sparseLU<double>::analyze<double> (const cscMatrix<double> &);
+template void sparseLU<std::complex<double> >::analyze<std::complex<double> > (const cscMatrix<std::complex<double> > &);
+template int sparseLU<float>::factor<double> (const cscMatrix<double> &);
+template int sparseLU<double>::factor<double> (const cscMatrix<double> &);
+template int sparseLU<std::complex<double> >::factor<std::complex<double> > (const cscMatrix<std::complex<double> > &);
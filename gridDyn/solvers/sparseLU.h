@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_SPARSE_LU_H_
+#define GRIDDYN_SPARSE_LU_H_
+
+#include "gridDynTypes.h"
+
+#include <vector>
+
+template <class X>
+class arrayData;
+
+/** @brief the symbolic analysis of a sparse matrix,  the nonzero pattern and a fill reducing column ordering
+ an analysis is computed once and can be given to any number of factorizations of matrices with the same pattern
+*/
+class sparsePattern
+{
+public:
+  count_t n = 0;  //!< the number of rows and columns
+  std::vector<index_t> colStart;  //!< the start of each column in the row array, size n+1
+  std::vector<index_t> rows;  //!< the row index of each entry,  sorted within each column
+  std::vector<index_t> colPerm;  //!< the column ordering
+
+  /** @brief compute the column ordering for the pattern
+   uses AMD on the pattern of A+A' if it is available otherwise the natural ordering
+  */
+  void order ();
+  count_t nonZeros () const
+  {
+    return static_cast<count_t> (rows.size ());
+  }
+};
+
+/** @brief sparse matrix in compressed column format
+ duplicate entries are summed when loading from an arrayData object
+*/
+template <class T>
+class cscMatrix
+{
+public:
+  count_t n = 0;  //!< the number of rows and columns
+  std::vector<index_t> colStart;  //!< the start of each column in the row and value arrays, size n+1
+  std::vector<index_t> rows;  //!< the row index of each entry
+  std::vector<T> vals;  //!< the value of each entry
+
+  /** @brief load the matrix from an arrayData object
+  @param[in] ad the array data to load
+  @param[in] size the number of rows and columns
+  */
+  void load (const arrayData<double> &ad, count_t size);
+  /** @brief load the matrix from vectors of row indices, column indices, and values
+  @param[in] size the number of rows and columns
+  */
+  void loadTriplets (const std::vector<index_t> &rowInd, const std::vector<index_t> &colInd, const std::vector<T> &values, count_t size);
+  /** @brief compute y=A*x*/
+  void multiply (const T x[], T y[]) const;
+  /** @brief compute r=b-A*x*/
+  void residual (const T b[], const T x[], T r[]) const;
+  /** @brief store the matrix in a larger pattern with explicit zeros for the missing entries
+  @return false if the matrix has an entry outside the pattern,  the matrix is unchanged in that case
+  */
+  bool expandTo (const sparsePattern &pattern);
+  /** @brief check if another matrix has the same nonzero pattern*/
+  bool samePattern (const cscMatrix<T> &other) const
+  {
+    return ((n == other.n) && (colStart == other.colStart) && (rows == other.rows));
+  }
+  count_t nonZeros () const
+  {
+    return static_cast<count_t> (rows.size ());
+  }
+
+private:
+  void compress (const std::vector<index_t> &tRows, const std::vector<T> &tVals);
+};
+
+/** @brief sparse LU factorization with partial pivoting
+ left looking Gilbert-Peierls factorization with a fill reducing column ordering and a threshold preference for the diagonal pivot
+the factors are stored in the value type T so the same code is used for single and double precision storage
+*/
+template <class T>
+class sparseLU
+{
+public:
+  /** @brief compute the column ordering for a matrix pattern
+   uses AMD on the pattern of A+A' if it is available otherwise the natural ordering
+  */
+  template <class X>
+  void analyze (const cscMatrix<X> &mat);
+  /** @brief use a previously computed analysis instead of analyzing the next matrix*/
+  void setAnalysis (const sparsePattern &pattern);
+  /** @brief factor a matrix
+   the matrix is analyzed first if the pattern does not match the previous analysis
+  @return FUNCTION_EXECUTION_SUCCESS or FUNCTION_EXECUTION_FAILURE if the matrix is structurally or numerically singular
+  */
+  template <class X>
+  int factor (const cscMatrix<X> &mat);
+  /** @brief solve A*x=b in place
+  @param[in,out] x the right hand side on input and the solution on output
+  */
+  void solve (T x[]) const;
+  /** @brief solve A*x=b in place using caller supplied work space of size n
+   the factors are only read so several threads can solve with the same factorization
+  */
+  void solve (T x[], T work[]) const;
+  /** @brief solve A'*x=b in place*/
+  void solveTranspose (T x[]) const;
+  /** @brief check if the object holds a valid factorization*/
+  bool isFactored () const
+  {
+    return factored;
+  }
+  /** @brief get the ratio of the smallest to the largest pivot magnitude,  a cheap indicator of the conditioning*/
+  double pivotRatio () const
+  {
+    return pivRatio;
+  }
+  /** @brief get the number of nonzeros in L and U*/
+  count_t factorNonZeros () const
+  {
+    return static_cast<count_t> (Li.size () + Ui.size ());
+  }
+  /** @brief set the threshold for preferring the diagonal entry as the pivot*/
+  void setPivotTolerance (double tol)
+  {
+    pivotTolerance = tol;
+  }
+  /** @brief drop the factorization and the column ordering*/
+  void clear ();
+
+private:
+  count_t n = 0;  //!< the matrix size
+  bool factored = false;  //!< the factorization is valid
+  double pivotTolerance = 0.001;  //!< the diagonal preference threshold
+  double pivRatio = 0.0;  //!< the ratio of the smallest to largest pivot
+  std::vector<index_t> patternStart;  //!< the column starts of the analyzed pattern
+  std::vector<index_t> patternRows;  //!< the rows of the analyzed pattern
+  std::vector<index_t> colPerm;  //!< the column ordering
+  std::vector<index_t> pinv;  //!< the inverse row permutation
+  std::vector<index_t> Lp;  //!< the column starts of L
+  std::vector<index_t> Li;  //!< the row indices of L
+  std::vector<T> Lx;  //!< the values of L, unit diagonal stored first in each column
+  std::vector<index_t> Up;  //!< the column starts of U
+  std::vector<index_t> Ui;  //!< the row indices of U
+  std::vector<T> Ux;  //!< the values of U, the diagonal is stored last in each column
+  //work space
+  std::vector<T> work;
+  mutable std::vector<T> solveWork;
+  std::vector<index_t> reach;
+  std::vector<index_t> stack;
+  std::vector<index_t> pstack;
+  std::vector<count_t> mark;
+  count_t markValue = 0;
+
+  void allocateWork ();
+  index_t computeReach (const std::vector<index_t> &colStarts, const std::vector<index_t> &colRows, index_t col);
+  void depthFirst (index_t j, index_t &top);
+};
+
+#endif
@@ -203,6 +203,19 @@ double sundialsInterface::get (const std::string &param) const
     {
 	  return static_cast<double>(maxNNZ);
     }
+  else if ((param == "refinementsteps")||(param == "precisionfallbacks")||(param == "doublefactorizations"))
+    {
+      if (!mpSolver)
+        {
+          return 0.0;
+        }
+      auto &st = mpSolver->getStats ();
+      if (param == "refinementsteps")
+        {
+          return static_cast<double> (st.refinementSteps);
+        }
+      return static_cast<double> ((param == "precisionfallbacks") ? st.fallbacks : st.doubleFactorizations);
+    }
   else
   {
 	  return solverInterface::get(param);
@@ -16,6 +16,7 @@
 
 #include "solverInterface.h"
 #include "arrayDataSparse.h"
+#include "mixedPrecisionSolver.h"
 //sundials libraries
 #include "nvector/nvector_serial.h"
 #ifdef HAVE_OPENMP
@@ -72,6 +73,7 @@ protected:
   N_Vector consData = nullptr;                                                     //!<constraint type Vector
   N_Vector scale = nullptr;                                                      //!< scaling vector
   N_Vector types = nullptr;						//!< type data
+  std::unique_ptr<mixedPrecisionSolver> mpSolver;  //!< the linear solver used in mixed precision mode
 public:
   sundialsInterface ();
   /** @brief constructor loading the solverInterface structure*
@@ -132,11 +134,15 @@ public:
   friend int kinsolJacSparse (N_Vector u, N_Vector f, SlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2);
 
 #endif
+  friend int kinsolPrecSetup (N_Vector u, N_Vector uscale, N_Vector f, N_Vector fscale, void *user_data, N_Vector tmp1, N_Vector tmp2);
+  friend int kinsolPrecSolve (N_Vector u, N_Vector uscale, N_Vector f, N_Vector fscale, N_Vector v, void *user_data, N_Vector tmp);
 private:
-  
+
+  arrayDataSparse a1;                              //!< array structure for holding the Jacobian in mixed precision mode
   FILE *m_kinsolInfoFile;                          //!<direct file reference TODO convert to stream vs FILE *
   double solveTime = 0;                            //!< storage for the time the solver is called
   bool fileCapture = false;							//!< flag indicating that the resid and Jacobian should be captured to a file
+  long int maxSetupCalls = 1;                      //!< the number of nonlinear iterations between Jacobian updates 1 for an exact Newton method
   std::string jacFile;						//!< the file to write the Jacobian to 
   std::string stateFile;					//!< the file to write the state and residual to
 #if MEASURE_TIMING > 0
@@ -153,7 +159,10 @@ public:
   count_t icCount = 0;
 private:
   arrayDataSparse a1;                                                     //!< array structure for holding the Jacobian information
-  
+  arrayDataSparse jacY;                                                   //!< the state part dF/dy of the held Jacobian
+  arrayDataSparse jacYp;                                                  //!< the derivative part dF/dy' of the held Jacobian
+  bool jacReady = false;                                                  //!< jacY and jacYp hold a Jacobian that can be reused if constantJacobian is set
+  long int jacConvFails = 0;                                              //!< the nonlinear convergence failures when the held Jacobian was computed
   std::vector<double> tempState;                                          //!<temporary holding location for a state vector
 public:
   /** @brief constructor*/
@@ -183,6 +192,19 @@ public:
   double get (const std::string &param) const override;
 
   void setConstraints () override;
+private:
+  /** @brief check if the held Jacobian can be used in place of a new one
+   a convergence failure since the Jacobian was computed forces a new evaluation
+  */
+  bool canReuseJacobian () const;
+  /** @brief record the conditions the held Jacobian was computed under*/
+  void holdJacobian ();
+  /** @brief load the Jacobian dF/dy+cj*dF/dy' into a1
+   with constantJacobian set the two parts are held and only recombined for a new cj so the models are not called
+  @param[in] maskValue the diagonal value assigned to masked rows
+  */
+  void loadJacobian (double ttime, const double state[], const double dstate_dt[], double cj, double maskValue);
+public:
   // declare friend some helper functions
   friend int idaFunc (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, void *user_data);
   friend int idaJacDense (long int Neq, realtype ttime, realtype cj, N_Vector state, N_Vector dstate_dt, N_Vector resid, DlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
@@ -190,6 +212,8 @@ public:
   friend int idaJacSparse (realtype ttime, realtype cj, N_Vector state, N_Vector dstate_dt, N_Vector resid, SlsMat J, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
 #endif
   friend int idaRootFunc (realtype ttime, N_Vector state, N_Vector dstate_dt, realtype *gout, void *user_data);
+  friend int idaPrecSetup (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, realtype cj, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  friend int idaPrecSolve (realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, N_Vector rvec, N_Vector zvec, realtype cj, realtype delta, void *user_data, N_Vector tmp);
 protected:
   void loadMaskElements ();
 };
@@ -222,6 +246,8 @@ public:
   int initialize (double t0) override;
   void setMaxNonZeros (count_t size) override;
   int sparseReInit (sparse_reinit_modes mode) override;
+  /** @brief reinitialize the solver from the current states,  only the fixed_diff mode is supported*/
+  int calcIC (double t0, double tstep0, ic_modes mode, bool constraints) override;
   int getCurrentData () override;
   int solve (double tStop, double &tReturn, step_mode stepMode = step_mode::normal) override;
   int getRoots () override;
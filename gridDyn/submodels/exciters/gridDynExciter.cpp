@@ -319,3 +319,37 @@ int gridDynExciter::set (const std::string &param, double val, gridUnits::units_
 
   return out;
 }
+
+double gridDynExciter::get (const std::string &param, gridUnits::units_t unitType) const
+{
+  double out = kNullVal;
+  if (param == "vref")
+    {
+      out = Vref;
+    }
+  else if (param == "ka")
+    {
+      out = Ka;
+    }
+  else if (param == "ta")
+    {
+      out = Ta;
+    }
+  else if ((param == "vrmax") || (param == "urmax"))
+    {
+      out = Vrmax;
+    }
+  else if ((param == "vrmin") || (param == "urmin"))
+    {
+      out = Vrmin;
+    }
+  else if (param == "vbias")
+    {
+      out = vBias;
+    }
+  else
+    {
+      out = gridSubModel::get (param, unitType);
+    }
+  return out;
+}
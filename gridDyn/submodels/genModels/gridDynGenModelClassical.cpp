@@ -525,3 +525,41 @@ int gridDynGenModelClassical::set (const std::string &param, double val, gridUni
 
   return out;
 }
+
+double gridDynGenModelClassical::get (const std::string &param, gridUnits::units_t unitType) const
+{
+  double out = kNullVal;
+  if (param == "h")
+    {
+      out = H;
+    }
+  else if (param == "m")
+    {
+      out = 2.0 * H;
+    }
+  else if (param == "d")
+    {
+      out = gridUnits::unitConversionFreq (D, gridUnits::puHz, unitType, m_baseFreq);
+    }
+  else if ((param == "xd") || (param == "x"))
+    {
+      out = Xd;
+    }
+  else if ((param == "rs") || (param == "r"))
+    {
+      out = Rs;
+    }
+  else if ((param == "base") || (param == "mbase"))
+    {
+      out = machineBasePower;
+    }
+  else if (param == "kw")
+    {
+      out = mp_Kw;
+    }
+  else
+    {
+      out = gridSubModel::get (param, unitType);
+    }
+  return out;
+}
@@ -90,6 +90,7 @@ public:
 
   virtual int set (const std::string &param, const std::string &val) override;
   virtual int set (const std::string &param, double val, gridUnits::units_t unitType = gridUnits::defUnit) override;
+  virtual double get (const std::string &param, gridUnits::units_t unitType = gridUnits::defUnit) const override;
 
   virtual stringVec localStateNames () const override;
   // dynamics
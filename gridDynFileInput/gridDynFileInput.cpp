@@ -165,6 +165,10 @@ uint32_t addflags (uint32_t iflags, const std::string &flags)
         {
           oflags |= (1 << ignore_step_up_transformer);
         }
+      else if (flag == "defer_dynamic_models")
+        {
+          oflags |= (1 << defer_dynamic_models);
+        }
     }
   return oflags;
 }
@@ -62,6 +62,7 @@ extern match_type defMatchType;
 enum readerFlags
 {
   ignore_step_up_transformer = 1, //!< ignore any step up transformer definitions
+  defer_dynamic_models = 2, //!< record the dynamic submodels and construct them when the dynamic initialization starts
 };
 
 std::shared_ptr<gridDynSimulation> readXML (const std::string &filename, readerInfo *ri = nullptr);
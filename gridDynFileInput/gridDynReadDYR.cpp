@@ -27,12 +27,28 @@
 
 static std::shared_ptr<coreObjectFactory> cof = coreObjectFactory::instance();
 
-void loadGENROU(gridCoreObject *parentObject, stringVec &tokens);
-void loadESDC1A(gridCoreObject *parentObject, stringVec &tokens);
-void loadTGOV1(gridCoreObject *parentObject, stringVec &tokens);
-void loadEXDC2(gridCoreObject *parentObject, stringVec &tokens);
+void loadGENROU(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri);
+void loadESDC1A(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri);
+void loadTGOV1(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri);
+void loadEXDC2(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri);
 
-void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basicReaderInfo &)
+/** construct the submodel and add it to the generator or leave the description with the generator if construction is deferred*/
+static void addDynamicModel(gridDynGenerator *gen, gridDynGenerator::deferredSubModel &model, const basicReaderInfo &bri)
+{
+  if ((bri.flags & (1 << defer_dynamic_models)) != 0)
+  {
+    gen->addDeferredModel(std::move(model));
+    return;
+  }
+  gridCoreObject *sm = cof->createObject(model.component, model.type);
+  for (auto &pp : model.params)
+  {
+    sm->set(pp.first, pp.second);
+  }
+  gen->add(sm);
+}
+
+void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basicReaderInfo &bri)
 {
   std::ifstream file(filename.c_str(), std::ios::in);
   std::string line,line2;  //line storage
@@ -75,19 +91,19 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
 	trimString(type);
     if (type == "'GENROU'")
     {
-      loadGENROU(parentObject, lineTokens);
+      loadGENROU(parentObject, lineTokens, bri);
     }
     else if (type == "'ESDC1A'")
     {
-      loadESDC1A(parentObject, lineTokens);
+      loadESDC1A(parentObject, lineTokens, bri);
     }
     else if (type == "'EXDC2'")
     {
-      loadESDC1A(parentObject, lineTokens);
+      loadESDC1A(parentObject, lineTokens, bri);
     }
     else if (type == "'TGOV1'")
     {
-      loadTGOV1(parentObject, lineTokens);
+      loadTGOV1(parentObject, lineTokens, bri);
     }
     else
     {
@@ -97,7 +113,7 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
 }
 
 
-  void loadGENROU(gridCoreObject *parentObject, stringVec &tokens)
+  void loadGENROU(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri)
   {
     int id = std::stoi(tokens[0]);
     gridBus *bus = static_cast<gridBus *>(parentObject->findByUserID("bus", id));
@@ -106,28 +122,19 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
 
     auto params = str2vector(tokens,kNullVal);
 
-    gridDynGenModel *sm = static_cast<gridDynGenModel *>(cof->createObject("genmodel", "6"));
-    sm->set("tdop", params[3]);
-    sm->set("tdopp", params[4]);
-    sm->set("tqop", params[5]);
-    sm->set("tqopp", params[6]);
-    sm->set("h", params[7]);
-    sm->set("d", params[8]);
-    sm->set("xd", params[9]);
-    sm->set("xq", params[10]);
-    sm->set("xdp", params[11]);
-    sm->set("xqp", params[12]);
-    sm->set("xdpp", params[13]);
-    sm->set("xqpp", params[13]);
-    sm->set("xl", params[14]);
-    sm->set("s1", params[15]);
-    sm->set("s12", params[16]);
-    
-    gen->add(sm);
+    gridDynGenerator::deferredSubModel sm;
+    sm.component = "genmodel";
+    sm.type = "6";
+    sm.params = { { "tdop", params[3] }, { "tdopp", params[4] }, { "tqop", params[5] }, { "tqopp", params[6] },
+                  { "h", params[7] }, { "d", params[8] }, { "xd", params[9] }, { "xq", params[10] },
+                  { "xdp", params[11] }, { "xqp", params[12] }, { "xdpp", params[13] }, { "xqpp", params[13] },
+                  { "xl", params[14] }, { "s1", params[15] }, { "s12", params[16] } };
+
+    addDynamicModel(gen, sm, bri);
 
   }
 
-  void loadESDC1A(gridCoreObject *parentObject, stringVec &tokens)
+  void loadESDC1A(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri)
   {
     int id = std::stoi(tokens[0]);
     gridBus *bus = static_cast<gridBus *>(parentObject->findByUserID("bus", id));
@@ -135,37 +142,27 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
     gridDynGenerator *gen = bus->getGen(id - 1);
 
     auto params = str2vector(tokens, kNullVal);
-    gridDynExciter *sm;
-    if (params[6] > 0.0)//dc1a model must have tb>0 otherwise revert to type1
-    {
-      sm = static_cast<gridDynExciter *>(cof->createObject("exciter", "dc1a"));
-    }
-    else
-    {
-      sm = static_cast<gridDynExciter *>(cof->createObject("exciter", "type1"));
-    }
+    gridDynGenerator::deferredSubModel sm;
+    sm.component = "exciter";
+    //dc1a model must have tb>0 otherwise revert to type1
+    sm.type = (params[6] > 0.0) ? "dc1a" : "type1";
     //TODO:: TR not implmented yet, no voltage compensation implemented
     //sm->set("tr", params[3]);
-    sm->set("ka", params[4]);
-    sm->set("ta", params[5]);
+    sm.params = { { "ka", params[4] }, { "ta", params[5] } };
     if (params[6] > 0) 
     {
-      sm->set("tb", params[6]);
-      sm->set("tc", params[7]);
+      sm.params.emplace_back("tb", params[6]);
+      sm.params.emplace_back("tc", params[7]);
     }
-    sm->set("vrmax", params[8]);
-    sm->set("vrmin", params[9]);
-    sm->set("ke", params[10]);
-    sm->set("te", params[11]);
-    sm->set("kf", params[12]);
-    sm->set("tf", params[13]);
+    sm.params.insert(sm.params.end(), { { "vrmax", params[8] }, { "vrmin", params[9] }, { "ke", params[10] },
+                                        { "te", params[11] }, { "kf", params[12] }, { "tf", params[13] } });
     //TODO I need to compute the saturation coeeficients to translate appropriately
 
-    gen->add(sm);
+    addDynamicModel(gen, sm, bri);
 
   }
 
-  void loadEXDC2(gridCoreObject *parentObject, stringVec &tokens)
+  void loadEXDC2(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri)
   {
     int id = std::stoi(tokens[0]);
     gridBus *bus = static_cast<gridBus *>(parentObject->findByUserID("bus", id));
@@ -174,26 +171,21 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
 
     auto params = str2vector(tokens, kNullVal);
 
-    gridDynExciter *sm = static_cast<gridDynExciter *>(cof->createObject("exciter", "dc2a"));
+    gridDynGenerator::deferredSubModel sm;
+    sm.component = "exciter";
+    sm.type = "dc2a";
     //TODO:: TR not implmented yet, no voltage compensation implemented
     //sm->set("tr", params[3]);
-    sm->set("ka", params[4]);
-    sm->set("ta", params[5]);
-    sm->set("tb", params[6]);
-    sm->set("tc", params[7]);
-    sm->set("vrmax", params[8]);
-    sm->set("vrmin", params[9]);
-    sm->set("ke", params[10]);
-    sm->set("te", params[11]);
-    sm->set("kf", params[12]);
-    sm->set("tf", params[13]);
+    sm.params = { { "ka", params[4] }, { "ta", params[5] }, { "tb", params[6] }, { "tc", params[7] },
+                  { "vrmax", params[8] }, { "vrmin", params[9] }, { "ke", params[10] }, { "te", params[11] },
+                  { "kf", params[12] }, { "tf", params[13] } };
     //TODO I need to compute the saturation coefficients to translate appropriately
 
-    gen->add(sm);
+    addDynamicModel(gen, sm, bri);
 
   }
 
-  void loadTGOV1(gridCoreObject *parentObject, stringVec &tokens)
+  void loadTGOV1(gridCoreObject *parentObject, stringVec &tokens, const basicReaderInfo &bri)
   {
     int id = std::stoi(tokens[0]);
     gridBus *bus = static_cast<gridBus *>(parentObject->findByUserID("bus", id));
@@ -202,18 +194,14 @@ void loadDYR(gridCoreObject *parentObject,const std::string &filename,const basi
 
     auto params = str2vector(tokens, kNullVal);
 
-    gridDynGovernor *sm = static_cast<gridDynGovernor *>(cof->createObject("governor", "tgov1"));
+    gridDynGenerator::deferredSubModel sm;
+    sm.component = "governor";
+    sm.type = "tgov1";
     //TODO:: TR not implmented yet, no voltage compensation implemented
     //sm->set("tr", params[3]);
-    sm->set("r", params[3]);
-    sm->set("t1", params[4]);
-    sm->set("pmax", params[5]);
-    sm->set("pmin", params[6]);
-    sm->set("t2", params[6]);
-    sm->set("t3", params[7]);
-    sm->set("dt", params[8]);
-    
-
-    gen->add(sm);
-
-  }
\ No newline at end of file
+    sm.params = { { "r", params[3] }, { "t1", params[4] }, { "pmax", params[5] }, { "pmin", params[6] },
+                  { "t2", params[6] }, { "t3", params[7] }, { "dt", params[8] } };
+
+    addDynamicModel(gen, sm, bri);
+
+  }
@@ -23,6 +23,8 @@
 #include "objectInterpreter.h"
 #include "gridDynFederatedScheduler.h"
 #include "simulation/gridDynSimulationFileOps.h"
+#include "simulation/realTimePacer.h"
+#include "solvers/solverInterface.h"
 #include "griddyn-tracer.h"
 #include "gridRecorder.h"
 #include "stringOps.h"
@@ -41,6 +43,7 @@
 #include "extraModels.h"
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <memory>
@@ -86,6 +89,18 @@ int griddyn_runner_main (int argc, char *argv[])
 
 namespace po = boost::program_options;
 
+GriddynRunner::GriddynRunner ()
+{
+}
+
+GriddynRunner::~GriddynRunner ()
+{
+  if (m_gds)
+    {
+      m_gds->setRealTimePacer (nullptr);
+    }
+}
+
 #ifdef GRIDDYN_HAVE_FSKIT
 int GriddynRunner::Initialize (int argc, char *argv[], std::shared_ptr<fskit::GrantedTimeWindowScheduler> scheduler)
 {
@@ -152,6 +167,10 @@ int GriddynRunner::Initialize (int argc, char *argv[])
     {
       return 0;
     }
+  if ((ret = setupRealTime (vm)) != 0)
+    {
+      return ret;
+    }
   m_gds->log (nullptr,GD_SUMMARY_PRINT, griddyn_version_string);
   m_stopTime = std::chrono::high_resolution_clock::now ();
   std::chrono::duration<double> elapsed_t = m_stopTime - m_startTime;
@@ -170,7 +189,24 @@ int GriddynRunner::Initialize (int argc, char *argv[])
 void GriddynRunner::Run (void)
 {
   GRIDDYN_TRACER ("griddyn::GriddynRunner::Run");
-
+  if (m_pacer)
+    {
+      double stop = m_gds->get ("stoptime");
+      double frame = (m_frameTime > 0) ? m_frameTime : m_gds->get ("steptime");
+      double current = m_gds->getCurrentTime ();
+      while (current < stop)
+        {
+          double next = Step ((std::min)(current + frame, stop));
+          //a zero frame or a step that makes no progress would otherwise loop forever
+          if (next <= current)
+            {
+              m_gds->log (m_gds.get (), GD_WARNING_PRINT, "paced run stopped at " + std::to_string (current) + " since the time did not advance");
+              break;
+            }
+          current = next;
+        }
+      return;
+    }
   m_gds->run ();
 }
 
@@ -179,6 +215,14 @@ double GriddynRunner::Step (double time)
   double actual = time;
   if (m_gds)
     {
+      if (m_pacer)
+        {
+          if (!m_pacer->isStarted ())
+            {
+              m_pacer->start (m_gds->getCurrentTime ());
+            }
+          m_pacer->beginFrame (time);
+        }
       if (eventMode)
         {
           int retval = m_gds->eventDrivenPowerflow (time);
@@ -198,12 +242,82 @@ double GriddynRunner::Step (double time)
               throw(std::runtime_error (error));
             }
         }
+      if (m_pacer)
+        {
+          if (m_pacer->endFrame ())
+            {
+              m_gds->log (m_gds.get (), GD_DEBUG_PRINT, "real time frame ending at " + std::to_string (time) + " overran its deadline by " + std::to_string (m_pacer->lastLateness ()) + "s");
+            }
+          updateDegradation ();
+        }
 
     }
 
   return actual;
 }
 
+int GriddynRunner::setupRealTime (po::variables_map &vm)
+{
+  if (vm.count ("realtime") == 0)
+    {
+      if ((vm.count ("realtime-degrade")) || (vm.count ("realtime-histogram")))
+        {
+          m_gds->log (m_gds.get (), GD_WARNING_PRINT, "real time options specified without --realtime");
+        }
+      return FUNCTION_EXECUTION_SUCCESS;
+    }
+  m_pacer.reset (new realTimePacer (vm["realtime"].as<double> ()));
+  if (vm.count ("realtime-degrade"))
+    {
+      if (m_pacer->setDegradation (vm["realtime-degrade"].as<std::string> ()) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          m_gds->log (m_gds.get (), GD_ERROR_PRINT, "unrecognized real time degradation " + vm["realtime-degrade"].as<std::string> ());
+          return FUNCTION_EXECUTION_FAILURE;
+        }
+    }
+  if (vm.count ("realtime-threshold"))
+    {
+      m_pacer->setRiskThreshold (vm["realtime-threshold"].as<double> ());
+    }
+  if (vm.count ("realtime-frame"))
+    {
+      m_frameTime = vm["realtime-frame"].as<double> ();
+    }
+  if (vm.count ("realtime-histogram"))
+    {
+      m_histogramFile = vm["realtime-histogram"].as<std::string> ();
+    }
+  m_gds->setRealTimePacer (m_pacer.get ());
+  return FUNCTION_EXECUTION_SUCCESS;
+}
+
+void GriddynRunner::updateDegradation ()
+{
+  bool degrade = m_pacer->degraded ();
+  if (degrade == m_degraded)
+    {
+      return;
+    }
+  m_degraded = degrade;
+  auto steps = m_pacer->getDegradation ();
+  if (steps & realTimePacer::degrade_recorders)
+    {
+      m_gds->set ("suspendrecorders", (degrade) ? 1.0 : 0.0);
+    }
+  if ((steps & realTimePacer::degrade_jacobian) && (!eventMode))
+    {
+      m_gds->getSolverInterface ("dynamic")->set ("constantjacobian", (degrade) ? 1.0 : 0.0);
+    }
+  if (degrade)
+    {
+      m_gds->log (m_gds.get (), GD_WARNING_PRINT, "real time frames at risk, used " + std::to_string (m_pacer->lastUsage () * 100.0) + "% of the frame budget: degradation enabled");
+    }
+  else
+    {
+      m_gds->log (m_gds.get (), GD_NORMAL_PRINT, "real time frames recovered: degradation disabled");
+    }
+}
+
 double GriddynRunner::getNextEvent () const
 {
   return m_gds->getEventTime ();
@@ -223,6 +337,17 @@ void GriddynRunner::Finalize (void)
   GRIDDYN_TRACER ("griddyn::GriddynRunner::Finalize");
 
   StopRecording ();
+  if (m_pacer)
+    {
+      m_gds->log (m_gds.get (), GD_SUMMARY_PRINT, m_pacer->getSummary ());
+      if (!m_histogramFile.empty ())
+        {
+          if (m_pacer->exportHistograms (m_histogramFile) != FUNCTION_EXECUTION_SUCCESS)
+            {
+              m_gds->log (m_gds.get (), GD_ERROR_PRINT, "unable to write real time histograms to " + m_histogramFile);
+            }
+        }
+    }
 
   if (!m_isMpiCountMode)
     {
@@ -230,6 +355,58 @@ void GriddynRunner::Finalize (void)
     }
 }
 
+int applyFlagStrings (gridDynSimulation *gds, const stringVec &flagstrings, std::ostream &msg)
+{
+  int failed = 0;
+  for (auto &str : flagstrings)
+    {
+      auto fstr = splitlineTrim (str);
+      for (auto &flag : fstr)
+        {
+          makeLowerCase (flag);
+          if (gds->setFlag (flag, true) != PARAMETER_FOUND)
+            {
+              msg << "flag " << str << " not recognized\n";
+              ++failed;
+            }
+        }
+    }
+  return failed;
+}
+
+int applyParamStrings (gridDynSimulation *gds, const stringVec &paramstrings, std::ostream &msg)
+{
+  int failed = 0;
+  for (auto &str : paramstrings)
+    {
+      gridParameter p (str);
+      if (p.valid)
+        {
+          objInfo oi (p.field, gds);
+          int temp;
+          if (oi.m_obj == nullptr)
+            {
+              temp = PARAMETER_NOT_FOUND;
+            }
+          else if (p.stringType)
+            {
+              temp = oi.m_obj->set (oi.m_field, p.strVal);
+            }
+          else
+            {
+              temp = oi.m_obj->set (oi.m_field, p.value, p.paramUnits);
+            }
+
+          if (temp != PARAMETER_FOUND)
+            {
+              msg << "param " << str << " not able to be processed\n";
+              ++failed;
+            }
+        }
+    }
+  return failed;
+}
+
 int processCommandArguments (std::shared_ptr<gridDynSimulation> gds, readerInfo *ri, po::variables_map &vm)
 {
   int temp;
@@ -274,6 +451,11 @@ int processCommandArguments (std::shared_ptr<gridDynSimulation> gds, readerInfo
           ri->flags = addflags (ri->flags, str);
         }
     }
+  if ((vm.count ("powerflow_only")) || (vm.count ("powerflow-only")))
+    {
+      //the dynamic models are not needed so their construction is left until a dynamic run asks for them
+      ri->flags = addflags (ri->flags, "defer_dynamic_models");
+    }
   std::string grid_file;
   grid_file = vm["input"].as<std::string> ();
 
@@ -310,49 +492,13 @@ int processCommandArguments (std::shared_ptr<gridDynSimulation> gds, readerInfo
   //set any flags used by the system
   if (vm.count ("flags"))
     {
-      stringVec flagstrings = vm["flags"].as<stringVec > ();
-      for (auto &str : flagstrings)
-        {
-          auto fstr = splitlineTrim (str);
-          for (auto &flag : fstr)
-            {
-              makeLowerCase (flag);
-              temp = gds->setFlag (flag, true);
-              if (temp != PARAMETER_FOUND)
-                {
-                  std::cout << "flag " << str << " not recognized\n";
-                }
-            }
-
-          //	std::cout << "set flags to " << str << '\n';
-        }
+      applyFlagStrings (gds.get (), vm["flags"].as<stringVec > (), std::cout);
     }
 
   //set any parameters
   if (vm.count ("param"))
     {
-      stringVec paramstrings = vm["param"].as<stringVec > ();
-      for (auto &str : paramstrings)
-        {
-          gridParameter p (str);
-          if (p.valid)
-            {
-              objInfo oi (p.field, gds.get ());
-              if (p.stringType)
-                {
-                  temp = oi.m_obj->set (oi.m_field, p.strVal);
-                }
-              else
-                {
-                  temp = oi.m_obj->set (oi.m_field, p.value, p.paramUnits);
-                }
-
-              if (temp != PARAMETER_FOUND)
-                {
-                  std::cout << "param " << str << " not able to be processed\n";
-                }
-            }
-        }
+      applyParamStrings (gds.get (), vm["param"].as<stringVec > (), std::cout);
     }
 
   if (vm.count ("powerflow-output"))
@@ -414,6 +560,7 @@ int argumentParser (int argc, char *argv[], po::variables_map &vm_map)
     ("config-file", po::value<std::string> (), "specify a config file to use")
     ("config-file-output", po::value<std::string> (), "file to store current config options")
     ("mpicount", "setup for an MPI run")
+    ("worker", po::value<std::string> ()->implicit_value (""), "run as a resident worker reading job lines from stdin or from the given file or pipe,  the input file becomes the default case")
     ("version", "print version string");
 
   config.add_options ()
@@ -435,7 +582,12 @@ int argumentParser (int argc, char *argv[], po::variables_map &vm_map)
     ("file-flags", po::value < std::vector < std::string >> (), "specify flags to feed to the file reader")
     ("define,D", po::value < std::vector < std::string >> (), "definition strings for the element file readers")
     ("translate,T", po::value < std::vector < std::string >> (), "translation strings for the element file readers")
-    ("warn,w", po::value<int> (), "specify warning level output 0=all, 1=important,2=none");
+    ("warn,w", po::value<int> (), "specify warning level output 0=all, 1=important,2=none")
+    ("realtime", po::value<double> (), "pace the simulation against the wall clock at the given ratio of simulated to wall clock time, 0 for timing only")
+    ("realtime-frame", po::value<double> (), "simulated time advanced in each real time frame (defaults to the simulation step time)")
+    ("realtime-degrade", po::value<std::string> (), "degradation steps when a real time frame is at risk: recorders,jacobian,all")
+    ("realtime-threshold", po::value<double> (), "fraction of the frame budget at which a real time frame is at risk (default 0.8)")
+    ("realtime-histogram", po::value<std::string> (), "csv file for the real time frame timing histograms");
 
   hidden.add_options ()
     ("input", po::value<std::string> (), "input file");
@@ -508,7 +660,7 @@ int argumentParser (int argc, char *argv[], po::variables_map &vm_map)
     }
   po::notify (vm_map);
   //check to make sure we have some input file
-  if (vm_map.count ("input") == 0)
+  if ((vm_map.count ("input") == 0) && (vm_map.count ("worker") == 0))
     {
       std::cout << " no input file specified\n";
       std::cout << visible << '\n';
@@ -18,9 +18,13 @@
 #include "griddyn-config.h"
 
 #include <chrono>
+#include <iosfwd>
 #include <memory>
+#include <string>
+#include <vector>
 
 class gridDynSimulation;
+class realTimePacer;
 
 #ifdef GRIDDYN_HAVE_FSKIT
 namespace fskit {
@@ -43,6 +47,8 @@ class variables_map;
 class GriddynRunner
 {
 public:
+  GriddynRunner ();
+  ~GriddynRunner ();
   /**
    * Initialize a simulation run from command line arguments.
    */
@@ -53,13 +59,14 @@ public:
 #endif
 
   /**
-   * Run simulation to completion
+   * Run simulation to completion,  in real time mode the simulation advances in frames paced by the wall clock
    */
   void Run (void);
 
   /**
    * Run simulation up to provided time.   Simulation may
-   * return early.
+   * return early.  In real time mode the call does not return before the
+   * wall clock time at which the provided time is due.
    *
    * @param time maximum time simulation may advance to.
    * @return time simulation successfully advanced to.
@@ -75,6 +82,16 @@ public:
 
   void Finalize (void);
 
+  /**
+   * Get the real time pacer
+   *
+   * @return a pointer to the pacer or nullptr if not running in real time mode
+   */
+  realTimePacer *getPacer () const
+  {
+    return m_pacer.get ();
+  }
+
 private:
   /**
    * Get the next Griddyn Event time
@@ -83,12 +100,26 @@ private:
    */
   void StopRecording (void);
 
+  /**
+   * set up the real time pacer from the command line options
+   */
+  int setupRealTime (boost::program_options::variables_map &vm);
+
+  /**
+   * apply or remove the degradation steps when the pacer changes state
+   */
+  void updateDegradation ();
+
   std::shared_ptr<gridDynSimulation> m_gds;
 
   decltype(std::chrono::high_resolution_clock::now ())m_startTime;
   decltype(std::chrono::high_resolution_clock::now ())m_stopTime;
   bool m_isMpiCountMode = false;
   bool eventMode = false;
+  std::unique_ptr<realTimePacer> m_pacer;  //!< pacer for real time execution
+  std::string m_histogramFile;  //!< file to export the frame timing histograms to
+  double m_frameTime = 0.0;  //!< the simulation time advanced by each frame in Run
+  bool m_degraded = false;  //!< the degradation steps are currently applied
 };
 
 class readerInfo;
@@ -100,5 +131,21 @@ void loadXMLinfo (boost::program_options::variables_map &vm_map, readerInfo *ri)
 
 
 int processCommandArguments (std::shared_ptr<gridDynSimulation> gds, readerInfo *ri, boost::program_options::variables_map &vm);
+
+/** @brief set simulation flags from strings in the --flags syntax
+@param[in] gds the simulation to set the flags on
+@param[in] flagstrings comma separated lists of flags
+@param[out] msg stream for the messages about unrecognized flags
+@return the number of flags which were not recognized
+*/
+int applyFlagStrings (gridDynSimulation *gds, const std::vector<std::string> &flagstrings, std::ostream &msg);
+
+/** @brief set object parameters from strings in the --param syntax
+@param[in] gds the simulation containing the objects
+@param[in] paramstrings strings of the form object::field=value
+@param[out] msg stream for the messages about parameters which could not be set
+@return the number of parameters which could not be set
+*/
+int applyParamStrings (gridDynSimulation *gds, const std::vector<std::string> &paramstrings, std::ostream &msg);
 #endif
 
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "gridDynWorker.h"
+#include "gridDynRunner.h"
+#include "gridDyn.h"
+#include "gridDynFileInput.h"
+#include "readerInfo.h"
+#include "objectInterpreter.h"
+#include "simulation/gridDynSimulationFileOps.h"
+#include "stringOps.h"
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace po = boost::program_options;
+
+gridDynWorker::gridDynWorker (const po::variables_map &vm) : options (vm)
+{
+  if (options.count ("input"))
+    {
+      defaultCase = options["input"].as<std::string> ();
+    }
+  //the reader messages would be mixed into the result stream
+  if (options.count ("verbose") == 0)
+    {
+      readerConfig::setPrintMode (READER_NO_PRINT);
+    }
+}
+
+gridDynWorker::~gridDynWorker ()
+{
+
+}
+
+void gridDynWorker::clearCache ()
+{
+  baseCases.clear ();
+}
+
+std::shared_ptr<gridDynSimulation> gridDynWorker::getBaseCase (const std::string &caseFile)
+{
+  boost::system::error_code ec;
+  std::time_t modTime = boost::filesystem::last_write_time (caseFile, ec);
+  if (ec)
+    {
+      modTime = 0;
+    }
+  auto fnd = baseCases.find (caseFile);
+  if ((fnd != baseCases.end ()) && (fnd->second.modTime == modTime))
+    {
+      return fnd->second.sim;
+    }
+  auto gds = std::make_shared<gridDynSimulation> ();
+  gridDynSimulation::setInstance (gds.get ());
+  gds->set ("consoleprintlevel", GD_ERROR_PRINT);
+  readerInfo ri;
+  loadXMLinfo (options, &ri);
+  if (options.count ("file-flags"))
+    {
+      for (auto &str : options["file-flags"].as<stringVec > ())
+        {
+          ri.flags = addflags (ri.flags, str);
+        }
+    }
+  loadFile (gds.get (), caseFile, &ri);
+  if (gds->getErrorCode () != FUNCTION_EXECUTION_SUCCESS)
+    {
+      std::cerr << "unable to load case " << caseFile << '\n';
+      baseCases.erase (caseFile);
+      return nullptr;
+    }
+  baseCase bc;
+  bc.sim = gds;
+  bc.modTime = modTime;
+  baseCases[caseFile] = bc;
+  return gds;
+}
+
+int gridDynWorker::run (std::istream &jobs, std::ostream &results)
+{
+  int failures = 0;
+  std::string line;
+  while (std::getline (jobs, line))
+    {
+      line = trim (line);
+      if ((line.empty ()) || (line[0] == '#'))
+        {
+          continue;
+        }
+      if ((line == "quit") || (line == "exit"))
+        {
+          break;
+        }
+      if (runJob (line, results) != FUNCTION_EXECUTION_SUCCESS)
+        {
+          ++failures;
+        }
+    }
+  return failures;
+}
+
+int gridDynWorker::runJob (const std::string &jobLine, std::ostream &results)
+{
+  auto start_t = std::chrono::high_resolution_clock::now ();
+  ++jobCount;
+  std::string jobId = std::to_string (jobCount);
+
+  po::options_description jobOptions ("job options");
+  jobOptions.add_options ()
+    ("case", po::value<std::string> (), "the case file")
+    ("id", po::value<std::string> (), "the name of the job used in the result line")
+    ("param,P", po::value<stringVec > (), "parameter override ParamName=<val>")
+    ("flags,f", po::value<stringVec > (), "flags to set")
+    ("action", po::value<stringVec > (), "actions to execute in order")
+    ("stop", po::value<double> (), "the time to run to if no actions are given")
+    ("powerflow-output,o", po::value<std::string> (), "file output for the powerflow solution")
+    ("state-output", po::value<std::string> (), "file for the final state")
+    ("get", po::value<stringVec > (), "values to report in the result line");
+  po::positional_options_description pos;
+  pos.add ("case", 1);
+
+  po::variables_map jvm;
+  try
+    {
+      po::store (po::command_line_parser (po::split_unix (jobLine)).options (jobOptions).positional (pos).run (), jvm);
+      po::notify (jvm);
+    }
+  catch (std::exception &e)
+    {
+      std::cerr << e.what () << '\n';
+      results << "job " << jobId << " status=" << INVALID_PARAMETER_VALUE << std::endl;
+      return INVALID_PARAMETER_VALUE;
+    }
+  if (jvm.count ("id"))
+    {
+      jobId = jvm["id"].as<std::string> ();
+    }
+  std::string caseFile = (jvm.count ("case")) ? jvm["case"].as<std::string> () : defaultCase;
+  auto base = (caseFile.empty ()) ? nullptr : getBaseCase (caseFile);
+  if (!base)
+    {
+      results << "job " << jobId << " status=" << FUNCTION_EXECUTION_FAILURE << std::endl;
+      return FUNCTION_EXECUTION_FAILURE;
+    }
+  //each job runs on its own copy so the base stays untouched for the next job
+  std::unique_ptr<gridDynSimulation> gds (static_cast<gridDynSimulation *> (base->clone ()));
+  gridDynSimulation::setInstance (gds.get ());
+
+  if (jvm.count ("flags"))
+    {
+      applyFlagStrings (gds.get (), jvm["flags"].as<stringVec > (), std::cerr);
+    }
+  if (jvm.count ("param"))
+    {
+      applyParamStrings (gds.get (), jvm["param"].as<stringVec > (), std::cerr);
+    }
+  if (jvm.count ("powerflow-output"))
+    {
+      gds->set ("powerflowfile", jvm["powerflow-output"].as<std::string> ());
+    }
+
+  int ret;
+  if (jvm.count ("action"))
+    {
+      for (auto &act : jvm["action"].as<stringVec > ())
+        {
+          gds->add (act);
+        }
+      ret = gds->run ();
+    }
+  else
+    {
+      ret = gds->run ((jvm.count ("stop")) ? jvm["stop"].as<double> () : kNullVal);
+    }
+  if (jvm.count ("state-output"))
+    {
+      saveState (gds.get (), jvm["state-output"].as<std::string> ());
+    }
+
+  std::chrono::duration<double> elapsed_t = std::chrono::high_resolution_clock::now () - start_t;
+  results << "job " << jobId << " status=" << ret << " state=" << static_cast<int> (gds->currentProcessState ()) << " time=" << gds->getCurrentTime () << " elapsed=" << elapsed_t.count ();
+  if (jvm.count ("get"))
+    {
+      for (auto &field : jvm["get"].as<stringVec > ())
+        {
+          objInfo oi (field, gds.get ());
+          double val = (oi.m_obj != nullptr) ? oi.m_obj->get (oi.m_field, oi.m_unitType) : kNullVal;
+          results << ' ' << field << '=' << val;
+        }
+    }
+  results << std::endl;
+  gridDynSimulation::setInstance (base.get ());
+  return (ret >= FUNCTION_EXECUTION_SUCCESS) ? FUNCTION_EXECUTION_SUCCESS : ret;
+}
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef GRIDDYN_WORKER_H_
+#define GRIDDYN_WORKER_H_
+
+#include "gridDynTypes.h"
+
+#include <boost/program_options/variables_map.hpp>
+
+#include <ctime>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+
+class gridDynSimulation;
+
+/** @brief resident worker running a stream of study jobs against cached base cases
+ each base case is read from its file once and kept in memory,  every job runs on a fresh clone of the cached case so the
+per job cost is the clone and the simulation itself.  A job is a single line in the command line syntax
+@code
+<casefile> [--id name] [--param field=value]... [--flags f1,f2]... [--action "action string"]... [--stop time]
+  [--powerflow-output file] [--state-output file] [--get field]...
+@endcode
+the case file may be omitted if the worker was started with an input file.  The result of each job is written as a single
+line
+@code
+job <id> status=<code> state=<process state> time=<simulation time> elapsed=<seconds> [field=value]...
+@endcode
+the line "quit" ends the job stream and lines starting with '#' are ignored.  Messages about the job setup go to std::cerr
+so the result stream only contains result lines.
+*/
+class gridDynWorker
+{
+public:
+  /** @brief constructor
+  @param[in] vm the command line options,  the directories,  definitions,  translations,  and reader flags are used when
+  reading the base cases and the input file if given becomes the default case
+  */
+  explicit gridDynWorker (const boost::program_options::variables_map &vm);
+  ~gridDynWorker ();
+  /** @brief run jobs until the end of the job stream or a quit line
+  @param[in] jobs the stream to read the job lines from
+  @param[out] results the stream to write the result lines to
+  @return the number of jobs which failed
+  */
+  int run (std::istream &jobs, std::ostream &results);
+  /** @brief run a single job
+  @param[in] jobLine the job description
+  @param[out] results the stream to write the result line to
+  @return FUNCTION_EXECUTION_SUCCESS or the error code of the job
+  */
+  int runJob (const std::string &jobLine, std::ostream &results);
+  /** @brief get the cached base case for a file,  reading it if it is not cached or has changed on disk
+  @return a pointer to the base case or nullptr if the file could not be read
+  */
+  std::shared_ptr<gridDynSimulation> getBaseCase (const std::string &caseFile);
+  /** @brief get the number of cached base cases*/
+  count_t cacheSize () const
+  {
+    return static_cast<count_t> (baseCases.size ());
+  }
+  /** @brief drop all the cached base cases*/
+  void clearCache ();
+
+private:
+  /** @brief a cached base case*/
+  class baseCase
+  {
+public:
+    std::shared_ptr<gridDynSimulation> sim;  //!< the base simulation
+    std::time_t modTime = 0;  //!< the modification time of the file when it was read
+  };
+  boost::program_options::variables_map options;  //!< the command line options of the worker
+  std::map<std::string, baseCase> baseCases;  //!< the cached base cases by file name
+  std::string defaultCase;  //!< the case used by jobs which do not name one
+  count_t jobCount = 0;  //!< the number of jobs run
+};
+
+#endif
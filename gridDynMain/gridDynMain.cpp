@@ -19,6 +19,7 @@
 #include "gridDynFileInput.h"
 #include "GhostSwingBusManager.h"
 #include "gridDynRunner.h"
+#include "gridDynWorker.h"
 #ifdef FMI_ENABLE
 #include "fmiGDinfo.h"
 #endif
@@ -30,6 +31,7 @@
 
 #include <chrono>
 #include <cstdio>
+#include <fstream>
 #include <memory>
 #include <iostream>
 
@@ -83,6 +85,33 @@ int main (int argc, char *argv[])
     }
 
 
+  if (vm.count ("worker"))
+    {
+      //resident worker mode the base cases stay in memory and the jobs run on clones of them
+      gridDynWorker worker (vm);
+      std::string jobSource = vm["worker"].as<std::string> ();
+      int failures;
+      if (jobSource.empty ())
+        {
+          failures = worker.run (std::cin, std::cout);
+        }
+      else
+        {
+          std::ifstream jobStream (jobSource);
+          if (!jobStream)
+            {
+              std::cerr << "unable to open job source " << jobSource << '\n';
+              return FUNCTION_EXECUTION_FAILURE;
+            }
+          failures = worker.run (jobStream, std::cout);
+        }
+      if (!isMpiCountMode)
+        {
+          GhostSwingBusManager::Instance ()->endSimulation ();
+        }
+      return (failures > 0) ? FUNCTION_EXECUTION_FAILURE : 0;
+    }
+
   //create the simulation
 
   readerInfo ri;
@@ -17,6 +17,9 @@
 #include "gridDynFileInput.h"
 #include "testHelper.h"
 #include "vectorOps.hpp"
+#include "gridBus.h"
+#include "simulation/objectRegistry.h"
+#include <algorithm>
 #include <cmath>
 //testP case for gridCoreObject object
 
@@ -68,4 +71,39 @@ BOOST_AUTO_TEST_CASE (area_test1)
  
 }
 
+BOOST_AUTO_TEST_CASE (area_test_registry)
+{
+  std::string fname = std::string (AREA_TEST_DIRECTORY "area_test1.xml");
+
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->pFlowInitialize ();
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::INITIALIZED);
+  auto reg = gds->getObjectRegistry ();
+  BOOST_REQUIRE (reg != nullptr);
+  BOOST_CHECK_EQUAL (reg->count (objectRegistry::object_type::area), 1u);
+  BOOST_CHECK_EQUAL (reg->count (objectRegistry::object_type::bus), 9u);
+  BOOST_CHECK_EQUAL (reg->count (objectRegistry::object_type::link), 9u);
+  BOOST_CHECK_EQUAL (reg->getClassObjects<gridBus> ().size (), 9u);
+
+  gds->powerflow ();
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+  //the bulk read matches the tree walk
+  std::vector<double> V1;
+  std::vector<double> V2;
+  gds->getVoltage (V1);
+  reg->getAll (objectRegistry::object_type::bus, "voltage", V2);
+  BOOST_REQUIRE_EQUAL (V1.size (), V2.size ());
+  std::sort (V1.begin (), V1.end ());
+  std::sort (V2.begin (), V2.end ());
+  BOOST_CHECK_SMALL (compareVec (V1, V2), 1e-9);
+
+  //the lists are rebuilt only after a structural change
+  auto builds = gds->getInt ("registrybuilds");
+  BOOST_CHECK_EQUAL (gds->getInt ("totalbuscount"), 9);
+  BOOST_CHECK_EQUAL (gds->getInt ("registrybuilds"), builds);
+  gds->add (new gridBus ("extra_bus"));
+  BOOST_CHECK_EQUAL (gds->getInt ("totalbuscount"), 10);
+  BOOST_CHECK_EQUAL (gds->getInt ("registrybuilds"), builds + 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,7 @@
 #include <boost/test/floating_point_comparison.hpp>
 #include "gridBus.h"
 #include "generators/gridDynGenerator.h"
+#include "submodels/gridDynExciter.h"
 #include "gridDynFileInput.h"
 #include "testHelper.h"
 #include "simulation/diagnostics.h"
@@ -52,4 +53,26 @@ BOOST_AUTO_TEST_CASE(gen_test_remote2b)
   std::string fname = std::string(GEN_TEST_DIRECTORY "test_gen_dualremote_b.xml");
   detailedStageCheck(fname, gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED);
 }
+
+/** the latest definition of a submodel should win between deferred records and added models*/
+BOOST_AUTO_TEST_CASE(gen_test_deferred_replace)
+{
+  gridDynGenerator gen;
+  gridDynGenerator::deferredSubModel dm;
+  dm.component = "exciter";
+  dm.type = "type1";
+  dm.params.emplace_back("ka", 20.0);
+  gen.addDeferredModel(dm);
+  dm.params[0].second = 40.0;
+  gen.addDeferredModel(dm);
+  BOOST_CHECK_EQUAL(gen.deferredModelCount(), 1u);
+  dm.component = "governor";
+  dm.type = "basic";
+  dm.params.clear();
+  gen.addDeferredModel(dm);
+  BOOST_CHECK_EQUAL(gen.deferredModelCount(), 2u);
+  //adding an exciter drops the pending exciter record but leaves the governor
+  BOOST_CHECK_EQUAL(gen.add(new gridDynExciterIEEEtype1()), OBJECT_ADD_SUCCESS);
+  BOOST_CHECK_EQUAL(gen.deferredModelCount(), 1u);
+}
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "loadModels/gridLoad.h"
 #include "loadModels/gridLabDLoad.h"
 #include "loadModels/motorLoad.h"
+#include "loadModels/motorBankLoad.h"
 #include "gridDynFileInput.h"
 #include "simulation/diagnostics.h"
 #include "testHelper.h"
@@ -442,6 +443,39 @@ BOOST_AUTO_TEST_CASE(motor_test3)
   delete gds;
 }
 
+BOOST_AUTO_TEST_CASE(motor_bank_test1)
+{
+  std::string fname = load_test_directory + "motorbank_test1.xml";
+
+  gridDynSimulation *gds = static_cast<gridDynSimulation *>(readSimXMLFile(fname));
+
+  gridBus *bus = gds->getBus(1);
+  motorBankLoad *bank = dynamic_cast<motorBankLoad *>(bus->getLoad());
+
+  BOOST_REQUIRE(bank != nullptr);
+  BOOST_CHECK_EQUAL(bank->getMotorCount(), 3u);
+  gds->pFlowInitialize();
+  int mmatch = runJacobianCheck(gds, cPflowSolverMode);
+  BOOST_REQUIRE_EQUAL(mmatch, 0);
+
+  gds->dynInitialize();
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED);
+  mmatch = runResidualCheck(gds, cDaeSolverMode);
+  BOOST_REQUIRE_EQUAL(mmatch, 0);
+  mmatch = runJacobianCheck(gds, cDaeSolverMode);
+  BOOST_REQUIRE_EQUAL(mmatch, 0);
+  auto ssize = gds->stateSize(cDaeSolverMode);
+  double p0 = bank->get("motorpower");
+  gds->run();
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  //the trip event disconnects half of each motor without changing the state count
+  BOOST_CHECK_CLOSE(bank->get("online"), 0.5, 1e-6);
+  BOOST_CHECK_EQUAL(gds->stateSize(cDaeSolverMode), ssize);
+  BOOST_CHECK_LT(bank->get("motorpower"), 0.75 * p0);
+
+  delete gds;
+}
+
 /** test case runs a 3rd order motor load to stall and unstall conditions*/
 BOOST_AUTO_TEST_CASE(motor_test3_stall)
 {
@@ -68,6 +68,23 @@ BOOST_AUTO_TEST_CASE (relay_test2)
 
 }
 
+/** a rollback across a relay trip should restore even though the relays hold a different number of pending condition checks*/
+BOOST_AUTO_TEST_CASE (relay_test_rollback)
+{
+  std::string fname = std::string (RELAY_TEST_DIRECTORY "relay_test2.xml");
+
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile (fname));
+  gds->run (0.9);
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  int retval = gds->execute ("checkpoint prefault");
+  BOOST_REQUIRE_EQUAL (retval, FUNCTION_EXECUTION_SUCCESS);
+  //the fault starts at 1.0 so the relays have delayed condition checks pending
+  gds->run (1.02);
+  retval = gds->execute ("rollback prefault");
+  BOOST_REQUIRE_EQUAL (retval, FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (gds->getCurrentTime (), 0.9, 0.0001);
+  BOOST_CHECK_EQUAL (gds->getInt ("rollbackrestores"), 1);
+}
 
 BOOST_AUTO_TEST_CASE (relay_test_multi)
 {
@@ -19,6 +19,8 @@
 #include "testHelper.h"
 #include "simulation/diagnostics.h"
 #include "gridBus.h"
+#include "solvers/solverInterface.h"
+#include "objectInterpreter.h"
 
 #include <vectorOps.hpp>
 #include <map>
@@ -147,6 +149,122 @@ printf("%d residual calls, %d Jacobian call\n",rcount,jcount);
 }
 
 
+/** compare the KLU and mixed precision linear solvers on the largest power flow cases*/
+BOOST_AUTO_TEST_CASE(performance_tests_mixed_precision)
+{
+	/* *INDENT-OFF* */
+	const stringVec perf_cases{ "case2869pegase.m", "case3375wp.m", "case9241pegase.m" };
+	const stringVec solver_flags{ "sparse", "mixedprecision" };
+	/* *INDENT-ON* */
+	for (const auto &mp : perf_cases)
+	{
+		std::string fname = validationTestDirectory + mp;
+		std::vector<std::vector<double>> results;
+		for (const auto &flag : solver_flags)
+		{
+			std::chrono::duration<double> pflow_time(0);
+			gds = new gridDynSimulation();
+			gds->set("consoleprintlevel", GD_SUMMARY_PRINT);
+			loadFile(gds, fname);
+			gds->setFlag("no_powerflow_adjustments");
+			BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::STARTUP);
+			auto solver = gds->getSolverInterface("powerflow");
+			solver->set("flags", flag);
+			auto start_t = std::chrono::high_resolution_clock::now();
+			gds->powerflow();
+			auto stop_t = std::chrono::high_resolution_clock::now();
+			pflow_time = (stop_t - start_t);
+			BOOST_CHECK(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+			std::vector<double> v;
+			gds->getVoltage(v);
+			results.push_back(v);
+			printf("%s %s powerflow in %f, %d Jacobian calls, %d refinement steps, %d fallbacks\n", mp.c_str(), flag.c_str(), pflow_time.count(),
+				gds->getInt("jaccount"), static_cast<int>(solver->get("refinementsteps")), static_cast<int>(solver->get("precisionfallbacks")));
+			delete gds;
+			gds = nullptr;
+		}
+		BOOST_CHECK(countDiffs(results[0], results[1], 1e-6) == 0);
+	}
+}
+
+
+/** compare the forward sensitivity engine against finite difference reruns of the dynamic simulation*/
+BOOST_AUTO_TEST_CASE(performance_tests_trajectory_sensitivity)
+{
+	std::string fname = std::string(GRIDDYN_TEST_DIRECTORY "/dyn_tests2/test_2m4bDyn.xml");
+	/* *INDENT-OFF* */
+	const stringVec sens_params{ "bus1::gen1::genmodel:h", "bus2::gen2::genmodel:h", "bus1::gen1::exciter:ka", "bus2::gen2::governor:k" };
+	/* *INDENT-ON* */
+	const double stopTime = 10.0;
+
+	gds = static_cast<gridDynSimulation *>(readSimXMLFile(fname));
+	gds->set("consoleprintlevel", GD_WARNING_PRINT);
+	for (const auto &sp : sens_params)
+	{
+		gds->set("sensitivity", sp);
+	}
+	auto start_t = std::chrono::high_resolution_clock::now();
+	gds->run(stopTime);
+	auto stop_t = std::chrono::high_resolution_clock::now();
+	std::chrono::duration<double> sens_time = stop_t - start_t;
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+	BOOST_CHECK_EQUAL(gds->getInt("sensitivitycount"), static_cast<int>(sens_params.size()));
+
+	//brute force takes a base run and one rerun per parameter
+	std::chrono::duration<double> rerun_time(0);
+	for (size_t kk = 0; kk <= sens_params.size(); ++kk)
+	{
+		gds2 = static_cast<gridDynSimulation *>(readSimXMLFile(fname));
+		gds2->set("consoleprintlevel", GD_WARNING_PRINT);
+		if (kk > 0)
+		{
+			objInfo oi(sens_params[kk - 1], gds2);
+			BOOST_REQUIRE(oi.m_obj != nullptr);
+			oi.m_obj->set(oi.m_field, oi.m_obj->get(oi.m_field) * 1.001);
+		}
+		start_t = std::chrono::high_resolution_clock::now();
+		gds2->run(stopTime);
+		stop_t = std::chrono::high_resolution_clock::now();
+		rerun_time += stop_t - start_t;
+		BOOST_CHECK(gds2->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+		delete gds2;
+		gds2 = nullptr;
+	}
+	printf("%d parameter sensitivities in %f, finite difference reruns in %f, %d sensitivity steps\n", static_cast<int>(sens_params.size()),
+		sens_time.count(), rerun_time.count(), gds->getInt("sensitivitysteps"));
+}
+
+/** compare the full DAE solution against the plain and error controlled partitioned solutions*/
+BOOST_AUTO_TEST_CASE(performance_tests_partitioned_coupling)
+{
+	std::string fname = std::string(GRIDDYN_TEST_DIRECTORY "/dyn_tests2/test_sineLoadChange2_partitioned.xml");
+	const double stopTime = 30.0;
+	const stringVec methods{ "dae", "partitioned", "coupled" };
+	for (const auto &method : methods)
+	{
+		gds = static_cast<gridDynSimulation *>(readSimXMLFile(fname));
+		gds->set("consoleprintlevel", GD_WARNING_PRINT);
+		if (method == "dae")
+		{
+			gds->set("dynamicsolvermethod", "dae");
+		}
+		else if (method == "coupled")
+		{
+			gds->set("partitionedtolerance", 1e-4);
+			gds->set("partitionedjacobianreuse", 5);
+		}
+		auto start_t = std::chrono::high_resolution_clock::now();
+		gds->run(stopTime);
+		auto stop_t = std::chrono::high_resolution_clock::now();
+		std::chrono::duration<double> run_time = stop_t - start_t;
+		BOOST_CHECK(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+		printf("%s solution in %f, %d macro steps, %d rejected, %d interface iterations\n", method.c_str(), run_time.count(),
+			gds->getInt("couplingsteps"), gds->getInt("couplingrejections"), gds->getInt("couplingiterations"));
+		delete gds;
+		gds = nullptr;
+	}
+}
+
 #ifdef ENABLE_IN_DEVELOPMENT_CASES
 #ifdef ENABLE_EXPERIMENTAL_TEST_CASES
 //test pjm case
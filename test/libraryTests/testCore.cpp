@@ -22,6 +22,13 @@
 #include "loadModels/otherLoads.h"
 #include "testHelper.h"
 #include "objectFactory.h"
+#include "gridDyn.h"
+#include "gridBus.h"
+#include "simulation/diagnostics.h"
+#include "internedString.h"
+
+#include <cstdio>
+
 //test case for gridCoreObject object
 
 using namespace gridUnits;
@@ -75,6 +82,63 @@ BOOST_AUTO_TEST_CASE (gridCoreObject_test)
   delete(obj3);
 }
 
+BOOST_AUTO_TEST_CASE (object_name_description_test)
+{
+  gridDynSimulation *gds = new gridDynSimulation ("sim");
+  gridBus *bus1 = new gridBus ("bus_a");
+  gridBus *bus2 = new gridBus ("bus_b");
+  gds->add (bus1);
+  gds->add (bus2);
+  //the names are shared in the string table but setting and finding by name works as before
+  bus2->setName ("bus_a_copy");
+  BOOST_CHECK_EQUAL (bus2->getName (), "bus_a_copy");
+  BOOST_CHECK (gds->find ("bus_a_copy") == bus2);
+  BOOST_CHECK (&(bus1->getName ()) != &(bus2->getName ()));
+  bus2->setName ("bus_a");
+  BOOST_CHECK (&(bus1->getName ()) == &(bus2->getName ()));
+  bus2->setName ("bus_b");
+
+  //descriptions are stored outside the object
+  BOOST_CHECK (bus1->getDescription ().empty ());
+  bus1->set ("description", "the first bus");
+  BOOST_CHECK_EQUAL (bus1->getString ("description"), "the first bus");
+  BOOST_CHECK (bus2->getDescription ().empty ());
+  BOOST_CHECK (!bus1->getPosition ());
+
+  auto bus3 = static_cast<gridBus *> (bus1->clone ());
+  BOOST_CHECK_EQUAL (bus3->getDescription (), "the first bus");
+  delete bus3;
+  BOOST_CHECK_EQUAL (bus1->getDescription (), "the first bus");
+
+  //generated names are released with the objects using them
+  auto tableSize = internedString::tableCount ();
+  for (int kk = 0; kk < 100; ++kk)
+    {
+      auto cl = bus1->clone ();
+      delete cl;
+      delete (new gridCoreObject ());
+    }
+  BOOST_CHECK_EQUAL (internedString::tableCount (), tableSize);
+
+  //a new object reusing an id does not see the description of an earlier object
+  gridCoreObject::setCounter (50000);
+  auto obj1 = new gridCoreObject ();
+  obj1->setDescription ("temporary");
+  delete obj1;
+  gridCoreObject::setCounter (50000);
+  auto obj2 = new gridCoreObject ();
+  BOOST_CHECK (obj2->getDescription ().empty ());
+  delete obj2;
+
+  auto report = memoryReport (gds);
+  BOOST_CHECK (report.objects >= 3u);
+  BOOST_CHECK (report.distinctNames >= 3u);
+  BOOST_CHECK_EQUAL (report.sideEntries, 1u);
+  BOOST_CHECK (report.savingsPerObject () > 0.0);
+  BOOST_CHECK_CLOSE (gds->get ("objectmemorysavings"), report.savingsPerObject (), 1e-9);
+  delete gds;
+}
+
 //testcase for gridDynGenModel Object
 BOOST_AUTO_TEST_CASE (gridDynGenModel_test)
 {
@@ -173,4 +237,49 @@ BOOST_AUTO_TEST_CASE (object_factory_test)
 
 }
 
+BOOST_AUTO_TEST_CASE (log_level_check_test)
+{
+  gridDynSimulation *sim = new gridDynSimulation ();
+  gridCoreObject *obj = new gridCoreObject ();
+  //objects without a parent discard all messages
+  BOOST_CHECK (!obj->checkLogLevel (GD_ERROR_PRINT));
+  obj->setParent (sim);
+  sim->set ("printlevel", "warning");
+  BOOST_CHECK (obj->checkLogLevel (GD_WARNING_PRINT));
+  BOOST_CHECK (!obj->checkLogLevel (GD_DEBUG_PRINT));
+  sim->set ("logprintlevel", "debug");
+  //the log print level does not matter without a log file
+  BOOST_CHECK (!obj->checkLogLevel (GD_DEBUG_PRINT));
+  sim->set ("logfile", "log_level_check.log");
+  BOOST_CHECK (obj->checkLogLevel (GD_DEBUG_PRINT));
+  BOOST_CHECK (!obj->checkLogLevel (GD_TRACE_PRINT));
+
+  BOOST_CHECK_EQUAL (sim->set ("logformat", "json"), PARAMETER_FOUND);
+  BOOST_CHECK_EQUAL (sim->set ("logformat", "xml"), INVALID_PARAMETER_VALUE);
+  BOOST_CHECK_EQUAL (sim->set ("logmode", "async"), PARAMETER_FOUND);
+  BOOST_CHECK_EQUAL (sim->set ("logratelimit", 5.0), PARAMETER_FOUND);
+  sim->set ("consoleprintlevel", "none");
+  for (int kk = 0; kk < 20; ++kk)
+    {
+      sim->log (obj, GD_WARNING_PRINT, "repeated warning");
+    }
+  sim->flushLog ();
+  //warnings are counted even if they get suppressed by the rate limit
+  BOOST_CHECK_EQUAL (sim->getInt ("warncount"), 20);
+  sim->set ("logmode", "sync");
+  //warnings and errors still pass the level check with nothing printed so they get counted
+  sim->set ("logprintlevel", "none");
+  BOOST_CHECK (obj->checkLogLevel (GD_WARNING_PRINT));
+  BOOST_CHECK (!obj->checkLogLevel (GD_SUMMARY_PRINT));
+  if (obj->checkLogLevel (GD_ERROR_PRINT))
+    {
+      sim->log (obj, GD_ERROR_PRINT, "unprinted error");
+    }
+  BOOST_CHECK_EQUAL (sim->getInt ("errorcount"), 1);
+  obj->setParent (nullptr);
+  delete obj;
+  delete sim;
+  remove ("log_level_check.log");
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -16,9 +16,12 @@
 #include "testHelper.h"
 #include "exeTestHelper.h"
 #include "gridDynRunner.h"
+#include "gridDynWorker.h"
 #include <boost/test/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
+#include <boost/program_options.hpp>
 #include <iostream>
+#include <sstream>
 #include <cstdlib>
 
 BOOST_AUTO_TEST_SUITE(runner_tests)
@@ -29,4 +32,38 @@ BOOST_AUTO_TEST_CASE(runner_test1)
 
 }
 
+BOOST_AUTO_TEST_CASE(worker_test_cached_case)
+{
+	std::string fname = std::string(GRIDDYN_TEST_DIRECTORY "/pFlow_tests/test_powerflow3m9b2.xml");
+	std::string workerArg = "--worker";
+	std::string progName = "gridDynMain";
+	char *argv[] = { &progName[0], &workerArg[0], &fname[0] };
+	boost::program_options::variables_map vm;
+	BOOST_REQUIRE_EQUAL(argumentParser(3, argv, vm), 0);
+
+	gridDynWorker worker(vm);
+	std::istringstream jobs("# two jobs against the default case\n--id a --flags powerflow_only\n"
+		"--id b --flags powerflow_only --param stoptime=5\nquit\n--id c\n");
+	std::ostringstream results;
+	BOOST_CHECK_EQUAL(worker.run(jobs, results), 0);
+	//both jobs share the one cached case and the quit line stops the stream
+	BOOST_CHECK_EQUAL(worker.cacheSize(), 1);
+	std::istringstream lines(results.str());
+	std::string line;
+	std::vector<std::string> ids;
+	while (std::getline(lines, line))
+	{
+		BOOST_REQUIRE(line.compare(0, 4, "job ") == 0);
+		BOOST_CHECK(line.find("status=0") != std::string::npos);
+		ids.push_back(line.substr(4, 1));
+	}
+	BOOST_REQUIRE_EQUAL(ids.size(), 2u);
+	BOOST_CHECK_EQUAL(ids[0], "a");
+	BOOST_CHECK_EQUAL(ids[1], "b");
+
+	std::ostringstream badResult;
+	BOOST_CHECK(worker.runJob("nonexistent_case.xml --id d", badResult) != 0);
+	BOOST_CHECK(badResult.str().find("job d status=") == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -17,9 +17,12 @@
 #include "gridDynFileInput.h"
 #include "gridBus.h"
 #include "primary/infiniteBus.h"
+#include "loadModels/gridLoad.h"
+#include "generators/gridDynGenerator.h"
 #include "testHelper.h"
 #include "simulation/diagnostics.h"
 #include "vectorOps.hpp"
+#include <cmath>
 //test case for gridCoreObject object
 
 
@@ -183,4 +186,134 @@ BOOST_AUTO_TEST_CASE(dyn_test_mbase)
   std::string fname = std::string(DYN1_TEST_DIRECTORY "test_dynSimple1_mod.xml");
   detailedStageCheck(fname, gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
 }
+
+/** the argument passing between objects should not allocate once the simulation is running*/
+BOOST_AUTO_TEST_CASE(dyn_test_io_allocations)
+{
+  std::string fname = std::string(DYN1_TEST_DIRECTORY "test_2m4bDyn_ss_ext_only.xml");
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::STARTUP);
+  gds->run(0.25);
+  BOOST_REQUIRE(gds->currentProcessState() >= gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED);
+
+  std::vector<double> st = gds->getState(cDaeSolverMode);
+  std::vector<double> dst(st.size(), 0.0);
+  std::vector<double> resid(st.size());
+  gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode);
+  auto allocs = ioVectorAllocations();
+  for (int kk = 0; kk < 5; ++kk)
+  {
+    gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode);
+  }
+  BOOST_CHECK_EQUAL(ioVectorAllocations(), allocs);
+}
+
+/** a non-finite state should be caught before the evaluation and located in the state vector*/
+BOOST_AUTO_TEST_CASE(dyn_test_residual_validation)
+{
+  std::string fname = std::string(DYN1_TEST_DIRECTORY "test_2m4bDyn_ss_ext_only.xml");
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  gds->consolePrintLevel = 0;
+  gds->run(0.25);
+  BOOST_REQUIRE(gds->currentProcessState() >= gridDynSimulation::gridState_t::DYNAMIC_INITIALIZED);
+
+  std::vector<double> st = gds->getState(cDaeSolverMode);
+  std::vector<double> dst(st.size(), 0.0);
+  std::vector<double> resid(st.size());
+  BOOST_CHECK_EQUAL(gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_EQUAL(gds->get("residualanomalies"), 0);
+
+  index_t loc = gds->getBus(1)->getGen(0)->getOffsets(cDaeSolverMode)->diffOffset;
+  BOOST_REQUIRE(loc < st.size());
+  double sv = st[loc];
+  st[loc] = std::nan("");
+  BOOST_CHECK_EQUAL(gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode), FUNCTION_EXECUTION_FAILURE);
+  BOOST_CHECK_EQUAL(gds->get("residualanomalies"), 1);
+  BOOST_CHECK_EQUAL(gds->get("residualanomalyindex"), static_cast<double>(loc));
+  st[loc] = sv;
+
+  //with no escalation window only every third evaluation is checked
+  gds->set("residualcheckwindow", 0);
+  gds->set("residualcheckperiod", 3);
+  gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode);
+  auto checks = gds->get("residualchecks");
+  for (int kk = 0; kk < 6; ++kk)
+  {
+    gds->residualFunction(0.25, st.data(), dst.data(), resid.data(), cDaeSolverMode);
+  }
+  BOOST_CHECK_EQUAL(gds->get("residualchecks") - checks, 2);
+}
+
+/** a concurrent initialization of the buses must give the same initial states as the sequential one*/
+BOOST_AUTO_TEST_CASE(dyn_test_parallel_initialization)
+{
+  std::string fname = std::string(DYN1_TEST_DIRECTORY "test_2m4bDyn_ss.xml");
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  gds2 = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  gds->consolePrintLevel = 0;
+  gds2->consolePrintLevel = 0;
+  gds2->setFlag("parallel_initialization");
+  BOOST_REQUIRE_EQUAL(gds->dynInitialize(), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_REQUIRE_EQUAL(gds2->dynInitialize(), FUNCTION_EXECUTION_SUCCESS);
+  auto st1 = gds->getState(cDaeSolverMode);
+  auto st2 = gds2->getState(cDaeSolverMode);
+  BOOST_REQUIRE_EQUAL(st1.size(), st2.size());
+  for (size_t kk = 0; kk < st1.size(); ++kk)
+  {
+    BOOST_CHECK_EQUAL(st1[kk], st2[kk]);
+  }
+  gds2->run(1.0);
+  BOOST_CHECK(gds2->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+}
+
+/** a rollback should restore the states and the discrete changes made after the checkpoint*/
+BOOST_AUTO_TEST_CASE(dyn_test_rollback)
+{
+  std::string fname = std::string(DYN1_TEST_DIRECTORY "test_2m4bDyn_ss.xml");
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::STARTUP);
+  gds->run(0.5);
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st = gds->getState(cDaeSolverMode);
+
+  int retval = gds->execute("checkpoint base");
+  BOOST_REQUIRE_EQUAL(retval, FUNCTION_EXECUTION_SUCCESS);
+  auto ld = gds->getBus(2)->getLoad();
+  BOOST_REQUIRE(ld != nullptr);
+  double P = ld->get("p");
+  ld->set("p", 1.2 * P);
+  gds->run(1.0);
+  std::vector<double> st2 = gds->getState(cDaeSolverMode);
+  BOOST_CHECK(countDiffs(st, st2, 0.0001) > 0);
+
+  retval = gds->execute("rollback base");
+  BOOST_REQUIRE_EQUAL(retval, FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE(gds->getCurrentTime(), 0.5, 0.0001);
+  BOOST_CHECK_CLOSE(ld->get("p"), P, 0.0001);
+  std::vector<double> st3 = gds->getState(cDaeSolverMode);
+  BOOST_CHECK_EQUAL(countDiffs(st, st3, 0.0000001), 0u);
+
+  gds->run(1.0);
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  st3 = gds->getState(cDaeSolverMode);
+  BOOST_CHECK_EQUAL(countDiffs(st, st3, 0.0001), 0u);
+  BOOST_CHECK_EQUAL(gds->getInt("rollbackrestores"), 1);
+}
+
+/** periodic captures should happen at most once per period even if a step lands just short of the capture time*/
+BOOST_AUTO_TEST_CASE(dyn_test_rollback_period)
+{
+  std::string fname = std::string(DYN1_TEST_DIRECTORY "test_2m4bDyn_ss.xml");
+  gds = static_cast<gridDynSimulation *> (readSimXMLFile(fname));
+  gds->run(0.5);
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  gds->set("rollbackcapacity", 20);
+  gds->set("rollbackperiod", 0.1);
+  gds->run(1.0);
+  BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  //captures at 0.5,0.6,...,1.0
+  BOOST_CHECK_LE(gds->getInt("rollbackcaptures"), 6);
+  BOOST_CHECK_GE(gds->getInt("rollbackcaptures"), 5);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
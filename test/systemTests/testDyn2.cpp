@@ -17,7 +17,18 @@
 #include "gridDynFileInput.h"
 #include "testHelper.h"
 #include "vectorOps.hpp"
+#include "simulation/coherencyAggregator.h"
+#include "simulation/realTimePacer.h"
+#include "simulation/trajectorySensitivity.h"
+#include "simulation/jacobianPatternCache.h"
+#include "simulation/ensembleRunner.h"
+#include "gridBus.h"
+#include "generators/gridDynGenerator.h"
+#include "solvers/solverInterface.h"
+#include "solvers/sparseLU.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <cmath>
 //test case for gridCoreObject object
@@ -79,6 +90,203 @@ BOOST_AUTO_TEST_CASE (dyn_test_simpleChunked)
 
 }
 
+BOOST_AUTO_TEST_CASE (dyn_test_deltaResidual)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  simpleRunTestXML (fname);
+  std::vector<double> st = gds->getState ();
+
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 2;
+  gds2->setFlag ("delta_residual", true);
+  gds2->run ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st2 = gds2->getState ();
+  //the exact mode should not change the solution
+  auto diff = countDiffsIgnoreCommon (st, st2, 0.0001);
+  BOOST_CHECK (diff == 0);
+  double skipFraction = gds2->get ("residualskipfraction");
+  BOOST_CHECK ((skipFraction >= 0.0) && (skipFraction < 1.0));
+  //the evaluator has to have handled the residual calls
+  BOOST_CHECK (gds2->get ("fullresidualcount") > 0.0);
+
+  //with a change tolerance the settled part of the run should skip unchanged objects
+  delete gds2;
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 2;
+  gds2->setFlag ("delta_residual", true);
+  gds2->set ("deltaresidualtolerance", 1e-8);
+  gds2->run ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  st2 = gds2->getState ();
+  diff = countDiffsIgnoreCommon (st, st2, 0.001);
+  BOOST_CHECK (diff == 0);
+  skipFraction = gds2->get ("residualskipfraction");
+  BOOST_CHECK (skipFraction > 0.0);
+  BOOST_CHECK (skipFraction < 1.0);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_mixedPrecision)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  simpleRunTestXML (fname);
+  std::vector<double> st = gds->getState ();
+
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 2;
+  gds2->getSolverInterface ("powerflow")->set ("flags", "mixedprecision");
+  gds2->getSolverInterface ("dynamic")->set ("flags", "mixedprecision");
+  gds2->run ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st2 = gds2->getState ();
+  auto diff = countDiffsIgnoreCommon (st, st2, 0.0001);
+  BOOST_CHECK (diff == 0);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_coherencyAggregation)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  coherencyAggregator agg (gds);
+  agg.addProbe ("load3:p=1.2@1.0");
+  agg.setProbeDuration (2.0);
+  BOOST_REQUIRE (agg.identifyGroups () == FUNCTION_EXECUTION_SUCCESS);
+  //gen1 is on the slack bus so there is nothing to aggregate
+  BOOST_CHECK (agg.getGroups ().empty ());
+  auto reduced = agg.buildReducedModel ();
+  BOOST_REQUIRE (reduced);
+  BOOST_REQUIRE (agg.evaluate (reduced.get ()) == FUNCTION_EXECUTION_SUCCESS);
+  auto &rep = agg.getReport ();
+  BOOST_CHECK_EQUAL (rep.originalStates, rep.reducedStates);
+  BOOST_REQUIRE (rep.maxError.size () == 1);
+  BOOST_CHECK_SMALL (rep.maxError[0], 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_coherencyAggregation_group)
+{
+  //gen2 and gen3 are identical machines on tightly coupled buses
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_3m5bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  coherencyAggregator agg (gds);
+  agg.addProbe ("load3:p=1.2@1.0");
+  agg.setProbeDuration (2.0);
+  BOOST_REQUIRE (agg.identifyGroups () == FUNCTION_EXECUTION_SUCCESS);
+  BOOST_REQUIRE_EQUAL (agg.getGroups ().size (), 1u);
+  BOOST_CHECK_EQUAL (agg.getGroups ()[0].size (), 2u);
+  auto reduced = agg.buildReducedModel ();
+  BOOST_REQUIRE (reduced);
+  BOOST_REQUIRE (agg.evaluate (reduced.get ()) == FUNCTION_EXECUTION_SUCCESS);
+  auto &rep = agg.getReport ();
+  BOOST_CHECK_EQUAL (rep.groupCount, 1u);
+  BOOST_CHECK_EQUAL (rep.removedGenerators, 2u);
+  BOOST_CHECK_LT (rep.reducedStates, rep.originalStates);
+  BOOST_CHECK (rep.stateReduction () > 0.0);
+  BOOST_REQUIRE (rep.maxError.size () == 1);
+  //the bus voltages of the reduced model should track the full model
+  BOOST_CHECK_SMALL (rep.maxError[0], 0.02);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_realTimePacing)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  gds->dynInitialize (gds->getStartTime ());
+  //ten times faster than real time so 0.5s of simulation takes at least 0.05s
+  realTimePacer pacer (10.0);
+  gds->setRealTimePacer (&pacer);
+  pacer.start (gds->getCurrentTime ());
+  auto wallStart = std::chrono::steady_clock::now ();
+  double actual = gds->getCurrentTime ();
+  for (int kk = 0; kk < 10; ++kk)
+    {
+      double target = actual + 0.05;
+      pacer.beginFrame (target);
+      int retval = gds->step (target, actual);
+      pacer.endFrame ();
+      BOOST_REQUIRE (retval == FUNCTION_EXECUTION_SUCCESS);
+    }
+  std::chrono::duration<double> wallTime = std::chrono::steady_clock::now () - wallStart;
+  gds->setRealTimePacer (nullptr);
+  BOOST_CHECK_EQUAL (pacer.getStats ().frames, 10u);
+  //a late frame moves the clock anchor so the pacing bound only holds without overruns
+  if (pacer.getStats ().overruns == 0)
+    {
+      BOOST_CHECK_GE (wallTime.count (), 0.049);
+    }
+  const auto &solverHist = pacer.getHistogram (realTimePacer::frame_section::solver);
+  BOOST_CHECK_EQUAL (solverHist.count (), 10u);
+  BOOST_CHECK (solverHist.maxTime () > 0.0);
+  BOOST_CHECK (pacer.getHistogram (realTimePacer::frame_section::total).maxTime () >= solverHist.maxTime ());
+}
+
+/** the degraded real time mode holds the Jacobian so the models should be asked for far fewer Jacobians*/
+BOOST_AUTO_TEST_CASE (dyn_test_constantJacobian)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  gds->run (10.0);
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st = gds->getState ();
+  double fullCount = gds->get ("jacobiancount");
+
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 0;
+  BOOST_REQUIRE_EQUAL (gds2->dynInitialize (), FUNCTION_EXECUTION_SUCCESS);
+  double initCount = gds2->get ("jacobiancount");
+  //the same setting the runner uses for --realtime-degrade jacobian
+  gds2->getSolverInterface ("dynamic")->set ("constantjacobian", 1.0);
+  gds2->run (10.0);
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st2 = gds2->getState ();
+  auto diff = countDiffsIgnoreCommon (st, st2, 0.001);
+  BOOST_CHECK (diff == 0);
+  BOOST_CHECK_LT (gds2->get ("jacobiancount") - initCount, fullCount - initCount);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_trajectorySensitivity)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  gds->set ("sensitivity", "bus2::gen2::genmodel:h");
+  BOOST_REQUIRE_EQUAL (gds->getInt ("sensitivitycount"), 1);
+  gds->run (2.0);
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  BOOST_CHECK (gds->getInt ("sensitivitysteps") > 0);
+  std::vector<double> dV;
+  gds->getSensitivity ()->getVoltageSensitivity (dV);
+  std::vector<double> V1;
+  gds->getVoltage (V1);
+  BOOST_REQUIRE_EQUAL (dV.size (), V1.size ());
+
+  //compare against a rerun with a perturbed inertia
+  double dH = 0.01;
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 0;
+  auto gmodel = gds2->getBus (1)->getGen (0)->find ("genmodel");
+  BOOST_REQUIRE (gmodel != nullptr);
+  gmodel->set ("h", gmodel->get ("h") + dH);
+  gds2->run (2.0);
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> V2;
+  gds2->getVoltage (V2);
+  double maxSens = 0.0;
+  for (auto &sv : dV)
+    {
+      maxSens = (std::max) (maxSens, std::abs (sv));
+    }
+  //the load step at t=1 excites the inertia so the sensitivity is not zero
+  BOOST_CHECK (maxSens > 1e-6);
+  for (size_t kk = 0; kk < dV.size (); ++kk)
+    {
+      BOOST_CHECK_SMALL ((V2[kk] - V1[kk]) / dH - dV[kk], 0.1 * maxSens + 1e-6);
+    }
+}
+
 BOOST_AUTO_TEST_CASE (dyn_test_randomLoadChange)
 {
   std::string fname = std::string (DYN2_TEST_DIRECTORY "test_randLoadChange.xml");
@@ -120,6 +328,108 @@ BOOST_AUTO_TEST_CASE(dyn_test_sinLoadChange_part2)
 	simpleRunTestXML(fname);
 }
 
+BOOST_AUTO_TEST_CASE(dyn_test_sinLoadChange_part_coupled)
+{
+	std::string fname = std::string(DYN2_TEST_DIRECTORY "test_sineLoadChange2_partitioned.xml");
+	gds = (gridDynSimulation *)readSimXMLFile(fname);
+	gds->consolePrintLevel = 0;
+	gds->run(20.0);
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+	std::vector<double> st = gds->getState();
+
+	gds2 = (gridDynSimulation *)readSimXMLFile(fname);
+	gds2->consolePrintLevel = 0;
+	BOOST_CHECK_EQUAL(gds2->set("partitionedtolerance", 1e-4), PARAMETER_FOUND);
+	gds2->run(20.0);
+	BOOST_REQUIRE(gds2->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+	std::vector<double> st2 = gds2->getState();
+	//the coupled solution should track the plain partitioned solution
+	auto diff = countDiffsIgnoreCommon(st, st2, 0.01);
+	BOOST_CHECK_EQUAL(diff, 0);
+	BOOST_CHECK_GT(gds2->getInt("couplingsteps"), 0);
+	BOOST_CHECK_EQUAL(gds->getInt("couplingsteps"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(dyn_test_jacobianPatternDerivation)
+{
+	std::string fname = std::string(DYN2_TEST_DIRECTORY "test_sineLoadChange2_partitioned.xml");
+	gds = (gridDynSimulation *)readSimXMLFile(fname);
+	gds->consolePrintLevel = 0;
+	gds->run(5.0);
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+	solverMode algMode = gds->getSolverMode("dynalg");
+	auto derived = gds->getJacobianPattern(algMode);
+	BOOST_REQUIRE(derived);
+	BOOST_CHECK_GT(gds->get("jacobianpatternderivations"), 0);
+	//a second request is served from the store
+	auto again = gds->getJacobianPattern(algMode);
+	BOOST_CHECK(again == derived);
+	BOOST_CHECK_GT(gds->get("jacobianpatternhits"), 0);
+
+	//the derived pattern must cover every entry of a pattern found directly from the algebraic mode
+	jacobianPatternCache cache(gds);
+	cache.setDerivation(false);
+	auto discovered = cache.getPattern(algMode);
+	BOOST_REQUIRE(discovered);
+	BOOST_REQUIRE_EQUAL(discovered->n, derived->n);
+	count_t missing = 0;
+	for (index_t col = 0; col < discovered->n; ++col)
+	{
+		auto dbeg = derived->rows.begin() + derived->colStart[col];
+		auto dend = derived->rows.begin() + derived->colStart[col + 1];
+		for (auto kk = discovered->colStart[col]; kk < discovered->colStart[col + 1]; ++kk)
+		{
+			if (!std::binary_search(dbeg, dend, discovered->rows[kk]))
+			{
+				++missing;
+			}
+		}
+	}
+	BOOST_CHECK_EQUAL(missing, 0u);
+	BOOST_CHECK_EQUAL(cache.getStats().discoveries, 1u);
+}
+
+BOOST_AUTO_TEST_CASE (dyn_test_ensemble)
+{
+  std::string fname = std::string (DYN2_TEST_DIRECTORY "test_2m4bDyn.xml");
+  gds = (gridDynSimulation *)readSimXMLFile (fname);
+  gds->consolePrintLevel = 0;
+  double pbase = 1.5;  //the load of load4 in the test file
+
+  gds2 = (gridDynSimulation *)readSimXMLFile (fname);
+  gds2->consolePrintLevel = 0;
+  gds2->run (10.0);
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  std::vector<double> st2 = gds2->getState ();
+
+  for (auto control : { ensembleRunner::step_control::lockstep, ensembleRunner::step_control::independent })
+    {
+      ensembleRunner ens (gds);
+      ens.addSweep ("load4:p", { pbase, pbase * 0.95, pbase * 1.05 });
+      ens.addOutput ("bus3:voltage");
+      ens.setSamplePeriod (2.0);
+      ens.setStepControl (control);
+      BOOST_REQUIRE_EQUAL (ens.run (10.0), FUNCTION_EXECUTION_SUCCESS);
+      auto &res = ens.getResults ();
+      BOOST_REQUIRE_EQUAL (res.size (), 3u);
+      BOOST_CHECK_EQUAL (ens.getStats ().failures, 0u);
+      BOOST_CHECK_EQUAL (ens.getSampleTimes ().size (), 6u);
+      //the variant with the base parameters matches an independent run
+      auto diff = countDiffsIgnoreCommon (res[0].finalState, st2, 0.0001);
+      BOOST_CHECK (diff == 0);
+      BOOST_CHECK (countDiffsIgnoreCommon (res[1].finalState, st2, 0.0001) > 0);
+      BOOST_CHECK_EQUAL (res[2].samples.size (), 6u);
+      //a heavier load gives a lower voltage
+      BOOST_CHECK_LT (res[2].samples.back ()[0], res[1].samples.back ()[0]);
+      //only the first variant analyzes the Jacobian structure
+      for (size_t kk = 1; kk < res.size (); ++kk)
+        {
+          BOOST_CHECK_EQUAL (res[kk].patternDiscoveries, 0u);
+        }
+      BOOST_CHECK_LE (ens.getStats ().sharedAnalyses, 2u);
+    }
+}
+
 #ifdef ENABLE_EXPERIMENTAL_TEST_CASES
 BOOST_AUTO_TEST_CASE(dyn_test_pulseLoadChange_part)
 {
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+* LLNS Copyright Start
+* Copyright (c) 2016, Lawrence Livermore National Security
+* This work was performed under the auspices of the U.S. Department
+* of Energy by Lawrence Livermore National Laboratory in part under
+* Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+* Produced at the Lawrence Livermore National Laboratory.
+* All rights reserved.
+* For details, see the LICENSE file.
+* LLNS Copyright End
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include "gridDyn.h"
+#include "gridDynFileInput.h"
+#include "testHelper.h"
+#include "simulation/federationCoordinator.h"
+
+#include <memory>
+#include <thread>
+
+#define DYN1_TEST_DIRECTORY GRIDDYN_TEST_DIRECTORY "/dyn_tests1/"
+
+BOOST_AUTO_TEST_SUITE (federation_tests)
+
+BOOST_AUTO_TEST_CASE (federation_independent_test)
+{
+  std::string fname = std::string (DYN1_TEST_DIRECTORY "test_dynSimple1.xml");
+  auto sim1 = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+  auto sim2 = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+
+  federationCoordinator fc;
+  fc.addFederate (sim1);
+  fc.addFederate (sim2);
+  BOOST_CHECK_EQUAL (fc.federateCount (), 2u);
+
+  int retval = fc.run (1.0);
+  BOOST_CHECK_EQUAL (retval, FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (fc.getFederateTime (0), 1.0, 0.0001);
+  BOOST_CHECK_CLOSE (fc.getFederateTime (1), 1.0, 0.0001);
+  BOOST_CHECK_EQUAL (fc.getStats ().windowRounds, 0u);
+}
+
+BOOST_AUTO_TEST_CASE (federation_link_test)
+{
+  std::string fname = std::string (DYN1_TEST_DIRECTORY "test_dynSimple1.xml");
+  auto sim1 = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+  auto sim2 = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+
+  //give each side a distinct value so the exchange is visible
+  auto ld1 = sim1->find ("load3");
+  auto ld2 = sim2->find ("load3");
+  BOOST_REQUIRE ((ld1 != nullptr) && (ld2 != nullptr));
+  ld1->set ("p", 1.2);
+  ld2->set ("q", 0.3);
+
+  federationCoordinator fc;
+  auto f1 = fc.addFederate (sim1);
+  auto f2 = fc.addFederate (sim2);
+  fc.setMaxStep (f1, 0.25);
+  fc.setMaxStep (f2, 0.25);
+  BOOST_CHECK_EQUAL (fc.addLink (f1, "load3:p", f2, "load3:p", 0.1), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_EQUAL (fc.addLink (f2, "load3:q", f1, "load3:q", 0.1), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (fc.getLookahead (f1), 0.1, 0.0001);
+
+  int retval = fc.run (1.0);
+  BOOST_CHECK_EQUAL (retval, FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (fc.getFederateTime (f1), 1.0, 0.0001);
+  BOOST_CHECK_CLOSE (fc.getFederateTime (f2), 1.0, 0.0001);
+  BOOST_CHECK_GT (fc.getStats ().messagesDelivered, 0u);
+  BOOST_CHECK_EQUAL (fc.getStats ().messageErrors, 0u);
+  BOOST_CHECK (sim1->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+  //the destinations should hold the values of the sources
+  BOOST_CHECK_CLOSE (ld2->get ("p"), 1.2, 0.0001);
+  BOOST_CHECK_CLOSE (ld1->get ("q"), 0.3, 0.0001);
+}
+
+/** messages should be applied in delivery time order regardless of the order they were sent*/
+BOOST_AUTO_TEST_CASE (federation_message_order_test)
+{
+  std::string fname = std::string (DYN1_TEST_DIRECTORY "test_dynSimple1.xml");
+  auto sim1 = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+  auto ld = sim1->find ("load3");
+  BOOST_REQUIRE (ld != nullptr);
+
+  federationCoordinator fc;
+  auto f1 = fc.addFederate (sim1);
+  federateMessage late;
+  late.deliveryTime = 0.6;
+  late.destination = f1;
+  late.target = "load3:p";
+  late.value = 1.4;
+  BOOST_CHECK_EQUAL (fc.send (late), FUNCTION_EXECUTION_SUCCESS);
+  federateMessage early = late;
+  early.deliveryTime = 0.3;
+  early.value = 1.6;
+  BOOST_CHECK_EQUAL (fc.send (early), FUNCTION_EXECUTION_SUCCESS);
+
+  BOOST_CHECK_EQUAL (fc.run (0.45), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (fc.getFederateTime (f1), 0.45, 0.0001);
+  BOOST_CHECK_CLOSE (ld->get ("p"), 1.6, 0.0001);
+  BOOST_CHECK_EQUAL (fc.getStats ().messagesDelivered, 1u);
+
+  BOOST_CHECK_EQUAL (fc.run (1.0), FUNCTION_EXECUTION_SUCCESS);
+  BOOST_CHECK_CLOSE (ld->get ("p"), 1.4, 0.0001);
+  BOOST_CHECK_EQUAL (fc.getStats ().messagesDelivered, 2u);
+  BOOST_CHECK_EQUAL (fc.getStats ().messageErrors, 0u);
+
+  //a message in the past of the federate is rejected
+  early.deliveryTime = 0.5;
+  BOOST_CHECK_EQUAL (fc.send (early), FUNCTION_EXECUTION_FAILURE);
+}
+
+/** every worker has to take part in the first round even if it is scheduled after the round starts*/
+BOOST_AUTO_TEST_CASE (federation_many_workers_test)
+{
+  std::string fname = std::string (DYN1_TEST_DIRECTORY "test_dynSimple1.xml");
+  unsigned int cores = std::thread::hardware_concurrency ();
+  count_t fedCount = 2 * ((cores > 0) ? cores : 2) + 1;
+  for (int rr = 0; rr < 10; ++rr)
+    {
+      federationCoordinator fc;
+      for (count_t kk = 0; kk < fedCount; ++kk)
+        {
+          auto sim = std::shared_ptr<gridDynSimulation> (static_cast<gridDynSimulation *> (readSimXMLFile (fname)));
+          sim->consolePrintLevel = GD_NO_PRINT;
+          fc.addFederate (sim);
+        }
+      BOOST_REQUIRE_EQUAL (fc.run (0.1), FUNCTION_EXECUTION_SUCCESS);
+      for (index_t kk = 0; kk < fedCount; ++kk)
+        {
+          BOOST_CHECK_CLOSE (fc.getFederateTime (kk), 0.1, 0.0001);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
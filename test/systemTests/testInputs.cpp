@@ -377,5 +377,35 @@ for (const auto &mp : executionCases)
 
 }
 
+BOOST_AUTO_TEST_CASE (deferred_dynamic_models_test)
+{
+  gds = new gridDynSimulation ();
+  loadFile (gds, INPUT_TEST_DIRECTORY "testIEEE39dynamic.xml");
+  gds2 = new gridDynSimulation ();
+  loadFile (gds2, INPUT_TEST_DIRECTORY "testIEEE39dynamic_deferred.xml");
+  BOOST_CHECK_EQUAL (gds->get ("deferreddynamicmodels"), 0.0);
+  BOOST_CHECK (gds2->get ("deferreddynamicmodels") > 0.0);
+
+  //the power flow does not need the dynamic models
+  gds->powerflow ();
+  gds2->powerflow ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+  BOOST_CHECK (gds2->get ("deferreddynamicmodels") > 0.0);
+  std::vector<double> V1;
+  std::vector<double> V2;
+  gds->getVoltage (V1);
+  gds2->getVoltage (V2);
+  BOOST_REQUIRE_EQUAL (V1.size (), V2.size ());
+  BOOST_CHECK_SMALL (compareVec (V1, V2), 1e-9);
+
+  //the models are constructed when the dynamic initialization starts
+  gds->dynInitialize ();
+  gds2->dynInitialize ();
+  BOOST_CHECK_EQUAL (gds2->get ("deferreddynamicmodels"), 0.0);
+  BOOST_CHECK_EQUAL (gds->stateSize (cDaeSolverMode), gds2->stateSize (cDaeSolverMode));
+  gds2->run ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::DYNAMIC_COMPLETE);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,9 +18,20 @@
 #include "testHelper.h"
 #include "solvers/solverInterface.h"
 #include "simulation/diagnostics.h"
+#include "gridBus.h"
+#include "loadModels/gridLoad.h"
+#include "linkModels/gridLink.h"
+#include "simulation/branchOutageScreening.h"
+#include "solvers/lowRankUpdateSolver.h"
+#include "arrayDataSparse.h"
+#include "simulation/voltageStabilityScreening.h"
+#include "generators/gridDynGenerator.h"
+#include "simulation/stateEstimator.h"
+#include "simulation/shortCircuitAnalysis.h"
 #include "vectorOps.hpp"
 #include <cstdio>
 #include <iostream>
+#include <random>
 
 
 static std::string pFlow_test_directory = std::string(GRIDDYN_TEST_DIRECTORY "/pFlow_tests/");
@@ -122,6 +133,37 @@ BOOST_AUTO_TEST_CASE (pFlow_test3)
 
 }
 
+/** test the mixed precision linear solver gives the same power flow solution as the default solver*/
+BOOST_AUTO_TEST_CASE (pflow_test_mixedPrecision)
+{
+  std::string fname = ieee_test_directory + "ieee118.cdf";
+  gds = new gridDynSimulation ();
+  loadFile (gds, fname);
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::STARTUP);
+  gds2 = new gridDynSimulation ();
+  loadFile (gds2, fname);
+  gds2->getSolverInterface ("powerflow")->set ("flags", "mixedprecision");
+
+  gds->powerflow ();
+  BOOST_REQUIRE (gds->currentProcessState () == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+  gds2->powerflow ();
+  BOOST_REQUIRE (gds2->currentProcessState () == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+
+  std::vector<double> volts1;
+  std::vector<double> ang1;
+  std::vector<double> volts2;
+  std::vector<double> ang2;
+  gds->getVoltage (volts1);
+  gds->getAngle (ang1);
+  gds2->getVoltage (volts2);
+  gds2->getAngle (ang2);
+  BOOST_REQUIRE_EQUAL (volts1.size (), volts2.size ());
+  BOOST_CHECK (countDiffs (volts1, volts2, 1e-6) == 0);
+  BOOST_CHECK (countDiffs (ang1, ang2, 1e-6) == 0);
+  //the refinement should converge without falling back to double precision factors
+  BOOST_CHECK_EQUAL (gds2->getSolverInterface ("powerflow")->get ("precisionfallbacks"), 0.0);
+}
+
 /** test the ieee 30 bus case with no shunts*/
 BOOST_AUTO_TEST_CASE (pflow_test30_no_shunt)
 {
@@ -424,4 +466,386 @@ BOOST_AUTO_TEST_CASE(pflow_test_line_modes)
 
 }
 
+/** test the power flow solution cache gives the same solutions as a cold start*/
+BOOST_AUTO_TEST_CASE(pflow_test_powerflow_cache)
+{
+	gds = new gridDynSimulation();
+	gds2 = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee30_no_limit.cdf";
+
+	loadCDF(gds, fname);
+	loadCDF(gds2, fname);
+	gds->set("flags", "powerflow_cache");
+	gds->pFlowInitialize(0);
+	gds2->pFlowInitialize(0);
+	gds->powerflow();
+	gds2->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	BOOST_CHECK_EQUAL(gds->getInt("powerflowcachesize"), 1);
+
+	std::vector<double> volts1;
+	std::vector<double> volts2;
+	std::vector<double> ang1;
+	std::vector<double> ang2;
+	auto ld1 = gds->getBus(4)->getLoad(0);
+	auto ld2 = gds2->getBus(4)->getLoad(0);
+	BOOST_REQUIRE((ld1 != nullptr) && (ld2 != nullptr));
+	double baseP = ld1->get("p");
+	//step a load through a sequence of small changes and back
+	std::vector<double> scales{ 1.01, 1.02, 1.0, 1.01 };
+	for (auto scale : scales)
+	{
+		ld1->set("p", baseP * scale);
+		ld2->set("p", baseP * scale);
+		for (auto sim : { gds, gds2 })
+		{
+			sim->powerflow();
+			BOOST_REQUIRE(sim->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+		}
+		gds->getVoltage(volts1);
+		gds2->getVoltage(volts2);
+		gds->getAngle(ang1);
+		gds2->getAngle(ang2);
+		BOOST_CHECK_EQUAL(countDiffs(volts1, volts2, 1e-6), 0u);
+		BOOST_CHECK_EQUAL(countDiffs(ang1, ang2, 1e-6), 0u);
+	}
+	BOOST_CHECK_EQUAL(gds->getInt("powerflowcachelookups"), 5);
+	//every solve after the first has a cached solution within the match tolerance
+	BOOST_CHECK_EQUAL(gds->getInt("powerflowcachehits"), 4);
+	//the return to the original loading is an exact match
+	BOOST_CHECK_EQUAL(gds->getInt("powerflowcachesize"), 3);
+	BOOST_CHECK(gds->get("powerflowcachehitrate") > 0.75);
+
+	gds->set("powerflowcachesize", 0);
+	BOOST_CHECK_EQUAL(gds->getInt("powerflowcachesize"), 0);
+}
+
+/** test the voltage stability margin estimates against full continuation runs*/
+BOOST_AUTO_TEST_CASE(pflow_test_stability_margin)
+{
+	gds = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee30_no_limit.cdf";
+
+	loadCDF(gds, fname);
+	gds->pFlowInitialize(0);
+	gds->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	std::vector<double> vbase;
+	gds->getVoltage(vbase);
+
+	voltageStabilityScreening screening(gds);
+	screening.addSystemLoadDirection();
+	//a transfer from the generator on bus 2 to the loads on bus 30
+	voltageStabilityScreening::transferDirection dir;
+	dir.name = "bus30";
+	auto bus30 = gds->getBus(29);
+	BOOST_REQUIRE(bus30->getLoad() != nullptr);
+	dir.loads.push_back(bus30->getLoad());
+	double p30 = bus30->getLoad()->get("p");
+	dir.generators.push_back(gds->getBus(1)->getGen());
+	screening.addDirection(dir);
+	screening.setVerification(true);
+	BOOST_REQUIRE_EQUAL(screening.screen(), FUNCTION_EXECUTION_SUCCESS);
+	auto &results = screening.getResults();
+	BOOST_REQUIRE_EQUAL(results.size(), 2u);
+	for (auto &res : results)
+	{
+		BOOST_CHECK(res.converged);
+		BOOST_REQUIRE(res.continuationMargin != kNullVal);
+		BOOST_REQUIRE(res.directMargin != kNullVal);
+		BOOST_CHECK_GT(res.continuationMargin, 0.0);
+		BOOST_CHECK(res.criticalBus != nullptr);
+		//the point of collapse estimate is close to the nose found by the continuation
+		BOOST_CHECK_LT(std::abs(res.continuationError), 0.1*res.continuationMargin);
+		BOOST_CHECK_LE(res.solvedLoading, res.continuationMargin + 1e-6);
+	}
+	BOOST_CHECK(results[0].lookAheadMargin != kNullVal);
+	//the network is restored after the screening
+	std::vector<double> vafter;
+	gds->getVoltage(vafter);
+	BOOST_CHECK_EQUAL(countDiffs(vbase, vafter, 1e-9), 0u);
+	BOOST_CHECK_CLOSE(bus30->getLoad()->get("p"), p30, 1e-9);
+}
+
+/** test the branch outage screening against full power flow solutions*/
+BOOST_AUTO_TEST_CASE(pflow_test_outage_screening)
+{
+	gds = new gridDynSimulation();
+	gds2 = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee30_no_limit.cdf";
+
+	loadCDF(gds, fname);
+	loadCDF(gds2, fname);
+	gds->pFlowInitialize(0);
+	gds->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	std::vector<double> vbase;
+	gds->getVoltage(vbase);
+
+	branchOutageScreening screening(gds);
+	BOOST_REQUIRE_EQUAL(screening.screen(), FUNCTION_EXECUTION_SUCCESS);
+	auto &results = screening.getResults();
+	BOOST_REQUIRE_EQUAL(results.size(), 41u);
+	//the base factorization is reused for every outage
+	BOOST_CHECK_EQUAL(screening.getSolverStats().baseFactorizations, 1u);
+	BOOST_CHECK_EQUAL(screening.getSolverStats().refactorizations, 0u);
+	int islanded = 0;
+	for (auto &res : results)
+	{
+		if (res.islanded)
+		{
+			++islanded;
+		}
+		else
+		{
+			BOOST_CHECK(res.converged);
+		}
+	}
+	//ieee 30 has radial branches to buses 11, 13, and 26
+	BOOST_CHECK_GE(islanded, 3);
+	//the network is restored after the screening
+	std::vector<double> vafter;
+	gds->getVoltage(vafter);
+	BOOST_CHECK_EQUAL(countDiffs(vbase, vafter, 1e-9), 0u);
+
+	gds2->pFlowInitialize(0);
+	int checked = 0;
+	std::vector<double> volts;
+	for (index_t kk = 0; (kk < results.size()) && (checked < 5); ++kk)
+	{
+		if ((results[kk].islanded) || (!results[kk].converged))
+		{
+			continue;
+		}
+		auto lnk = gds2->getLink(kk);
+		BOOST_REQUIRE(lnk->getName() == results[kk].name);
+		lnk->disconnect();
+		gds2->powerflow();
+		BOOST_REQUIRE(gds2->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+		gds2->getVoltage(volts);
+		BOOST_CHECK_CLOSE(*std::min_element(volts.begin(), volts.end()), results[kk].minVoltage, 1e-4);
+		lnk->reconnect();
+		++checked;
+	}
+	BOOST_CHECK_EQUAL(checked, 5);
+}
+
+/** test the low rank solves on random well conditioned updates which need pivoting in the capacitance matrix*/
+BOOST_AUTO_TEST_CASE(pflow_test_low_rank_update_accuracy)
+{
+	const count_t n = 40;
+	std::mt19937 gen(2476);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	std::uniform_int_distribution<int> pick(0, n - 1);
+	arrayDataSparse base;
+	for (index_t kk = 0; kk < n; ++kk)
+	{
+		base.assign(kk, kk, 10.0);
+		for (index_t jj = 1; jj <= 2; ++jj)
+		{
+			base.assign(kk, (kk + jj) % n, dist(gen));
+			base.assign((kk + jj) % n, kk, dist(gen));
+		}
+	}
+	lowRankUpdateSolver solver;
+	BOOST_REQUIRE_EQUAL(solver.setBase(base, n), FUNCTION_EXECUTION_SUCCESS);
+	for (int tt = 0; tt < 200; ++tt)
+	{
+		arrayDataSparse upd;
+		for (index_t kk = 0; kk < base.size(); ++kk)
+		{
+			upd.assign(base.rowIndex(kk), base.colIndex(kk), base.val(kk));
+		}
+		for (int uu = 0; uu < 4; ++uu)
+		{
+			upd.assign(pick(gen), pick(gen), 20.0 * dist(gen));
+		}
+		BOOST_REQUIRE(solver.update(upd, n) == lowRankUpdateSolver::update_mode::low_rank);
+		std::vector<double> x(n);
+		for (auto &xv : x)
+		{
+			xv = dist(gen);
+		}
+		BOOST_CHECK_EQUAL(solver.solve(x.data(), x.data()), FUNCTION_EXECUTION_SUCCESS);
+	}
+	//every solve reaches the tolerance with the low rank correction alone
+	BOOST_CHECK_EQUAL(solver.getStats().lowRankUpdates, 200u);
+	BOOST_CHECK_EQUAL(solver.getStats().refinementSteps, 0u);
+	BOOST_CHECK_EQUAL(solver.getStats().accuracyFallbacks, 0u);
+	BOOST_CHECK_EQUAL(solver.getStats().refactorizations, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(pflow_test_state_estimation)
+{
+	gds = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee30_no_limit.cdf";
+
+	loadCDF(gds, fname);
+	gds->pFlowInitialize(0);
+	gds->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	std::vector<double> vbase;
+	std::vector<double> abase;
+	gds->getVoltage(vbase);
+	gds->getAngle(abase);
+
+	stateEstimator se(gds);
+	std::vector<gridBus *> buses;
+	gds->getBusVector(buses);
+	for (auto &bus : buses)
+	{
+		BOOST_REQUIRE(se.addMeasurement(bus, "voltage", 1.0, 0.004) != kNullLocation);
+		BOOST_REQUIRE(se.addMeasurement(bus, "linkp", 0.0, 0.01) != kNullLocation);
+		BOOST_REQUIRE(se.addMeasurement(bus, "linkq", 0.0, 0.01) != kNullLocation);
+	}
+	index_t kk = 0;
+	gridLink *lnk;
+	index_t flowMeas = kNullLocation;
+	while ((lnk = gds->getLink(kk)) != nullptr)
+	{
+		flowMeas = se.addMeasurement(lnk, "p1", 0.0, 0.008);
+		BOOST_REQUIRE(flowMeas != kNullLocation);
+		BOOST_REQUIRE(se.addMeasurement(lnk, "q1", 0.0, 0.008) != kNullLocation);
+		++kk;
+	}
+	BOOST_CHECK(se.addMeasurement(buses[0], "freq", 0.0, 0.01) == kNullLocation);
+	se.sampleMeasurements();
+	//start from a flat profile so the estimate does not begin at the answer
+	se.setFlatStart(true);
+	BOOST_REQUIRE_EQUAL(se.estimate(), FUNCTION_EXECUTION_SUCCESS);
+	std::vector<double> vest;
+	std::vector<double> aest;
+	gds->getVoltage(vest);
+	gds->getAngle(aest);
+	BOOST_CHECK_EQUAL(countDiffs(vbase, vest, 1e-5), 0u);
+	BOOST_CHECK_EQUAL(countDiffs(abase, aest, 1e-5), 0u);
+	BOOST_CHECK_SMALL(se.getStats().objective, 1e-6);
+	BOOST_CHECK_EQUAL(se.getStats().badDataRemoved, 0u);
+
+	//a repeated scan reuses the factorization
+	auto factors = se.getStats().factorizations;
+	BOOST_REQUIRE_EQUAL(se.estimate(), FUNCTION_EXECUTION_SUCCESS);
+	BOOST_CHECK_EQUAL(se.getStats().factorizations, factors);
+
+	//a gross error in a flow measurement is removed as bad data
+	double goodValue = se.getMeasurement(flowMeas).value;
+	se.setMeasurement(flowMeas, goodValue + 0.5);
+	BOOST_REQUIRE_EQUAL(se.estimate(), FUNCTION_EXECUTION_SUCCESS);
+	BOOST_CHECK(se.getMeasurement(flowMeas).badData);
+	BOOST_CHECK_EQUAL(se.getStats().badDataRemoved, 1u);
+	gds->getVoltage(vest);
+	BOOST_CHECK_EQUAL(countDiffs(vbase, vest, 1e-5), 0u);
+	BOOST_CHECK_SMALL(se.getMeasurement(flowMeas).estimate - goodValue, 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(pflow_test_short_circuit)
+{
+	gds = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee14.cdf";
+
+	loadCDF(gds, fname);
+	gds->pFlowInitialize(0);
+	gds->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+
+	shortCircuitAnalysis sc(gds);
+	//with identical sequence networks the fault currents have fixed ratios
+	sc.setLineZeroSequenceRatio(1.0);
+	sc.setGeneratorZeroSequenceRatio(1.0);
+	BOOST_REQUIRE_EQUAL(sc.sweep(), FUNCTION_EXECUTION_SUCCESS);
+	auto &results = sc.getResults();
+	BOOST_REQUIRE_EQUAL(results.size(), 14u);
+	for (auto &res : results)
+	{
+		double i3 = res.current[static_cast<int>(shortCircuitAnalysis::fault_type::three_phase)];
+		BOOST_CHECK_CLOSE(i3, std::abs(res.prefaultVoltage / res.Z1), 1e-8);
+		BOOST_CHECK_CLOSE(res.current[static_cast<int>(shortCircuitAnalysis::fault_type::line_ground)], i3, 1e-6);
+		BOOST_CHECK_CLOSE(res.current[static_cast<int>(shortCircuitAnalysis::fault_type::line_line)], i3 * std::sqrt(3.0) / 2.0, 1e-6);
+		BOOST_CHECK_CLOSE(res.current[static_cast<int>(shortCircuitAnalysis::fault_type::double_line_ground)], i3, 1e-6);
+		BOOST_CHECK_LT(res.minVoltage[static_cast<int>(shortCircuitAnalysis::fault_type::three_phase)], std::abs(res.prefaultVoltage));
+	}
+
+	//the voltage at the faulted bus is the drop across the fault impedance
+	std::complex<double> Zf(0.0, 0.05);
+	sc.setFaultImpedance(Zf);
+	std::vector<gridBus *> faultBus{ results[4].bus };
+	BOOST_REQUIRE_EQUAL(sc.sweep(faultBus), FUNCTION_EXECUTION_SUCCESS);
+	BOOST_REQUIRE_EQUAL(sc.getResults().size(), 1u);
+	double ifault = sc.getResults()[0].current[0];
+	std::vector<double> Va, Vb, Vc;
+	BOOST_REQUIRE_EQUAL(sc.faultVoltages(faultBus[0], shortCircuitAnalysis::fault_type::three_phase, Va, Vb, Vc), FUNCTION_EXECUTION_SUCCESS);
+	BOOST_CHECK_CLOSE(Va[4], std::abs(Zf) * ifault, 1e-6);
+	BOOST_CHECK_CLOSE(Vb[4], Va[4], 1e-6);
+
+	//a higher zero sequence impedance lowers the ground fault current
+	sc.setFaultImpedance(0.0);
+	sc.setLineZeroSequenceRatio(3.0);
+	BOOST_REQUIRE_EQUAL(sc.sweep(faultBus), FUNCTION_EXECUTION_SUCCESS);
+	BOOST_CHECK_GT(std::abs(sc.getResults()[0].Z0), std::abs(sc.getResults()[0].Z1));
+	BOOST_CHECK_LT(sc.getResults()[0].current[static_cast<int>(shortCircuitAnalysis::fault_type::line_ground)], sc.getResults()[0].current[0]);
+}
+
+/** test the assembled network mode against the link by link evaluation*/
+BOOST_AUTO_TEST_CASE(pflow_test_assembled_network)
+{
+	gds = new gridDynSimulation();
+	gds2 = new gridDynSimulation();
+	std::string fname = ieee_test_directory + "ieee30_no_limit.cdf";
+
+	loadCDF(gds, fname);
+	loadCDF(gds2, fname);
+	gds->set("flags", "assembled_network");
+	gds->pFlowInitialize(0);
+	gds2->pFlowInitialize(0);
+	gds->powerflow();
+	gds2->powerflow();
+	BOOST_REQUIRE(gds->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	BOOST_REQUIRE(gds2->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	BOOST_CHECK_GT(gds->getInt("networkevaluations"), 0);
+	BOOST_CHECK_EQUAL(gds->getInt("networkbuilds"), 1);
+	BOOST_CHECK_EQUAL(JacobianCheck(gds, cPflowSolverMode), 0);
+
+	std::vector<double> volts1;
+	std::vector<double> volts2;
+	std::vector<double> ang1;
+	std::vector<double> ang2;
+	gds->getVoltage(volts1);
+	gds2->getVoltage(volts2);
+	gds->getAngle(ang1);
+	gds2->getAngle(ang2);
+	BOOST_CHECK_EQUAL(countDiffs(volts1, volts2, 1e-6), 0u);
+	BOOST_CHECK_EQUAL(countDiffs(ang1, ang2, 1e-6), 0u);
+
+	//a tap change and a branch outage restamp the changed branches without rebuilding the matrix
+	index_t tapLink = kNullLocation;
+	index_t kk = 0;
+	gridLink *lnk;
+	while ((lnk = gds->getLink(kk)) != nullptr)
+	{
+		if (lnk->get("tap") != 1.0)
+		{
+			tapLink = kk;
+			break;
+		}
+		++kk;
+	}
+	BOOST_REQUIRE(tapLink != kNullLocation);
+	for (auto sim : { gds, gds2 })
+	{
+		sim->getLink(tapLink)->set("tap", 1.0);
+		sim->getLink(0)->disconnect();
+		sim->powerflow();
+		BOOST_REQUIRE(sim->currentProcessState() == gridDynSimulation::gridState_t::POWERFLOW_COMPLETE);
+	}
+	BOOST_CHECK_EQUAL(gds->getInt("networkbuilds"), 1);
+	BOOST_CHECK_GE(gds->getInt("networkrestamps"), 2);
+	gds->getVoltage(volts1);
+	gds2->getVoltage(volts2);
+	gds->getAngle(ang1);
+	gds2->getAngle(ang2);
+	BOOST_CHECK_EQUAL(countDiffs(volts1, volts2, 1e-6), 0u);
+	BOOST_CHECK_EQUAL(countDiffs(ang1, ang2, 1e-6), 0u);
+	BOOST_CHECK_EQUAL(JacobianCheck(gds, cPflowSolverMode), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+*/
+
+#include "gridLogger.h"
+
+#include <iostream>
+
+//times below this are considered to be before the simulation started
+static const double prestartTime = -1e40;
+//the console is shared by every logger in the process, simulations running on separate threads (federates, ensemble
+//members) each have their own logger so console output is serialized here to keep the lines intact
+static std::mutex consoleLock;
+
+gridLogger::gridLogger () : halt (false), queued (0), written (0), writerIdle (false)
+{
+}
+
+gridLogger::~gridLogger ()
+{
+  stopWriter ();
+  closeFile ();
+}
+
+bool gridLogger::openFile (const std::string &fileName)
+{
+  flush ();
+  std::lock_guard<std::mutex> lock (writeLock);
+  if (logStream.is_open ())
+    {
+      logStream.close ();
+    }
+  if (format == log_format::binary)
+    {
+      logStream.open (fileName.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+    }
+  else
+    {
+      logStream.open (fileName.c_str (), std::ios::out | std::ios::trunc);
+    }
+  fileOpen = logStream.is_open ();
+  return fileOpen;
+}
+
+void gridLogger::closeFile ()
+{
+  flush ();
+  std::lock_guard<std::mutex> lock (writeLock);
+  if (logStream.is_open ())
+    {
+      logStream.close ();
+    }
+  fileOpen = false;
+}
+
+void gridLogger::setFormat (log_format newFormat)
+{
+  flush ();
+  format = newFormat;
+}
+
+bool gridLogger::formatFromString (const std::string &fmt, log_format &result)
+{
+  if (fmt == "text")
+    {
+      result = log_format::text;
+    }
+  else if (fmt == "json")
+    {
+      result = log_format::json;
+    }
+  else if (fmt == "binary")
+    {
+      result = log_format::binary;
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+void gridLogger::setAsynchronous (bool async)
+{
+  if (async == asyncMode)
+    {
+      return;
+    }
+  if (async)
+    {
+      halt = false;
+      writer = std::thread (&gridLogger::writerLoop, this);
+      asyncMode = true;
+    }
+  else
+    {
+      stopWriter ();
+    }
+}
+
+void gridLogger::write (logRecord &&rec)
+{
+  if (asyncMode)
+    {
+      ++queued;
+      recordQueue.push (std::move (rec));
+      //the writer sets writerIdle before it checks the queue count so either it sees this record or it gets woken
+      if (writerIdle.load ())
+        {
+          std::lock_guard<std::mutex> lock (waitLock);
+          wake.notify_one ();
+        }
+    }
+  else
+    {
+      std::lock_guard<std::mutex> lock (writeLock);
+      writeRecord (rec);
+      ++queued;
+      ++written;
+    }
+}
+
+void gridLogger::flush ()
+{
+  if (asyncMode)
+    {
+      std::unique_lock<std::mutex> lock (waitLock);
+      drained.wait (lock, [this] {
+        return (written.load () >= queued.load ());
+      });
+    }
+  std::lock_guard<std::mutex> lock (writeLock);
+  if (logStream.is_open ())
+    {
+      logStream.flush ();
+    }
+  std::lock_guard<std::mutex> clock (consoleLock);
+  std::cout.flush ();
+}
+
+void gridLogger::stopWriter ()
+{
+  if (!asyncMode)
+    {
+      return;
+    }
+  {
+    std::lock_guard<std::mutex> lock (waitLock);
+    halt = true;
+    wake.notify_one ();
+  }
+  if (writer.joinable ())
+    {
+      writer.join ();
+    }
+  asyncMode = false;
+}
+
+void gridLogger::writerLoop ()
+{
+  logRecord rec;
+  while (true)
+    {
+      bool haltRequested = halt.load ();
+      bool found = false;
+      while (recordQueue.pop (rec))
+        {
+          found = true;
+          {
+            std::lock_guard<std::mutex> lock (writeLock);
+            writeRecord (rec);
+          }
+          ++written;
+        }
+      if (found)
+        {
+          std::lock_guard<std::mutex> lock (waitLock);
+          drained.notify_all ();
+        }
+      if (haltRequested)
+        {
+          break;
+        }
+      if (!found)
+        {
+          std::unique_lock<std::mutex> lock (waitLock);
+          writerIdle = true;
+          wake.wait (lock, [this] {
+            return ((halt.load ()) || (written.load () < queued.load ()));
+          });
+          writerIdle = false;
+        }
+    }
+}
+
+static void writeJsonString (std::ostream &out, const std::string &str)
+{
+  out << '"';
+  for (auto c : str)
+    {
+      switch (c)
+        {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        case '\t':
+          out << "\\t";
+          break;
+        default:
+          out << c;
+        }
+    }
+  out << '"';
+}
+
+void gridLogger::writeRecord (const logRecord &rec)
+{
+  std::string key;
+  //levels match GD_WARNING_PRINT and GD_ERROR_PRINT
+  if (rec.level == 2)
+    {
+      key = "||WARNING||";
+    }
+  else if (rec.level == 1)
+    {
+      key = "||ERROR||";
+    }
+  std::string simtime = ((rec.time > prestartTime) ? '(' + std::to_string (rec.time) + ')' : std::string ("(PRESTART)"));
+  if ((rec.toFile) && (logStream.is_open ()))
+    {
+      switch (format)
+        {
+        case log_format::text:
+          logStream << simtime << rec.objectName << "::" << key << rec.message << '\n';
+          break;
+        case log_format::json:
+          logStream << "{\"time\":";
+          if (rec.time > prestartTime)
+            {
+              logStream << rec.time;
+            }
+          else
+            {
+              logStream << "null";
+            }
+          logStream << ",\"level\":" << rec.level << ",\"source\":" << rec.source << ",\"object\":";
+          writeJsonString (logStream, rec.objectName);
+          logStream << ",\"message\":";
+          writeJsonString (logStream, rec.message);
+          logStream << "}\n";
+          break;
+        case log_format::binary:
+          {
+            //record layout: time(double) level(int32) source(uint32) name length(uint32) message length(uint32) name message
+            std::int32_t level = rec.level;
+            auto nameLen = static_cast<std::uint32_t> (rec.objectName.size ());
+            auto msgLen = static_cast<std::uint32_t> (rec.message.size ());
+            logStream.write (reinterpret_cast<const char *> (&rec.time), sizeof(double));
+            logStream.write (reinterpret_cast<const char *> (&level), sizeof(level));
+            logStream.write (reinterpret_cast<const char *> (&rec.source), sizeof(rec.source));
+            logStream.write (reinterpret_cast<const char *> (&nameLen), sizeof(nameLen));
+            logStream.write (reinterpret_cast<const char *> (&msgLen), sizeof(msgLen));
+            logStream.write (rec.objectName.data (), nameLen);
+            logStream.write (rec.message.data (), msgLen);
+          }
+          break;
+        }
+    }
+  if (rec.toConsole)
+    {
+      std::string line = simtime + rec.objectName + "::" + key + rec.message + '\n';
+      std::lock_guard<std::mutex> lock (consoleLock);
+      std::cout << line;
+    }
+}
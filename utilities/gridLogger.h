@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+*/
+
+#ifndef GRID_LOGGER_H_
+#define GRID_LOGGER_H_
+
+#include "mpscQueue.hpp"
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/** @brief a single log entry*/
+class logRecord
+{
+public:
+  double time = 0.0;  //!< the simulation time of the message
+  int level = 0;  //!< the print level of the message
+  std::uint32_t source = 0;  //!< an identifier for the object generating the message
+  std::string objectName;  //!< the formatted object name
+  std::string message;  //!< the message itself
+  bool toConsole = false;  //!< the record should be printed to the console
+  bool toFile = false;  //!< the record should be written to the file
+};
+
+/** @brief logging sink for a simulation
+ writes log records to the console and optionally a file as text, json lines, or a binary record stream
+in asynchronous mode records are placed in a lock free queue and written from a background thread so the
+calling thread only pays for the record construction
+*/
+class gridLogger
+{
+public:
+  /** @brief the format used in the log file, the console always gets text*/
+  enum class log_format
+  {
+    text,  //!< the classic human readable format
+    json,  //!< one json object per line
+    binary,  //!< length prefixed binary records
+  };
+  gridLogger ();
+  ~gridLogger ();
+  gridLogger (const gridLogger &) = delete;
+  gridLogger &operator= (const gridLogger &) = delete;
+
+  /** @brief open a file for the log output
+  @return true if the file was opened
+  */
+  bool openFile (const std::string &fileName);
+  /** @brief close the log file if one is open*/
+  void closeFile ();
+  bool isFileOpen () const
+  {
+    return fileOpen;
+  }
+  /** @brief set the format for the file output*/
+  void setFormat (log_format newFormat);
+  log_format getFormat () const
+  {
+    return format;
+  }
+  /** @brief turn asynchronous writing on or off, turning it off flushes all pending records*/
+  void setAsynchronous (bool async);
+  bool isAsynchronous () const
+  {
+    return asyncMode;
+  }
+  /** @brief write a record to the requested outputs*/
+  void write (logRecord &&rec);
+  /** @brief wait until all queued records have been written*/
+  void flush ();
+  /** @brief get the number of records written*/
+  std::uint64_t recordCount () const
+  {
+    return written.load ();
+  }
+  /** @brief convert a format string (text, json, binary) to a log format
+  @return true if the string was recognized
+  */
+  static bool formatFromString (const std::string &fmt, log_format &result);
+
+private:
+  log_format format = log_format::text;
+  bool asyncMode = false;
+  bool fileOpen = false;
+  std::ofstream logStream;
+  std::mutex writeLock;  //!< serializes the actual output
+  mpscQueue<logRecord> recordQueue;
+  std::thread writer;
+  std::atomic<bool> halt;
+  std::atomic<std::uint64_t> queued;
+  std::atomic<std::uint64_t> written;
+  std::atomic<bool> writerIdle;  //!< the writer thread is waiting for records
+  std::mutex waitLock;
+  std::condition_variable wake;  //!< wakes the writer thread
+  std::condition_variable drained;  //!< signals flush that the writer has caught up
+
+  void writeRecord (const logRecord &rec);
+  void writerLoop ();
+  void stopWriter ();
+};
+
+#endif
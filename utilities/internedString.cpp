@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#include "internedString.h"
+
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace
+{
+/** the global table,  the nodes of an unordered_map don't move so the entries can be referenced directly
+the empty string is a permanent entry which is not counted*/
+class stringTable
+{
+public:
+  std::unordered_map<std::string, size_t> entries;
+  std::mutex lock;
+  internedString::tableEntry *empty;
+
+  stringTable ()
+  {
+    empty = &(*(entries.emplace (std::string (), 0).first));
+  }
+  internedString::tableEntry *intern (const std::string &val)
+  {
+    if (val.empty ())
+      {
+        return empty;
+      }
+    std::lock_guard<std::mutex> guard (lock);
+    auto ent = &(*(entries.emplace (val, 0).first));
+    ++ent->second;
+    return ent;
+  }
+  internedString::tableEntry *acquire (internedString::tableEntry *ent)
+  {
+    if (ent != empty)
+      {
+        std::lock_guard<std::mutex> guard (lock);
+        ++ent->second;
+      }
+    return ent;
+  }
+  void release (internedString::tableEntry *ent)
+  {
+    if (ent == empty)
+      {
+        return;
+      }
+    std::lock_guard<std::mutex> guard (lock);
+    if (--ent->second == 0)
+      {
+        entries.erase (entries.find (ent->first));
+      }
+  }
+};
+
+stringTable &table ()
+{
+  static stringTable strTable;
+  return strTable;
+}
+}
+
+internedString::internedString () : ref (table ().empty)
+{
+
+}
+
+internedString::internedString (const std::string &val) : ref (table ().intern (val))
+{
+
+}
+
+internedString::internedString (const char *val) : ref (table ().intern (std::string (val)))
+{
+
+}
+
+internedString::internedString (const internedString &val) : ref (table ().acquire (val.ref))
+{
+
+}
+
+internedString::~internedString ()
+{
+  table ().release (ref);
+}
+
+internedString &internedString::operator= (const internedString &val)
+{
+  if (ref != val.ref)
+    {
+      auto &tab = table ();
+      auto old = ref;
+      ref = tab.acquire (val.ref);
+      tab.release (old);
+    }
+  return *this;
+}
+
+internedString &internedString::operator= (const std::string &val)
+{
+  auto &tab = table ();
+  auto old = ref;
+  ref = tab.intern (val);
+  tab.release (old);
+  return *this;
+}
+
+internedString &internedString::operator= (const char *val)
+{
+  return (*this = std::string (val));
+}
+
+size_t internedString::tableCount ()
+{
+  auto &tab = table ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  return tab.entries.size ();
+}
+
+size_t internedString::stringHeapBytes (size_t length)
+{
+  //strings up to the small string capacity are stored inside the std::string object
+  static const size_t inlineCapacity = std::string ().capacity ();
+  return (length > inlineCapacity) ? length + 1 : 0;
+}
+
+size_t internedString::tableBytes ()
+{
+  auto &tab = table ();
+  std::lock_guard<std::mutex> guard (tab.lock);
+  size_t bytes = tab.entries.bucket_count () * sizeof (void *);
+  for (auto &ent : tab.entries)
+    {
+      //each node holds the string,  the count,  a next pointer,  and the cached hash
+      bytes += sizeof (tableEntry) + sizeof (void *) + sizeof (size_t) + stringHeapBytes (ent.first.size ());
+    }
+  return bytes;
+}
+
+std::ostream &operator<< (std::ostream &os, const internedString &val)
+{
+  return (os << val.str ());
+}
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef INTERNED_STRING_H_
+#define INTERNED_STRING_H_
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+/** @brief a string stored once in a global string table
+ the object only holds a pointer to the table entry so equal strings used by many objects share a single copy and
+comparing two interned strings is a pointer operation.  The entries are reference counted and removed when the last
+string using them is destroyed or reassigned so generated unique names do not accumulate in the table.
+The class converts implicitly to a const std::string reference so it can be used in most places a string is read.
+*/
+class internedString
+{
+public:
+  /** @brief an entry in the table,  the string and the number of interned strings referencing it*/
+  typedef std::pair<const std::string, size_t> tableEntry;
+
+  internedString ();
+  internedString (const std::string &val);
+  internedString (const char *val);
+  internedString (const internedString &val);
+  ~internedString ();
+
+  internedString &operator= (const internedString &val);
+  internedString &operator= (const std::string &val);
+  internedString &operator= (const char *val);
+
+  operator const std::string & () const
+  {
+    return ref->first;
+  }
+  const std::string &str () const
+  {
+    return ref->first;
+  }
+  const char *c_str () const
+  {
+    return ref->first.c_str ();
+  }
+  bool empty () const
+  {
+    return ref->first.empty ();
+  }
+  size_t size () const
+  {
+    return ref->first.size ();
+  }
+  size_t length () const
+  {
+    return ref->first.size ();
+  }
+  char back () const
+  {
+    return ref->first.back ();
+  }
+  char operator[] (size_t pos) const
+  {
+    return ref->first[pos];
+  }
+  std::string substr (size_t pos = 0, size_t count = std::string::npos) const
+  {
+    return ref->first.substr (pos, count);
+  }
+  size_t find (const std::string &val, size_t pos = 0) const
+  {
+    return ref->first.find (val, pos);
+  }
+  size_t find (char val, size_t pos = 0) const
+  {
+    return ref->first.find (val, pos);
+  }
+  int compare (const std::string &val) const
+  {
+    return ref->first.compare (val);
+  }
+  /** @brief two interned strings are equal only if they reference the same table entry*/
+  bool operator== (const internedString &other) const
+  {
+    return (ref == other.ref);
+  }
+  bool operator!= (const internedString &other) const
+  {
+    return (ref != other.ref);
+  }
+  bool operator< (const internedString &other) const
+  {
+    return (ref->first < other.ref->first);
+  }
+
+  /** @brief get the number of distinct strings in the table*/
+  static size_t tableCount ();
+  /** @brief get the approximate number of bytes held by the table including the string storage*/
+  static size_t tableBytes ();
+  /** @brief get the heap bytes a std::string of a given length would hold outside the object*/
+  static size_t stringHeapBytes (size_t length);
+
+private:
+  tableEntry *ref;  //!< the table entry
+};
+
+inline bool operator== (const internedString &a, const std::string &b)
+{
+  return (a.str () == b);
+}
+inline bool operator== (const std::string &a, const internedString &b)
+{
+  return (a == b.str ());
+}
+inline bool operator== (const internedString &a, const char *b)
+{
+  return (a.str () == b);
+}
+inline bool operator== (const char *a, const internedString &b)
+{
+  return (b.str () == a);
+}
+inline bool operator!= (const internedString &a, const std::string &b)
+{
+  return (a.str () != b);
+}
+inline bool operator!= (const std::string &a, const internedString &b)
+{
+  return (a != b.str ());
+}
+inline bool operator!= (const internedString &a, const char *b)
+{
+  return (a.str () != b);
+}
+inline bool operator!= (const char *a, const internedString &b)
+{
+  return (b.str () != a);
+}
+
+inline std::string operator+ (const internedString &a, const std::string &b)
+{
+  return a.str () + b;
+}
+inline std::string operator+ (const std::string &a, const internedString &b)
+{
+  return a + b.str ();
+}
+inline std::string operator+ (const internedString &a, const char *b)
+{
+  return a.str () + b;
+}
+inline std::string operator+ (const char *a, const internedString &b)
+{
+  return a + b.str ();
+}
+inline std::string operator+ (const internedString &a, char b)
+{
+  return a.str () + b;
+}
+inline std::string operator+ (char a, const internedString &b)
+{
+  return a + b.str ();
+}
+inline std::string operator+ (const internedString &a, const internedString &b)
+{
+  return a.str () + b.str ();
+}
+
+std::ostream &operator<< (std::ostream &os, const internedString &val);
+
+#endif
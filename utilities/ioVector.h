@@ -0,0 +1,402 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+ */
+
+#ifndef IO_VECTOR_H_
+#define IO_VECTOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/** @brief the number of heap allocations made by all the ioVectors
+ the count is intended for checking that the argument passing between objects does not allocate in steady state
+*/
+inline std::atomic<unsigned long long> &ioVectorAllocationCounter ()
+{
+  static std::atomic<unsigned long long> allocations (0);
+  return allocations;
+}
+
+/** @brief get the number of heap allocations made by the ioVectors*/
+inline unsigned long long ioVectorAllocations ()
+{
+  return ioVectorAllocationCounter ().load ();
+}
+
+/** @brief vector with inline storage for the arguments and outputs passed between objects
+ up to N elements are stored in the object itself so creating,  copying,  and returning the small argument sets used in
+the model interfaces never touches the heap,  larger sets move to heap storage and are counted by ioVectorAllocations.
+Only trivial element types are supported so the elements are copied directly.
+*/
+template <class T, std::size_t N>
+class ioVector
+{
+  static_assert (std::is_trivial<T>::value, "ioVector only supports trivial types");
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  ioVector ()
+  {
+  }
+  explicit ioVector (size_type count)
+  {
+    resize (count);
+  }
+  ioVector (size_type count, const T &val)
+  {
+    assign (count, val);
+  }
+  template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+  ioVector (InputIt first, InputIt last)
+  {
+    assign (first, last);
+  }
+  ioVector (std::initializer_list<T> init)
+  {
+    assign (init.begin (), init.end ());
+  }
+  ioVector (const ioVector &iov)
+  {
+    assign (iov.begin (), iov.end ());
+  }
+  ioVector (ioVector &&iov)
+  {
+    moveFrom (iov);
+  }
+  ~ioVector ()
+  {
+    if (ptr != local)
+      {
+        delete[] ptr;
+      }
+  }
+  ioVector &operator= (const ioVector &iov)
+  {
+    if (this != &iov)
+      {
+        assign (iov.begin (), iov.end ());
+      }
+    return *this;
+  }
+  ioVector &operator= (ioVector &&iov)
+  {
+    if (this != &iov)
+      {
+        if (ptr != local)
+          {
+            delete[] ptr;
+          }
+        ptr = local;
+        cap = N;
+        moveFrom (iov);
+      }
+    return *this;
+  }
+  ioVector &operator= (std::initializer_list<T> init)
+  {
+    assign (init.begin (), init.end ());
+    return *this;
+  }
+
+  void assign (size_type count, const T &val)
+  {
+    reserve (count);
+    std::fill (ptr, ptr + count, val);
+    sz = count;
+  }
+  template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+  void assign (InputIt first, InputIt last)
+  {
+    clear ();
+    insert (end (), first, last);
+  }
+  void assign (std::initializer_list<T> init)
+  {
+    assign (init.begin (), init.end ());
+  }
+
+  reference operator[] (size_type pos)
+  {
+    return ptr[pos];
+  }
+  const_reference operator[] (size_type pos) const
+  {
+    return ptr[pos];
+  }
+  reference at (size_type pos)
+  {
+    if (pos >= sz)
+      {
+        throw (std::out_of_range ("ioVector index out of range"));
+      }
+    return ptr[pos];
+  }
+  const_reference at (size_type pos) const
+  {
+    if (pos >= sz)
+      {
+        throw (std::out_of_range ("ioVector index out of range"));
+      }
+    return ptr[pos];
+  }
+  reference front ()
+  {
+    return ptr[0];
+  }
+  const_reference front () const
+  {
+    return ptr[0];
+  }
+  reference back ()
+  {
+    return ptr[sz - 1];
+  }
+  const_reference back () const
+  {
+    return ptr[sz - 1];
+  }
+  T *data ()
+  {
+    return ptr;
+  }
+  const T *data () const
+  {
+    return ptr;
+  }
+
+  iterator begin ()
+  {
+    return ptr;
+  }
+  const_iterator begin () const
+  {
+    return ptr;
+  }
+  const_iterator cbegin () const
+  {
+    return ptr;
+  }
+  iterator end ()
+  {
+    return ptr + sz;
+  }
+  const_iterator end () const
+  {
+    return ptr + sz;
+  }
+  const_iterator cend () const
+  {
+    return ptr + sz;
+  }
+  reverse_iterator rbegin ()
+  {
+    return reverse_iterator (end ());
+  }
+  const_reverse_iterator rbegin () const
+  {
+    return const_reverse_iterator (end ());
+  }
+  reverse_iterator rend ()
+  {
+    return reverse_iterator (begin ());
+  }
+  const_reverse_iterator rend () const
+  {
+    return const_reverse_iterator (begin ());
+  }
+
+  bool empty () const
+  {
+    return (sz == 0);
+  }
+  size_type size () const
+  {
+    return sz;
+  }
+  size_type capacity () const
+  {
+    return cap;
+  }
+  /** @brief check if the elements are stored inline*/
+  bool isInline () const
+  {
+    return (ptr == local);
+  }
+  void reserve (size_type newCap)
+  {
+    if (newCap <= cap)
+      {
+        return;
+      }
+    newCap = (std::max)(newCap, 2 * cap);
+    T *nptr = new T[newCap];
+    ++ioVectorAllocationCounter ();
+    std::copy (ptr, ptr + sz, nptr);
+    if (ptr != local)
+      {
+        delete[] ptr;
+      }
+    ptr = nptr;
+    cap = newCap;
+  }
+  void shrink_to_fit ()
+  {
+  }
+
+  void clear ()
+  {
+    sz = 0;
+  }
+  iterator insert (const_iterator pos, const T &val)
+  {
+    return insert (pos, size_type (1), val);
+  }
+  iterator insert (const_iterator pos, size_type count, const T &val)
+  {
+    T cval = val;  //val may refer to an element that moves
+    auto off = static_cast<size_type> (pos - ptr);
+    reserve (sz + count);
+    std::copy_backward (ptr + off, ptr + sz, ptr + sz + count);
+    std::fill (ptr + off, ptr + off + count, cval);
+    sz += count;
+    return ptr + off;
+  }
+  template <class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+  iterator insert (const_iterator pos, InputIt first, InputIt last)
+  {
+    auto off = static_cast<size_type> (pos - ptr);
+    auto count = static_cast<size_type> (std::distance (first, last));
+    reserve (sz + count);
+    std::copy_backward (ptr + off, ptr + sz, ptr + sz + count);
+    std::copy (first, last, ptr + off);
+    sz += count;
+    return ptr + off;
+  }
+  iterator insert (const_iterator pos, std::initializer_list<T> init)
+  {
+    return insert (pos, init.begin (), init.end ());
+  }
+  iterator erase (const_iterator pos)
+  {
+    return erase (pos, pos + 1);
+  }
+  iterator erase (const_iterator first, const_iterator last)
+  {
+    auto off = static_cast<size_type> (first - ptr);
+    auto count = static_cast<size_type> (last - first);
+    std::copy (ptr + off + count, ptr + sz, ptr + off);
+    sz -= count;
+    return ptr + off;
+  }
+  void push_back (const T &val)
+  {
+    if (sz == cap)
+      {
+        T cval = val;
+        reserve (sz + 1);
+        ptr[sz++] = cval;
+      }
+    else
+      {
+        ptr[sz++] = val;
+      }
+  }
+  template <class ... Args>
+  void emplace_back (Args && ... args)
+  {
+    push_back (T (std::forward<Args> (args) ...));
+  }
+  void pop_back ()
+  {
+    --sz;
+  }
+  void resize (size_type count)
+  {
+    resize (count, T ());
+  }
+  void resize (size_type count, const T &val)
+  {
+    if (count > sz)
+      {
+        T cval = val;
+        reserve (count);
+        std::fill (ptr + sz, ptr + count, cval);
+      }
+    sz = count;
+  }
+  void swap (ioVector &iov)
+  {
+    ioVector temp (std::move (iov));
+    iov = std::move (*this);
+    *this = std::move (temp);
+  }
+
+private:
+  T local[N];  //!< the inline storage
+  T *ptr = local;  //!< the current storage
+  size_type sz = 0;  //!< the number of elements
+  size_type cap = N;  //!< the capacity of the current storage
+
+  void moveFrom (ioVector &iov)
+  {
+    if (iov.ptr == iov.local)
+      {
+        std::copy (iov.local, iov.local + iov.sz, local);
+      }
+    else
+      {
+        //take over the heap storage
+        ptr = iov.ptr;
+        cap = iov.cap;
+        iov.ptr = iov.local;
+        iov.cap = N;
+      }
+    sz = iov.sz;
+    iov.sz = 0;
+  }
+};
+
+template <class T, std::size_t N>
+bool operator== (const ioVector<T, N> &a, const ioVector<T, N> &b)
+{
+  return ((a.size () == b.size ()) && (std::equal (a.begin (), a.end (), b.begin ())));
+}
+
+template <class T, std::size_t N>
+bool operator!= (const ioVector<T, N> &a, const ioVector<T, N> &b)
+{
+  return !(a == b);
+}
+
+template <class T, std::size_t N>
+bool operator< (const ioVector<T, N> &a, const ioVector<T, N> &b)
+{
+  return std::lexicographical_compare (a.begin (), a.end (), b.begin (), b.end ());
+}
+
+#endif
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil;  eval: (c-set-offset 'innamespace 0); -*- */
+/*
+ * LLNS Copyright Start
+ * Copyright (c) 2016, Lawrence Livermore National Security
+ * This work was performed under the auspices of the U.S. Department
+ * of Energy by Lawrence Livermore National Laboratory in part under
+ * Contract W-7405-Eng-48 and in part under Contract DE-AC52-07NA27344.
+ * Produced at the Lawrence Livermore National Laboratory.
+ * All rights reserved.
+ * For details, see the LICENSE file.
+ * LLNS Copyright End
+*/
+
+#ifndef MPSC_QUEUE_H_
+#define MPSC_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+/** @brief lock free queue with multiple producers and a single consumer
+ producers link a new node onto the head with a single atomic exchange so a push never blocks
+the consumer walks the list from the tail, only one thread may call pop at a time
+@tparam T the type of value stored in the queue must be default constructible
+*/
+template <class T>
+class mpscQueue
+{
+private:
+  class node
+  {
+public:
+    std::atomic<node *> next;
+    T value;
+    node () : next (nullptr)
+    {
+    }
+    explicit node (T &&val) : next (nullptr), value (std::move (val))
+    {
+    }
+  };
+  std::atomic<node *> head;  //!< the most recently pushed node
+  node *tail;  //!< the stub node before the next value to pop
+public:
+  mpscQueue () : head (new node ()), tail (nullptr)
+  {
+    tail = head.load ();
+  }
+  ~mpscQueue ()
+  {
+    T discard;
+    while (pop (discard))
+      {
+      }
+    delete tail;
+  }
+  mpscQueue (const mpscQueue &) = delete;
+  mpscQueue &operator= (const mpscQueue &) = delete;
+
+  /** @brief add a value to the queue,  safe to call from any thread*/
+  void push (T val)
+  {
+    node *nd = new node (std::move (val));
+    node *prev = head.exchange (nd, std::memory_order_acq_rel);
+    prev->next.store (nd, std::memory_order_release);
+  }
+
+  /** @brief remove the oldest value from the queue, only to be called from the consumer thread
+  @param[out] val the location to store the value
+  @return true if a value was retrieved false if the queue was empty
+  */
+  bool pop (T &val)
+  {
+    node *nxt = tail->next.load (std::memory_order_acquire);
+    if (nxt == nullptr)
+      {
+        return false;
+      }
+    val = std::move (nxt->value);
+    delete tail;
+    tail = nxt;
+    return true;
+  }
+
+  /** @brief check if the queue has anything in it, only valid on the consumer thread*/
+  bool empty () const
+  {
+    return (tail->next.load (std::memory_order_acquire) == nullptr);
+  }
+};
+
+#endif